@@ -961,6 +961,12 @@ struct adreno_gpudev {
 	int (*ringbuffer_submitcmd)(struct adreno_device *adreno_dev,
 			struct kgsl_drawobj_cmd *cmdobj, u32 flags,
 			struct adreno_submit_time *time);
+	/**
+	 * @ringbuffer_submit: Write the ringbuffer WPTR to the hardware. Set
+	 * for targets that honor adreno_ringbuffer.defer_wptr
+	 */
+	int (*ringbuffer_submit)(struct adreno_ringbuffer *rb,
+			struct adreno_submit_time *time);
 	/**
 	 * @is_hw_collapsible: Return true if the hardware can be collapsed.
 	 * Only used by non GMU/RGMU targets
@@ -499,11 +499,12 @@ static void process_rt_bus_hint(struct kgsl_device *device, bool on)
  * sendcmd() - Send a drawobj to the GPU hardware
  * @dispatcher: Pointer to the adreno dispatcher struct
  * @drawobj: Pointer to the KGSL drawobj being sent
+ * @defer_wptr: Leave the WPTR write to adreno_ringbuffer_kick()
  *
  * Send a KGSL drawobj to the GPU hardware
  */
 static int sendcmd(struct adreno_device *adreno_dev,
-	struct kgsl_drawobj_cmd *cmdobj)
+	struct kgsl_drawobj_cmd *cmdobj, bool defer_wptr)
 {
 	struct kgsl_device *device = KGSL_DEVICE(adreno_dev);
 	struct kgsl_drawobj *drawobj = DRAWOBJ(cmdobj);
@@ -553,7 +554,9 @@ static int sendcmd(struct adreno_device *adreno_dev,
 
 	process_rt_bus_hint(device, true);
 
+	drawctxt->rb->defer_wptr = defer_wptr;
 	ret = adreno_ringbuffer_submitcmd(adreno_dev, cmdobj, &time);
+	drawctxt->rb->defer_wptr = false;
 
 	/*
 	 * On the first command, if the submission was successful, then read the
@@ -683,6 +686,8 @@ static int dispatcher_context_sendcmds(struct adreno_device *adreno_dev,
 	int ret = 0;
 	int inflight = _drawqueue_inflight(dispatch_q);
 	unsigned int timestamp;
+	bool can_defer = adreno_ringbuffer_can_defer_wptr(adreno_dev);
+	bool deferred = false;
 
 	if (dispatch_q->inflight >= inflight) {
 		spin_lock(&drawctxt->lock);
@@ -699,6 +704,7 @@ static int dispatcher_context_sendcmds(struct adreno_device *adreno_dev,
 		struct kgsl_drawobj *drawobj;
 		struct kgsl_drawobj_cmd *cmdobj;
 		struct kgsl_context *context;
+		bool defer_wptr;
 
 		if (adreno_gpu_fault(adreno_dev) != 0)
 			break;
@@ -720,6 +726,15 @@ static int dispatcher_context_sendcmds(struct adreno_device *adreno_dev,
 			break;
 		}
 		_pop_drawobj(drawctxt);
+
+		/*
+		 * If more drawobjs can follow in this burst, write them all to
+		 * the ringbuffer and update the WPTR only once at the end.
+		 * Every drawobj still gets its own timestamps and markers.
+		 */
+		defer_wptr = can_defer && drawctxt->queued &&
+			(count + 1 < _context_drawobj_burst) &&
+			(dispatch_q->inflight + 1 < inflight);
 		spin_unlock(&drawctxt->lock);
 
 		timestamp = drawobj->timestamp;
@@ -727,7 +742,7 @@ static int dispatcher_context_sendcmds(struct adreno_device *adreno_dev,
 		context = drawobj->context;
 		trace_adreno_cmdbatch_ready(context->id, context->priority,
 			drawobj->timestamp, cmdobj->requeue_cnt);
-		ret = sendcmd(adreno_dev, cmdobj);
+		ret = sendcmd(adreno_dev, cmdobj, defer_wptr);
 
 		/*
 		 * On error from sendcmd() try to requeue the cmdobj
@@ -754,9 +769,23 @@ static int dispatcher_context_sendcmds(struct adreno_device *adreno_dev,
 
 		drawctxt->submitted_timestamp = timestamp;
 
+		deferred |= defer_wptr;
 		count++;
 	}
 
+	/*
+	 * Kick off whatever the burst left in the ringbuffer. If a fault is
+	 * pending, leave the WPTR alone and let recovery restore it.
+	 */
+	if (deferred) {
+		struct kgsl_device *device = KGSL_DEVICE(adreno_dev);
+
+		mutex_lock(&device->mutex);
+		if (!adreno_gpu_fault(adreno_dev))
+			adreno_ringbuffer_kick(adreno_dev, drawctxt->rb);
+		mutex_unlock(&device->mutex);
+	}
+
 	/*
 	 * Wake up any snoozing threads if we have consumed any real commands
 	 * or marker commands and we have room in the context queue.
@@ -1881,7 +1910,7 @@ replay:
 
 		set_bit(CMDOBJ_WFI, &replay[i]->priv);
 
-		ret = sendcmd(adreno_dev, replay[i]);
+		ret = sendcmd(adreno_dev, replay[i], false);
 
 		/*
 		 * If sending the command fails, then try to recover by
@@ -2220,6 +2249,7 @@ static void retire_cmdobj(struct adreno_device *adreno_dev,
 	if (drawobj->flags & KGSL_DRAWOBJ_END_OF_FRAME) {
 		atomic64_inc(&context->proc_priv->frame_count);
 		atomic_inc(&context->proc_priv->period->frames);
+		kgsl_pwrscale_frame_retired(KGSL_DEVICE(adreno_dev), cmdobj);
 	}
 
 	/*
@@ -2239,6 +2239,7 @@ const struct gen7_gpudev adreno_gen7_gmu_gpudev = {
 		.power_ops = &gen7_gmu_power_ops,
 		.remove = gen7_remove,
 		.ringbuffer_submitcmd = gen7_ringbuffer_submitcmd,
+		.ringbuffer_submit = gen7_ringbuffer_submit,
 		.power_stats = gen7_power_stats,
 		.setproperty = gen7_setproperty,
 		.add_to_va_minidump = gen7_gmu_add_to_minidump,
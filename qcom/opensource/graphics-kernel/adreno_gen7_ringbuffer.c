@@ -172,6 +172,10 @@ int gen7_ringbuffer_submit(struct adreno_ringbuffer *rb,
 	adreno_get_submit_time(adreno_dev, rb, time);
 	adreno_profile_submit_time(time);
 
+	/* The dispatcher writes the WPTR once at the end of the burst */
+	if (rb->defer_wptr)
+		return 0;
+
 	spin_lock_irqsave(&rb->preempt_lock, flags);
 	if (adreno_in_preempt_state(adreno_dev, ADRENO_PREEMPT_NONE)) {
 		if (adreno_dev->cur_rb == rb) {
@@ -2762,6 +2762,7 @@ const struct gen8_gpudev adreno_gen8_gmu_gpudev = {
 		.power_ops = &gen8_gmu_power_ops,
 		.remove = gen8_remove,
 		.ringbuffer_submitcmd = gen8_ringbuffer_submitcmd,
+		.ringbuffer_submit = gen8_ringbuffer_submit,
 		.power_stats = gen8_power_stats,
 		.setproperty = gen8_setproperty,
 		.add_to_va_minidump = gen8_gmu_add_to_minidump,
@@ -1129,6 +1129,7 @@ void adreno_hwsched_retire_cmdobj(struct adreno_hwsched *hwsched,
 	if (drawobj->flags & KGSL_DRAWOBJ_END_OF_FRAME) {
 		atomic64_inc(&drawobj->context->proc_priv->frame_count);
 		atomic_inc(&drawobj->context->proc_priv->period->frames);
+		kgsl_pwrscale_frame_retired(context->device, cmdobj);
 	}
 
 	entry = cmdobj->profiling_buf_entry;
@@ -6,7 +6,10 @@
 
 #include <linux/ctype.h>
 #include <linux/debugfs.h>
+#include <linux/log2.h>
 #include <linux/sched/signal.h>
+#include <linux/vmalloc.h>
+#include <linux/version.h>
 
 #include "adreno.h"
 #include "adreno_hwsched.h"
@@ -499,6 +502,213 @@ static int profile_enable_set(void *data, u64 val)
 	return 0;
 }
 
+static enum hrtimer_restart profile_sample_timer(struct hrtimer *timer)
+{
+	struct adreno_profile_sampler *sampler = container_of(timer,
+		struct adreno_profile_sampler, timer);
+	unsigned int period = READ_ONCE(sampler->period);
+
+	if (!period)
+		return HRTIMER_NORESTART;
+
+	/* The previous sample is still pending, skip this period */
+	if (!queue_work(kgsl_driver.workqueue, &sampler->work))
+		sampler->overruns++;
+
+	hrtimer_forward_now(timer, us_to_ktime(period));
+	return HRTIMER_RESTART;
+}
+
+static void profile_sample_work(struct work_struct *work)
+{
+	struct adreno_profile_sampler *sampler = container_of(work,
+		struct adreno_profile_sampler, work);
+	struct adreno_device *adreno_dev = container_of(sampler,
+		struct adreno_device, profile.sampler);
+	struct kgsl_device *device = KGSL_DEVICE(adreno_dev);
+	struct adreno_profile_ring *ring = sampler->ring;
+	struct adreno_profile_sample *sample;
+	unsigned int i;
+
+	mutex_lock(&device->mutex);
+
+	/*
+	 * Don't wake up the GPU for a sample, the counters don't count while
+	 * it is off anyway
+	 */
+	if (!sampler->period || device->state != KGSL_STATE_ACTIVE)
+		goto out;
+
+	WRITE_ONCE(ring->overruns, sampler->overruns);
+
+	if (sampler->head - smp_load_acquire(&ring->tail) >= sampler->slots) {
+		WRITE_ONCE(ring->seq, ++sampler->seq);
+		WRITE_ONCE(ring->dropped, ++sampler->dropped);
+		goto out;
+	}
+
+	if (adreno_perfcntr_active_oob_get(adreno_dev))
+		goto out;
+
+	sample = (void *)ring + PAGE_ALIGN(sizeof(*ring)) +
+		(sampler->head & (sampler->slots - 1)) * sampler->size;
+
+	sample->seq = sampler->seq++;
+	sample->time_ns = ktime_get_ns();
+
+	for (i = 0; i < sampler->count; i++)
+		sample->values[i] = adreno_perfcounter_read(adreno_dev,
+			sampler->counters[i].groupid, sampler->counters[i].reg);
+
+	adreno_perfcntr_active_oob_put(adreno_dev);
+
+	WRITE_ONCE(ring->seq, sampler->seq);
+
+	/* Publish the sample to the consumer */
+	smp_store_release(&ring->head, ++sampler->head);
+out:
+	mutex_unlock(&device->mutex);
+}
+
+static void _sample_stop(struct adreno_profile_sampler *sampler)
+{
+	hrtimer_cancel(&sampler->timer);
+	cancel_work_sync(&sampler->work);
+}
+
+static int _sample_start(struct adreno_device *adreno_dev,
+		unsigned int period)
+{
+	const struct adreno_perfcounters *counters =
+		ADRENO_PERFCOUNTERS(adreno_dev);
+	struct adreno_profile *profile = &adreno_dev->profile;
+	struct adreno_profile_sampler *sampler = &profile->sampler;
+	struct adreno_profile_assigns_list *entry;
+	struct adreno_profile_ring *ring;
+	unsigned int count = 0;
+
+	if (!profile->assignment_count ||
+		profile->assignment_count > ADRENO_PROFILE_RING_MAX_COUNTERS)
+		return -EINVAL;
+
+	if (!sampler->ring) {
+		/* allocate the ring the first time sampling is enabled */
+		sampler->ring = vmalloc_user(ADRENO_PROFILE_RING_SIZE);
+		if (!sampler->ring)
+			return -ENOMEM;
+	}
+
+	kfree(sampler->counters);
+	sampler->counters = kcalloc(profile->assignment_count,
+		sizeof(*sampler->counters), GFP_KERNEL);
+	if (!sampler->counters)
+		return -ENOMEM;
+
+	ring = sampler->ring;
+
+	list_for_each_entry(entry, &profile->assignments_list, list) {
+		const struct adreno_perfcount_group *group =
+			&counters->groups[entry->groupid];
+		unsigned int i;
+
+		for (i = 0; i < group->reg_count; i++) {
+			if (group->regs[i].offset == entry->offset)
+				break;
+		}
+
+		if (i == group->reg_count)
+			continue;
+
+		sampler->counters[count].groupid = entry->groupid;
+		sampler->counters[count].reg = i;
+		ring->counters[count].groupid = entry->groupid;
+		ring->counters[count].countable = entry->countable;
+		count++;
+	}
+
+	sampler->count = count;
+	sampler->size = sizeof(struct adreno_profile_sample) +
+		count * sizeof(u64);
+	sampler->slots = rounddown_pow_of_two((ADRENO_PROFILE_RING_SIZE -
+		PAGE_ALIGN(sizeof(*ring))) / sampler->size);
+	sampler->head = 0;
+	sampler->seq = 0;
+	sampler->dropped = 0;
+	sampler->overruns = 0;
+
+	ring->version = ADRENO_PROFILE_RING_VERSION;
+	ring->data_offset = PAGE_ALIGN(sizeof(*ring));
+	ring->sample_size = sampler->size;
+	ring->nr_samples = sampler->slots;
+	ring->nr_counters = count;
+	ring->period_us = period;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->seq = 0;
+	ring->dropped = 0;
+	ring->overruns = 0;
+
+	WRITE_ONCE(sampler->period, period);
+	hrtimer_start(&sampler->timer, us_to_ktime(period), HRTIMER_MODE_REL);
+
+	return 0;
+}
+
+static int profile_sample_period_get(void *data, u64 *val)
+{
+	struct kgsl_device *device = data;
+	struct adreno_device *adreno_dev = ADRENO_DEVICE(device);
+
+	mutex_lock(&device->mutex);
+	*val = adreno_dev->profile.sampler.period;
+	mutex_unlock(&device->mutex);
+
+	return 0;
+}
+
+static int profile_sample_period_set(void *data, u64 val)
+{
+	struct kgsl_device *device = data;
+	struct adreno_device *adreno_dev = ADRENO_DEVICE(device);
+	struct adreno_profile_sampler *sampler = &adreno_dev->profile.sampler;
+	int ret = 0;
+
+	if (val && (val < ADRENO_PROFILE_SAMPLE_PERIOD_MIN ||
+		val > USEC_PER_SEC))
+		return -EINVAL;
+
+	/* The sample work takes the device mutex, stop it before taking it */
+	WRITE_ONCE(sampler->period, 0);
+	_sample_stop(sampler);
+
+	mutex_lock(&device->mutex);
+
+	if (val)
+		ret = _sample_start(adreno_dev, val);
+
+	mutex_unlock(&device->mutex);
+
+	return ret;
+}
+
+static int profile_samples_mmap(struct file *filep, struct vm_area_struct *vma)
+{
+	struct kgsl_device *device = filep->private_data;
+	struct adreno_device *adreno_dev = ADRENO_DEVICE(device);
+	struct adreno_profile_sampler *sampler = &adreno_dev->profile.sampler;
+	int ret = -ENODEV;
+
+	mutex_lock(&device->mutex);
+
+	/* The ring exists once sampling was enabled and stays until close */
+	if (sampler->ring)
+		ret = remap_vmalloc_range(vma, sampler->ring, vma->vm_pgoff);
+
+	mutex_unlock(&device->mutex);
+
+	return ret;
+}
+
 static ssize_t profile_assignments_read(struct file *filep,
 		char __user *ubuf, size_t max, loff_t *ppos)
 {
@@ -680,7 +890,8 @@ static ssize_t profile_assignments_write(struct file *filep,
 
 	mutex_lock(&device->mutex);
 
-	if (adreno_profile_enabled(profile)) {
+	/* The counters can't change under a profiling or sampling session */
+	if (adreno_profile_enabled(profile) || profile->sampler.period) {
 		size = -EINVAL;
 		goto error_unlock;
 	}
@@ -996,6 +1207,17 @@ DEFINE_DEBUGFS_ATTRIBUTE(profile_enable_fops,
 			profile_enable_get,
 			profile_enable_set, "%llu\n");
 
+DEFINE_DEBUGFS_ATTRIBUTE(profile_sample_period_fops,
+			profile_sample_period_get,
+			profile_sample_period_set, "%llu\n");
+
+static const struct file_operations profile_samples_fops = {
+	.owner = THIS_MODULE,
+	.open = simple_open,
+	.mmap = profile_samples_mmap,
+	.llseek = noop_llseek,
+};
+
 void adreno_profile_init(struct adreno_device *adreno_dev)
 {
 	struct kgsl_device *device = KGSL_DEVICE(adreno_dev);
@@ -1007,6 +1229,16 @@ void adreno_profile_init(struct adreno_device *adreno_dev)
 	if (adreno_dev->hwsched_enabled)
 		return;
 
+#if (KERNEL_VERSION(6, 13, 0) <= LINUX_VERSION_CODE)
+	hrtimer_setup(&profile->sampler.timer, profile_sample_timer,
+		CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+#else
+	hrtimer_init(&profile->sampler.timer, CLOCK_MONOTONIC,
+		HRTIMER_MODE_REL);
+	profile->sampler.timer.function = profile_sample_timer;
+#endif
+	INIT_WORK(&profile->sampler.work, profile_sample_work);
+
 	/* allocate shared_buffer, which includes pre_ib and post_ib */
 	profile->shared_size = ADRENO_PROFILE_SHARED_BUF_SIZE_DWORDS;
 	profile->shared_buffer =  kgsl_allocate_global(device,
@@ -1032,6 +1264,11 @@ void adreno_profile_init(struct adreno_device *adreno_dev)
 			&profile_pipe_fops);
 	debugfs_create_file("assignments", 0644, profile_dir, device,
 			&profile_assignments_fops);
+	debugfs_create_file("sample_period", 0644, profile_dir, device,
+			&profile_sample_period_fops);
+	/* The proxy fops of debugfs_create_file() don't forward mmap */
+	debugfs_create_file_unsafe("samples", 0644, profile_dir, device,
+			&profile_samples_fops);
 }
 
 void adreno_profile_close(struct adreno_device *adreno_dev)
@@ -1043,6 +1280,14 @@ void adreno_profile_close(struct adreno_device *adreno_dev)
 		return;
 
 	profile->enabled = false;
+
+	WRITE_ONCE(profile->sampler.period, 0);
+	_sample_stop(&profile->sampler);
+	vfree(profile->sampler.ring);
+	profile->sampler.ring = NULL;
+	kfree(profile->sampler.counters);
+	profile->sampler.counters = NULL;
+
 	vfree(profile->log_buffer);
 	profile->log_buffer = NULL;
 	profile->log_head = NULL;
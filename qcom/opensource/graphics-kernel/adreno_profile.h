@@ -6,6 +6,11 @@
 #ifndef __ADRENO_PROFILE_H
 #define __ADRENO_PROFILE_H
 
+#include <linux/hrtimer.h>
+#include <linux/workqueue.h>
+
+#include "adreno_profile_ring.h"
+
 /**
  * struct adreno_profile_assigns_list: linked list for assigned perf counters
  * @list: linkage for nodes in list
@@ -23,6 +28,49 @@ struct adreno_profile_assigns_list {
 	unsigned int offset_hi; /* HI offset */
 };
 
+/**
+ * struct adreno_profile_sample_counter: a counter read by the sampler
+ * @groupid: group id
+ * @reg: index of the counter register in the group
+ */
+struct adreno_profile_sample_counter {
+	unsigned int groupid;
+	unsigned int reg;
+};
+
+/**
+ * struct adreno_profile_sampler: periodic sampling of the assigned counters
+ * @ring: ring the samples are written to, mapped by userspace
+ * @counters: counters read for each sample
+ * @count: number of counters in @counters
+ * @period: sampling period in microseconds, 0 when not sampling
+ * @size: size of a sample slot in bytes
+ * @slots: number of sample slots in @ring
+ * @head: index of the next sample to write
+ * @seq: sequence number of the next sample
+ * @dropped: number of samples dropped because @ring was full
+ * @overruns: number of periods skipped because a sample was still pending
+ * @timer: timer firing every @period
+ * @work: work reading the counters
+ *
+ * Userspace can write to all of @ring, so the state the kernel relies on
+ * is kept here and only copied out to the ring header.
+ */
+struct adreno_profile_sampler {
+	struct adreno_profile_ring *ring;
+	struct adreno_profile_sample_counter *counters;
+	unsigned int count;
+	unsigned int period;
+	unsigned int size;
+	unsigned int slots;
+	u64 head;
+	u64 seq;
+	u64 dropped;
+	u64 overruns;
+	struct hrtimer timer;
+	struct work_struct work;
+};
+
 struct adreno_profile {
 	struct list_head assignments_list; /* list of all assignments */
 	unsigned int assignment_count;  /* Number of assigned counters */
@@ -44,6 +92,7 @@ struct adreno_profile {
 	unsigned int shared_head;
 	unsigned int shared_tail;
 	unsigned int shared_size;
+	struct adreno_profile_sampler sampler;
 };
 
 #define ADRENO_PROFILE_SHARED_BUF_SIZE_DWORDS (48 * 4096 / sizeof(uint))
@@ -54,6 +103,10 @@ struct adreno_profile {
 #define ADRENO_PROFILE_LOG_BUF_SIZE_DWORDS  (ADRENO_PROFILE_LOG_BUF_SIZE / \
 						sizeof(unsigned int))
 
+#define ADRENO_PROFILE_RING_SIZE (64 * PAGE_SIZE)
+/* Shortest sampling period in microseconds */
+#define ADRENO_PROFILE_SAMPLE_PERIOD_MIN 100
+
 #ifdef CONFIG_DEBUG_FS
 void adreno_profile_init(struct adreno_device *adreno_dev);
 void adreno_profile_close(struct adreno_device *adreno_dev);
@@ -0,0 +1,85 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+#ifndef __ADRENO_PROFILE_RING_H
+#define __ADRENO_PROFILE_RING_H
+
+#include <linux/types.h>
+
+/*
+ * Layout of the perfcounter sampling ring exported through the
+ * profiling/samples debugfs file. It only uses uapi types so that
+ * tools/adreno_profile_sample.c can share it.
+ *
+ * The kernel is the only producer and the process that mapped the ring
+ * the only consumer. The kernel writes a sample at head and then publishes
+ * it with a release store of head. The consumer reads head with an acquire
+ * load, reads the samples up to it and then frees them with a release
+ * store of tail. Both indices count samples since sampling was enabled
+ * and are masked with nr_samples - 1 to find the slot of a sample.
+ *
+ * A sample that finds the ring full is dropped and counted in dropped.
+ * Every sample taken, written or dropped, gets the next sequence number,
+ * so a gap in the seq of consecutive samples is the number of samples
+ * dropped in between and seq is always head plus dropped.
+ */
+
+#define ADRENO_PROFILE_RING_VERSION 1
+#define ADRENO_PROFILE_RING_MAX_COUNTERS 64
+
+/**
+ * struct adreno_profile_ring_counter - A sampled perfcounter
+ * @groupid: Perfcounter group id
+ * @countable: Countable selected in the group
+ */
+struct adreno_profile_ring_counter {
+	__u32 groupid;
+	__u32 countable;
+};
+
+/**
+ * struct adreno_profile_ring - Header of the sampling ring
+ * @version: ADRENO_PROFILE_RING_VERSION
+ * @data_offset: Offset of the first sample slot from the header
+ * @sample_size: Size of a sample slot in bytes
+ * @nr_samples: Number of sample slots, a power of two
+ * @nr_counters: Number of values in each sample
+ * @period_us: Sampling period in microseconds
+ * @head: Index of the next sample the kernel writes
+ * @tail: Index of the next sample the consumer reads
+ * @seq: Sequence number of the next sample
+ * @dropped: Number of samples dropped because the ring was full
+ * @overruns: Number of periods skipped because the previous sample was
+ * still pending
+ * @counters: The counters in the order of the values in a sample
+ */
+struct adreno_profile_ring {
+	__u32 version;
+	__u32 data_offset;
+	__u32 sample_size;
+	__u32 nr_samples;
+	__u32 nr_counters;
+	__u32 period_us;
+	__u64 head;
+	__u64 tail;
+	__u64 seq;
+	__u64 dropped;
+	__u64 overruns;
+	struct adreno_profile_ring_counter
+		counters[ADRENO_PROFILE_RING_MAX_COUNTERS];
+};
+
+/**
+ * struct adreno_profile_sample - A sample in the sampling ring
+ * @seq: Sequence number of the sample
+ * @time_ns: CLOCK_MONOTONIC time the counters were read at
+ * @values: The counter values in the order of the ring counters
+ */
+struct adreno_profile_sample {
+	__u64 seq;
+	__u64 time_ns;
+	__u64 values[];
+};
+
+#endif
@@ -349,6 +349,22 @@ int adreno_ringbuffer_submitcmd(struct adreno_device *adreno_dev,
 	return ret;
 }
 
+bool adreno_ringbuffer_can_defer_wptr(struct adreno_device *adreno_dev)
+{
+	const struct adreno_gpudev *gpudev = ADRENO_GPU_DEVICE(adreno_dev);
+
+	return gpudev->ringbuffer_submit != NULL;
+}
+
+void adreno_ringbuffer_kick(struct adreno_device *adreno_dev,
+		struct adreno_ringbuffer *rb)
+{
+	const struct adreno_gpudev *gpudev = ADRENO_GPU_DEVICE(adreno_dev);
+
+	if (gpudev->ringbuffer_submit && rb->wptr != rb->_wptr)
+		gpudev->ringbuffer_submit(rb, NULL);
+}
+
 /**
  * adreno_ringbuffer_wait_callback() - Callback function for event registered
  * on a ringbuffer timestamp
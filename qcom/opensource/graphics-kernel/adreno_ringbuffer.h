@@ -104,6 +104,9 @@ struct adreno_submit_time {
  * @preempt_lock: Lock to protect the wptr pointer while it is being updated
  * @skip_inline_wptr: Used during preemption to make sure wptr is updated in
  * hardware
+ * @defer_wptr: Set while the dispatcher submits a command that is followed by
+ * more in the same burst. The WPTR is then written once for the whole burst by
+ * adreno_ringbuffer_kick()
  */
 struct adreno_ringbuffer {
 	unsigned long flags;
@@ -126,6 +129,7 @@ struct adreno_ringbuffer {
 	int preempted_midway;
 	spinlock_t preempt_lock;
 	bool skip_inline_wptr;
+	bool defer_wptr;
 	/**
 	 * @profile_desc: global memory to construct IB1s to do user side
 	 * profiling
@@ -159,6 +163,23 @@ int adreno_ringbuffer_submitcmd(struct adreno_device *adreno_dev,
 		struct kgsl_drawobj_cmd *cmdobj,
 		struct adreno_submit_time *time);
 
+/**
+ * adreno_ringbuffer_can_defer_wptr - Return true if the target can defer the
+ * WPTR write of a submission
+ * @adreno_dev: Pointer to an Adreno GPU handle
+ */
+bool adreno_ringbuffer_can_defer_wptr(struct adreno_device *adreno_dev);
+
+/**
+ * adreno_ringbuffer_kick - Write the WPTR held back by deferred submissions
+ * @adreno_dev: Pointer to an Adreno GPU handle
+ * @rb: Ringbuffer to kick
+ *
+ * Must be called with the device mutex held.
+ */
+void adreno_ringbuffer_kick(struct adreno_device *adreno_dev,
+		struct adreno_ringbuffer *rb);
+
 
 void adreno_ringbuffer_stop(struct adreno_device *adreno_dev);
 
@@ -19,6 +19,7 @@
 
 #include "governor.h"
 #include "msm_adreno_devfreq.h"
+#include "msm_adreno_frame_dcvs.h"
 
 static DEFINE_SPINLOCK(tz_lock);
 static DEFINE_SPINLOCK(sample_lock);
@@ -151,15 +152,44 @@ static ssize_t mod_percent_show(struct device *dev,
 	return scnprintf(buf, PAGE_SIZE, "%u\n", priv->mod_percent);
 }
 
+static ssize_t frame_aware_store(struct device *dev,
+			struct device_attribute *attr,
+			const char *buf, size_t count)
+{
+	int ret;
+	bool val;
+	struct devfreq *devfreq = to_devfreq(dev);
+	struct devfreq_msm_adreno_tz_data *priv = devfreq->data;
+
+	ret = kstrtobool(buf, &val);
+	if (ret)
+		return ret;
+
+	priv->frame_aware = val;
+
+	return count;
+}
+
+static ssize_t frame_aware_show(struct device *dev,
+			struct device_attribute *attr, char *buf)
+{
+	struct devfreq *devfreq = to_devfreq(dev);
+	struct devfreq_msm_adreno_tz_data *priv = devfreq->data;
+
+	return scnprintf(buf, PAGE_SIZE, "%d\n", priv->frame_aware);
+}
+
 static DEVICE_ATTR_RO(gpu_load);
 
 static DEVICE_ATTR_RO(suspend_time);
 static DEVICE_ATTR_RW(mod_percent);
+static DEVICE_ATTR_RW(frame_aware);
 
 static const struct device_attribute *adreno_tz_attr_list[] = {
 		&dev_attr_gpu_load,
 		&dev_attr_suspend_time,
 		&dev_attr_mod_percent,
+		&dev_attr_frame_aware,
 		NULL
 };
 
@@ -348,7 +378,7 @@ static int tz_get_target_freq(struct devfreq *devfreq, unsigned long *freq)
 	int result = 0;
 	struct devfreq_msm_adreno_tz_data *priv = devfreq->data;
 	struct devfreq_dev_status *stats = &devfreq->last_status;
-	int val, level = 0;
+	int val, level = 0, frame_level = -1;
 	int context_count = 0;
 	u64 busy_time;
 
@@ -374,8 +404,17 @@ static int tz_get_target_freq(struct devfreq *devfreq, unsigned long *freq)
 
 	priv->bin.busy_time += stats->busy_time;
 
-	if (stats->private_data)
-		context_count =  *((int *)stats->private_data);
+	if (stats->private_data) {
+		struct tz_xstats *xstats = stats->private_data;
+
+		context_count = xstats->context_count;
+
+		priv->bin.frames += xstats->frames;
+		priv->bin.missed += xstats->missed;
+		if (xstats->frame_period && (!priv->bin.frame_period ||
+				xstats->frame_period < priv->bin.frame_period))
+			priv->bin.frame_period = xstats->frame_period;
+	}
 
 	/* Update the GPU load statistics */
 	compute_work_load(stats, priv, devfreq);
@@ -391,19 +430,40 @@ static int tz_get_target_freq(struct devfreq *devfreq, unsigned long *freq)
 		return 0;
 	}
 
+	/*
+	 * The sample windows are not aligned to the frames, so in frame
+	 * aware mode keep collecting until a frame retires unless frames
+	 * stopped coming.
+	 */
+	if (priv->frame_aware && !priv->bin.frames &&
+			priv->bin.total_time < MSM_ADRENO_FRAME_WINDOW_MAX)
+		return 0;
+
 	level = devfreq_get_freq_level(devfreq, stats->current_frequency);
 	if (level < 0) {
 		pr_err(TAG "bad freq %ld\n", stats->current_frequency);
 		return level;
 	}
 
+	if (priv->frame_aware)
+		frame_level = msm_adreno_frame_level(
+			devfreq->profile->freq_table,
+			devfreq->profile->max_state, level,
+			priv->bin.busy_time, priv->bin.frames,
+			priv->bin.frame_period, priv->bin.missed,
+			&priv->frame_cycles);
+
 	/*
 	 * If there is an extended block of busy processing,
-	 * increase frequency.  Otherwise run the normal algorithm.
+	 * increase frequency.  Otherwise pick the level that meets
+	 * the frame deadlines if there were frames in the window,
+	 * or run the normal algorithm.
 	 */
 	if (!priv->disable_busy_time_burst &&
 			priv->bin.busy_time > CEILING) {
 		val = -1 * level;
+	} else if (frame_level >= 0) {
+		val = frame_level - level;
 	} else {
 		val = __secure_tz_update_entry3(level, priv->bin.total_time,
 			priv->bin.busy_time, context_count, priv);
@@ -411,6 +471,9 @@ static int tz_get_target_freq(struct devfreq *devfreq, unsigned long *freq)
 
 	priv->bin.total_time = 0;
 	priv->bin.busy_time = 0;
+	priv->bin.frames = 0;
+	priv->bin.missed = 0;
+	priv->bin.frame_period = 0;
 
 	/*
 	 * If the decision is to move to a different level, make sure the GPU
@@ -506,6 +569,10 @@ static int tz_suspend(struct devfreq *devfreq)
 
 	priv->bin.total_time = 0;
 	priv->bin.busy_time = 0;
+	priv->bin.frames = 0;
+	priv->bin.missed = 0;
+	priv->bin.frame_period = 0;
+	priv->frame_cycles = 0;
 	return 0;
 }
 
@@ -12,6 +12,7 @@
 #include <linux/dma-buf.h>
 #include <linux/dma-map-ops.h>
 #include <linux/fdtable.h>
+#include <linux/interval_tree_generic.h>
 #include <linux/io.h>
 #include <linux/mem-buf.h>
 #include <linux/mman.h>
@@ -255,6 +256,7 @@ static struct kgsl_mem_entry *kgsl_mem_entry_create(void)
 	struct kgsl_mem_entry *entry = kzalloc(sizeof(*entry), GFP_KERNEL);
 
 	if (entry != NULL) {
+		RB_CLEAR_NODE(&entry->node);
 		kref_init(&entry->refcount);
 		/* put this ref in userspace memory alloc and map ioctls */
 		kref_get(&entry->refcount);
@@ -441,6 +443,41 @@ void kgsl_mem_entry_destroy_deferred(struct kref *kref)
 	queue_work(kgsl_driver.lockless_workqueue, &entry->work);
 }
 
+#define KGSL_MEM_ENTRY_START(_entry) ((_entry)->memdesc.gpuaddr)
+#define KGSL_MEM_ENTRY_LAST(_entry) \
+	((_entry)->memdesc.gpuaddr + (_entry)->memdesc.size - 1)
+
+INTERVAL_TREE_DEFINE(struct kgsl_mem_entry, node, u64, __subtree_last,
+		KGSL_MEM_ENTRY_START, KGSL_MEM_ENTRY_LAST, static inline,
+		kgsl_mem_tree)
+
+/*
+ * Add the entry to the gpu address tree of its process once it has a gpu
+ * address. The caller must hold the process mem_lock.
+ */
+static void kgsl_mem_entry_insert_gpuaddr(struct kgsl_mem_entry *entry)
+{
+	struct kgsl_memdesc *memdesc = &entry->memdesc;
+
+	if (!memdesc->gpuaddr || !memdesc->size || !RB_EMPTY_NODE(&entry->node))
+		return;
+
+	kgsl_mem_tree_insert(entry, &entry->priv->mem_tree);
+}
+
+/*
+ * Remove the entry from the gpu address tree before its gpu address is put.
+ * The caller must hold the process mem_lock.
+ */
+static void kgsl_mem_entry_remove_gpuaddr(struct kgsl_mem_entry *entry)
+{
+	if (RB_EMPTY_NODE(&entry->node))
+		return;
+
+	kgsl_mem_tree_remove(entry, &entry->priv->mem_tree);
+	RB_CLEAR_NODE(&entry->node);
+}
+
 /* Commit the entry to the process so it can be accessed by other operations */
 static void kgsl_mem_entry_commit_process(struct kgsl_mem_entry *entry)
 {
@@ -449,6 +486,7 @@ static void kgsl_mem_entry_commit_process(struct kgsl_mem_entry *entry)
 
 	spin_lock(&entry->priv->mem_lock);
 	idr_replace(&entry->priv->mem_idr, entry, entry->id);
+	kgsl_mem_entry_insert_gpuaddr(entry);
 	spin_unlock(&entry->priv->mem_lock);
 }
 
@@ -547,6 +585,7 @@ static void kgsl_mem_entry_detach_process(struct kgsl_mem_entry *entry)
 	if (entry->id != 0)
 		idr_remove(&entry->priv->mem_idr, entry->id);
 	entry->id = 0;
+	kgsl_mem_entry_remove_gpuaddr(entry);
 
 	spin_unlock(&entry->priv->mem_lock);
 
@@ -1188,6 +1227,7 @@ static struct kgsl_process_private *kgsl_process_private_new(
 	mutex_init(&private->private_mutex);
 
 	idr_init(&private->mem_idr);
+	private->mem_tree = RB_ROOT_CACHED;
 	idr_init(&private->syncsource_idr);
 
 	kgsl_reclaim_proc_private_init(private);
@@ -1216,10 +1256,47 @@ static struct kgsl_process_private *kgsl_process_private_new(
 	return private;
 }
 
+/* Number of memory entries released under a single TLB invalidation */
+#define KGSL_RELEASE_BATCH 32
+
+/*
+ * Release callback of the last reference dropped by process_release_memory().
+ * The entry is destroyed by process_release_batch() once it is unmapped.
+ */
+static void process_release_last_ref(struct kref *kref)
+{
+}
+
+/*
+ * Unmap a batch of entries whose last reference is gone with one TLB
+ * invalidation and then destroy them
+ */
+static void process_release_batch(struct kgsl_process_private *private,
+		struct kgsl_mem_entry **entries, int count)
+{
+	struct kgsl_mmu_batch batch;
+	int i;
+
+	kgsl_mmu_batch_start(&batch, private->pagetable);
+
+	for (i = 0; i < count; i++) {
+		struct kgsl_memdesc *memdesc = &entries[i]->memdesc;
+
+		if (!kgsl_mmu_batch_unmap(&batch, memdesc))
+			memdesc->priv |= KGSL_MEMDESC_BATCH_UNMAPPED;
+	}
+
+	kgsl_mmu_batch_end(&batch);
+
+	for (i = 0; i < count; i++)
+		kgsl_mem_entry_destroy(&entries[i]->refcount);
+}
+
 static void process_release_memory(struct kgsl_process_private *private)
 {
+	struct kgsl_mem_entry *entries[KGSL_RELEASE_BATCH];
 	struct kgsl_mem_entry *entry;
-	int next = 0;
+	int next = 0, count = 0;
 
 	while (1) {
 		spin_lock(&private->mem_lock);
@@ -1232,17 +1309,29 @@ static void process_release_memory(struct kgsl_process_private *private)
 		 * If the free pending flag is not set it means that user space
 		 * did not free it's reference to this entry, in that case
 		 * free a reference to this entry, other references are from
-		 * within kgsl so they will be freed eventually by kgsl
+		 * within kgsl so they will be freed eventually by kgsl. If
+		 * it was the last reference, the entry is destroyed once it
+		 * has been unmapped along with the rest of the batch.
 		 */
 		if (!entry->pending_free) {
 			entry->pending_free = 1;
 			spin_unlock(&private->mem_lock);
-			kgsl_mem_entry_put(entry);
+			if (kref_put(&entry->refcount,
+				process_release_last_ref)) {
+				entries[count++] = entry;
+				if (count == KGSL_RELEASE_BATCH) {
+					process_release_batch(private, entries,
+						count);
+					count = 0;
+				}
+			}
 		} else {
 			spin_unlock(&private->mem_lock);
 		}
 		next = next + 1;
 	}
+
+	process_release_batch(private, entries, count);
 }
 
 static void kgsl_process_private_close(struct kgsl_device_private *dev_priv,
@@ -1495,10 +1584,6 @@ err:
 	return result;
 }
 
-#define GPUADDR_IN_MEMDESC(_val, _memdesc) \
-	(((_val) >= (_memdesc)->gpuaddr) && \
-	 ((_val) < ((_memdesc)->gpuaddr + (_memdesc)->size)))
-
 /**
  * kgsl_sharedmem_find() - Find a gpu memory allocation
  *
@@ -1511,7 +1596,6 @@ err:
 struct kgsl_mem_entry * __must_check
 kgsl_sharedmem_find(struct kgsl_process_private *private, uint64_t gpuaddr)
 {
-	int id;
 	struct kgsl_mem_entry *entry, *ret = NULL;
 
 	if (!private)
@@ -1523,13 +1607,9 @@ kgsl_sharedmem_find(struct kgsl_process_private *private, uint64_t gpuaddr)
 		return NULL;
 
 	spin_lock(&private->mem_lock);
-	idr_for_each_entry(&private->mem_idr, entry, id) {
-		if (GPUADDR_IN_MEMDESC(gpuaddr, &entry->memdesc)) {
-			if (!entry->pending_free)
-				ret = kgsl_mem_entry_get(entry);
-			break;
-		}
-	}
+	entry = kgsl_mem_tree_iter_first(&private->mem_tree, gpuaddr, gpuaddr);
+	if (entry && !entry->pending_free)
+		ret = kgsl_mem_entry_get(entry);
 	spin_unlock(&private->mem_lock);
 
 	return ret;
@@ -1568,6 +1648,35 @@ kgsl_sharedmem_find_id(struct kgsl_process_private *process, unsigned int id)
 	return kgsl_sharedmem_find_id_flags(process, id, 0);
 }
 
+/**
+ * kgsl_sharedmem_mark_used() - Stamp a gpu memory allocation as used
+ * @process: the owning process
+ * @id: id of the allocation or 0 to find it by @gpuaddr
+ * @gpuaddr: address inside the allocation
+ *
+ * Record that a submission references the allocation so that reclaim
+ * picks it last. The entry is stamped under the lookup lock so no
+ * reference is taken.
+ */
+void kgsl_sharedmem_mark_used(struct kgsl_process_private *process,
+		unsigned int id, uint64_t gpuaddr)
+{
+	struct kgsl_mem_entry *entry;
+
+	if (!IS_ENABLED(CONFIG_QCOM_KGSL_PROCESS_RECLAIM) || !process)
+		return;
+
+	spin_lock(&process->mem_lock);
+	if (id)
+		entry = idr_find(&process->mem_idr, id);
+	else
+		entry = kgsl_mem_tree_iter_first(&process->mem_tree, gpuaddr,
+			gpuaddr);
+	if (entry && !entry->pending_free)
+		kgsl_reclaim_mark_used(entry);
+	spin_unlock(&process->mem_lock);
+}
+
 /**
  * kgsl_mem_entry_unset_pend() - Unset the pending free flag of an entry
  * @entry - The memory entry
@@ -4702,6 +4811,10 @@ static unsigned long _gpu_set_svm_region(struct kgsl_process_private *private,
 		return (unsigned long) ret;
 	}
 
+	spin_lock(&private->mem_lock);
+	kgsl_mem_entry_insert_gpuaddr(entry);
+	spin_unlock(&private->mem_lock);
+
 	kgsl_memfree_purge(private->pagetable, entry->memdesc.gpuaddr,
 		entry->memdesc.size);
 
@@ -5420,3 +5533,7 @@ err:
 	kgsl_core_exit();
 	return result;
 }
+
+#if IS_ENABLED(CONFIG_QCOM_KGSL_KUNIT_TEST)
+#include "tests/kgsl_mem_tree_test.c"
+#endif
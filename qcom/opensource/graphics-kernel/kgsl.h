@@ -251,6 +251,8 @@ struct kgsl_memdesc_ops {
 #define KGSL_MEMDESC_SKIP_RECLAIM BIT(12)
 /* The memdesc is hypassigned to HLOS*/
 #define KGSL_MEMDESC_HYPASSIGNED_HLOS BIT(13)
+/* The memdesc was unmapped by a batch ahead of its release */
+#define KGSL_MEMDESC_BATCH_UNMAPPED BIT(14)
 
 /**
  * struct kgsl_memdesc - GPU memory object descriptor
@@ -335,7 +337,8 @@ struct kgsl_global_memdesc {
  *  hold a single reference count, but the kernel may hold more.
  * @memdesc: description of the memory
  * @priv_data: type-specific data, such as the dma-buf attachment pointer.
- * @node: rb_node for the gpu address lookup rb tree
+ * @node: rb_node for the process gpu address interval tree
+ * @__subtree_last: Last gpu address in the interval tree subtree of @node
  * @id: idr index for this entry, can be used to find memory that does not have
  *  a valid GPU address.
  * @priv: back pointer to the process that owns this memory
@@ -350,6 +353,7 @@ struct kgsl_mem_entry {
 	struct kgsl_memdesc memdesc;
 	void *priv_data;
 	struct rb_node node;
+	u64 __subtree_last;
 	unsigned int id;
 	struct kgsl_process_private *priv;
 	int pending_free;
@@ -362,6 +366,12 @@ struct kgsl_mem_entry {
 	atomic_t map_count;
 	/** @vbo_count: Count how many VBO ranges this entry is mapped in */
 	atomic_t vbo_count;
+	/**
+	 * @last_used: Jiffies when the entry was last referenced by a GPU
+	 * submission, used to reclaim the coldest entries first. 0 until the
+	 * first submission references the entry.
+	 */
+	unsigned long last_used;
 };
 
 struct kgsl_device_private;
@@ -403,7 +413,7 @@ typedef int (*readtimestamp_func)(struct kgsl_device *, void *,
  * struct event_group - A list of GPU events
  * @context: Pointer to the active context for the events
  * @lock: Spinlock for protecting the list
- * @events: List of active GPU events
+ * @events: List of active GPU events sorted by timestamp
  * @group: Node for the master group list
  * @processed: Last processed timestamp
  * @name: String name for the group (for the debugfs file)
@@ -555,6 +565,9 @@ kgsl_sharedmem_find(struct kgsl_process_private *private, uint64_t gpuaddr);
 struct kgsl_mem_entry * __must_check
 kgsl_sharedmem_find_id(struct kgsl_process_private *process, unsigned int id);
 
+void kgsl_sharedmem_mark_used(struct kgsl_process_private *process,
+		unsigned int id, uint64_t gpuaddr);
+
 struct kgsl_mem_entry *gpumem_alloc_entry(struct kgsl_device_private *dev_priv,
 				uint64_t size, uint64_t flags);
 long gpumem_free_entry(struct kgsl_mem_entry *entry);
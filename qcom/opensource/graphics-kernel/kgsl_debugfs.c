@@ -93,6 +93,18 @@ DEFINE_DEBUGFS_ATTRIBUTE(_reserved_fops,
 					kgsl_pool_reserved_get, NULL, "%llu\n");
 DEFINE_DEBUGFS_ATTRIBUTE(_page_count_fops,
 					kgsl_pool_page_count_get, NULL, "%llu\n");
+DEFINE_DEBUGFS_ATTRIBUTE(_zeroed_count_fops,
+					kgsl_pool_zeroed_count_get, NULL, "%llu\n");
+DEFINE_DEBUGFS_ATTRIBUTE(_zeroed_watermark_fops,
+					kgsl_pool_zeroed_watermark_get,
+					kgsl_pool_zeroed_watermark_set, "%llu\n");
+
+static int alloc_latency_show(struct seq_file *s, void *unused)
+{
+	return kgsl_pool_alloc_latency_show(s, unused);
+}
+
+DEFINE_SHOW_ATTRIBUTE(alloc_latency);
 
 void kgsl_pool_init_debugfs(struct dentry *pool_debugfs,
 					char *name, void *pool)
@@ -119,6 +131,24 @@ void kgsl_pool_init_debugfs(struct dentry *pool_debugfs,
 
 	WARN((IS_ERR_OR_NULL(dentry)),
 		"Unable to create 'count' file for %s\n", name);
+
+	dentry = debugfs_create_file("zeroed", 0444,
+		pool_debugfs, pool, &_zeroed_count_fops);
+
+	WARN((IS_ERR_OR_NULL(dentry)),
+		"Unable to create 'zeroed' file for %s\n", name);
+
+	dentry = debugfs_create_file("zeroed_watermark", 0644,
+		pool_debugfs, pool, &_zeroed_watermark_fops);
+
+	WARN((IS_ERR_OR_NULL(dentry)),
+		"Unable to create 'zeroed_watermark' file for %s\n", name);
+
+	dentry = debugfs_create_file("alloc_latency", 0444,
+		pool_debugfs, pool, &alloc_latency_fops);
+
+	WARN((IS_ERR_OR_NULL(dentry)),
+		"Unable to create 'alloc_latency' file for %s\n", name);
 }
 
 void kgsl_device_debugfs_init(struct kgsl_device *device)
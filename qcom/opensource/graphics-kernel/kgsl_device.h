@@ -264,6 +264,7 @@ struct kgsl_device {
 	u32 snapshot_faultcount;	/* Total number of faults since boot */
 	bool force_panic;		/* Force panic after snapshot dump */
 	bool skip_ib_capture;		/* Skip IB capture after snapshot */
+	bool snapshot_compress;		/* Compress the frozen GPU objects */
 	bool prioritize_unrecoverable;	/* Overwrite with new GMU snapshots */
 	bool set_isdb_breakpoint;	/* Set isdb registers before snapshot */
 	bool snapshot_atomic;		/* To capture snapshot in atomic context*/
@@ -446,6 +447,10 @@ struct kgsl_context {
 	struct list_head faults;
 	/** @fault_lock: Mutex to protect faults */
 	struct mutex fault_lock;
+	/** @frame_queued: Time the last end of frame command was queued */
+	ktime_t frame_queued;
+	/** @frame_period: Average time between frames in microseconds */
+	u32 frame_period;
 };
 
 #define _context_comm(_c) \
@@ -470,6 +475,7 @@ struct kgsl_context {
  * @mem_lock: Spinlock to protect the process memory lists
  * @refcount: kref object for reference counting the process
  * @idr: Iterator for assigning IDs to memory allocations
+ * @mem_tree: Interval tree of the memory allocations by gpu address
  * @pagetable: Pointer to the pagetable owned by this process
  * @kobj: Pointer to a kobj for the sysfs directory for this process
  * @debug_root: Pointer to the debugfs root for this process
@@ -489,6 +495,7 @@ struct kgsl_process_private {
 	spinlock_t mem_lock;
 	struct kref refcount;
 	struct idr mem_idr;
+	struct rb_root_cached mem_tree;
 	struct kgsl_pagetable *pagetable;
 	struct list_head list;
 	struct list_head reclaim_list;
@@ -562,8 +569,8 @@ struct kgsl_device_private {
  * @ptr: Pointer to the next block of memory to write to during snapshotting
  * @remain: Bytes left in the snapshot region
  * @timestamp: Timestamp of the snapshot instance (in seconds since boot)
- * @mempool: Pointer to the memory pool for storing memory objects
- * @mempool_size: Size of the memory pool
+ * @mempool: List of chunks storing the frozen memory objects
+ * @mempool_size: Bytes used in the memory pool
  * @obj_list: List of frozen GPU buffers that are waiting to be dumped.
  * @cp_list: List of IB's to be dumped.
  * @work: worker to dump the frozen memory
@@ -593,7 +600,7 @@ struct kgsl_snapshot {
 	u8 *ptr;
 	size_t remain;
 	unsigned long timestamp;
-	u8 *mempool;
+	struct list_head mempool;
 	size_t mempool_size;
 	struct list_head obj_list;
 	struct list_head cp_list;
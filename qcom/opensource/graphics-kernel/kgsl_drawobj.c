@@ -27,6 +27,7 @@
 #include "kgsl_device.h"
 #include "kgsl_drawobj.h"
 #include "kgsl_eventlog.h"
+#include "kgsl_reclaim.h"
 #include "kgsl_sync.h"
 #include "kgsl_timeline.h"
 #include "kgsl_trace.h"
@@ -850,6 +851,8 @@ static void add_profiling_buffer(struct kgsl_device *device,
 		return;
 	}
 
+	kgsl_reclaim_mark_used(entry);
+
 	cmdobj->profiling_buffer_gpuaddr = start;
 	cmdobj->profiling_buf_entry = entry;
 }
@@ -898,6 +901,8 @@ int kgsl_drawobj_cmd_add_ibdesc(struct kgsl_device *device,
 	mem->offset = 0;
 	mem->flags = 0;
 
+	kgsl_sharedmem_mark_used(drawobj->context->proc_priv, 0, gpuaddr);
+
 	if (drawobj->flags & KGSL_DRAWOBJ_MEMLIST &&
 			ibdesc->ctrl & KGSL_IBDESC_MEMLIST)
 		/* add to the memlist */
@@ -1259,6 +1264,9 @@ struct kgsl_drawobj_cmd *kgsl_drawobj_cmd_create(struct kgsl_device *device,
 	if (!(type & CMDOBJ_TYPE))
 		return cmdobj;
 
+	if (cmdobj->base.flags & KGSL_DRAWOBJ_END_OF_FRAME)
+		kgsl_pwrscale_frame_queued(context, cmdobj);
+
 	atomic_inc(&context->proc_priv->cmd_count);
 	atomic_inc(&context->proc_priv->period->active_cmds);
 	spin_lock(&device->work_period_lock);
@@ -1495,6 +1503,9 @@ int kgsl_drawobj_cmd_add_cmdlist(struct kgsl_device *device,
 		if (ret)
 			return ret;
 
+		kgsl_sharedmem_mark_used(baseobj->context->proc_priv, obj.id,
+			obj.gpuaddr);
+
 		ptr += sizeof(obj);
 	}
 
@@ -1538,6 +1549,9 @@ int kgsl_drawobj_cmd_add_memlist(struct kgsl_device *device,
 				&obj);
 			if (ret)
 				return ret;
+
+			kgsl_sharedmem_mark_used(baseobj->context->proc_priv,
+				obj.id, obj.gpuaddr);
 		}
 
 		ptr += sizeof(obj);
@@ -87,6 +87,8 @@ struct kgsl_drawobj_cmd {
 	u32 numibs;
 	/* @requeue_cnt: Number of times cmdobj was requeued before submission to dq succeeded */
 	u32 requeue_cnt;
+	/* @frame_deadline: Time an end of frame cmdobj is expected to retire by */
+	ktime_t frame_deadline;
 };
 
 /* This sync object cannot be sent to hardware */
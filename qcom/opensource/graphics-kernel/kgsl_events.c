@@ -50,6 +50,26 @@ static void _kgsl_event_worker(struct kthread_work *work)
 	kmem_cache_free(events_cache, event);
 }
 
+/*
+ * Keep the group list sorted by timestamp, oldest first. Events are mostly
+ * added in timestamp order so walk back from the tail to find the spot.
+ * Events with the same timestamp stay in the order they were added.
+ */
+static void _add_event_sorted(struct kgsl_event_group *group,
+		struct kgsl_event *event)
+{
+	struct kgsl_event *prev;
+
+	list_for_each_entry_reverse(prev, &group->events, node) {
+		if (timestamp_cmp(prev->timestamp, event->timestamp) <= 0) {
+			list_add(&event->node, &prev->node);
+			return;
+		}
+	}
+
+	list_add(&event->node, &group->events);
+}
+
 /* return true if the group needs to be processed */
 static bool _do_process_group(unsigned int processed, unsigned int cur)
 {
@@ -94,12 +114,17 @@ static void _process_event_group(struct kgsl_device *device,
 	if (!flush && !_do_process_group(group->processed, timestamp))
 		goto out;
 
+	/*
+	 * The events are sorted by timestamp so everything after the first
+	 * pending event is pending as well
+	 */
 	list_for_each_entry_safe(event, tmp, &group->events, node) {
 		if (timestamp_cmp(event->timestamp, timestamp) <= 0)
 			signal_event(device, event, KGSL_EVENT_RETIRED);
 		else if (flush)
 			signal_event(device, event, KGSL_EVENT_CANCELLED);
-
+		else
+			break;
 	}
 
 	group->processed = timestamp;
@@ -147,8 +172,12 @@ void kgsl_cancel_events_timestamp(struct kgsl_device *device,
 	spin_lock(&group->lock);
 
 	list_for_each_entry_safe(event, tmp, &group->events, node) {
-		if (timestamp_cmp(timestamp, event->timestamp) == 0)
+		int ret = timestamp_cmp(timestamp, event->timestamp);
+
+		if (ret == 0)
 			signal_event(device, event, KGSL_EVENT_CANCELLED);
+		else if (ret < 0)
+			break;
 	}
 
 	spin_unlock(&group->lock);
@@ -189,6 +218,9 @@ void kgsl_cancel_event(struct kgsl_device *device,
 	spin_lock(&group->lock);
 
 	list_for_each_entry_safe(event, tmp, &group->events, node) {
+		if (timestamp_cmp(timestamp, event->timestamp) < 0)
+			break;
+
 		if (timestamp == event->timestamp && func == event->func &&
 			event->priv == priv) {
 			signal_event(device, event, KGSL_EVENT_CANCELLED);
@@ -216,6 +248,9 @@ bool kgsl_event_pending(struct kgsl_device *device,
 
 	spin_lock(&group->lock);
 	list_for_each_entry(event, &group->events, node) {
+		if (timestamp_cmp(timestamp, event->timestamp) < 0)
+			break;
+
 		if (timestamp == event->timestamp && func == event->func &&
 			event->priv == priv) {
 			result = true;
@@ -295,8 +330,7 @@ int kgsl_add_event(struct kgsl_device *device, struct kgsl_event_group *group,
 		return 0;
 	}
 
-	/* Add the event to the group list */
-	list_add_tail(&event->node, &group->events);
+	_add_event_sorted(group, event);
 
 	spin_unlock(&group->lock);
 
@@ -435,3 +469,7 @@ void __init kgsl_events_init(void)
 {
 	events_cache = KMEM_CACHE(kgsl_event, 0);
 }
+
+#if IS_ENABLED(CONFIG_QCOM_KGSL_KUNIT_TEST)
+#include "tests/kgsl_events_test.c"
+#endif
@@ -276,30 +276,28 @@ static void kgsl_iommu_flush_tlb(struct kgsl_mmu *mmu)
 		iommu_flush_iotlb_all(to_iommu_domain(&iommu->lpac_context));
 }
 
-static int _iopgtbl_unmap(struct kgsl_iommu_pt *pt, u64 gpuaddr, size_t size)
+static int _iopgtbl_unmap_noflush(struct kgsl_iommu_pt *pt, u64 gpuaddr,
+		size_t size)
 {
 	struct io_pgtable_ops *ops = pt->pgtbl_ops;
-	int ret = 0;
 	size_t unmapped;
 
-	if (IS_ENABLED(CONFIG_IOMMU_IO_PGTABLE_LPAE)) {
-		ret = _iopgtbl_unmap_pages(pt, gpuaddr, size);
-		if (ret)
-			return ret;
-		goto flush;
-	}
+	if (IS_ENABLED(CONFIG_IOMMU_IO_PGTABLE_LPAE))
+		return _iopgtbl_unmap_pages(pt, gpuaddr, size);
 
 	unmapped = ops->unmap_pages(ops, gpuaddr, PAGE_SIZE,
 				    size >> PAGE_SHIFT, NULL);
-	if (unmapped != size)
-		return -EINVAL;
 
+	return (unmapped == size) ? 0 : -EINVAL;
+}
+
+static void _iopgtbl_flush_tlb(struct kgsl_iommu_pt *pt)
+{
 	/*
 	 * Skip below logic for 6.1 kernel version and above as
 	 * qcom_skip_tlb_management() API takes care of avoiding
 	 * TLB operations during slumber.
 	 */
-flush:
 	if (KERNEL_VERSION(6, 1, 0) > LINUX_VERSION_CODE) {
 		struct kgsl_device *device = KGSL_MMU_DEVICE(pt->base.mmu);
 
@@ -307,13 +305,23 @@ flush:
 		if (mutex_trylock(&device->mutex)) {
 			if (device->state == KGSL_STATE_SLUMBER) {
 				mutex_unlock(&device->mutex);
-				return 0;
+				return;
 			}
 			mutex_unlock(&device->mutex);
 		}
 	}
 
 	kgsl_iommu_flush_tlb(pt->base.mmu);
+}
+
+static int _iopgtbl_unmap(struct kgsl_iommu_pt *pt, u64 gpuaddr, size_t size)
+{
+	int ret = _iopgtbl_unmap_noflush(pt, gpuaddr, size);
+
+	if (ret)
+		return ret;
+
+	_iopgtbl_flush_tlb(pt);
 	return 0;
 }
 
@@ -531,6 +539,22 @@ static int kgsl_iopgtbl_unmap(struct kgsl_pagetable *pagetable,
 		kgsl_memdesc_footprint(memdesc));
 }
 
+static int kgsl_iopgtbl_unmap_noflush(struct kgsl_pagetable *pagetable,
+		struct kgsl_memdesc *memdesc, u64 offset, u64 length)
+{
+	if (WARN_ON(offset >= kgsl_memdesc_footprint(memdesc) ||
+		(offset + length) > kgsl_memdesc_footprint(memdesc)))
+		return -ERANGE;
+
+	return _iopgtbl_unmap_noflush(to_iommu_pt(pagetable),
+		memdesc->gpuaddr + offset, length);
+}
+
+static void kgsl_iopgtbl_flush_tlb(struct kgsl_pagetable *pagetable)
+{
+	_iopgtbl_flush_tlb(to_iommu_pt(pagetable));
+}
+
 static int _iommu_unmap(struct iommu_domain *domain, u64 addr, size_t size)
 {
 	size_t unmapped = 0;
@@ -2729,6 +2753,8 @@ static const struct kgsl_mmu_pt_ops iopgtbl_pt_ops = {
 	.mmu_map_zero_page_to_range = kgsl_iopgtbl_map_zero_page_to_range,
 	.mmu_unmap = kgsl_iopgtbl_unmap,
 	.mmu_unmap_range = kgsl_iopgtbl_unmap_range,
+	.mmu_unmap_noflush = kgsl_iopgtbl_unmap_noflush,
+	.mmu_flush_tlb = kgsl_iopgtbl_flush_tlb,
 	.mmu_destroy_pagetable = kgsl_iommu_destroy_pagetable,
 	.get_ttbr0 = kgsl_iommu_get_ttbr0,
 	.get_context_bank = kgsl_iommu_get_context_bank,
@@ -435,9 +435,8 @@ int kgsl_mmu_svm_range(struct kgsl_pagetable *pagetable,
 	return -ENODEV;
 }
 
-int
-kgsl_mmu_unmap(struct kgsl_pagetable *pagetable,
-		struct kgsl_memdesc *memdesc)
+static int _kgsl_mmu_unmap(struct kgsl_pagetable *pagetable,
+		struct kgsl_memdesc *memdesc, struct kgsl_mmu_batch *batch)
 {
 	int ret = 0;
 	struct kgsl_device *device = KGSL_MMU_DEVICE(pagetable->mmu);
@@ -457,7 +456,14 @@ kgsl_mmu_unmap(struct kgsl_pagetable *pagetable,
 
 		size = kgsl_memdesc_footprint(memdesc);
 
-		ret = pagetable->pt_ops->mmu_unmap(pagetable, memdesc);
+		if (batch && PT_OP_VALID(pagetable, mmu_unmap_noflush)) {
+			ret = pagetable->pt_ops->mmu_unmap_noflush(pagetable,
+				memdesc, 0, size);
+			if (!ret)
+				batch->flush = true;
+		} else {
+			ret = pagetable->pt_ops->mmu_unmap(pagetable, memdesc);
+		}
 		if (ret)
 			return ret;
 
@@ -476,8 +482,15 @@ kgsl_mmu_unmap(struct kgsl_pagetable *pagetable,
 }
 
 int
-kgsl_mmu_unmap_range(struct kgsl_pagetable *pagetable,
-		struct kgsl_memdesc *memdesc, u64 offset, u64 length)
+kgsl_mmu_unmap(struct kgsl_pagetable *pagetable,
+		struct kgsl_memdesc *memdesc)
+{
+	return _kgsl_mmu_unmap(pagetable, memdesc, NULL);
+}
+
+static int _kgsl_mmu_unmap_range(struct kgsl_pagetable *pagetable,
+		struct kgsl_memdesc *memdesc, u64 offset, u64 length,
+		struct kgsl_mmu_batch *batch)
 {
 	int ret = 0;
 
@@ -485,7 +498,15 @@ kgsl_mmu_unmap_range(struct kgsl_pagetable *pagetable,
 	if (!(memdesc->flags & KGSL_MEMFLAGS_VBO))
 		return -EINVAL;
 
-	if (PT_OP_VALID(pagetable, mmu_unmap_range)) {
+	if (batch && PT_OP_VALID(pagetable, mmu_unmap_noflush)) {
+		ret = pagetable->pt_ops->mmu_unmap_noflush(pagetable, memdesc,
+			offset, length);
+
+		if (!ret) {
+			batch->flush = true;
+			atomic_long_sub(length, &pagetable->stats.mapped);
+		}
+	} else if (PT_OP_VALID(pagetable, mmu_unmap_range)) {
 		ret = pagetable->pt_ops->mmu_unmap_range(pagetable, memdesc,
 			offset, length);
 
@@ -496,6 +517,97 @@ kgsl_mmu_unmap_range(struct kgsl_pagetable *pagetable,
 	return ret;
 }
 
+int
+kgsl_mmu_unmap_range(struct kgsl_pagetable *pagetable,
+		struct kgsl_memdesc *memdesc, u64 offset, u64 length)
+{
+	return _kgsl_mmu_unmap_range(pagetable, memdesc, offset, length, NULL);
+}
+
+/**
+ * kgsl_mmu_batch_start() - Start a batch of unmaps in a pagetable
+ * @batch: Batch to initialize
+ * @pagetable: Pagetable the unmaps are done in
+ *
+ * Unmaps added to the batch skip the TLB invalidation and leave it to
+ * kgsl_mmu_batch_end(). Until then the GPU may still reach the unmapped
+ * memory through stale TLB entries, so the caller must hold on to the
+ * backing pages and the GPU addresses of the unmapped memdescs until the
+ * batch is ended. Anything mapped into a range unmapped in the batch must
+ * be preceded by kgsl_mmu_batch_flush().
+ */
+void kgsl_mmu_batch_start(struct kgsl_mmu_batch *batch,
+		struct kgsl_pagetable *pagetable)
+{
+	batch->pagetable = pagetable;
+	batch->flush = false;
+}
+
+/**
+ * kgsl_mmu_batch_unmap() - Unmap a memdesc as part of a batch
+ * @batch: Batch started with kgsl_mmu_batch_start()
+ * @memdesc: Memory descriptor to unmap
+ *
+ * Return: 0 on success, -EINVAL if @memdesc is not mapped in the batch
+ * pagetable or another negative error on failure
+ */
+int kgsl_mmu_batch_unmap(struct kgsl_mmu_batch *batch,
+		struct kgsl_memdesc *memdesc)
+{
+	if (!batch->pagetable || memdesc->pagetable != batch->pagetable)
+		return -EINVAL;
+
+	return _kgsl_mmu_unmap(batch->pagetable, memdesc, batch);
+}
+
+/**
+ * kgsl_mmu_batch_unmap_range() - Unmap a range of a VBO as part of a batch
+ * @batch: Batch started with kgsl_mmu_batch_start()
+ * @memdesc: Memory descriptor of the VBO
+ * @offset: Offset of the range in @memdesc
+ * @length: Length of the range
+ *
+ * Return: 0 on success, -EINVAL if @memdesc is not a VBO in the batch
+ * pagetable or another negative error on failure
+ */
+int kgsl_mmu_batch_unmap_range(struct kgsl_mmu_batch *batch,
+		struct kgsl_memdesc *memdesc, u64 offset, u64 length)
+{
+	if (!batch->pagetable || memdesc->pagetable != batch->pagetable)
+		return -EINVAL;
+
+	return _kgsl_mmu_unmap_range(batch->pagetable, memdesc, offset,
+		length, batch);
+}
+
+/**
+ * kgsl_mmu_batch_flush() - Invalidate the TLB for the unmaps of a batch so far
+ * @batch: Batch started with kgsl_mmu_batch_start()
+ *
+ * Break before make: the TLB must not hold the old translation of an
+ * address once a new one is written, so this has to be called before
+ * mapping into a range that was unmapped in the batch. The batch stays
+ * open and gathers the following unmaps.
+ */
+void kgsl_mmu_batch_flush(struct kgsl_mmu_batch *batch)
+{
+	struct kgsl_pagetable *pagetable = batch->pagetable;
+
+	if (batch->flush && PT_OP_VALID(pagetable, mmu_flush_tlb))
+		pagetable->pt_ops->mmu_flush_tlb(pagetable);
+
+	batch->flush = false;
+}
+
+/**
+ * kgsl_mmu_batch_end() - Invalidate the TLB for all unmaps of a batch
+ * @batch: Batch started with kgsl_mmu_batch_start()
+ */
+void kgsl_mmu_batch_end(struct kgsl_mmu_batch *batch)
+{
+	kgsl_mmu_batch_flush(batch);
+}
+
 void kgsl_mmu_map_global(struct kgsl_device *device,
 		struct kgsl_memdesc *memdesc, u32 padding)
 {
@@ -131,6 +131,9 @@ struct kgsl_mmu_pt_ops {
 			struct kgsl_memdesc *memdesc);
 	int (*mmu_unmap_range)(struct kgsl_pagetable *pt,
 			struct kgsl_memdesc *memdesc, u64 offset, u64 length);
+	int (*mmu_unmap_noflush)(struct kgsl_pagetable *pt,
+			struct kgsl_memdesc *memdesc, u64 offset, u64 length);
+	void (*mmu_flush_tlb)(struct kgsl_pagetable *pt);
 	void (*mmu_destroy_pagetable)(struct kgsl_pagetable *pt);
 	u64 (*get_ttbr0)(struct kgsl_pagetable *pt);
 	int (*get_context_bank)(struct kgsl_pagetable *pt, struct kgsl_context *context);
@@ -177,6 +180,16 @@ enum kgsl_mmu_feature {
 
 #include "kgsl_iommu.h"
 
+/**
+ * struct kgsl_mmu_batch - Unmaps that share a single TLB invalidation
+ * @pagetable: Pagetable the unmaps are done in
+ * @flush: True if kgsl_mmu_batch_end() owes a TLB invalidation
+ */
+struct kgsl_mmu_batch {
+	struct kgsl_pagetable *pagetable;
+	bool flush;
+};
+
 /**
  * struct kgsl_mmu - Master definition for KGSL MMU devices
  * @flags: MMU device flags
@@ -224,6 +237,14 @@ int kgsl_mmu_unmap(struct kgsl_pagetable *pagetable,
 		    struct kgsl_memdesc *memdesc);
 int kgsl_mmu_unmap_range(struct kgsl_pagetable *pt,
 		struct kgsl_memdesc *memdesc, u64 offset, u64 length);
+void kgsl_mmu_batch_start(struct kgsl_mmu_batch *batch,
+		struct kgsl_pagetable *pagetable);
+int kgsl_mmu_batch_unmap(struct kgsl_mmu_batch *batch,
+		struct kgsl_memdesc *memdesc);
+int kgsl_mmu_batch_unmap_range(struct kgsl_mmu_batch *batch,
+		struct kgsl_memdesc *memdesc, u64 offset, u64 length);
+void kgsl_mmu_batch_flush(struct kgsl_mmu_batch *batch);
+void kgsl_mmu_batch_end(struct kgsl_mmu_batch *batch);
 unsigned int kgsl_mmu_log_fault_addr(struct kgsl_mmu *mmu,
 		u64 ttbr0, uint64_t addr);
 bool kgsl_mmu_gpuaddr_in_range(struct kgsl_pagetable *pt, uint64_t gpuaddr,
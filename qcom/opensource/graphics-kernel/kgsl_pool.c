@@ -7,9 +7,11 @@
 #include <asm/cacheflush.h>
 #include <linux/debugfs.h>
 #include <linux/highmem.h>
+#include <linux/kthread.h>
 #include <linux/mempool.h>
 #include <linux/of.h>
 #include <linux/scatterlist.h>
+#include <linux/seq_file.h>
 #include <linux/version.h>
 
 #include "kgsl_debugfs.h"
@@ -18,6 +20,9 @@
 #include "kgsl_sharedmem.h"
 #include "kgsl_trace.h"
 
+/* Log2 buckets of the pool allocation latency histogram, starting at 1us */
+#define KGSL_POOL_HIST_BUCKETS 16
+
 #ifdef CONFIG_QCOM_KGSL_SORT_POOL
 
 struct kgsl_pool_page_entry {
@@ -38,6 +43,12 @@ static struct kmem_cache *addr_page_cache;
  * @mempool: Mempool to pre-allocate tracking structs for pages in this pool
  * @debug_root: Pointer to the debugfs root for this pool
  * @max_pages: Limit on number of pages this pool can hold
+ * @zeroed_list: List of pages already zeroed by the zero worker
+ * @zeroed_count: Number of pages in @zeroed_list
+ * @zeroed_watermark: Number of zeroed pages the zero worker keeps around
+ * @zeroed_hits: Number of allocations served from @zeroed_list
+ * @alloc_hist: Allocation latency histogram, bucket i counts allocations
+ * that took less than 2^(i + 1) us
  */
 struct kgsl_page_pool {
 	unsigned int pool_order;
@@ -48,6 +59,11 @@ struct kgsl_page_pool {
 	mempool_t *mempool;
 	struct dentry *debug_root;
 	unsigned int max_pages;
+	struct list_head zeroed_list;
+	unsigned int zeroed_count;
+	unsigned int zeroed_watermark;
+	atomic_t zeroed_hits;
+	atomic_t alloc_hist[KGSL_POOL_HIST_BUCKETS];
 };
 
 static void *_pool_entry_alloc(gfp_t gfp_mask, void *arg)
@@ -159,6 +175,12 @@ static void kgsl_destroy_page_pool(struct kgsl_page_pool *pool)
  * @page_list: List of pages held/reserved in this pool
  * @debug_root: Pointer to the debugfs root for this pool
  * @max_pages: Limit on number of pages this pool can hold
+ * @zeroed_list: List of pages already zeroed by the zero worker
+ * @zeroed_count: Number of pages in @zeroed_list
+ * @zeroed_watermark: Number of zeroed pages the zero worker keeps around
+ * @zeroed_hits: Number of allocations served from @zeroed_list
+ * @alloc_hist: Allocation latency histogram, bucket i counts allocations
+ * that took less than 2^(i + 1) us
  */
 struct kgsl_page_pool {
 	unsigned int pool_order;
@@ -168,6 +190,11 @@ struct kgsl_page_pool {
 	struct list_head page_list;
 	struct dentry *debug_root;
 	unsigned int max_pages;
+	struct list_head zeroed_list;
+	unsigned int zeroed_count;
+	unsigned int zeroed_watermark;
+	atomic_t zeroed_hits;
+	atomic_t alloc_hist[KGSL_POOL_HIST_BUCKETS];
 };
 
 static int
@@ -229,6 +256,14 @@ static struct kgsl_page_pool kgsl_pools[6];
 static int kgsl_num_pools;
 static int kgsl_pool_max_pages;
 
+/* Background worker that keeps the zeroed page lists filled */
+static struct kthread_worker *kgsl_pool_zero_worker;
+static struct kthread_work kgsl_pool_zero_work;
+/* Device used for the cache maintenance of the zeroed pages */
+static struct device *kgsl_pool_zero_dev;
+/* Set while the GPU is in slumber, the worker only runs while it is set */
+static atomic_t kgsl_pool_gpu_idle;
+
 /* Return the index of the pool for the specified order */
 static int kgsl_get_pool_index(int order)
 {
@@ -298,6 +333,43 @@ _kgsl_pool_get_page(struct kgsl_page_pool *pool)
 	return p;
 }
 
+/* Add a zeroed page to the zeroed list of the specified pool */
+static void
+_kgsl_pool_add_zeroed_page(struct kgsl_page_pool *pool, struct page *p)
+{
+	spin_lock(&pool->list_lock);
+	list_add_tail(&p->lru, &pool->zeroed_list);
+	WRITE_ONCE(pool->zeroed_count, pool->zeroed_count + 1);
+	spin_unlock(&pool->list_lock);
+
+	mod_node_page_state(page_pgdat(p), NR_KERNEL_MISC_RECLAIMABLE,
+			(1 << pool->pool_order));
+}
+
+/* Returns a zeroed page from specified pool */
+static struct page *
+_kgsl_pool_get_zeroed_page(struct kgsl_page_pool *pool)
+{
+	struct page *p;
+
+	/* Use READ_ONCE to read zeroed_count without holding list_lock */
+	if (!READ_ONCE(pool->zeroed_count))
+		return NULL;
+
+	spin_lock(&pool->list_lock);
+	p = list_first_entry_or_null(&pool->zeroed_list, struct page, lru);
+	if (p) {
+		list_del(&p->lru);
+		WRITE_ONCE(pool->zeroed_count, pool->zeroed_count - 1);
+	}
+	spin_unlock(&pool->list_lock);
+
+	if (p != NULL)
+		mod_node_page_state(page_pgdat(p), NR_KERNEL_MISC_RECLAIMABLE,
+				-(1 << pool->pool_order));
+	return p;
+}
+
 int kgsl_pool_size_total(void)
 {
 	int i;
@@ -307,7 +379,8 @@ int kgsl_pool_size_total(void)
 		struct kgsl_page_pool *kgsl_pool = &kgsl_pools[i];
 
 		spin_lock(&kgsl_pool->list_lock);
-		total += kgsl_pool->page_count * (1 << kgsl_pool->pool_order);
+		total += (kgsl_pool->page_count + kgsl_pool->zeroed_count) *
+				(1 << kgsl_pool->pool_order);
 		spin_unlock(&kgsl_pool->list_lock);
 	}
 
@@ -327,6 +400,7 @@ static unsigned long kgsl_pool_size_nonreserved(void)
 		if (pool->page_count > pool->reserved_pages)
 			total += (pool->page_count - pool->reserved_pages) *
 					(1 << pool->pool_order);
+		total += pool->zeroed_count * (1 << pool->pool_order);
 		spin_unlock(&pool->list_lock);
 	}
 
@@ -387,6 +461,10 @@ _kgsl_pool_shrink(struct kgsl_page_pool *pool,
 	for (j = 0; j < num_pages; j++) {
 		struct page *page = get_page(pool);
 
+		/* Zeroed pages go last, they are the cheapest to hand out */
+		if (!page)
+			page = _kgsl_pool_get_zeroed_page(pool);
+
 		if (!page)
 			break;
 
@@ -481,18 +559,29 @@ u32 kgsl_get_page_size(size_t size, unsigned int align)
 	return PAGE_SIZE;
 }
 
+/* Add the time since @start to the allocation latency histogram */
+static void _kgsl_pool_account_alloc(struct kgsl_page_pool *pool, u64 start)
+{
+	u64 us = div_u64(ktime_get_ns() - start, NSEC_PER_USEC);
+	int bucket = us ? min_t(int, ilog2(us), KGSL_POOL_HIST_BUCKETS - 1) : 0;
+
+	atomic_inc(&pool->alloc_hist[bucket]);
+}
+
 int kgsl_pool_alloc_page(int *page_size, struct page **pages,
 			unsigned int pages_len, unsigned int *align,
 			struct device *dev)
 {
 	int j;
 	int pcount = 0;
-	struct kgsl_page_pool *pool;
+	struct kgsl_page_pool *pool = NULL;
 	struct page *page = NULL;
 	struct page *p = NULL;
 	int order = get_order(*page_size);
 	int pool_idx;
 	size_t size = 0;
+	bool zeroed = false;
+	u64 start = 0;
 
 	if ((pages == NULL) || pages_len < (*page_size >> PAGE_SHIFT))
 		return -EINVAL;
@@ -537,6 +626,16 @@ int kgsl_pool_alloc_page(int *page_size, struct page **pages,
 	}
 
 	pool_idx = kgsl_get_pool_index(order);
+	start = ktime_get_ns();
+
+	/* Pages zeroed in the background skip kgsl_zero_page() */
+	page = _kgsl_pool_get_zeroed_page(pool);
+	if (page) {
+		atomic_inc(&pool->zeroed_hits);
+		zeroed = true;
+		goto done;
+	}
+
 	page = _kgsl_pool_get_page(pool);
 
 	/* Allocate a new page if not allocated from pool */
@@ -558,7 +657,11 @@ int kgsl_pool_alloc_page(int *page_size, struct page **pages,
 	}
 
 done:
-	kgsl_zero_page(page, order, dev);
+	if (!zeroed)
+		kgsl_zero_page(page, order, dev);
+
+	if (pool)
+		_kgsl_pool_account_alloc(pool, start);
 
 	for (j = 0; j < (*page_size >> PAGE_SHIFT); j++) {
 		p = nth_page(page, j);
@@ -649,6 +752,117 @@ int kgsl_pool_page_count_get(void *data, u64 *val)
 	return 0;
 }
 
+int kgsl_pool_zeroed_count_get(void *data, u64 *val)
+{
+	struct kgsl_page_pool *pool = data;
+
+	/* Use READ_ONCE to read zeroed_count without holding list_lock */
+	*val = (u64) READ_ONCE(pool->zeroed_count);
+	return 0;
+}
+
+int kgsl_pool_zeroed_watermark_get(void *data, u64 *val)
+{
+	struct kgsl_page_pool *pool = data;
+
+	*val = (u64) READ_ONCE(pool->zeroed_watermark);
+	return 0;
+}
+
+int kgsl_pool_zeroed_watermark_set(void *data, u64 val)
+{
+	struct kgsl_page_pool *pool = data;
+
+	if (val > pool->max_pages)
+		return -EINVAL;
+
+	WRITE_ONCE(pool->zeroed_watermark, (unsigned int) val);
+
+	/* Lowering the watermark releases the extra zeroed pages */
+	while (READ_ONCE(pool->zeroed_count) > val) {
+		struct page *page = _kgsl_pool_get_zeroed_page(pool);
+
+		if (!page)
+			break;
+
+		__free_pages(page, pool->pool_order);
+		trace_kgsl_pool_free_page(pool->pool_order);
+	}
+
+	return 0;
+}
+
+int kgsl_pool_alloc_latency_show(struct seq_file *s, void *unused)
+{
+	struct kgsl_page_pool *pool = s->private;
+	int i;
+
+	seq_printf(s, "zeroed_hits: %d\n", atomic_read(&pool->zeroed_hits));
+
+	for (i = 0; i < KGSL_POOL_HIST_BUCKETS; i++)
+		seq_printf(s, "<%8luus: %d\n", 1UL << (i + 1),
+			atomic_read(&pool->alloc_hist[i]));
+
+	return 0;
+}
+
+static void kgsl_pool_zero_refill(struct kthread_work *work)
+{
+	int i;
+
+	for (i = 0; i < kgsl_num_pools; i++) {
+		struct kgsl_page_pool *pool = &kgsl_pools[i];
+		gfp_t gfp_mask = (kgsl_gfp_mask(pool->pool_order) |
+			__GFP_NOWARN) & ~__GFP_DIRECT_RECLAIM;
+
+		while (READ_ONCE(pool->zeroed_count) <
+				READ_ONCE(pool->zeroed_watermark)) {
+			struct page *page;
+
+			/* Stop as soon as the GPU has work again */
+			if (!atomic_read(&kgsl_pool_gpu_idle))
+				return;
+
+			/* Zero pages already in the pool before growing it */
+			page = _kgsl_pool_get_nonreserved_page(pool);
+			if (!page) {
+				if (kgsl_pool_max_pages &&
+					(kgsl_pool_size_total() >=
+						kgsl_pool_max_pages))
+					break;
+
+				page = alloc_pages(gfp_mask, pool->pool_order);
+				if (!page)
+					break;
+
+				trace_kgsl_pool_alloc_page_system(
+					pool->pool_order);
+			}
+
+			kgsl_zero_page(page, pool->pool_order,
+				kgsl_pool_zero_dev);
+			_kgsl_pool_add_zeroed_page(pool, page);
+
+			cond_resched();
+		}
+	}
+}
+
+void kgsl_pool_gpu_idle_start(struct device *dev)
+{
+	if (!kgsl_pool_zero_worker)
+		return;
+
+	kgsl_pool_zero_dev = dev;
+	atomic_set(&kgsl_pool_gpu_idle, 1);
+	kthread_queue_work(kgsl_pool_zero_worker, &kgsl_pool_zero_work);
+}
+
+void kgsl_pool_gpu_idle_stop(void)
+{
+	atomic_set(&kgsl_pool_gpu_idle, 0);
+}
+
 static void kgsl_pool_reserve_pages(struct kgsl_page_pool *pool,
 		struct device_node *node)
 {
@@ -702,8 +916,15 @@ static int kgsl_of_parse_mempool(struct kgsl_page_pool *pool,
 	if (of_property_read_u32(node, "qcom,mempool-max-pages", &pool->max_pages))
 		pool->max_pages = UINT_MAX;
 
+	/* Number of pages the zero worker keeps zeroed, off by default */
+	of_property_read_u32(node, "qcom,mempool-zeroed-pages",
+		&pool->zeroed_watermark);
+	pool->zeroed_watermark = min_t(u32, pool->zeroed_watermark,
+		pool->max_pages);
+
 	spin_lock_init(&pool->list_lock);
 	kgsl_pool_list_init(pool);
+	INIT_LIST_HEAD(&pool->zeroed_list);
 
 	kgsl_pool_reserve_pages(pool, node);
 
@@ -741,6 +962,15 @@ void kgsl_probe_page_pools(void)
 	kgsl_num_pools = index;
 	of_node_put(node);
 
+	if (kgsl_num_pools) {
+		kthread_init_work(&kgsl_pool_zero_work, kgsl_pool_zero_refill);
+		kgsl_pool_zero_worker = kthread_create_worker(0, "kgsl_pool_zero");
+		if (IS_ERR(kgsl_pool_zero_worker))
+			kgsl_pool_zero_worker = NULL;
+		else
+			sched_set_normal(kgsl_pool_zero_worker->task, MAX_NICE);
+	}
+
 	/* Initialize shrinker */
 #if (KERNEL_VERSION(6, 0, 0) <= LINUX_VERSION_CODE)
 	register_shrinker(&kgsl_pool_shrinker, "kgsl_pool_shrinker");
@@ -753,6 +983,13 @@ void kgsl_exit_page_pools(void)
 {
 	int i;
 
+	/* Stop the zero worker before the pools go away */
+	if (kgsl_pool_zero_worker) {
+		kgsl_pool_gpu_idle_stop();
+		kthread_destroy_worker(kgsl_pool_zero_worker);
+		kgsl_pool_zero_worker = NULL;
+	}
+
 	/* Release all pages in pools, if any.*/
 	kgsl_pool_reduce(INT_MAX, true);
 
@@ -6,6 +6,9 @@
 #ifndef __KGSL_POOL_H
 #define __KGSL_POOL_H
 
+struct device;
+struct seq_file;
+
 #ifdef CONFIG_QCOM_KGSL_USE_SHMEM
 static inline void kgsl_probe_page_pools(void) { }
 static inline void kgsl_exit_page_pools(void) { }
@@ -38,6 +41,30 @@ static inline int kgsl_pool_size_total(void)
 {
 	return 0;
 }
+
+static inline int kgsl_pool_zeroed_count_get(void *data, u64 *val)
+{
+	return 0;
+}
+
+static inline int kgsl_pool_zeroed_watermark_get(void *data, u64 *val)
+{
+	return 0;
+}
+
+static inline int kgsl_pool_zeroed_watermark_set(void *data, u64 val)
+{
+	return 0;
+}
+
+static inline int kgsl_pool_alloc_latency_show(struct seq_file *s,
+		void *unused)
+{
+	return 0;
+}
+
+static inline void kgsl_pool_gpu_idle_start(struct device *dev) { }
+static inline void kgsl_pool_gpu_idle_stop(void) { }
 #else
 /**
  * kgsl_pool_free_page - Frees the page and adds it back to pool/system memory
@@ -82,6 +109,24 @@ void kgsl_pool_free_pages(struct page **pages, unsigned int page_count);
 /* Debugfs node functions */
 int kgsl_pool_reserved_get(void *data, u64 *val);
 int kgsl_pool_page_count_get(void *data, u64 *val);
+int kgsl_pool_zeroed_count_get(void *data, u64 *val);
+int kgsl_pool_zeroed_watermark_get(void *data, u64 *val);
+int kgsl_pool_zeroed_watermark_set(void *data, u64 val);
+int kgsl_pool_alloc_latency_show(struct seq_file *s, void *unused);
+
+/**
+ * kgsl_pool_gpu_idle_start - Start refilling the zeroed page lists
+ * @dev: GPU device used for the cache maintenance of the zeroed pages
+ *
+ * Called when the GPU goes to slumber. A low priority worker zeroes pages
+ * until every pool holds its zeroed page watermark or the GPU wakes up.
+ */
+void kgsl_pool_gpu_idle_start(struct device *dev);
+
+/**
+ * kgsl_pool_gpu_idle_stop - Stop refilling the zeroed page lists
+ */
+void kgsl_pool_gpu_idle_stop(void);
 
 /**
  * kgsl_pool_size_total - Return the number of pages in all kgsl page pools
@@ -17,6 +17,7 @@
 
 #include "kgsl_device.h"
 #include "kgsl_bus.h"
+#include "kgsl_pool.h"
 #include "kgsl_pwrscale.h"
 #include "kgsl_sysfs.h"
 #include "kgsl_trace.h"
@@ -2138,8 +2139,12 @@ void kgsl_pwrctrl_set_state(struct kgsl_device *device,
 	device->state = state;
 	device->requested_state = KGSL_STATE_NONE;
 
-	if (state == KGSL_STATE_SLUMBER)
+	if (state == KGSL_STATE_SLUMBER) {
 		device->pwrctrl.wake_on_touch = false;
+		kgsl_pool_gpu_idle_start(&device->pdev->dev);
+	} else {
+		kgsl_pool_gpu_idle_stop();
+	}
 
 	spin_lock(&device->submit_lock);
 	if (state == KGSL_STATE_ACTIVE)
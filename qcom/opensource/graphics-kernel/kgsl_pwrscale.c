@@ -324,7 +324,13 @@ int kgsl_devfreq_get_dev_status(struct device *dev,
 
 	stat->current_frequency = kgsl_pwrctrl_active_freq(&device->pwrctrl);
 
-	stat->private_data = &device->active_context_count;
+	spin_lock(&pwrscale->frame_lock);
+	pwrscale->tz_xstats = pwrscale->frame_stats;
+	memset(&pwrscale->frame_stats, 0, sizeof(pwrscale->frame_stats));
+	spin_unlock(&pwrscale->frame_lock);
+
+	pwrscale->tz_xstats.context_count = device->active_context_count;
+	stat->private_data = &pwrscale->tz_xstats;
 
 	/*
 	 * keep the latest devfreq_dev_status values
@@ -430,6 +436,47 @@ int kgsl_busmon_get_dev_status(struct device *dev,
 	return 0;
 }
 
+/* Frames further apart than this are the context going idle (usecs) */
+#define KGSL_FRAME_PERIOD_MAX 100000
+
+void kgsl_pwrscale_frame_queued(struct kgsl_context *context,
+		struct kgsl_drawobj_cmd *cmdobj)
+{
+	ktime_t now = ktime_get();
+	s64 delta = ktime_us_delta(now, context->frame_queued);
+	u32 period = context->frame_period;
+
+	context->frame_queued = now;
+
+	if (delta > 0 && delta < KGSL_FRAME_PERIOD_MAX)
+		period = period ? (period * 7 + (u32) delta) / 8 : (u32) delta;
+	else
+		period = 0;
+
+	context->frame_period = period;
+	cmdobj->frame_deadline = period ? ktime_add_us(now, period) : 0;
+}
+
+void kgsl_pwrscale_frame_retired(struct kgsl_device *device,
+		struct kgsl_drawobj_cmd *cmdobj)
+{
+	struct kgsl_pwrscale *pwrscale = &device->pwrscale;
+	struct tz_xstats *stats = &pwrscale->frame_stats;
+	u32 period = cmdobj->base.context->frame_period;
+
+	/* The first frame after an idle period has no deadline */
+	if (!cmdobj->frame_deadline)
+		return;
+
+	spin_lock(&pwrscale->frame_lock);
+	stats->frames++;
+	if (ktime_after(ktime_get(), cmdobj->frame_deadline))
+		stats->missed++;
+	if (period && (!stats->frame_period || period < stats->frame_period))
+		stats->frame_period = period;
+	spin_unlock(&pwrscale->frame_lock);
+}
+
 static int _read_hint(u32 flags)
 {
 	switch (flags) {
@@ -700,6 +747,8 @@ int kgsl_pwrscale_init(struct kgsl_device *device, struct platform_device *pdev,
 	struct msm_adreno_extended_profile *gpu_profile;
 	int i, ret;
 
+	spin_lock_init(&pwrscale->frame_lock);
+
 	gpu_profile = &pwrscale->gpu_profile;
 	gpu_profile->private_data = &adreno_tz_data;
 
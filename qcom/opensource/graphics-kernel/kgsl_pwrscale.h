@@ -11,6 +11,9 @@
 #include "kgsl_pwrctrl.h"
 #include "msm_adreno_devfreq.h"
 
+struct kgsl_context;
+struct kgsl_drawobj_cmd;
+
 /* devfreq governor call window in usec */
 #define KGSL_GOVERNOR_CALL_INTERVAL 10000
 
@@ -69,6 +72,12 @@ struct kgsl_pwrscale {
 	struct devfreq *bus_devfreq;
 	/** @devfreq_enabled: Whether or not devfreq is enabled */
 	bool devfreq_enabled;
+	/** @frame_lock: Protects @frame_stats */
+	spinlock_t frame_lock;
+	/** @frame_stats: Frame statistics accumulated since the last sample */
+	struct tz_xstats frame_stats;
+	/** @tz_xstats: Extra statistics of the last sample for the governor */
+	struct tz_xstats tz_xstats;
 };
 
 /**
@@ -113,4 +122,23 @@ int devfreq_gpubw_init(void);
 void devfreq_gpubw_exit(void);
 
 void kgsl_pwrscale_fast_bus_hint(bool on);
+
+/**
+ * kgsl_pwrscale_frame_queued - Track a frame boundary of a context
+ * @context: Context that queued an end of frame command
+ * @cmdobj: The end of frame command
+ *
+ * Update the frame period of @context and set the deadline of @cmdobj to
+ * one period from now.
+ */
+void kgsl_pwrscale_frame_queued(struct kgsl_context *context,
+		struct kgsl_drawobj_cmd *cmdobj);
+
+/**
+ * kgsl_pwrscale_frame_retired - Account a retired frame for the governor
+ * @device: A GPU device handle
+ * @cmdobj: The end of frame command that retired
+ */
+void kgsl_pwrscale_frame_retired(struct kgsl_device *device,
+		struct kgsl_drawobj_cmd *cmdobj);
 #endif
@@ -8,6 +8,7 @@
 #include <linux/notifier.h>
 #include <linux/pagevec.h>
 #include <linux/shmem_fs.h>
+#include <linux/sort.h>
 #include <linux/swap.h>
 #include <linux/version.h>
 
@@ -31,6 +32,28 @@ struct work_struct reclaim_work;
 
 static atomic_t kgsl_nr_to_reclaim;
 
+/* Pages moved out of and back into GPU memory and the time it took */
+static atomic64_t kgsl_reclaimed_pages;
+static atomic64_t kgsl_reclaim_time_ns;
+static atomic64_t kgsl_restored_pages;
+static atomic64_t kgsl_restore_time_ns;
+
+/*
+ * Number of the least recently used entries of a process that are picked
+ * for reclaim at a time
+ */
+#define KGSL_RECLAIM_CANDIDATES 256
+
+/**
+ * struct kgsl_reclaim_candidate - An entry that can be reclaimed
+ * @entry: The memory entry, holds a reference
+ * @last_used: Snapshot of the last use of @entry to sort the candidates by
+ */
+struct kgsl_reclaim_candidate {
+	struct kgsl_mem_entry *entry;
+	unsigned long last_used;
+};
+
 static int kgsl_memdesc_get_reclaimed_pages(struct kgsl_mem_entry *entry)
 {
 	struct kgsl_memdesc *memdesc = &entry->memdesc;
@@ -79,6 +102,7 @@ int kgsl_reclaim_to_pinned_state(
 {
 	struct kgsl_mem_entry *entry, *valid_entry;
 	int next = 0, ret = 0, count;
+	ktime_t start;
 
 	mutex_lock(&process->reclaim_lock);
 
@@ -86,6 +110,7 @@ int kgsl_reclaim_to_pinned_state(
 		goto done;
 
 	count = atomic_read(&process->unpinned_page_count);
+	start = ktime_get();
 
 	for ( ; ; ) {
 		valid_entry = NULL;
@@ -112,6 +137,10 @@ int kgsl_reclaim_to_pinned_state(
 
 	trace_kgsl_reclaim_process(process, count, false);
 	set_bit(KGSL_PROC_PINNED_STATE, &process->state);
+
+	atomic64_add(count, &kgsl_restored_pages);
+	atomic64_add(ktime_to_ns(ktime_sub(ktime_get(), start)),
+		&kgsl_restore_time_ns);
 done:
 	mutex_unlock(&process->reclaim_lock);
 	return ret;
@@ -211,44 +240,107 @@ ssize_t kgsl_nr_to_scan_show(struct device *dev,
 	return scnprintf(buf, PAGE_SIZE, "%d\n", kgsl_nr_to_scan);
 }
 
+static u64 kgsl_reclaim_kbps(u64 pages, u64 ns)
+{
+	if (!ns)
+		return 0;
+
+	return div64_u64((pages << (PAGE_SHIFT - 10)) * NSEC_PER_SEC, ns);
+}
+
+ssize_t kgsl_reclaim_stats_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	u64 reclaimed = atomic64_read(&kgsl_reclaimed_pages);
+	u64 reclaim_ns = atomic64_read(&kgsl_reclaim_time_ns);
+	u64 restored = atomic64_read(&kgsl_restored_pages);
+	u64 restore_ns = atomic64_read(&kgsl_restore_time_ns);
+
+	return scnprintf(buf, PAGE_SIZE,
+		"reclaimed_kb %llu\nreclaim_us %llu\nreclaim_kbps %llu\n"
+		"restored_kb %llu\nrestore_us %llu\nrestore_kbps %llu\n",
+		reclaimed << (PAGE_SHIFT - 10), div_u64(reclaim_ns, NSEC_PER_USEC),
+		kgsl_reclaim_kbps(reclaimed, reclaim_ns),
+		restored << (PAGE_SHIFT - 10), div_u64(restore_ns, NSEC_PER_USEC),
+		kgsl_reclaim_kbps(restored, restore_ns));
+}
+
 static void kgsl_release_page_vec(struct pagevec *pvec)
 {
 	check_move_unevictable_pages(pvec);
 	__pagevec_release(pvec);
 }
 
-static u32 kgsl_reclaim_process(struct kgsl_process_private *process,
-		u32 pages_to_reclaim)
+static int kgsl_reclaim_candidate_cmp(const void *a, const void *b)
 {
-	struct kgsl_memdesc *memdesc;
-	struct kgsl_mem_entry *entry, *valid_entry;
-	u32 next = 0, remaining = pages_to_reclaim;
+	const struct kgsl_reclaim_candidate *x = a, *y = b;
 
-	/*
-	 * If we do not get the lock here, it means that the buffers are
-	 * being pinned back. So do not keep waiting here as we would anyway
-	 * return empty handed once the lock is acquired.
-	 */
-	if (!mutex_trylock(&process->reclaim_lock))
-		return 0;
+	if (time_before(x->last_used, y->last_used))
+		return -1;
 
-	while (remaining) {
+	return time_after(x->last_used, y->last_used) ? 1 : 0;
+}
 
-		if (atomic_read(&process->unpinned_page_count) >=
-				kgsl_reclaim_max_page_limit)
-			break;
+/*
+ * The candidates are gathered in a max-heap on last_used so that the most
+ * recently used one sits at the root and is the one replaced when a colder
+ * entry shows up.
+ */
+static void kgsl_reclaim_heap_up(struct kgsl_reclaim_candidate *heap, u32 i)
+{
+	while (i) {
+		u32 parent = (i - 1) / 2;
 
-		/* Abort reclaim if process submitted work. */
-		if (atomic_read(&process->cmd_count))
+		if (!time_after(heap[i].last_used, heap[parent].last_used))
 			break;
 
-		/* Abort reclaim if process foreground hint is received. */
-		if (test_bit(KGSL_PROC_STATE, &process->state))
+		swap(heap[i], heap[parent]);
+		i = parent;
+	}
+}
+
+static void kgsl_reclaim_heap_down(struct kgsl_reclaim_candidate *heap,
+		u32 count, u32 i)
+{
+	for ( ; ; ) {
+		u32 hot = i, left = 2 * i + 1, right = left + 1;
+
+		if (left < count &&
+			time_after(heap[left].last_used, heap[hot].last_used))
+			hot = left;
+
+		if (right < count &&
+			time_after(heap[right].last_used, heap[hot].last_used))
+			hot = right;
+
+		if (hot == i)
 			break;
 
+		swap(heap[i], heap[hot]);
+		i = hot;
+	}
+}
+
+/*
+ * Take a reference on up to @max entries of the process that can be
+ * reclaimed and return how many were taken. With @coldest the whole process
+ * is walked and the @max least recently used entries are kept, sorted from
+ * the least to the most recently used. Otherwise the first @max entries
+ * from id *@next on are taken in id order and *@next is moved past them.
+ */
+static u32 kgsl_reclaim_get_candidates(struct kgsl_process_private *process,
+		struct kgsl_reclaim_candidate *candidates, u32 max, bool coldest,
+		u32 *next)
+{
+	struct kgsl_mem_entry *entry, *valid_entry;
+	struct kgsl_memdesc *memdesc;
+	unsigned long last_used;
+	u32 count = 0;
+
+	while (coldest || count < max) {
 		valid_entry = NULL;
 		spin_lock(&process->mem_lock);
-		entry = idr_get_next(&process->mem_idr, &next);
+		entry = idr_get_next(&process->mem_idr, next);
 		if (entry == NULL) {
 			spin_unlock(&process->mem_lock);
 			break;
@@ -262,31 +354,105 @@ static u32 kgsl_reclaim_process(struct kgsl_process_private *process,
 			valid_entry = kgsl_mem_entry_get(entry);
 		spin_unlock(&process->mem_lock);
 
-		if (!valid_entry) {
-			next++;
+		(*next)++;
+
+		if (!valid_entry)
 			continue;
-		}
 
 		/* Do not reclaim pages mapped into a VBO */
 		if (atomic_read(&valid_entry->vbo_count)) {
 			kgsl_mem_entry_put(entry);
-			next++;
 			continue;
 		}
 
-		if ((atomic_read(&process->unpinned_page_count) +
-			memdesc->page_count) > kgsl_reclaim_max_page_limit) {
+		last_used = READ_ONCE(entry->last_used);
+
+		/*
+		 * An entry no submission listed may still be read by the GPU
+		 * through bindless descriptors, which the kernel cannot see.
+		 * Its age is unknown so do not reclaim it.
+		 */
+		if (!last_used) {
 			kgsl_mem_entry_put(entry);
-			next++;
 			continue;
 		}
 
-		if (memdesc->page_count > remaining) {
+		if (count < max) {
+			candidates[count].entry = entry;
+			candidates[count].last_used = last_used;
+			if (coldest)
+				kgsl_reclaim_heap_up(candidates, count);
+			count++;
+			continue;
+		}
+
+		/* Full, keep the entry only if it is colder than the hottest */
+		if (!time_before(last_used, candidates[0].last_used)) {
 			kgsl_mem_entry_put(entry);
-			next++;
 			continue;
 		}
 
+		kgsl_mem_entry_put(candidates[0].entry);
+		candidates[0].entry = entry;
+		candidates[0].last_used = last_used;
+		kgsl_reclaim_heap_down(candidates, count, 0);
+	}
+
+	if (coldest && count)
+		sort(candidates, count, sizeof(*candidates),
+			kgsl_reclaim_candidate_cmp, NULL);
+
+	return count;
+}
+
+/*
+ * Reclaim the candidates in order until the budget runs out and drop their
+ * references. Return true if reclaim of the process has to stop.
+ */
+static bool kgsl_reclaim_candidates(struct kgsl_process_private *process,
+		struct kgsl_reclaim_candidate *candidates, u32 count,
+		u32 *remaining)
+{
+	struct kgsl_memdesc *memdesc;
+	struct kgsl_mem_entry *entry;
+	bool stop = false;
+	u32 n;
+
+	for (n = 0; n < count; n++) {
+		if (!*remaining ||
+			atomic_read(&process->unpinned_page_count) >=
+				kgsl_reclaim_max_page_limit) {
+			stop = true;
+			break;
+		}
+
+		/* Abort reclaim if process submitted work. */
+		if (atomic_read(&process->cmd_count)) {
+			stop = true;
+			break;
+		}
+
+		/* Abort reclaim if process foreground hint is received. */
+		if (test_bit(KGSL_PROC_STATE, &process->state)) {
+			stop = true;
+			break;
+		}
+
+		entry = candidates[n].entry;
+		memdesc = &entry->memdesc;
+
+		/* Skip entries that were reclaimed or freed meanwhile */
+		if (entry->pending_free ||
+				(memdesc->priv & KGSL_MEMDESC_RECLAIMED))
+			continue;
+
+		if ((atomic_read(&process->unpinned_page_count) +
+			memdesc->page_count) > kgsl_reclaim_max_page_limit)
+			continue;
+
+		if (memdesc->page_count > *remaining)
+			continue;
+
 		if (!kgsl_mmu_unmap(memdesc->pagetable, memdesc)) {
 			int i;
 			struct pagevec pvec;
@@ -312,7 +478,7 @@ static u32 kgsl_reclaim_process(struct kgsl_process_private *process,
 				spin_unlock(&memdesc->lock);
 				if (pagevec_count(&pvec) == PAGEVEC_SIZE)
 					kgsl_release_page_vec(&pvec);
-				remaining--;
+				(*remaining)--;
 			}
 			if (pagevec_count(&pvec))
 				kgsl_release_page_vec(&pvec);
@@ -322,14 +488,80 @@ static u32 kgsl_reclaim_process(struct kgsl_process_private *process,
 			memdesc->priv |= KGSL_MEMDESC_RECLAIMED;
 			trace_kgsl_reclaim_memdesc(entry, true);
 		}
+	}
 
-		kgsl_mem_entry_put(entry);
-		next++;
+	for (n = 0; n < count; n++)
+		kgsl_mem_entry_put(candidates[n].entry);
+
+	return stop;
+}
+
+static u32 kgsl_reclaim_process(struct kgsl_process_private *process,
+		u32 pages_to_reclaim)
+{
+	struct kgsl_reclaim_candidate *candidates, fallback;
+	u32 count, max, next = 0, remaining = pages_to_reclaim;
+	bool coldest = true, stop;
+	ktime_t start;
+
+	/*
+	 * If we do not get the lock here, it means that the buffers are
+	 * being pinned back. So do not keep waiting here as we would anyway
+	 * return empty handed once the lock is acquired.
+	 */
+	if (!mutex_trylock(&process->reclaim_lock))
+		return 0;
+
+	start = ktime_get();
+
+	/*
+	 * Evict the coldest entries first so that the working set of the
+	 * process stays resident for as long as the budget allows. Reclaim
+	 * runs when memory is short so don't try hard for the candidate
+	 * array, without it reclaim goes one entry at a time in id order.
+	 */
+	candidates = kvmalloc_array(KGSL_RECLAIM_CANDIDATES,
+		sizeof(*candidates), GFP_KERNEL | __GFP_NORETRY | __GFP_NOWARN);
+	if (candidates) {
+		max = KGSL_RECLAIM_CANDIDATES;
+	} else {
+		candidates = &fallback;
+		max = 1;
+		coldest = false;
 	}
 
-	if (next)
+	do {
+		u32 before = remaining;
+
+		if (coldest)
+			next = 0;
+
+		count = kgsl_reclaim_get_candidates(process, candidates, max,
+			coldest, &next);
+		stop = kgsl_reclaim_candidates(process, candidates, count,
+			&remaining);
+
+		/*
+		 * A full batch leaves the warmer entries of the process out.
+		 * Pick the next coldest batch only while the last one
+		 * reclaimed something so that the loop always ends.
+		 */
+		if (coldest && remaining == before)
+			break;
+	} while (!stop && count == max);
+
+	if (candidates != &fallback)
+		kvfree(candidates);
+
+	if (remaining != pages_to_reclaim) {
 		clear_bit(KGSL_PROC_PINNED_STATE, &process->state);
 
+		atomic64_add(pages_to_reclaim - remaining,
+			&kgsl_reclaimed_pages);
+		atomic64_add(ktime_to_ns(ktime_sub(ktime_get(), start)),
+			&kgsl_reclaim_time_ns);
+	}
+
 	trace_kgsl_reclaim_process(process, pages_to_reclaim - remaining, true);
 	mutex_unlock(&process->reclaim_lock);
 
@@ -459,3 +691,7 @@ void kgsl_reclaim_close(void)
 
 	cancel_work_sync(&reclaim_work);
 }
+
+#if IS_ENABLED(CONFIG_QCOM_KGSL_KUNIT_TEST)
+#include "tests/kgsl_reclaim_test.c"
+#endif
@@ -30,6 +30,23 @@ ssize_t kgsl_nr_to_scan_store(struct device *dev,
 		struct device_attribute *attr, const char *buf, size_t count);
 ssize_t kgsl_nr_to_scan_show(struct device *dev,
 		struct device_attribute *attr, char *buf);
+ssize_t kgsl_reclaim_stats_show(struct device *dev,
+		struct device_attribute *attr, char *buf);
+
+/**
+ * kgsl_reclaim_mark_used() - Record that a submission references an entry
+ * @entry: The memory entry
+ *
+ * Reclaim picks the entries that were referenced the longest time ago first.
+ * A stamp of 0 is kept for entries that were never referenced.
+ */
+static inline void kgsl_reclaim_mark_used(struct kgsl_mem_entry *entry)
+{
+	unsigned long now = jiffies ?: 1;
+
+	if (READ_ONCE(entry->last_used) != now)
+		WRITE_ONCE(entry->last_used, now);
+}
 #else
 static inline int kgsl_reclaim_start(void)
 {
@@ -55,5 +72,7 @@ static inline void kgsl_reclaim_proc_sysfs_init
 static inline void kgsl_reclaim_proc_private_init
 		(struct kgsl_process_private *process) { }
 
+static inline void kgsl_reclaim_mark_used(struct kgsl_mem_entry *entry) { }
+
 #endif
 #endif /* __KGSL_RECLAIM_H */
@@ -397,6 +397,11 @@ static struct device_attribute dev_attr_page_reclaim_per_call = {
 	.show = kgsl_nr_to_scan_show,
 	.store = kgsl_nr_to_scan_store,
 };
+
+static struct device_attribute dev_attr_reclaim_stats = {
+	.attr = { .name = "reclaim_stats", .mode = 0444 },
+	.show = kgsl_reclaim_stats_show,
+};
 #endif
 
 /**
@@ -506,6 +511,7 @@ static const struct attribute *drv_attr_list[] = {
 #ifdef CONFIG_QCOM_KGSL_PROCESS_RECLAIM
 	&dev_attr_max_reclaim_limit.attr,
 	&dev_attr_page_reclaim_per_call.attr,
+	&dev_attr_reclaim_stats.attr,
 #endif
 	NULL,
 };
@@ -1404,9 +1410,11 @@ void kgsl_unmap_and_put_gpuaddr(struct kgsl_memdesc *memdesc)
 	/*
 	 * Don't release the GPU address if the memory fails to unmap because
 	 * the IOMMU driver will BUG later if we reallocated the address and
-	 * tried to map it
+	 * tried to map it. Memory already unmapped by a batch only needs its
+	 * address released, while memory that was never mapped keeps it.
 	 */
 	if (!kgsl_memdesc_is_reclaimed(memdesc) &&
+		!(memdesc->priv & KGSL_MEMDESC_BATCH_UNMAPPED) &&
 		kgsl_mmu_unmap(memdesc->pagetable, memdesc))
 		return;
 
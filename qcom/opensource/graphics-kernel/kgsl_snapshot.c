@@ -8,6 +8,7 @@
 #include <linux/panic_notifier.h>
 #include <linux/slab.h>
 #include <linux/utsname.h>
+#include <linux/zlib.h>
 
 #include "adreno_cp_parser.h"
 #include "kgsl_device.h"
@@ -25,6 +26,21 @@ struct kgsl_snapshot_cp_obj {
 	struct list_head node;
 };
 
+/* The frozen GPU objects are saved in chunks of this size */
+#define SNAPSHOT_CHUNK_SIZE SZ_1M
+
+/**
+ * struct kgsl_snapshot_chunk - A piece of the snapshot memory pool
+ * @node: Node in kgsl_snapshot.mempool
+ * @used: Bytes of @data in use
+ * @data: The saved sections
+ */
+struct kgsl_snapshot_chunk {
+	struct list_head node;
+	size_t used;
+	u8 data[];
+};
+
 struct snapshot_obj_itr {
 	u8 *buf;      /* Buffer pointer to write to */
 	int pos;        /* Current position in the sequence */
@@ -493,6 +509,26 @@ void kgsl_snapshot_add_section(struct kgsl_device *device, u16 id,
 	snapshot->size += header->size;
 }
 
+/* Drop the data past @size bytes from the memory pool */
+static void snapshot_mempool_trim(struct kgsl_snapshot *snapshot, size_t size)
+{
+	struct kgsl_snapshot_chunk *chunk, *tmp;
+	size_t trim;
+
+	list_for_each_entry_safe_reverse(chunk, tmp, &snapshot->mempool,
+			node) {
+		trim = min_t(size_t, chunk->used, snapshot->mempool_size - size);
+		chunk->used -= trim;
+		snapshot->mempool_size -= trim;
+
+		if (chunk->used)
+			break;
+
+		list_del(&chunk->node);
+		vfree(chunk);
+	}
+}
+
 static void kgsl_free_snapshot(struct kgsl_snapshot *snapshot)
 {
 	struct kgsl_snapshot_object *obj, *tmp;
@@ -504,8 +540,7 @@ static void kgsl_free_snapshot(struct kgsl_snapshot *snapshot)
 				&snapshot->obj_list, node)
 		kgsl_snapshot_put_object(obj);
 
-	if (snapshot->mempool)
-		vfree(snapshot->mempool);
+	snapshot_mempool_trim(snapshot, 0);
 
 	kfree(snapshot);
 	dev_err(device->dev, "snapshot: objects released\n");
@@ -683,6 +718,7 @@ void kgsl_device_snapshot(struct kgsl_device *device,
 	init_completion(&snapshot->dump_gate);
 	INIT_LIST_HEAD(&snapshot->obj_list);
 	INIT_LIST_HEAD(&snapshot->cp_list);
+	INIT_LIST_HEAD(&snapshot->mempool);
 	INIT_WORK(&snapshot->work, kgsl_snapshot_save_frozen_objs);
 
 	snapshot->start = device->snapshot_memory.ptr;
@@ -806,6 +842,7 @@ static ssize_t snapshot_show(struct file *filep, struct kobject *kobj,
 	struct kgsl_device *device = kobj_to_device(kobj);
 	struct kgsl_snapshot *snapshot;
 	struct kgsl_snapshot_section_header head;
+	struct kgsl_snapshot_chunk *chunk;
 	struct snapshot_obj_itr itr;
 	int ret = 0;
 
@@ -851,10 +888,9 @@ static ssize_t snapshot_show(struct file *filep, struct kobject *kobj,
 	if (ret == 0)
 		goto done;
 
-	/* Dump the memory pool if it exists */
-	if (snapshot->mempool) {
-		ret = obj_itr_out(&itr, snapshot->mempool,
-				snapshot->mempool_size);
+	/* Dump the memory pool one chunk at a time */
+	list_for_each_entry(chunk, &snapshot->mempool, node) {
+		ret = obj_itr_out(&itr, chunk->data, chunk->used);
 		if (ret == 0)
 			goto done;
 	}
@@ -1001,6 +1037,26 @@ static ssize_t snapshot_legacy_store(struct kgsl_device *device,
 	return count;
 }
 
+static ssize_t snapshot_compress_show(struct kgsl_device *device, char *buf)
+{
+	return scnprintf(buf, PAGE_SIZE, "%d\n", device->snapshot_compress);
+}
+
+static ssize_t snapshot_compress_store(struct kgsl_device *device,
+	const char *buf, size_t count)
+{
+	bool val;
+
+	if (strtobool(buf, &val))
+		return -EINVAL;
+
+	if (val && !IS_ENABLED(CONFIG_ZLIB_DEFLATE))
+		return -EOPNOTSUPP;
+
+	device->snapshot_compress = val;
+	return count;
+}
+
 static struct bin_attribute snapshot_attr = {
 	.attr.name = "dump",
 	.attr.mode = 0444,
@@ -1026,6 +1082,8 @@ static SNAPSHOT_ATTR(snapshot_legacy, 0644, snapshot_legacy_show,
 	snapshot_legacy_store);
 static SNAPSHOT_ATTR(skip_ib_capture, 0644, skip_ib_capture_show,
 		skip_ib_capture_store);
+static SNAPSHOT_ATTR(snapshot_compress, 0644, snapshot_compress_show,
+		snapshot_compress_store);
 
 static ssize_t snapshot_sysfs_show(struct kobject *kobj,
 	struct attribute *attr, char *buf)
@@ -1072,6 +1130,7 @@ static const struct attribute *snapshot_attrs[] = {
 	&attr_snapshot_crashdumper.attr,
 	&attr_snapshot_legacy.attr,
 	&attr_skip_ib_capture.attr,
+	&attr_snapshot_compress.attr,
 	NULL,
 };
 
@@ -1191,33 +1250,254 @@ int kgsl_snapshot_add_ib_obj_list(struct kgsl_snapshot *snapshot,
 	return 0;
 }
 
-static size_t _mempool_add_object(struct kgsl_snapshot *snapshot, u8 *data,
-		struct kgsl_snapshot_object *obj)
+/*
+ * Return at least @min bytes of contiguous space at the end of the memory
+ * pool, adding a chunk if the last one is too full
+ */
+static void *snapshot_mempool_reserve(struct kgsl_snapshot *snapshot,
+		size_t min, size_t *len)
+{
+	struct kgsl_snapshot_chunk *chunk = NULL;
+
+	if (!list_empty(&snapshot->mempool))
+		chunk = list_last_entry(&snapshot->mempool,
+			struct kgsl_snapshot_chunk, node);
+
+	if (!chunk || (SNAPSHOT_CHUNK_SIZE - chunk->used) < min) {
+		chunk = vmalloc(struct_size(chunk, data, SNAPSHOT_CHUNK_SIZE));
+		if (!chunk)
+			return NULL;
+
+		chunk->used = 0;
+		list_add_tail(&chunk->node, &snapshot->mempool);
+	}
+
+	*len = SNAPSHOT_CHUNK_SIZE - chunk->used;
+	return chunk->data + chunk->used;
+}
+
+/* Account @len bytes written to the space returned by the last reserve */
+static void snapshot_mempool_commit(struct kgsl_snapshot *snapshot,
+		size_t len)
+{
+	struct kgsl_snapshot_chunk *chunk = list_last_entry(&snapshot->mempool,
+		struct kgsl_snapshot_chunk, node);
+
+	chunk->used += len;
+	snapshot->mempool_size += len;
+}
+
+static int snapshot_mempool_write(struct kgsl_snapshot *snapshot,
+		const u8 *src, u64 size)
+{
+	size_t len;
+	u8 *dst;
+
+	while (size) {
+		dst = snapshot_mempool_reserve(snapshot, 1, &len);
+		if (!dst)
+			return -ENOMEM;
+
+		len = min_t(u64, len, size);
+		memcpy(dst, src, len);
+		snapshot_mempool_commit(snapshot, len);
+
+		src += len;
+		size -= len;
+	}
+
+	return 0;
+}
+
+/*
+ * Compression is only available when the kernel has zlib deflate, a GKI
+ * kernel does not enable it on behalf of a vendor module.
+ */
+#if IS_ENABLED(CONFIG_ZLIB_DEFLATE)
+static int snapshot_mempool_deflate(struct kgsl_snapshot *snapshot,
+		z_stream *strm, const u8 *src, size_t size, int flush)
+{
+	size_t len;
+	int ret;
+
+	strm->next_in = src;
+	strm->avail_in = size;
+
+	do {
+		strm->next_out = snapshot_mempool_reserve(snapshot, 1, &len);
+		if (!strm->next_out)
+			return -ENOMEM;
+
+		strm->avail_out = len;
+		ret = zlib_deflate(strm, flush);
+		if (ret != Z_OK && ret != Z_STREAM_END)
+			return -EIO;
+
+		snapshot_mempool_commit(snapshot, len - strm->avail_out);
+		cond_resched();
+	} while ((flush == Z_FINISH) ? (ret != Z_STREAM_END) : strm->avail_in);
+
+	return 0;
+}
+
+/*
+ * Save the section made of @hdr and @size bytes at @src as a compressed
+ * section. Large objects are fed to zlib one chunk at a time.
+ */
+static int _mempool_deflate_section(struct kgsl_snapshot *snapshot,
+		z_stream *strm, const void *hdr, size_t hdr_size,
+		const u8 *src, u64 size)
+{
+	struct kgsl_snapshot_section_header *section;
+	struct kgsl_snapshot_compressed *header;
+	size_t start, len;
+	u64 remain = size;
+	int ret;
+
+	section = snapshot_mempool_reserve(snapshot,
+		sizeof(*section) + sizeof(*header), &len);
+	if (!section)
+		return -ENOMEM;
+
+	start = snapshot->mempool_size;
+	header = (struct kgsl_snapshot_compressed *)(section + 1);
+	snapshot_mempool_commit(snapshot, sizeof(*section) + sizeof(*header));
+
+	if (zlib_deflateReset(strm) != Z_OK)
+		return -EIO;
+
+	ret = snapshot_mempool_deflate(snapshot, strm, hdr, hdr_size,
+		Z_NO_FLUSH);
+
+	while (!ret) {
+		len = min_t(u64, remain, SNAPSHOT_CHUNK_SIZE);
+		remain -= len;
+
+		ret = snapshot_mempool_deflate(snapshot, strm, src, len,
+			remain ? Z_NO_FLUSH : Z_FINISH);
+		if (!remain)
+			break;
+
+		src += len;
+	}
+
+	if (ret)
+		return ret;
+
+	section->magic = SNAPSHOT_SECTION_MAGIC;
+	section->id = KGSL_SNAPSHOT_SECTION_COMPRESSED;
+	section->size = snapshot->mempool_size - start;
+	header->algo = KGSL_SNAPSHOT_COMPRESS_ZLIB;
+	header->size = hdr_size + size;
+
+	return 0;
+}
+
+/* Set up a zlib stream for compressing the frozen objects */
+static z_stream *snapshot_deflate_init(struct kgsl_snapshot *snapshot,
+		z_stream *strm)
+{
+	if (!snapshot->device->snapshot_compress)
+		return NULL;
+
+	strm->workspace = vmalloc(zlib_deflate_workspacesize(MAX_WBITS,
+		MAX_MEM_LEVEL));
+	if (!strm->workspace)
+		return NULL;
+
+	/* Favor speed, IBs compress well even at the lowest level */
+	if (zlib_deflateInit2(strm, Z_BEST_SPEED, Z_DEFLATED, MAX_WBITS,
+			MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+		vfree(strm->workspace);
+		return NULL;
+	}
+
+	return strm;
+}
+
+static void snapshot_deflate_end(z_stream *strm)
+{
+	if (!strm)
+		return;
+
+	zlib_deflateEnd(strm);
+	vfree(strm->workspace);
+}
+#else
+static int _mempool_deflate_section(struct kgsl_snapshot *snapshot,
+		z_stream *strm, const void *hdr, size_t hdr_size,
+		const u8 *src, u64 size)
+{
+	return -EOPNOTSUPP;
+}
+
+static z_stream *snapshot_deflate_init(struct kgsl_snapshot *snapshot,
+		z_stream *strm)
 {
-	struct kgsl_snapshot_section_header *section =
-		(struct kgsl_snapshot_section_header *)data;
-	struct kgsl_snapshot_gpu_object_v2 *header =
-		(struct kgsl_snapshot_gpu_object_v2 *)(data + sizeof(*section));
-	u8 *dest = data + sizeof(*section) + sizeof(*header);
-	uint64_t size;
+	return NULL;
+}
 
-	size = obj->size;
+static void snapshot_deflate_end(z_stream *strm) { }
+#endif
+
+static int _mempool_add_object(struct kgsl_snapshot *snapshot,
+		struct kgsl_snapshot_object *obj, z_stream *strm)
+{
+	struct {
+		struct kgsl_snapshot_section_header section;
+		struct kgsl_snapshot_gpu_object_v2 header;
+	} __packed hdr;
+	size_t start = snapshot->mempool_size;
+	u64 size = obj->size;
+	bool compressed = false;
+	const u8 *src;
+	int ret;
 
 	if (!kgsl_memdesc_map(&obj->entry->memdesc)) {
 		dev_err(snapshot->device->dev,
 			"snapshot: failed to map GPU object\n");
-		return 0;
+		return -ENOMEM;
 	}
 
-	section->magic = SNAPSHOT_SECTION_MAGIC;
-	section->id = KGSL_SNAPSHOT_SECTION_GPU_OBJECT_V2;
-	section->size = size + sizeof(*header) + sizeof(*section);
+	hdr.section.magic = SNAPSHOT_SECTION_MAGIC;
+	hdr.section.id = KGSL_SNAPSHOT_SECTION_GPU_OBJECT_V2;
+	hdr.section.size = size + sizeof(hdr);
 
-	header->size = size >> 2;
-	header->gpuaddr = obj->gpuaddr;
-	header->ptbase =
+	hdr.header.size = size >> 2;
+	hdr.header.gpuaddr = obj->gpuaddr;
+	hdr.header.ptbase =
 		kgsl_mmu_pagetable_get_ttbr0(obj->entry->priv->pagetable);
-	header->type = obj->type;
+	hdr.header.type = obj->type;
+
+	src = obj->entry->memdesc.hostptr + obj->offset;
+
+	if (strm) {
+		ret = _mempool_deflate_section(snapshot, strm, &hdr,
+			sizeof(hdr), src, size);
+
+		/* Keep the object as is if it doesn't compress */
+		compressed = !ret &&
+			(snapshot->mempool_size - start) < hdr.section.size;
+		if (!compressed)
+			snapshot_mempool_trim(snapshot, start);
+	}
+
+	if (!compressed) {
+		ret = snapshot_mempool_write(snapshot, (const u8 *)&hdr,
+			sizeof(hdr));
+		if (!ret)
+			ret = snapshot_mempool_write(snapshot, src, size);
+	}
+
+	kgsl_memdesc_unmap(&obj->entry->memdesc);
+
+	if (ret) {
+		snapshot_mempool_trim(snapshot, start);
+		dev_err(snapshot->device->dev,
+			"snapshot: failed to save GPU object 0x%016llx\n",
+			obj->gpuaddr);
+		return ret;
+	}
 
 	if (kgsl_addr_range_overlap(obj->gpuaddr, obj->size,
 				snapshot->ib1base, snapshot->ib1size))
@@ -1227,10 +1507,7 @@ static size_t _mempool_add_object(struct kgsl_snapshot *snapshot, u8 *data,
 				snapshot->ib2base, snapshot->ib2size))
 		snapshot->ib2dumped = true;
 
-	memcpy(dest, obj->entry->memdesc.hostptr + obj->offset, size);
-	kgsl_memdesc_unmap(&obj->entry->memdesc);
-
-	return section->size;
+	return 0;
 }
 
 /**
@@ -1238,47 +1515,37 @@ static size_t _mempool_add_object(struct kgsl_snapshot *snapshot, u8 *data,
  * memory so that the data reported in these objects is correct when snapshot
  * is taken
  * @work: The work item that scheduled this work
+ *
+ * The objects are saved, optionally compressed, into chunks that are only
+ * allocated as they fill up so that a large set of objects does not need a
+ * single large allocation.
  */
 static void kgsl_snapshot_save_frozen_objs(struct work_struct *work)
 {
 	struct kgsl_snapshot *snapshot = container_of(work,
 				struct kgsl_snapshot, work);
 	struct kgsl_snapshot_object *obj, *tmp;
-	size_t size = 0;
-	void *ptr;
+	z_stream stream, *strm;
 
 	if (snapshot->device->gmu_fault)
 		goto gmu_only;
 
 	kgsl_snapshot_process_ib_obj_list(snapshot);
 
-	list_for_each_entry(obj, &snapshot->obj_list, node) {
-		obj->size = ALIGN(obj->size, 4);
-
-		size += ((size_t) obj->size +
-			sizeof(struct kgsl_snapshot_gpu_object_v2) +
-			sizeof(struct kgsl_snapshot_section_header));
-	}
-
-	if (size == 0)
+	if (list_empty(&snapshot->obj_list))
 		goto done;
 
-	snapshot->mempool = vmalloc(size);
-
-	ptr = snapshot->mempool;
-	snapshot->mempool_size = 0;
+	strm = snapshot_deflate_init(snapshot, &stream);
 
-	/* even if vmalloc fails, make sure we clean up the obj_list */
+	/* even if an object can't be saved, make sure we clean up the list */
 	list_for_each_entry_safe(obj, tmp, &snapshot->obj_list, node) {
-		if (snapshot->mempool) {
-			size_t ret = _mempool_add_object(snapshot, ptr, obj);
-
-			ptr += ret;
-			snapshot->mempool_size += ret;
-		}
+		obj->size = ALIGN(obj->size, 4);
+		_mempool_add_object(snapshot, obj, strm);
 
 		kgsl_snapshot_put_object(obj);
 	}
+
+	snapshot_deflate_end(strm);
 done:
 	/*
 	 * Get rid of the process struct here, so that it doesn't sit
@@ -63,6 +63,7 @@ struct kgsl_snapshot_section_header {
 #define KGSL_SNAPSHOT_SECTION_SIDE_DEBUGBUS 0x1801
 #define KGSL_SNAPSHOT_SECTION_TRACE_BUFFER 0x1901
 #define KGSL_SNAPSHOT_SECTION_EVENTLOG     0x1A01
+#define KGSL_SNAPSHOT_SECTION_COMPRESSED   0x1B01
 
 #define KGSL_SNAPSHOT_SECTION_END          0xFFFF
 
@@ -399,6 +400,18 @@ struct kgsl_snapshot_gpu_object_v2 {
 	__u64 size;    /* Size of the object (in dwords) */
 } __packed;
 
+/* Compression algorithms */
+#define KGSL_SNAPSHOT_COMPRESS_ZLIB 0x1
+
+/*
+ * A compressed section is followed by the compressed stream of a complete
+ * section, including its own section header
+ */
+struct kgsl_snapshot_compressed {
+	__u32 algo; /* KGSL_SNAPSHOT_COMPRESS_* */
+	__u32 size; /* Size of the section once uncompressed */
+} __packed;
+
 struct kgsl_snapshot_eventlog {
 	/** @type: Type of the event log buffer */
 	__u16 type;
@@ -19,6 +19,8 @@
 struct kgsl_memdesc_bind_range {
 	struct kgsl_mem_entry *entry;
 	struct interval_tree_node range;
+	/** @node: Node in the list of ranges waiting for a TLB invalidation */
+	struct list_head node;
 };
 
 static struct kgsl_memdesc_bind_range *bind_to_range(struct interval_tree_node *node)
@@ -57,6 +59,20 @@ static void bind_range_destroy(struct kgsl_memdesc_bind_range *range)
 	kfree(range);
 }
 
+/*
+ * Destroy the ranges unmapped in a batch once the TLB invalidation of the
+ * batch is done, the child memory must stay around until then
+ */
+static void bind_range_destroy_list(struct list_head *list)
+{
+	struct kgsl_memdesc_bind_range *range, *tmp;
+
+	list_for_each_entry_safe(range, tmp, list, node) {
+		list_del(&range->node);
+		bind_range_destroy(range);
+	}
+}
+
 static u64 bind_range_len(struct kgsl_memdesc_bind_range *range)
 {
 	return (range->range.last - range->range.start) + 1;
@@ -93,11 +109,13 @@ void kgsl_memdesc_print_vbo_ranges(struct kgsl_mem_entry *entry,
 }
 
 static void kgsl_memdesc_remove_range(struct kgsl_mem_entry *target,
-		u64 start, u64 last, struct kgsl_mem_entry *entry)
+		u64 start, u64 last, struct kgsl_mem_entry *entry,
+		struct kgsl_mmu_batch *batch, struct list_head *unmapped)
 {
 	struct  interval_tree_node *node, *next;
 	struct kgsl_memdesc_bind_range *range;
 	struct kgsl_memdesc *memdesc = &target->memdesc;
+	LIST_HEAD(removed);
 
 	mutex_lock(&memdesc->ranges_lock);
 
@@ -112,7 +130,7 @@ static void kgsl_memdesc_remove_range(struct kgsl_mem_entry *target,
 		 * the entire range between start and last in this case.
 		 */
 		if (!entry || range->entry->id == entry->id) {
-			if (kgsl_mmu_unmap_range(memdesc->pagetable,
+			if (kgsl_mmu_batch_unmap_range(batch,
 				memdesc, range->range.start, bind_range_len(range)))
 				continue;
 
@@ -121,19 +139,32 @@ static void kgsl_memdesc_remove_range(struct kgsl_mem_entry *target,
 				range->range.start, range->entry,
 				bind_range_len(range));
 
-			if (!(memdesc->flags & KGSL_MEMFLAGS_VBO_NO_MAP_ZERO))
-				kgsl_mmu_map_zero_page_to_range(memdesc->pagetable,
-					memdesc, range->range.start, bind_range_len(range));
-
-			bind_range_destroy(range);
+			list_add_tail(&range->node, &removed);
 		}
 	}
 
+	/*
+	 * The zero page goes where the ranges were just unmapped, so the
+	 * stale translations have to be invalidated first. Doing it once
+	 * after all the unmaps keeps it to a single invalidation.
+	 */
+	if (!(memdesc->flags & KGSL_MEMFLAGS_VBO_NO_MAP_ZERO) &&
+		!list_empty(&removed)) {
+		kgsl_mmu_batch_flush(batch);
+
+		list_for_each_entry(range, &removed, node)
+			kgsl_mmu_map_zero_page_to_range(memdesc->pagetable,
+				memdesc, range->range.start, bind_range_len(range));
+	}
+
+	list_splice_tail(&removed, unmapped);
+
 	mutex_unlock(&memdesc->ranges_lock);
 }
 
 static int kgsl_memdesc_add_range(struct kgsl_mem_entry *target,
-		u64 start, u64 last, struct kgsl_mem_entry *entry, u64 offset)
+		u64 start, u64 last, struct kgsl_mem_entry *entry, u64 offset,
+		struct kgsl_mmu_batch *batch, struct list_head *unmapped)
 {
 	struct  interval_tree_node *node, *next;
 	struct kgsl_memdesc *memdesc = &target->memdesc;
@@ -152,7 +183,7 @@ static int kgsl_memdesc_add_range(struct kgsl_mem_entry *target,
 	 * while walking the interval tree.
 	 */
 	if (!(memdesc->flags & KGSL_MEMFLAGS_VBO_NO_MAP_ZERO)) {
-		ret = kgsl_mmu_unmap_range(memdesc->pagetable, memdesc, start,
+		ret = kgsl_mmu_batch_unmap_range(batch, memdesc, start,
 			last - start + 1);
 		if (ret)
 			goto error;
@@ -176,7 +207,7 @@ static int kgsl_memdesc_add_range(struct kgsl_mem_entry *target,
 			if (last >= cur->range.last) {
 				/* Unmap the entire cur range */
 				if (memdesc->flags & KGSL_MEMFLAGS_VBO_NO_MAP_ZERO) {
-					ret = kgsl_mmu_unmap_range(memdesc->pagetable, memdesc,
+					ret = kgsl_mmu_batch_unmap_range(batch, memdesc,
 						cur->range.start,
 						cur->range.last - cur->range.start + 1);
 					if (ret) {
@@ -185,13 +216,13 @@ static int kgsl_memdesc_add_range(struct kgsl_mem_entry *target,
 					}
 				}
 
-				bind_range_destroy(cur);
+				list_add_tail(&cur->node, unmapped);
 				continue;
 			}
 
 			/* Unmap the range overlapping cur */
 			if (memdesc->flags & KGSL_MEMFLAGS_VBO_NO_MAP_ZERO) {
-				ret = kgsl_mmu_unmap_range(memdesc->pagetable, memdesc,
+				ret = kgsl_mmu_batch_unmap_range(batch, memdesc,
 					cur->range.start,
 					last - cur->range.start + 1);
 				if (ret) {
@@ -230,7 +261,7 @@ static int kgsl_memdesc_add_range(struct kgsl_mem_entry *target,
 
 			/* Unmap the range overlapping cur */
 			if (memdesc->flags & KGSL_MEMFLAGS_VBO_NO_MAP_ZERO) {
-				ret = kgsl_mmu_unmap_range(memdesc->pagetable, memdesc,
+				ret = kgsl_mmu_batch_unmap_range(batch, memdesc,
 					start,
 					min_t(u64, cur->range.last, last) - start + 1);
 				if (ret) {
@@ -247,6 +278,9 @@ static int kgsl_memdesc_add_range(struct kgsl_mem_entry *target,
 		}
 	}
 
+	/* Invalidate the translations unmapped above before the remap */
+	kgsl_mmu_batch_flush(batch);
+
 	ret = kgsl_mmu_map_child(memdesc->pagetable, memdesc, start,
 			&entry->memdesc, offset, last - start + 1);
 	if (ret)
@@ -271,15 +305,19 @@ static void kgsl_sharedmem_vbo_put_gpuaddr(struct kgsl_memdesc *memdesc)
 {
 	struct interval_tree_node *node, *next;
 	struct kgsl_memdesc_bind_range *range;
+	struct kgsl_mmu_batch batch;
+	LIST_HEAD(unmapped);
 	int ret = 0;
 	bool unmap_fail;
 
+	kgsl_mmu_batch_start(&batch, memdesc->pagetable);
+
 	/*
 	 * If the VBO maps the zero range then we can unmap the entire
 	 * pagetable region in one call.
 	 */
 	if (!(memdesc->flags & KGSL_MEMFLAGS_VBO_NO_MAP_ZERO))
-		ret = kgsl_mmu_unmap_range(memdesc->pagetable, memdesc,
+		ret = kgsl_mmu_batch_unmap_range(&batch, memdesc,
 			0, memdesc->size);
 
 	unmap_fail = ret;
@@ -301,19 +339,22 @@ static void kgsl_sharedmem_vbo_put_gpuaddr(struct kgsl_memdesc *memdesc)
 
 		/* Unmap this range */
 		if (memdesc->flags & KGSL_MEMFLAGS_VBO_NO_MAP_ZERO)
-			ret = kgsl_mmu_unmap_range(memdesc->pagetable, memdesc,
+			ret = kgsl_mmu_batch_unmap_range(&batch, memdesc,
 				range->range.start,
 				range->range.last - range->range.start + 1);
 
 		/* Put the child's refcount if unmap succeeds */
 		if (!ret)
-			bind_range_destroy(range);
+			list_add_tail(&range->node, &unmapped);
 		else
 			kfree(range);
 
 		unmap_fail = unmap_fail || ret;
 	}
 
+	kgsl_mmu_batch_end(&batch);
+	bind_range_destroy_list(&unmapped);
+
 	if (unmap_fail)
 		return;
 
@@ -382,6 +423,63 @@ static void kgsl_sharedmem_free_bind_op(struct kgsl_sharedmem_bind_op *op)
 	kfree(op);
 }
 
+static bool kgsl_sharedmem_bind_op_mergeable(
+		struct kgsl_sharedmem_bind_op_range *prev,
+		struct kgsl_sharedmem_bind_op_range *next)
+{
+	if (prev->op != next->op || prev->entry != next->entry)
+		return false;
+
+	/* The ranges must overlap or be adjacent in the target */
+	if (next->start > prev->last + 1 || prev->start > next->last + 1)
+		return false;
+
+	/* Binds must map the same child offsets in both ranges */
+	if (prev->op == KGSL_GPUMEM_RANGE_OP_BIND)
+		return prev->start - prev->child_offset ==
+			next->start - next->child_offset;
+
+	return true;
+}
+
+/*
+ * Merge runs of operations that can be applied as a single one so that
+ * userspace streaming sparse resources a page at a time doesn't cost a
+ * walk of the interval tree and a page table update per page. Only
+ * consecutive operations are merged because a later operation overrides
+ * the earlier ones where they overlap.
+ */
+static void kgsl_sharedmem_coalesce_bind_op(struct kgsl_sharedmem_bind_op *op)
+{
+	struct kgsl_sharedmem_bind_op_range *prev = &op->ops[0];
+	int i, nr_ops = 1;
+
+	for (i = 1; i < op->nr_ops; i++) {
+		struct kgsl_sharedmem_bind_op_range *next = &op->ops[i];
+
+		if (!kgsl_sharedmem_bind_op_mergeable(prev, next)) {
+			prev = &op->ops[nr_ops++];
+			*prev = *next;
+			continue;
+		}
+
+		if (next->start < prev->start) {
+			prev->start = next->start;
+			prev->child_offset = next->child_offset;
+		}
+
+		prev->last = max(prev->last, next->last);
+
+		/* prev holds the same references on the child */
+		if (next->entry) {
+			atomic_dec(&next->entry->vbo_count);
+			kgsl_mem_entry_put(next->entry);
+		}
+	}
+
+	op->nr_ops = nr_ops;
+}
+
 struct kgsl_sharedmem_bind_op *
 kgsl_sharedmem_create_bind_op(struct kgsl_process_private *private,
 		u32 target_id, void __user *ranges, u32 ranges_nents,
@@ -533,6 +631,8 @@ kgsl_sharedmem_create_bind_op(struct kgsl_process_private *private,
 		ranges += ranges_size;
 	}
 
+	kgsl_sharedmem_coalesce_bind_op(op);
+
 	atomic_dec(&private->cmd_count);
 	init_completion(&op->comp);
 	kref_init(&op->ref);
@@ -557,22 +657,35 @@ static void kgsl_sharedmem_bind_worker(struct work_struct *work)
 {
 	struct kgsl_sharedmem_bind_op *op = container_of(work,
 		struct kgsl_sharedmem_bind_op, work);
+	struct kgsl_mmu_batch batch;
+	LIST_HEAD(unmapped);
 	int i;
 
+	/*
+	 * Gather the TLB invalidation of the ranges unmapped by the op, binds
+	 * only invalidate early before remapping what they unmapped
+	 */
+	kgsl_mmu_batch_start(&batch, op->target->memdesc.pagetable);
+
 	for (i = 0; i < op->nr_ops; i++) {
 		if (op->ops[i].op == KGSL_GPUMEM_RANGE_OP_BIND)
 			kgsl_memdesc_add_range(op->target,
 				op->ops[i].start,
 				op->ops[i].last,
 				op->ops[i].entry,
-				op->ops[i].child_offset);
+				op->ops[i].child_offset,
+				&batch, &unmapped);
 		else
 			kgsl_memdesc_remove_range(op->target,
 				op->ops[i].start,
 				op->ops[i].last,
-				op->ops[i].entry);
+				op->ops[i].entry,
+				&batch, &unmapped);
 	}
 
+	kgsl_mmu_batch_end(&batch);
+	bind_range_destroy_list(&unmapped);
+
 	/* Wake up any threads waiting for the bind operation */
 	complete_all(&op->comp);
 
@@ -730,3 +843,7 @@ long kgsl_ioctl_gpumem_bind_ranges(struct kgsl_device_private *dev_priv,
 
 	return ret;
 }
+
+#if IS_ENABLED(CONFIG_QCOM_KGSL_KUNIT_TEST)
+#include "tests/kgsl_vbo_test.c"
+#endif
@@ -27,6 +27,22 @@ struct xstats {
 	unsigned long gpu_minfreq;
 };
 
+/**
+ * struct tz_xstats - Extra GPU statistics of a sample window for the
+ * msm-adreno-tz governor
+ * @context_count: Number of active contexts
+ * @frames: Frames retired in the window
+ * @missed: Frames retired after their deadline in the window
+ * @frame_period: Shortest frame period of the contexts that retired a frame
+ * in the window, in microseconds
+ */
+struct tz_xstats {
+	int context_count;
+	u32 frames;
+	u32 missed;
+	u32 frame_period;
+};
+
 struct devfreq_msm_adreno_tz_data {
 	struct notifier_block nb;
 	struct {
@@ -34,6 +50,9 @@ struct devfreq_msm_adreno_tz_data {
 		s64 busy_time;
 		u32 ctxt_aware_target_pwrlevel;
 		u32 ctxt_aware_busy_penalty;
+		u32 frames;
+		u32 missed;
+		u32 frame_period;
 	} bin;
 	struct {
 		u64 total_time;
@@ -58,6 +77,10 @@ struct devfreq_msm_adreno_tz_data {
 	u32 mod_percent;
 	/* Increase IB vote on high ddr stall */
 	bool fast_bus_hint;
+	/* Scale to the frame deadlines instead of going through TZ */
+	bool frame_aware;
+	/* Running average of the GPU cycles of a frame */
+	u64 frame_cycles;
 };
 
 struct msm_adreno_extended_profile {
@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef MSM_ADRENO_FRAME_DCVS_H
+#define MSM_ADRENO_FRAME_DCVS_H
+
+/*
+ * Frame aware DCVS policy of the msm-adreno-tz governor. This is kept free
+ * of kernel dependencies so that tools/adreno_frame_dcvs_sim.c can replay
+ * traces through the exact same policy on the host.
+ */
+
+#ifdef __KERNEL__
+#include <linux/math64.h>
+#else
+#include <stdint.h>
+
+static inline uint64_t div64_u64(uint64_t dividend, uint64_t divisor)
+{
+	return dividend / divisor;
+}
+#endif
+
+/* Percentage of the frame period that the GPU work of a frame should take */
+#define MSM_ADRENO_FRAME_TARGET_PERCENT 80
+/* Weight of the running average of the frame cycles */
+#define MSM_ADRENO_FRAME_AVG_WEIGHT 4
+/* Longest window in microseconds to wait for a frame to retire */
+#define MSM_ADRENO_FRAME_WINDOW_MAX 100000
+
+/**
+ * msm_adreno_frame_level() - Pick the power level for the next window
+ * @freq_table: Frequencies in Hz by power level, fastest first
+ * @num_levels: Number of power levels in @freq_table
+ * @level: Current power level
+ * @busy_time: GPU busy time in the window in microseconds
+ * @frames: Number of frames retired in the window
+ * @period: Shortest frame period of the active contexts in microseconds
+ * @missed: Number of frames retired after their deadline in the window
+ * @frame_cycles: Running average of the GPU cycles of a frame
+ *
+ * Update the average GPU cycles of a frame with the window and pick the
+ * slowest level that fits them in the frame period. The windows are not
+ * aligned to the frames, so the average smooths out the partial frames
+ * each window sees. If a frame missed its deadline, go at least one level
+ * faster than @level.
+ *
+ * Return: The power level to use or -1 if there were no frames to go by
+ */
+static inline int msm_adreno_frame_level(const unsigned long *freq_table,
+		int num_levels, int level, uint64_t busy_time,
+		unsigned int frames, unsigned int period, unsigned int missed,
+		uint64_t *frame_cycles)
+{
+	uint64_t cycles, freq;
+	int lev;
+
+	if (!frames || !period)
+		return -1;
+
+	cycles = div64_u64(busy_time * freq_table[level], frames);
+	if (*frame_cycles)
+		cycles = (*frame_cycles * (MSM_ADRENO_FRAME_AVG_WEIGHT - 1) +
+			cycles) / MSM_ADRENO_FRAME_AVG_WEIGHT;
+	*frame_cycles = cycles;
+
+	freq = div64_u64(cycles * 100,
+		(uint64_t)period * MSM_ADRENO_FRAME_TARGET_PERCENT);
+
+	for (lev = num_levels - 1; lev > 0; lev--)
+		if (freq_table[lev] >= freq)
+			break;
+
+	if (missed && lev >= level)
+		lev = level > 0 ? level - 1 : 0;
+
+	return lev;
+}
+
+#endif
@@ -0,0 +1,318 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/*
+ * KUnit tests of the timestamp ordered event groups. Included at the end of
+ * kgsl_events.c so that they can look at the group list and the events
+ * cache directly. The group has no context and reads its timestamps from
+ * the test, the callbacks run on a private events worker.
+ */
+
+#include <kunit/test.h>
+
+#define KGSL_EVENTS_TEST_MAX 64
+
+struct kgsl_events_test {
+	struct kgsl_device *device;
+	struct kgsl_event_group group;
+	unsigned int queued;
+	unsigned int retired;
+	/* Written by the callbacks, read after flushing the worker */
+	int nr_fired;
+	uintptr_t fired[KGSL_EVENTS_TEST_MAX];
+	int results[KGSL_EVENTS_TEST_MAX];
+};
+
+static int kgsl_events_test_readtimestamp(struct kgsl_device *device,
+		void *priv, enum kgsl_timestamp_type type, unsigned int *timestamp)
+{
+	struct kgsl_events_test *t = priv;
+
+	*timestamp = (type == KGSL_TIMESTAMP_QUEUED) ? t->queued : t->retired;
+	return 0;
+}
+
+static void kgsl_events_test_func(struct kgsl_device *device,
+		struct kgsl_event_group *group, void *priv, int result)
+{
+	struct kgsl_events_test *t = container_of(group,
+		struct kgsl_events_test, group);
+
+	if (t->nr_fired < KGSL_EVENTS_TEST_MAX) {
+		t->fired[t->nr_fired] = (uintptr_t)priv;
+		t->results[t->nr_fired] = result;
+	}
+
+	t->nr_fired++;
+}
+
+static int kgsl_events_test_init(struct kunit *test)
+{
+	struct kgsl_events_test *t;
+
+	KUNIT_ASSERT_NOT_NULL(test, events_cache);
+
+	t = kunit_kzalloc(test, sizeof(*t), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, t);
+
+	t->device = kunit_kzalloc(test, sizeof(*t->device), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, t->device);
+
+	t->device->events_worker = kthread_create_worker(0, "kgsl-events-test");
+	KUNIT_ASSERT_FALSE(test, IS_ERR(t->device->events_worker));
+
+	/* Not on the device list, only the test processes the group */
+	spin_lock_init(&t->group.lock);
+	INIT_LIST_HEAD(&t->group.events);
+	t->group.readtimestamp = kgsl_events_test_readtimestamp;
+	t->group.priv = t;
+
+	test->priv = t;
+	return 0;
+}
+
+static void kgsl_events_test_exit(struct kunit *test)
+{
+	struct kgsl_events_test *t = test->priv;
+
+	kgsl_cancel_events(t->device, &t->group);
+	kthread_flush_worker(t->device->events_worker);
+	kthread_destroy_worker(t->device->events_worker);
+}
+
+static void kgsl_events_test_add(struct kunit *test, unsigned int timestamp,
+		uintptr_t id)
+{
+	struct kgsl_events_test *t = test->priv;
+
+	KUNIT_ASSERT_EQ(test, kgsl_add_event(t->device, &t->group, timestamp,
+		kgsl_events_test_func, (void *)id), 0);
+}
+
+static void kgsl_events_test_flush_worker(struct kunit *test)
+{
+	struct kgsl_events_test *t = test->priv;
+
+	kthread_flush_worker(t->device->events_worker);
+	KUNIT_ASSERT_LE(test, t->nr_fired, KGSL_EVENTS_TEST_MAX);
+}
+
+/* Check that the list is in timestamp order and return its length */
+static int kgsl_events_test_check_sorted(struct kunit *test)
+{
+	struct kgsl_events_test *t = test->priv;
+	struct kgsl_event *event, *prev = NULL;
+	int count = 0;
+
+	spin_lock(&t->group.lock);
+	list_for_each_entry(event, &t->group.events, node) {
+		if (prev)
+			KUNIT_EXPECT_LE(test,
+				timestamp_cmp(prev->timestamp, event->timestamp), 0);
+		prev = event;
+		count++;
+	}
+	spin_unlock(&t->group.lock);
+
+	return count;
+}
+
+static void kgsl_events_test_sorted(struct kunit *test)
+{
+	struct kgsl_events_test *t = test->priv;
+	int i;
+
+	t->queued = KGSL_EVENTS_TEST_MAX;
+
+	/* 29 is coprime with the count, this adds every timestamp once */
+	for (i = 0; i < KGSL_EVENTS_TEST_MAX; i++) {
+		unsigned int timestamp = (i * 29) % KGSL_EVENTS_TEST_MAX + 1;
+
+		kgsl_events_test_add(test, timestamp, timestamp);
+		KUNIT_EXPECT_EQ(test, kgsl_events_test_check_sorted(test), i + 1);
+	}
+
+	kgsl_cancel_events(t->device, &t->group);
+	kgsl_events_test_flush_worker(test);
+	KUNIT_EXPECT_EQ(test, t->nr_fired, KGSL_EVENTS_TEST_MAX);
+	t->nr_fired = 0;
+
+	/* Adding in order only ever appends */
+	for (i = 1; i <= KGSL_EVENTS_TEST_MAX; i++)
+		kgsl_events_test_add(test, i, i);
+	KUNIT_EXPECT_EQ(test, kgsl_events_test_check_sorted(test),
+		KGSL_EVENTS_TEST_MAX);
+}
+
+static void kgsl_events_test_wraparound(struct kunit *test)
+{
+	static const unsigned int order[] = {
+		0xfffffff1, 0xfffffff8, 0x0, 0x5, 0x10,
+	};
+	struct kgsl_events_test *t = test->priv;
+	int i;
+
+	t->retired = 0xfffffff0;
+	t->queued = 0x10;
+
+	kgsl_events_test_add(test, 0x5, 3);
+	kgsl_events_test_add(test, 0xfffffff8, 1);
+	kgsl_events_test_add(test, 0x10, 4);
+	kgsl_events_test_add(test, 0xfffffff1, 0);
+	kgsl_events_test_add(test, 0x0, 2);
+
+	KUNIT_EXPECT_EQ(test, kgsl_events_test_check_sorted(test),
+		ARRAY_SIZE(order));
+
+	/* A flush at the retired timestamp cancels them oldest first */
+	kgsl_flush_event_group(t->device, &t->group);
+	kgsl_events_test_flush_worker(test);
+
+	KUNIT_ASSERT_EQ(test, t->nr_fired, ARRAY_SIZE(order));
+	for (i = 0; i < ARRAY_SIZE(order); i++) {
+		KUNIT_EXPECT_EQ(test, t->fired[i], (uintptr_t)i);
+		KUNIT_EXPECT_EQ(test, t->results[i], KGSL_EVENT_CANCELLED);
+	}
+}
+
+static void kgsl_events_test_equal(struct kunit *test)
+{
+	struct kgsl_events_test *t = test->priv;
+	int i;
+
+	t->queued = 10;
+
+	/* Events on the same timestamp fire in the order they were added */
+	kgsl_events_test_add(test, 5, 0);
+	kgsl_events_test_add(test, 10, 4);
+	kgsl_events_test_add(test, 5, 1);
+	kgsl_events_test_add(test, 3, 100);
+	kgsl_events_test_add(test, 5, 2);
+	kgsl_events_test_add(test, 5, 3);
+
+	t->retired = 5;
+	kgsl_process_event_group(t->device, &t->group);
+	kgsl_events_test_flush_worker(test);
+
+	KUNIT_ASSERT_EQ(test, t->nr_fired, 5);
+	KUNIT_EXPECT_EQ(test, t->fired[0], (uintptr_t)100);
+	for (i = 1; i < 5; i++) {
+		KUNIT_EXPECT_EQ(test, t->fired[i], (uintptr_t)(i - 1));
+		KUNIT_EXPECT_EQ(test, t->results[i], KGSL_EVENT_RETIRED);
+	}
+
+	KUNIT_EXPECT_EQ(test, kgsl_events_test_check_sorted(test), 1);
+}
+
+static void kgsl_events_test_process(struct kunit *test)
+{
+	struct kgsl_events_test *t = test->priv;
+	int i;
+
+	t->queued = 16;
+
+	for (i = 0; i < 16; i++) {
+		unsigned int timestamp = (i * 5) % 16 + 1;
+
+		kgsl_events_test_add(test, timestamp, timestamp);
+	}
+
+	/* Only the retired half fires, oldest first */
+	t->retired = 8;
+	kgsl_process_event_group(t->device, &t->group);
+	kgsl_events_test_flush_worker(test);
+
+	KUNIT_ASSERT_EQ(test, t->nr_fired, 8);
+	for (i = 0; i < 8; i++) {
+		KUNIT_EXPECT_EQ(test, t->fired[i], (uintptr_t)(i + 1));
+		KUNIT_EXPECT_EQ(test, t->results[i], KGSL_EVENT_RETIRED);
+	}
+
+	KUNIT_EXPECT_EQ(test, kgsl_events_test_check_sorted(test), 8);
+	KUNIT_EXPECT_EQ(test, t->group.processed, 8U);
+
+	/* Nothing new retired, nothing fires */
+	kgsl_process_event_group(t->device, &t->group);
+	kgsl_events_test_flush_worker(test);
+	KUNIT_EXPECT_EQ(test, t->nr_fired, 8);
+
+	/* The flush retires what retired since and cancels the rest */
+	t->retired = 12;
+	kgsl_flush_event_group(t->device, &t->group);
+	kgsl_events_test_flush_worker(test);
+
+	KUNIT_ASSERT_EQ(test, t->nr_fired, 16);
+	for (i = 8; i < 16; i++) {
+		KUNIT_EXPECT_EQ(test, t->fired[i], (uintptr_t)(i + 1));
+		KUNIT_EXPECT_EQ(test, t->results[i], i < 12 ?
+			KGSL_EVENT_RETIRED : KGSL_EVENT_CANCELLED);
+	}
+
+	KUNIT_EXPECT_TRUE(test, list_empty(&t->group.events));
+}
+
+static void kgsl_events_test_cancel(struct kunit *test)
+{
+	struct kgsl_events_test *t = test->priv;
+	struct kgsl_event_group *group = &t->group;
+	struct kgsl_device *device = t->device;
+
+	t->queued = 10;
+
+	kgsl_events_test_add(test, 2, 0);
+	kgsl_events_test_add(test, 7, 1);
+	kgsl_events_test_add(test, 5, 2);
+	kgsl_events_test_add(test, 7, 3);
+	kgsl_events_test_add(test, 5, 4);
+	kgsl_events_test_add(test, 9, 5);
+
+	KUNIT_EXPECT_TRUE(test, kgsl_event_pending(device, group, 7,
+		kgsl_events_test_func, (void *)3));
+	KUNIT_EXPECT_TRUE(test, kgsl_event_pending(device, group, 9,
+		kgsl_events_test_func, (void *)5));
+	/* The lookups stop past the timestamp, the wrong one never matches */
+	KUNIT_EXPECT_FALSE(test, kgsl_event_pending(device, group, 5,
+		kgsl_events_test_func, (void *)3));
+	KUNIT_EXPECT_FALSE(test, kgsl_event_pending(device, group, 6,
+		kgsl_events_test_func, (void *)3));
+
+	kgsl_cancel_event(device, group, 7, kgsl_events_test_func, (void *)3);
+	KUNIT_EXPECT_FALSE(test, kgsl_event_pending(device, group, 7,
+		kgsl_events_test_func, (void *)3));
+	KUNIT_EXPECT_TRUE(test, kgsl_event_pending(device, group, 7,
+		kgsl_events_test_func, (void *)1));
+
+	kgsl_cancel_events_timestamp(device, group, 5);
+	KUNIT_EXPECT_FALSE(test, kgsl_event_pending(device, group, 5,
+		kgsl_events_test_func, (void *)2));
+	KUNIT_EXPECT_FALSE(test, kgsl_event_pending(device, group, 5,
+		kgsl_events_test_func, (void *)4));
+
+	kgsl_events_test_flush_worker(test);
+	KUNIT_ASSERT_EQ(test, t->nr_fired, 3);
+	KUNIT_EXPECT_EQ(test, t->fired[0], (uintptr_t)3);
+	KUNIT_EXPECT_EQ(test, t->fired[1], (uintptr_t)2);
+	KUNIT_EXPECT_EQ(test, t->fired[2], (uintptr_t)4);
+
+	KUNIT_EXPECT_EQ(test, kgsl_events_test_check_sorted(test), 3);
+}
+
+static struct kunit_case kgsl_events_test_cases[] = {
+	KUNIT_CASE(kgsl_events_test_sorted),
+	KUNIT_CASE(kgsl_events_test_wraparound),
+	KUNIT_CASE(kgsl_events_test_equal),
+	KUNIT_CASE(kgsl_events_test_process),
+	KUNIT_CASE(kgsl_events_test_cancel),
+	{}
+};
+
+static struct kunit_suite kgsl_events_test_suite = {
+	.name = "kgsl_events",
+	.init = kgsl_events_test_init,
+	.exit = kgsl_events_test_exit,
+	.test_cases = kgsl_events_test_cases,
+};
+
+kunit_test_suite(kgsl_events_test_suite);
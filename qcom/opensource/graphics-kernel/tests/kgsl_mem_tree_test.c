@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/*
+ * KUnit tests of the process gpu address tree. Included at the end of
+ * kgsl.c so that they run against the static tree helpers that
+ * kgsl_sharedmem_find() uses.
+ */
+
+#include <kunit/test.h>
+
+#define KGSL_MEM_TREE_TEST_ENTRIES 256
+#define KGSL_MEM_TREE_TEST_BASE 0x100000ULL
+
+struct kgsl_mem_tree_test {
+	struct kgsl_process_private private;
+	struct kgsl_mem_entry *entries;
+	int count;
+};
+
+static int kgsl_mem_tree_test_init(struct kunit *test)
+{
+	struct kgsl_mem_tree_test *t;
+	u64 gpuaddr = KGSL_MEM_TREE_TEST_BASE;
+	int i;
+
+	t = kunit_kzalloc(test, sizeof(*t), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, t);
+
+	t->count = KGSL_MEM_TREE_TEST_ENTRIES;
+	t->entries = kunit_kcalloc(test, t->count, sizeof(*t->entries),
+		GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, t->entries);
+
+	t->private.mem_tree = RB_ROOT_CACHED;
+
+	/*
+	 * Entries of varying size, every third one is followed by a one page
+	 * hole so that lookups can miss between two entries.
+	 */
+	for (i = 0; i < t->count; i++) {
+		struct kgsl_mem_entry *entry = &t->entries[i];
+
+		RB_CLEAR_NODE(&entry->node);
+		entry->priv = &t->private;
+		entry->memdesc.gpuaddr = gpuaddr;
+		entry->memdesc.size = PAGE_SIZE << (i % 4);
+
+		gpuaddr += entry->memdesc.size;
+		if (i % 3 == 0)
+			gpuaddr += PAGE_SIZE;
+	}
+
+	test->priv = t;
+	return 0;
+}
+
+/* Insert the entries in a scrambled order so the tree has to rebalance */
+static void kgsl_mem_tree_test_insert_all(struct kgsl_mem_tree_test *t)
+{
+	int i;
+
+	/* 97 is coprime with the entry count, this visits every entry once */
+	for (i = 0; i < t->count; i++)
+		kgsl_mem_entry_insert_gpuaddr(&t->entries[(i * 97) % t->count]);
+}
+
+static struct kgsl_mem_entry *
+kgsl_mem_tree_test_linear(struct kgsl_mem_tree_test *t, u64 gpuaddr)
+{
+	int i;
+
+	for (i = 0; i < t->count; i++) {
+		struct kgsl_mem_entry *entry = &t->entries[i];
+
+		if (RB_EMPTY_NODE(&entry->node))
+			continue;
+
+		if (gpuaddr >= entry->memdesc.gpuaddr &&
+			gpuaddr < entry->memdesc.gpuaddr + entry->memdesc.size)
+			return entry;
+	}
+
+	return NULL;
+}
+
+static struct kgsl_mem_entry *
+kgsl_mem_tree_test_find(struct kgsl_mem_tree_test *t, u64 gpuaddr)
+{
+	return kgsl_mem_tree_iter_first(&t->private.mem_tree, gpuaddr, gpuaddr);
+}
+
+static void kgsl_mem_tree_test_bounds(struct kunit *test)
+{
+	struct kgsl_mem_tree_test *t = test->priv;
+	int i;
+
+	kgsl_mem_tree_test_insert_all(t);
+
+	for (i = 0; i < t->count; i++) {
+		struct kgsl_mem_entry *entry = &t->entries[i];
+		u64 start = entry->memdesc.gpuaddr;
+		u64 end = start + entry->memdesc.size;
+
+		KUNIT_EXPECT_PTR_EQ(test, kgsl_mem_tree_test_find(t, start),
+			entry);
+		KUNIT_EXPECT_PTR_EQ(test,
+			kgsl_mem_tree_test_find(t, start + entry->memdesc.size / 2),
+			entry);
+		KUNIT_EXPECT_PTR_EQ(test, kgsl_mem_tree_test_find(t, end - 1),
+			entry);
+
+		/* The end is exclusive, it is the next entry or a hole */
+		if (i % 3 == 0 || i == t->count - 1)
+			KUNIT_EXPECT_NULL(test, kgsl_mem_tree_test_find(t, end));
+		else
+			KUNIT_EXPECT_PTR_EQ(test, kgsl_mem_tree_test_find(t, end),
+				&t->entries[i + 1]);
+	}
+
+	KUNIT_EXPECT_NULL(test, kgsl_mem_tree_test_find(t, 0));
+	KUNIT_EXPECT_NULL(test,
+		kgsl_mem_tree_test_find(t, KGSL_MEM_TREE_TEST_BASE - 1));
+}
+
+static void kgsl_mem_tree_test_matches_linear(struct kunit *test)
+{
+	struct kgsl_mem_tree_test *t = test->priv;
+	struct kgsl_mem_entry *last = &t->entries[t->count - 1];
+	u64 end = last->memdesc.gpuaddr + last->memdesc.size;
+	u64 gpuaddr;
+
+	kgsl_mem_tree_test_insert_all(t);
+
+	for (gpuaddr = KGSL_MEM_TREE_TEST_BASE - PAGE_SIZE;
+		gpuaddr < end + PAGE_SIZE; gpuaddr += PAGE_SIZE / 4)
+		KUNIT_EXPECT_PTR_EQ(test, kgsl_mem_tree_test_find(t, gpuaddr),
+			kgsl_mem_tree_test_linear(t, gpuaddr));
+}
+
+static void kgsl_mem_tree_test_remove(struct kunit *test)
+{
+	struct kgsl_mem_tree_test *t = test->priv;
+	int i;
+
+	kgsl_mem_tree_test_insert_all(t);
+
+	/* Drop every other entry, its neighbours must still be found */
+	for (i = 0; i < t->count; i += 2)
+		kgsl_mem_entry_remove_gpuaddr(&t->entries[i]);
+
+	for (i = 0; i < t->count; i++) {
+		struct kgsl_mem_entry *entry = &t->entries[i];
+
+		if (i % 2) {
+			KUNIT_EXPECT_FALSE(test, RB_EMPTY_NODE(&entry->node));
+			KUNIT_EXPECT_PTR_EQ(test,
+				kgsl_mem_tree_test_find(t, entry->memdesc.gpuaddr),
+				entry);
+		} else {
+			KUNIT_EXPECT_TRUE(test, RB_EMPTY_NODE(&entry->node));
+			KUNIT_EXPECT_NULL(test,
+				kgsl_mem_tree_test_find(t, entry->memdesc.gpuaddr));
+		}
+	}
+
+	/* Removing twice is a no-op */
+	kgsl_mem_entry_remove_gpuaddr(&t->entries[0]);
+	KUNIT_EXPECT_PTR_EQ(test,
+		kgsl_mem_tree_test_find(t, t->entries[1].memdesc.gpuaddr),
+		&t->entries[1]);
+
+	for (i = 1; i < t->count; i += 2)
+		kgsl_mem_entry_remove_gpuaddr(&t->entries[i]);
+
+	KUNIT_EXPECT_TRUE(test, RB_EMPTY_ROOT(&t->private.mem_tree.rb_root));
+}
+
+static void kgsl_mem_tree_test_insert_skip(struct kunit *test)
+{
+	struct kgsl_mem_tree_test *t = test->priv;
+	struct kgsl_mem_entry *entry = &t->entries[0];
+	u64 gpuaddr = entry->memdesc.gpuaddr;
+
+	/* An entry without an address yet, e.g. SVM before mmap, is skipped */
+	entry->memdesc.gpuaddr = 0;
+	kgsl_mem_entry_insert_gpuaddr(entry);
+	KUNIT_EXPECT_TRUE(test, RB_EMPTY_NODE(&entry->node));
+
+	entry->memdesc.gpuaddr = gpuaddr;
+	kgsl_mem_entry_insert_gpuaddr(entry);
+	KUNIT_EXPECT_FALSE(test, RB_EMPTY_NODE(&entry->node));
+
+	/* A second insert, e.g. commit after the SVM mmap, is a no-op */
+	kgsl_mem_entry_insert_gpuaddr(entry);
+	kgsl_mem_entry_remove_gpuaddr(entry);
+	KUNIT_EXPECT_TRUE(test, RB_EMPTY_ROOT(&t->private.mem_tree.rb_root));
+}
+
+static struct kunit_case kgsl_mem_tree_test_cases[] = {
+	KUNIT_CASE(kgsl_mem_tree_test_bounds),
+	KUNIT_CASE(kgsl_mem_tree_test_matches_linear),
+	KUNIT_CASE(kgsl_mem_tree_test_remove),
+	KUNIT_CASE(kgsl_mem_tree_test_insert_skip),
+	{}
+};
+
+static struct kunit_suite kgsl_mem_tree_test_suite = {
+	.name = "kgsl_mem_tree",
+	.init = kgsl_mem_tree_test_init,
+	.test_cases = kgsl_mem_tree_test_cases,
+};
+
+kunit_test_suite(kgsl_mem_tree_test_suite);
@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/*
+ * KUnit tests of the order process reclaim picks entries in. Included at
+ * the end of kgsl_reclaim.c so that they run against the static candidate
+ * selection. The test holds the first reference of every entry so the
+ * candidate references never free them.
+ */
+
+#include <kunit/test.h>
+
+#define KGSL_RECLAIM_TEST_ENTRIES (3 * KGSL_RECLAIM_CANDIDATES)
+
+struct kgsl_reclaim_test {
+	struct kgsl_process_private process;
+	struct kgsl_mem_entry *entries;
+	struct kgsl_reclaim_candidate *candidates;
+	int count;
+};
+
+static int kgsl_reclaim_test_init(struct kunit *test)
+{
+	struct kgsl_reclaim_test *t;
+	int i;
+
+	t = kunit_kzalloc(test, sizeof(*t), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, t);
+
+	t->count = KGSL_RECLAIM_TEST_ENTRIES;
+	t->entries = kunit_kcalloc(test, t->count, sizeof(*t->entries),
+		GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, t->entries);
+
+	t->candidates = kunit_kcalloc(test, KGSL_RECLAIM_CANDIDATES,
+		sizeof(*t->candidates), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, t->candidates);
+
+	spin_lock_init(&t->process.mem_lock);
+	idr_init(&t->process.mem_idr);
+
+	/* Ids follow the array index, last_used is set by each case */
+	for (i = 0; i < t->count; i++) {
+		struct kgsl_mem_entry *entry = &t->entries[i];
+
+		kref_init(&entry->refcount);
+		entry->priv = &t->process;
+		entry->memdesc.priv = KGSL_MEMDESC_CAN_RECLAIM;
+		entry->memdesc.page_count = 1;
+
+		KUNIT_ASSERT_EQ(test, idr_alloc(&t->process.mem_idr, entry,
+			i + 1, i + 2, GFP_KERNEL), i + 1);
+	}
+
+	test->priv = t;
+	return 0;
+}
+
+static void kgsl_reclaim_test_exit(struct kunit *test)
+{
+	struct kgsl_reclaim_test *t = test->priv;
+
+	idr_destroy(&t->process.mem_idr);
+}
+
+/* Drop the candidate references and check that none were leaked */
+static void kgsl_reclaim_test_put(struct kunit *test, u32 count)
+{
+	struct kgsl_reclaim_test *t = test->priv;
+	int i;
+
+	for (i = 0; i < count; i++)
+		kgsl_mem_entry_put(t->candidates[i].entry);
+
+	for (i = 0; i < t->count; i++)
+		KUNIT_EXPECT_EQ(test, kref_read(&t->entries[i].refcount), 1);
+}
+
+static u32 kgsl_reclaim_test_coldest(struct kunit *test, int nr)
+{
+	struct kgsl_reclaim_test *t = test->priv;
+	u32 next = 0, count;
+	int i;
+
+	/* Hide the entries past nr from the walk */
+	for (i = nr; i < t->count; i++)
+		t->entries[i].memdesc.priv = 0;
+
+	count = kgsl_reclaim_get_candidates(&t->process, t->candidates,
+		KGSL_RECLAIM_CANDIDATES, true, &next);
+
+	for (i = 0; i < count; i++)
+		KUNIT_EXPECT_EQ(test,
+			kref_read(&t->candidates[i].entry->refcount), 2);
+
+	return count;
+}
+
+/* Check the coldest entries come back oldest first with a scrambled age */
+static void kgsl_reclaim_test_order(struct kunit *test, unsigned long base)
+{
+	struct kgsl_reclaim_test *t = test->priv;
+	u32 count;
+	int i;
+
+	/* 97 is coprime with the entry count, every age is used once */
+	for (i = 0; i < t->count; i++)
+		t->entries[i].last_used = base + (i * 97) % t->count;
+
+	count = kgsl_reclaim_test_coldest(test, t->count);
+	KUNIT_ASSERT_EQ(test, count, KGSL_RECLAIM_CANDIDATES);
+
+	for (i = 0; i < count; i++) {
+		KUNIT_EXPECT_EQ(test, t->candidates[i].last_used, base + i);
+		KUNIT_EXPECT_EQ(test, t->candidates[i].entry->last_used,
+			base + i);
+	}
+
+	kgsl_reclaim_test_put(test, count);
+}
+
+static void kgsl_reclaim_test_coldest_first(struct kunit *test)
+{
+	kgsl_reclaim_test_order(test, 1000);
+}
+
+static void kgsl_reclaim_test_wraparound(struct kunit *test)
+{
+	/* Half of the entries were used before jiffies wrapped */
+	kgsl_reclaim_test_order(test, ULONG_MAX - KGSL_RECLAIM_TEST_ENTRIES / 2);
+}
+
+static void kgsl_reclaim_test_few(struct kunit *test)
+{
+	struct kgsl_reclaim_test *t = test->priv;
+	u32 count;
+	int i;
+
+	/* Fewer entries than slots are all taken and sorted */
+	for (i = 0; i < 10; i++)
+		t->entries[i].last_used = 100 - i;
+
+	count = kgsl_reclaim_test_coldest(test, 10);
+	KUNIT_ASSERT_EQ(test, count, 10);
+
+	for (i = 0; i < count; i++)
+		KUNIT_EXPECT_PTR_EQ(test, t->candidates[i].entry,
+			&t->entries[9 - i]);
+
+	kgsl_reclaim_test_put(test, count);
+}
+
+static void kgsl_reclaim_test_skip(struct kunit *test)
+{
+	struct kgsl_reclaim_test *t = test->priv;
+	u32 count;
+	int i;
+
+	for (i = 0; i < 10; i++)
+		t->entries[i].last_used = 100 + i;
+
+	/* The coldest entries are all ineligible */
+	t->entries[0].pending_free = 1;
+	t->entries[1].memdesc.priv |= KGSL_MEMDESC_RECLAIMED;
+	t->entries[2].memdesc.priv |= KGSL_MEMDESC_SKIP_RECLAIM;
+	t->entries[3].memdesc.priv = 0;
+	atomic_set(&t->entries[4].vbo_count, 1);
+	t->entries[5].last_used = 0;
+
+	count = kgsl_reclaim_test_coldest(test, 10);
+	KUNIT_ASSERT_EQ(test, count, 4);
+
+	for (i = 0; i < count; i++)
+		KUNIT_EXPECT_PTR_EQ(test, t->candidates[i].entry,
+			&t->entries[6 + i]);
+
+	kgsl_reclaim_test_put(test, count);
+}
+
+static void kgsl_reclaim_test_id_order(struct kunit *test)
+{
+	struct kgsl_reclaim_test *t = test->priv;
+	u32 next = 0, count;
+	int i;
+
+	/* Without the candidate array reclaim falls back to id order */
+	for (i = 0; i < t->count; i++)
+		t->entries[i].last_used = t->count - i;
+
+	t->entries[1].memdesc.priv |= KGSL_MEMDESC_RECLAIMED;
+
+	for (i = 0; i < t->count; i++) {
+		if (i == 1)
+			continue;
+
+		count = kgsl_reclaim_get_candidates(&t->process,
+			t->candidates, 1, false, &next);
+		KUNIT_ASSERT_EQ(test, count, 1);
+		KUNIT_EXPECT_PTR_EQ(test, t->candidates[0].entry,
+			&t->entries[i]);
+		KUNIT_EXPECT_EQ(test, next, i + 2);
+		kgsl_mem_entry_put(t->candidates[0].entry);
+	}
+
+	count = kgsl_reclaim_get_candidates(&t->process, t->candidates, 1,
+		false, &next);
+	KUNIT_EXPECT_EQ(test, count, 0);
+
+	kgsl_reclaim_test_put(test, 0);
+}
+
+static struct kunit_case kgsl_reclaim_test_cases[] = {
+	KUNIT_CASE(kgsl_reclaim_test_coldest_first),
+	KUNIT_CASE(kgsl_reclaim_test_wraparound),
+	KUNIT_CASE(kgsl_reclaim_test_few),
+	KUNIT_CASE(kgsl_reclaim_test_skip),
+	KUNIT_CASE(kgsl_reclaim_test_id_order),
+	{}
+};
+
+static struct kunit_suite kgsl_reclaim_test_suite = {
+	.name = "kgsl_reclaim",
+	.init = kgsl_reclaim_test_init,
+	.exit = kgsl_reclaim_test_exit,
+	.test_cases = kgsl_reclaim_test_cases,
+};
+
+kunit_test_suite(kgsl_reclaim_test_suite);
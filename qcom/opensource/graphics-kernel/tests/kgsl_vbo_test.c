@@ -0,0 +1,607 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/*
+ * KUnit tests of VBO bind operations. Included at the end of kgsl_vbo.c.
+ *
+ * kgsl_vbo_batch checks the batched TLB invalidation. The ranges are bound
+ * into a fake pagetable whose ops log every unmap, invalidation and map,
+ * and the log is checked for break before make: nothing may be mapped into
+ * a range that was unmapped without an invalidation in between.
+ *
+ * kgsl_vbo_coalesce checks the merging of the ranges of a bind operation
+ * and that the child references of the merged ranges are dropped.
+ */
+
+#include <kunit/test.h>
+
+#define KGSL_VBO_TEST_BASE 0x200000ULL
+#define KGSL_VBO_TEST_PAGES 64
+#define KGSL_VBO_TEST_CHILDREN 4
+#define KGSL_VBO_TEST_MAX_STALE 64
+
+struct kgsl_vbo_test_stale {
+	u64 start;
+	u64 last;
+};
+
+struct kgsl_vbo_test {
+	struct kunit *test;
+	struct kgsl_pagetable pt;
+	struct kgsl_mem_entry target;
+	struct kgsl_mem_entry children[KGSL_VBO_TEST_CHILDREN];
+	/* Ranges unmapped since the last invalidation */
+	struct kgsl_vbo_test_stale stale[KGSL_VBO_TEST_MAX_STALE];
+	int nr_stale;
+	int unmaps;
+	int flushes;
+	int maps;
+};
+
+static struct kgsl_vbo_test *to_vbo_test(struct kgsl_pagetable *pt)
+{
+	return container_of(pt, struct kgsl_vbo_test, pt);
+}
+
+static void kgsl_vbo_test_check_map(struct kgsl_vbo_test *t, u64 offset,
+		u64 length)
+{
+	u64 last = offset + length - 1;
+	int i;
+
+	t->maps++;
+
+	for (i = 0; i < t->nr_stale; i++)
+		if (offset <= t->stale[i].last && last >= t->stale[i].start)
+			KUNIT_FAIL(t->test,
+				"map 0x%llx-0x%llx over 0x%llx-0x%llx before the TLB invalidation",
+				offset, last, t->stale[i].start,
+				t->stale[i].last);
+}
+
+static int kgsl_vbo_test_unmap_noflush(struct kgsl_pagetable *pt,
+		struct kgsl_memdesc *memdesc, u64 offset, u64 length)
+{
+	struct kgsl_vbo_test *t = to_vbo_test(pt);
+
+	KUNIT_ASSERT_LT(t->test, t->nr_stale, KGSL_VBO_TEST_MAX_STALE);
+
+	t->stale[t->nr_stale].start = offset;
+	t->stale[t->nr_stale].last = offset + length - 1;
+	t->nr_stale++;
+	t->unmaps++;
+	return 0;
+}
+
+static void kgsl_vbo_test_flush_tlb(struct kgsl_pagetable *pt)
+{
+	struct kgsl_vbo_test *t = to_vbo_test(pt);
+
+	t->nr_stale = 0;
+	t->flushes++;
+}
+
+static int kgsl_vbo_test_map_child(struct kgsl_pagetable *pt,
+		struct kgsl_memdesc *memdesc, u64 offset,
+		struct kgsl_memdesc *child, u64 child_offset, u64 length)
+{
+	kgsl_vbo_test_check_map(to_vbo_test(pt), offset, length);
+	return 0;
+}
+
+static int kgsl_vbo_test_map_zero_page_to_range(struct kgsl_pagetable *pt,
+		struct kgsl_memdesc *memdesc, u64 start, u64 length)
+{
+	kgsl_vbo_test_check_map(to_vbo_test(pt), start, length);
+	return 0;
+}
+
+static const struct kgsl_mmu_pt_ops kgsl_vbo_test_pt_ops = {
+	.mmu_map_child = kgsl_vbo_test_map_child,
+	.mmu_map_zero_page_to_range = kgsl_vbo_test_map_zero_page_to_range,
+	.mmu_unmap_noflush = kgsl_vbo_test_unmap_noflush,
+	.mmu_flush_tlb = kgsl_vbo_test_flush_tlb,
+};
+
+static int kgsl_vbo_test_init(struct kunit *test)
+{
+	struct kgsl_vbo_test *t;
+	int i;
+
+	t = kunit_kzalloc(test, sizeof(*t), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, t);
+
+	t->test = test;
+	t->pt.pt_ops = &kgsl_vbo_test_pt_ops;
+
+	t->target.id = 1;
+	t->target.memdesc.flags = KGSL_MEMFLAGS_VBO;
+	t->target.memdesc.gpuaddr = KGSL_VBO_TEST_BASE;
+	t->target.memdesc.size = KGSL_VBO_TEST_PAGES * PAGE_SIZE;
+	t->target.memdesc.pagetable = &t->pt;
+	t->target.memdesc.ranges = RB_ROOT_CACHED;
+	mutex_init(&t->target.memdesc.ranges_lock);
+
+	/* The test keeps a reference so the bind ranges never free a child */
+	for (i = 0; i < KGSL_VBO_TEST_CHILDREN; i++) {
+		struct kgsl_mem_entry *child = &t->children[i];
+
+		child->id = i + 2;
+		child->memdesc.size = KGSL_VBO_TEST_PAGES * PAGE_SIZE;
+		kref_init(&child->refcount);
+	}
+
+	test->priv = t;
+	return 0;
+}
+
+static void kgsl_vbo_test_exit(struct kunit *test)
+{
+	struct kgsl_vbo_test *t = test->priv;
+	struct kgsl_mmu_batch batch;
+	LIST_HEAD(unmapped);
+	int i;
+
+	kgsl_mmu_batch_start(&batch, &t->pt);
+	kgsl_memdesc_remove_range(&t->target, 0, ~0ULL, NULL, &batch,
+		&unmapped);
+	kgsl_mmu_batch_end(&batch);
+	bind_range_destroy_list(&unmapped);
+
+	for (i = 0; i < KGSL_VBO_TEST_CHILDREN; i++)
+		KUNIT_EXPECT_EQ(test, atomic_read(&t->children[i].vbo_count), 0);
+}
+
+static void kgsl_vbo_test_reset(struct kgsl_vbo_test *t)
+{
+	t->nr_stale = 0;
+	t->unmaps = 0;
+	t->flushes = 0;
+	t->maps = 0;
+}
+
+/* Bind a page range of the target to a child as one op */
+static void kgsl_vbo_test_bind(struct kgsl_vbo_test *t, int child,
+		u64 first_page, u64 nr_pages)
+{
+	struct kgsl_mmu_batch batch;
+	LIST_HEAD(unmapped);
+	int ret;
+
+	kgsl_mmu_batch_start(&batch, &t->pt);
+	ret = kgsl_memdesc_add_range(&t->target, first_page * PAGE_SIZE,
+		(first_page + nr_pages) * PAGE_SIZE - 1, &t->children[child],
+		0, &batch, &unmapped);
+	kgsl_mmu_batch_end(&batch);
+	bind_range_destroy_list(&unmapped);
+
+	KUNIT_EXPECT_EQ(t->test, ret, 0);
+}
+
+static void kgsl_vbo_test_bind_over_zero(struct kunit *test)
+{
+	struct kgsl_vbo_test *t = test->priv;
+
+	/* The range is unmapped from the zero page and remapped in place */
+	kgsl_vbo_test_bind(t, 0, 4, 8);
+
+	KUNIT_EXPECT_EQ(test, t->unmaps, 1);
+	KUNIT_EXPECT_EQ(test, t->maps, 1);
+	KUNIT_EXPECT_EQ(test, t->flushes, 1);
+	KUNIT_EXPECT_EQ(test, t->nr_stale, 0);
+}
+
+static void kgsl_vbo_test_rebind(struct kunit *test)
+{
+	struct kgsl_vbo_test *t = test->priv;
+
+	t->target.memdesc.flags |= KGSL_MEMFLAGS_VBO_NO_MAP_ZERO;
+
+	kgsl_vbo_test_bind(t, 0, 0, 8);
+	kgsl_vbo_test_bind(t, 1, 16, 8);
+	kgsl_vbo_test_reset(t);
+
+	/* Overlaps the end of the first range and the start of the second */
+	kgsl_vbo_test_bind(t, 2, 4, 16);
+
+	KUNIT_EXPECT_EQ(test, t->unmaps, 2);
+	KUNIT_EXPECT_EQ(test, t->maps, 1);
+	KUNIT_EXPECT_EQ(test, t->flushes, 1);
+
+	/* Splits the new range in two */
+	kgsl_vbo_test_reset(t);
+	kgsl_vbo_test_bind(t, 3, 8, 2);
+
+	KUNIT_EXPECT_EQ(test, t->unmaps, 1);
+	KUNIT_EXPECT_EQ(test, t->maps, 1);
+	KUNIT_EXPECT_EQ(test, t->flushes, 1);
+}
+
+static void kgsl_vbo_test_unbind_zero(struct kunit *test)
+{
+	struct kgsl_vbo_test *t = test->priv;
+	struct kgsl_mmu_batch batch;
+	LIST_HEAD(unmapped);
+	int i;
+
+	for (i = 0; i < KGSL_VBO_TEST_CHILDREN; i++)
+		kgsl_vbo_test_bind(t, i, i * 8, 4);
+	kgsl_vbo_test_reset(t);
+
+	/* The zero page goes back only after a single invalidation */
+	kgsl_mmu_batch_start(&batch, &t->pt);
+	kgsl_memdesc_remove_range(&t->target, 0, KGSL_VBO_TEST_PAGES *
+		PAGE_SIZE - 1, NULL, &batch, &unmapped);
+
+	KUNIT_EXPECT_EQ(test, t->unmaps, KGSL_VBO_TEST_CHILDREN);
+	KUNIT_EXPECT_EQ(test, t->maps, KGSL_VBO_TEST_CHILDREN);
+	KUNIT_EXPECT_EQ(test, t->flushes, 1);
+
+	/* The children stay referenced until the batch is over */
+	for (i = 0; i < KGSL_VBO_TEST_CHILDREN; i++)
+		KUNIT_EXPECT_EQ(test, atomic_read(&t->children[i].vbo_count), 1);
+
+	kgsl_mmu_batch_end(&batch);
+	bind_range_destroy_list(&unmapped);
+
+	KUNIT_EXPECT_EQ(test, t->flushes, 1);
+}
+
+static void kgsl_vbo_test_unbind_gathered(struct kunit *test)
+{
+	struct kgsl_vbo_test *t = test->priv;
+	struct kgsl_mmu_batch batch;
+	LIST_HEAD(unmapped);
+	int i;
+
+	t->target.memdesc.flags |= KGSL_MEMFLAGS_VBO_NO_MAP_ZERO;
+
+	for (i = 0; i < KGSL_VBO_TEST_CHILDREN; i++)
+		kgsl_vbo_test_bind(t, i, i * 8, 4);
+	kgsl_vbo_test_reset(t);
+
+	/* Pure unmaps, one op per child, share the invalidation at the end */
+	kgsl_mmu_batch_start(&batch, &t->pt);
+	for (i = 0; i < KGSL_VBO_TEST_CHILDREN; i++)
+		kgsl_memdesc_remove_range(&t->target, i * 8 * PAGE_SIZE,
+			(i * 8 + 4) * PAGE_SIZE - 1, &t->children[i], &batch,
+			&unmapped);
+
+	KUNIT_EXPECT_EQ(test, t->unmaps, KGSL_VBO_TEST_CHILDREN);
+	KUNIT_EXPECT_EQ(test, t->flushes, 0);
+
+	kgsl_mmu_batch_end(&batch);
+	bind_range_destroy_list(&unmapped);
+
+	KUNIT_EXPECT_EQ(test, t->flushes, 1);
+	KUNIT_EXPECT_EQ(test, t->maps, 0);
+}
+
+static void kgsl_vbo_test_unbind_then_bind(struct kunit *test)
+{
+	struct kgsl_vbo_test *t = test->priv;
+	struct kgsl_mmu_batch batch;
+	LIST_HEAD(unmapped);
+	int ret;
+
+	t->target.memdesc.flags |= KGSL_MEMFLAGS_VBO_NO_MAP_ZERO;
+
+	kgsl_vbo_test_bind(t, 0, 0, 8);
+	kgsl_vbo_test_reset(t);
+
+	/* An unbind and a bind of the same range in one op */
+	kgsl_mmu_batch_start(&batch, &t->pt);
+	kgsl_memdesc_remove_range(&t->target, 0, 8 * PAGE_SIZE - 1,
+		&t->children[0], &batch, &unmapped);
+	ret = kgsl_memdesc_add_range(&t->target, 0, 8 * PAGE_SIZE - 1,
+		&t->children[1], 0, &batch, &unmapped);
+	kgsl_mmu_batch_end(&batch);
+	bind_range_destroy_list(&unmapped);
+
+	KUNIT_EXPECT_EQ(test, ret, 0);
+	KUNIT_EXPECT_EQ(test, t->maps, 1);
+	KUNIT_EXPECT_EQ(test, t->flushes, 1);
+}
+
+static struct kunit_case kgsl_vbo_test_cases[] = {
+	KUNIT_CASE(kgsl_vbo_test_bind_over_zero),
+	KUNIT_CASE(kgsl_vbo_test_rebind),
+	KUNIT_CASE(kgsl_vbo_test_unbind_zero),
+	KUNIT_CASE(kgsl_vbo_test_unbind_gathered),
+	KUNIT_CASE(kgsl_vbo_test_unbind_then_bind),
+	{}
+};
+
+static struct kunit_suite kgsl_vbo_test_suite = {
+	.name = "kgsl_vbo_batch",
+	.init = kgsl_vbo_test_init,
+	.exit = kgsl_vbo_test_exit,
+	.test_cases = kgsl_vbo_test_cases,
+};
+
+#define KGSL_VBO_COALESCE_TEST_MAX 32
+#define KGSL_VBO_COALESCE_TEST_UNBIND_ALL -1
+
+struct kgsl_vbo_coalesce_test {
+	struct kgsl_mem_entry children[KGSL_VBO_TEST_CHILDREN];
+	struct kgsl_sharedmem_bind_op op;
+	struct kgsl_sharedmem_bind_op_range ranges[KGSL_VBO_COALESCE_TEST_MAX];
+};
+
+static int kgsl_vbo_coalesce_test_init(struct kunit *test)
+{
+	struct kgsl_vbo_coalesce_test *t;
+	int i;
+
+	t = kunit_kzalloc(test, sizeof(*t), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, t);
+
+	/* The test keeps a reference so dropping a range never frees a child */
+	for (i = 0; i < KGSL_VBO_TEST_CHILDREN; i++) {
+		t->children[i].id = i + 2;
+		kref_init(&t->children[i].refcount);
+	}
+
+	t->op.ops = t->ranges;
+
+	test->priv = t;
+	return 0;
+}
+
+static void kgsl_vbo_coalesce_test_exit(struct kunit *test)
+{
+	struct kgsl_vbo_coalesce_test *t = test->priv;
+	int i;
+
+	/* Drop what the remaining ranges hold, nothing else may be left */
+	for (i = 0; i < t->op.nr_ops; i++) {
+		struct kgsl_mem_entry *entry = t->op.ops[i].entry;
+
+		if (entry) {
+			atomic_dec(&entry->vbo_count);
+			kgsl_mem_entry_put(entry);
+		}
+	}
+
+	for (i = 0; i < KGSL_VBO_TEST_CHILDREN; i++) {
+		KUNIT_EXPECT_EQ(test, kref_read(&t->children[i].refcount), 1);
+		KUNIT_EXPECT_EQ(test, atomic_read(&t->children[i].vbo_count), 0);
+	}
+}
+
+/*
+ * Append a range in pages to the op and take the child references the way
+ * kgsl_sharedmem_create_bind_op() does
+ */
+static void kgsl_vbo_coalesce_test_add(struct kunit *test, u32 opcode,
+		u64 first_page, u64 nr_pages, int child, u64 child_page)
+{
+	struct kgsl_vbo_coalesce_test *t = test->priv;
+	struct kgsl_sharedmem_bind_op_range *range;
+
+	KUNIT_ASSERT_LT(test, t->op.nr_ops, KGSL_VBO_COALESCE_TEST_MAX);
+
+	range = &t->op.ops[t->op.nr_ops++];
+	range->op = opcode;
+	range->start = first_page * PAGE_SIZE;
+	range->last = (first_page + nr_pages) * PAGE_SIZE - 1;
+	range->child_offset = child_page * PAGE_SIZE;
+	range->entry = NULL;
+
+	if (child == KGSL_VBO_COALESCE_TEST_UNBIND_ALL)
+		return;
+
+	range->entry = kgsl_mem_entry_get(&t->children[child]);
+	atomic_inc(&range->entry->vbo_count);
+}
+
+static void kgsl_vbo_coalesce_test_expect(struct kunit *test, int i,
+		u32 opcode, u64 first_page, u64 nr_pages, int child,
+		u64 child_page)
+{
+	struct kgsl_vbo_coalesce_test *t = test->priv;
+	struct kgsl_sharedmem_bind_op_range *range = &t->op.ops[i];
+
+	KUNIT_EXPECT_EQ(test, range->op, opcode);
+	KUNIT_EXPECT_EQ(test, range->start, first_page * PAGE_SIZE);
+	KUNIT_EXPECT_EQ(test, range->last,
+		(first_page + nr_pages) * PAGE_SIZE - 1);
+	KUNIT_EXPECT_EQ(test, range->child_offset, child_page * PAGE_SIZE);
+
+	if (child == KGSL_VBO_COALESCE_TEST_UNBIND_ALL)
+		KUNIT_EXPECT_NULL(test, range->entry);
+	else
+		KUNIT_EXPECT_PTR_EQ(test, range->entry, &t->children[child]);
+}
+
+/* Check the references one child holds for the ranges that use it */
+static void kgsl_vbo_coalesce_test_refs(struct kunit *test, int child,
+		int nr_ranges)
+{
+	struct kgsl_vbo_coalesce_test *t = test->priv;
+
+	KUNIT_EXPECT_EQ(test, kref_read(&t->children[child].refcount),
+		nr_ranges + 1);
+	KUNIT_EXPECT_EQ(test, atomic_read(&t->children[child].vbo_count),
+		nr_ranges);
+}
+
+static void kgsl_vbo_coalesce_test_adjacent(struct kunit *test)
+{
+	struct kgsl_vbo_coalesce_test *t = test->priv;
+	int i;
+
+	/* A page at a time, the way sparse resources are streamed in */
+	for (i = 0; i < 16; i++)
+		kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+			i, 1, 0, 32 + i);
+
+	kgsl_sharedmem_coalesce_bind_op(&t->op);
+
+	KUNIT_ASSERT_EQ(test, t->op.nr_ops, 1);
+	kgsl_vbo_coalesce_test_expect(test, 0, KGSL_GPUMEM_RANGE_OP_BIND,
+		0, 16, 0, 32);
+	kgsl_vbo_coalesce_test_refs(test, 0, 1);
+}
+
+static void kgsl_vbo_coalesce_test_overlap(struct kunit *test)
+{
+	struct kgsl_vbo_coalesce_test *t = test->priv;
+
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+		0, 8, 0, 0);
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+		4, 8, 0, 4);
+	/* Contained in the merged range */
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+		2, 2, 0, 2);
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		20, 8, 1, 0);
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		24, 8, 1, 0);
+
+	kgsl_sharedmem_coalesce_bind_op(&t->op);
+
+	KUNIT_ASSERT_EQ(test, t->op.nr_ops, 2);
+	kgsl_vbo_coalesce_test_expect(test, 0, KGSL_GPUMEM_RANGE_OP_BIND,
+		0, 12, 0, 0);
+	kgsl_vbo_coalesce_test_expect(test, 1, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		20, 12, 1, 0);
+	kgsl_vbo_coalesce_test_refs(test, 0, 1);
+	kgsl_vbo_coalesce_test_refs(test, 1, 1);
+}
+
+static void kgsl_vbo_coalesce_test_reversed(struct kunit *test)
+{
+	struct kgsl_vbo_coalesce_test *t = test->priv;
+
+	/* The merged range starts at the lowest one and its child offset */
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+		8, 4, 2, 12);
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+		4, 4, 2, 8);
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+		0, 4, 2, 4);
+
+	kgsl_sharedmem_coalesce_bind_op(&t->op);
+
+	KUNIT_ASSERT_EQ(test, t->op.nr_ops, 1);
+	kgsl_vbo_coalesce_test_expect(test, 0, KGSL_GPUMEM_RANGE_OP_BIND,
+		0, 12, 2, 4);
+	kgsl_vbo_coalesce_test_refs(test, 2, 1);
+}
+
+static void kgsl_vbo_coalesce_test_no_merge(struct kunit *test)
+{
+	struct kgsl_vbo_coalesce_test *t = test->priv;
+
+	/* Adjacent in the target but not in the child */
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+		0, 4, 0, 0);
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+		4, 4, 0, 0);
+	/* Another child */
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+		8, 4, 1, 8);
+	/* Another operation on the same child */
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		12, 4, 1, 0);
+	/* A gap in the target */
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		17, 4, 1, 0);
+
+	kgsl_sharedmem_coalesce_bind_op(&t->op);
+
+	KUNIT_ASSERT_EQ(test, t->op.nr_ops, 5);
+	kgsl_vbo_coalesce_test_expect(test, 0, KGSL_GPUMEM_RANGE_OP_BIND,
+		0, 4, 0, 0);
+	kgsl_vbo_coalesce_test_expect(test, 1, KGSL_GPUMEM_RANGE_OP_BIND,
+		4, 4, 0, 0);
+	kgsl_vbo_coalesce_test_expect(test, 2, KGSL_GPUMEM_RANGE_OP_BIND,
+		8, 4, 1, 8);
+	kgsl_vbo_coalesce_test_expect(test, 3, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		12, 4, 1, 0);
+	kgsl_vbo_coalesce_test_expect(test, 4, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		17, 4, 1, 0);
+	kgsl_vbo_coalesce_test_refs(test, 0, 2);
+	kgsl_vbo_coalesce_test_refs(test, 1, 3);
+}
+
+static void kgsl_vbo_coalesce_test_unbind_all(struct kunit *test)
+{
+	struct kgsl_vbo_coalesce_test *t = test->priv;
+
+	/* Unbinds without a child merge with each other only */
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		0, 4, KGSL_VBO_COALESCE_TEST_UNBIND_ALL, 0);
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		4, 4, KGSL_VBO_COALESCE_TEST_UNBIND_ALL, 0);
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		8, 4, 3, 0);
+	kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		12, 4, KGSL_VBO_COALESCE_TEST_UNBIND_ALL, 0);
+
+	kgsl_sharedmem_coalesce_bind_op(&t->op);
+
+	KUNIT_ASSERT_EQ(test, t->op.nr_ops, 3);
+	kgsl_vbo_coalesce_test_expect(test, 0, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		0, 8, KGSL_VBO_COALESCE_TEST_UNBIND_ALL, 0);
+	kgsl_vbo_coalesce_test_expect(test, 1, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		8, 4, 3, 0);
+	kgsl_vbo_coalesce_test_expect(test, 2, KGSL_GPUMEM_RANGE_OP_UNBIND,
+		12, 4, KGSL_VBO_COALESCE_TEST_UNBIND_ALL, 0);
+	kgsl_vbo_coalesce_test_refs(test, 3, 1);
+}
+
+static void kgsl_vbo_coalesce_test_refs_dropped(struct kunit *test)
+{
+	struct kgsl_vbo_coalesce_test *t = test->priv;
+	int i;
+
+	/* Runs of two children, the runs are compacted to the front */
+	for (i = 0; i < 8; i++)
+		kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+			i, 1, 0, i);
+	for (i = 8; i < 16; i++)
+		kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+			i, 1, 1, i);
+	for (i = 16; i < 24; i++)
+		kgsl_vbo_coalesce_test_add(test, KGSL_GPUMEM_RANGE_OP_BIND,
+			i, 1, 0, i);
+
+	kgsl_vbo_coalesce_test_refs(test, 0, 16);
+	kgsl_vbo_coalesce_test_refs(test, 1, 8);
+
+	kgsl_sharedmem_coalesce_bind_op(&t->op);
+
+	KUNIT_ASSERT_EQ(test, t->op.nr_ops, 3);
+	kgsl_vbo_coalesce_test_expect(test, 0, KGSL_GPUMEM_RANGE_OP_BIND,
+		0, 8, 0, 0);
+	kgsl_vbo_coalesce_test_expect(test, 1, KGSL_GPUMEM_RANGE_OP_BIND,
+		8, 8, 1, 8);
+	kgsl_vbo_coalesce_test_expect(test, 2, KGSL_GPUMEM_RANGE_OP_BIND,
+		16, 8, 0, 16);
+	kgsl_vbo_coalesce_test_refs(test, 0, 2);
+	kgsl_vbo_coalesce_test_refs(test, 1, 1);
+}
+
+static struct kunit_case kgsl_vbo_coalesce_test_cases[] = {
+	KUNIT_CASE(kgsl_vbo_coalesce_test_adjacent),
+	KUNIT_CASE(kgsl_vbo_coalesce_test_overlap),
+	KUNIT_CASE(kgsl_vbo_coalesce_test_reversed),
+	KUNIT_CASE(kgsl_vbo_coalesce_test_no_merge),
+	KUNIT_CASE(kgsl_vbo_coalesce_test_unbind_all),
+	KUNIT_CASE(kgsl_vbo_coalesce_test_refs_dropped),
+	{}
+};
+
+static struct kunit_suite kgsl_vbo_coalesce_test_suite = {
+	.name = "kgsl_vbo_coalesce",
+	.init = kgsl_vbo_coalesce_test_init,
+	.exit = kgsl_vbo_coalesce_test_exit,
+	.test_cases = kgsl_vbo_coalesce_test_cases,
+};
+
+kunit_test_suites(&kgsl_vbo_test_suite, &kgsl_vbo_coalesce_test_suite);
@@ -0,0 +1,322 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/*
+ * Host side simulator for the frame aware DCVS mode of the msm-adreno-tz
+ * governor. It replays a frame trace through the governor policies and
+ * reports the GPU energy and the missed frame deadlines of each.
+ *
+ * Build: cc -O2 -I.. -o adreno_frame_dcvs_sim adreno_frame_dcvs_sim.c
+ *
+ * The trace has one line per frame: the time the end of frame command was
+ * queued in microseconds, the GPU busy time of the frame in microseconds
+ * and the GPU frequency in MHz the busy time was measured at. Lines
+ * starting with '#' are ignored. The energy is reported in microseconds
+ * busy at the power of the fastest level.
+ *
+ * The TZ policy runs in the secure world and is not available on the host,
+ * so the baseline is a utilization based stand-in that steps up above
+ * UTIL_UP percent busy and down below UTIL_DOWN percent busy.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "msm_adreno_frame_dcvs.h"
+
+/* Same as KGSL_GOVERNOR_CALL_INTERVAL, FLOOR and MIN_BUSY in the driver */
+#define WINDOW		10000
+#define FLOOR		5000
+#define MIN_BUSY	1000
+#define CEILING		50000
+
+/* Same as KGSL_FRAME_PERIOD_MAX in the driver */
+#define FRAME_PERIOD_MAX 100000
+
+#define UTIL_UP		85
+#define UTIL_DOWN	50
+
+#define MAX_LEVELS	32
+
+struct frame {
+	double queued;
+	double cycles;
+	double deadline;
+	unsigned int period;
+};
+
+struct result {
+	unsigned long frames;
+	unsigned long missed;
+	double energy;
+	double busy;
+	double freq_time;
+};
+
+static unsigned long freq_table[MAX_LEVELS] = {
+	900000000, 800000000, 680000000, 550000000,
+	450000000, 350000000, 260000000,
+};
+static int num_levels = 7;
+
+static int util_level(int level, double total, double busy)
+{
+	if (busy * 100 > total * UTIL_UP)
+		return level > 0 ? level - 1 : 0;
+
+	if (busy * 100 < total * UTIL_DOWN)
+		return level < num_levels - 1 ? level + 1 : level;
+
+	return level;
+}
+
+/* Dynamic power scales with f * V^2, with V roughly linear in f */
+static double power(int level)
+{
+	double f = (double)freq_table[level] / freq_table[0];
+
+	return f * f * f;
+}
+
+static void simulate(struct frame *frames, int count, bool frame_aware,
+		struct result *res)
+{
+	double now = frames[0].queued, bin_total = 0, bin_busy = 0;
+	double next_window = now + WINDOW;
+	unsigned int bin_frames = 0, bin_missed = 0, bin_period = 0;
+	uint64_t frame_cycles = 0;
+	int head = 0, queued = 0, level = num_levels - 1;
+	double remain = frames[0].cycles;
+
+	memset(res, 0, sizeof(*res));
+
+	while (head < count) {
+		double mhz = freq_table[level] / 1e6, next = next_window, dt;
+		bool done = false;
+
+		while (queued < count && frames[queued].queued <= now)
+			queued++;
+
+		if (queued < count && frames[queued].queued < next)
+			next = frames[queued].queued;
+
+		/* The GPU works on the oldest queued frame */
+		if (head < queued && now + remain / mhz <= next) {
+			next = now + remain / mhz;
+			done = true;
+		}
+
+		dt = next - now;
+		if (head < queued) {
+			remain -= dt * mhz;
+			bin_busy += dt;
+			res->busy += dt;
+			res->energy += dt * power(level);
+		}
+
+		bin_total += dt;
+		res->freq_time += dt * mhz;
+		now = next;
+
+		if (done) {
+			struct frame *f = &frames[head];
+
+			if (f->period) {
+				res->frames++;
+				bin_frames++;
+				if (now > f->deadline) {
+					res->missed++;
+					bin_missed++;
+				}
+				if (!bin_period || f->period < bin_period)
+					bin_period = f->period;
+			}
+
+			if (++head < count)
+				remain = frames[head].cycles;
+		}
+
+		if (now < next_window)
+			continue;
+
+		next_window += WINDOW;
+
+		if (bin_total < FLOOR || bin_busy < MIN_BUSY)
+			continue;
+
+		/* Same as the governor, wait for a frame to decide on */
+		if (frame_aware && !bin_frames &&
+				bin_total < MSM_ADRENO_FRAME_WINDOW_MAX)
+			continue;
+
+		if (bin_busy > CEILING) {
+			level = 0;
+		} else {
+			int frame_level = -1;
+
+			if (frame_aware)
+				frame_level = msm_adreno_frame_level(freq_table,
+					num_levels, level, (uint64_t)bin_busy,
+					bin_frames, bin_period, bin_missed,
+					&frame_cycles);
+
+			level = frame_level >= 0 ? frame_level :
+				util_level(level, bin_total, bin_busy);
+		}
+
+		bin_total = bin_busy = 0;
+		bin_frames = bin_missed = bin_period = 0;
+	}
+
+	res->freq_time /= now - frames[0].queued;
+}
+
+/* Derive the frame periods and deadlines the same way the driver does */
+static void frame_deadlines(struct frame *frames, int count)
+{
+	unsigned int period = 0;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		double delta = i ? frames[i].queued - frames[i - 1].queued : 0;
+
+		if (delta > 0 && delta < FRAME_PERIOD_MAX)
+			period = period ? (period * 7 + (unsigned int)delta) / 8 :
+				(unsigned int)delta;
+		else
+			period = 0;
+
+		frames[i].period = period;
+		frames[i].deadline = frames[i].queued + period;
+	}
+}
+
+static int parse_freqs(char *arg)
+{
+	char *tok;
+
+	num_levels = 0;
+	for (tok = strtok(arg, ","); tok; tok = strtok(NULL, ",")) {
+		if (num_levels == MAX_LEVELS)
+			return -1;
+		freq_table[num_levels++] = strtoul(tok, NULL, 0) * 1000000;
+	}
+
+	/* The driver orders the levels fastest first */
+	for (int i = 1; i < num_levels; i++)
+		if (freq_table[i] >= freq_table[i - 1])
+			return -1;
+
+	return num_levels ? 0 : -1;
+}
+
+static struct frame *read_trace(FILE *fp, int *count)
+{
+	struct frame *frames = NULL;
+	int size = 0;
+	char line[256];
+	double queued, busy, mhz;
+
+	*count = 0;
+	while (fgets(line, sizeof(line), fp)) {
+		if (line[0] == '#' || line[0] == '\n')
+			continue;
+
+		if (sscanf(line, "%lf %lf %lf", &queued, &busy, &mhz) != 3) {
+			fprintf(stderr, "bad trace line: %s", line);
+			free(frames);
+			return NULL;
+		}
+
+		if (*count == size) {
+			struct frame *tmp;
+
+			size = size ? size * 2 : 1024;
+			tmp = realloc(frames, size * sizeof(*frames));
+			if (!tmp) {
+				free(frames);
+				return NULL;
+			}
+			frames = tmp;
+		}
+
+		frames[*count].queued = queued;
+		frames[*count].cycles = busy * mhz;
+		(*count)++;
+	}
+
+	return frames;
+}
+
+static void print_result(const char *name, struct result *res)
+{
+	printf("%-8s frames %8lu missed %6lu (%5.2f%%) energy %12.0f busy %10.0fus avg %6.1fMHz\n",
+		name, res->frames, res->missed,
+		res->frames ? 100.0 * res->missed / res->frames : 0.0,
+		res->energy, res->busy, res->freq_time);
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+		"usage: %s [-f mhz,mhz,...] <trace>\n"
+		"  -f  GPU frequencies in MHz, fastest first\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+	struct result util, frame;
+	struct frame *frames;
+	int opt, count;
+	FILE *fp;
+
+	while ((opt = getopt(argc, argv, "f:h")) != -1) {
+		switch (opt) {
+		case 'f':
+			if (parse_freqs(optarg)) {
+				fprintf(stderr, "bad frequency list\n");
+				return 1;
+			}
+			break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind != argc - 1) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	fp = fopen(argv[optind], "r");
+	if (!fp) {
+		perror(argv[optind]);
+		return 1;
+	}
+
+	frames = read_trace(fp, &count);
+	fclose(fp);
+	if (!frames || !count) {
+		fprintf(stderr, "no frames in trace\n");
+		free(frames);
+		return 1;
+	}
+
+	frame_deadlines(frames, count);
+
+	simulate(frames, count, false, &util);
+	simulate(frames, count, true, &frame);
+
+	print_result("util", &util);
+	print_result("frame", &frame);
+
+	free(frames);
+	return 0;
+}
@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/*
+ * Consumer of the adreno perfcounter sampling ring. It enables sampling of
+ * the counters in profiling/assignments, maps profiling/samples and prints
+ * each sample as a CSV line: seq, time in ns and the counter values.
+ *
+ * Build: cc -O2 -I.. -o adreno_profile_sample adreno_profile_sample.c
+ *
+ * Every sample is checked against the ordering and overflow accounting
+ * rules of adreno_profile_ring.h. With -t it runs as a selftest instead:
+ * it consumes for a while, stops consuming until the ring overflows and
+ * then checks that the dropped samples show up as seq gaps. The GPU has to
+ * be busy for the selftest as no samples are taken while it is off.
+ */
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "adreno_profile_ring.h"
+
+#define DEFAULT_DIR	"/sys/kernel/debug/kgsl/kgsl-3d0/profiling"
+#define DEFAULT_PERIOD	1000
+
+struct consumer {
+	struct adreno_profile_ring *ring;
+	size_t size;
+	uint64_t consumed;
+	uint64_t last_seq;
+	uint64_t last_time;
+	uint64_t gaps;
+	uint64_t limit;
+	bool quiet;
+	int errors;
+};
+
+static int write_period(const char *dir, unsigned int period)
+{
+	char path[256], val[16];
+	int fd, len, ret = 0;
+
+	snprintf(path, sizeof(path), "%s/sample_period", dir);
+	fd = open(path, O_WRONLY);
+	if (fd < 0) {
+		perror(path);
+		return -1;
+	}
+
+	len = snprintf(val, sizeof(val), "%u\n", period);
+	if (write(fd, val, len) != len) {
+		perror(path);
+		ret = -1;
+	}
+
+	close(fd);
+	return ret;
+}
+
+static int map_ring(const char *dir, struct consumer *c)
+{
+	struct adreno_profile_ring *ring;
+	char path[256];
+	int fd;
+
+	snprintf(path, sizeof(path), "%s/samples", dir);
+	fd = open(path, O_RDWR);
+	if (fd < 0) {
+		perror(path);
+		return -1;
+	}
+
+	/* Map the header first to find the size of the ring */
+	ring = mmap(NULL, sizeof(*ring), PROT_READ, MAP_SHARED, fd, 0);
+	if (ring == MAP_FAILED) {
+		perror("mmap");
+		close(fd);
+		return -1;
+	}
+
+	if (ring->version != ADRENO_PROFILE_RING_VERSION) {
+		fprintf(stderr, "unknown ring version %u\n", ring->version);
+		munmap(ring, sizeof(*ring));
+		close(fd);
+		return -1;
+	}
+
+	c->size = ring->data_offset +
+		(size_t)ring->nr_samples * ring->sample_size;
+	munmap(ring, sizeof(*ring));
+
+	c->ring = mmap(NULL, c->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+		fd, 0);
+	close(fd);
+	if (c->ring == MAP_FAILED) {
+		perror("mmap");
+		return -1;
+	}
+
+	return 0;
+}
+
+static void check(struct consumer *c, bool cond, const char *fmt,
+		uint64_t a, uint64_t b)
+{
+	if (cond)
+		return;
+
+	fprintf(stderr, "error at sample %" PRIu64 ": ", c->consumed);
+	fprintf(stderr, fmt, a, b);
+	fputc('\n', stderr);
+	c->errors++;
+}
+
+/* Consume everything published so far, return the number of samples */
+static uint64_t drain(struct consumer *c)
+{
+	struct adreno_profile_ring *ring = c->ring;
+	uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	uint64_t dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+	uint64_t tail = ring->tail, count = 0;
+
+	check(c, head - tail <= ring->nr_samples,
+		"head %" PRIu64 " is past tail %" PRIu64 " by more than the ring",
+		head, tail);
+
+	for (; tail != head; tail++, count++) {
+		if (c->limit && c->consumed == c->limit)
+			break;
+
+		struct adreno_profile_sample *sample = (void *)ring +
+			ring->data_offset +
+			(tail & (ring->nr_samples - 1)) * ring->sample_size;
+		uint32_t i;
+
+		if (c->consumed) {
+			check(c, sample->seq > c->last_seq,
+				"seq %" PRIu64 " after %" PRIu64,
+				sample->seq, c->last_seq);
+			check(c, sample->time_ns >= c->last_time,
+				"time %" PRIu64 " before %" PRIu64,
+				sample->time_ns, c->last_time);
+			c->gaps += sample->seq - c->last_seq - 1;
+		} else {
+			c->gaps = sample->seq - tail;
+		}
+
+		/* Every gap must have been counted as dropped */
+		check(c, sample->seq - tail <= dropped,
+			"seq gaps %" PRIu64 " but only %" PRIu64 " dropped",
+			sample->seq - tail, dropped);
+
+		if (!c->quiet) {
+			printf("%" PRIu64 ",%" PRIu64, (uint64_t)sample->seq,
+				(uint64_t)sample->time_ns);
+			for (i = 0; i < ring->nr_counters; i++)
+				printf(",%" PRIu64,
+					(uint64_t)sample->values[i]);
+			putchar('\n');
+		}
+
+		c->last_seq = sample->seq;
+		c->last_time = sample->time_ns;
+		c->consumed++;
+	}
+
+	__atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+	return count;
+}
+
+static void print_header(struct consumer *c)
+{
+	struct adreno_profile_ring *ring = c->ring;
+	uint32_t i;
+
+	printf("seq,time_ns");
+	for (i = 0; i < ring->nr_counters; i++)
+		printf(",%u:%u", ring->counters[i].groupid,
+			ring->counters[i].countable);
+	putchar('\n');
+}
+
+static int selftest(const char *dir, struct consumer *c)
+{
+	struct adreno_profile_ring *ring = c->ring;
+	useconds_t period = ring->period_us;
+	uint64_t dropped, seq, head;
+	int i;
+
+	/* Keep up with the ring for a while */
+	for (i = 0; i < 100; i++) {
+		drain(c);
+		usleep(period * 10);
+	}
+
+	if (!c->consumed) {
+		fprintf(stderr, "no samples, is the GPU busy?\n");
+		return 1;
+	}
+
+	/* Stop consuming until the ring overflows */
+	usleep((useconds_t)ring->nr_samples * period * 2);
+
+	for (i = 0; i < 10; i++) {
+		drain(c);
+		usleep(period * 10);
+	}
+
+	/* Once sampling stopped every sample taken was written or dropped */
+	if (write_period(dir, 0))
+		return 1;
+
+	drain(c);
+
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	seq = __atomic_load_n(&ring->seq, __ATOMIC_RELAXED);
+	dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+
+	check(c, seq == head + dropped,
+		"seq %" PRIu64 " isn't head plus %" PRIu64 " dropped",
+		seq, dropped);
+
+	/* Samples dropped after the last one written leave no gap */
+	c->gaps += seq - c->last_seq - 1;
+	check(c, c->gaps == dropped,
+		"seq gaps %" PRIu64 " don't match %" PRIu64 " dropped",
+		c->gaps, dropped);
+	check(c, dropped > 0,
+		"ring of %" PRIu64 " samples never overflowed in %" PRIu64
+		" samples", ring->nr_samples, seq);
+
+	printf("consumed %" PRIu64 " dropped %" PRIu64 " overruns %" PRIu64
+		": %s\n", c->consumed, dropped, (uint64_t)ring->overruns,
+		c->errors ? "FAIL" : "PASS");
+
+	return c->errors ? 1 : 0;
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+		"usage: %s [-d dir] [-p period_us] [-n samples] [-t]\n"
+		"  -d  profiling debugfs directory, default " DEFAULT_DIR "\n"
+		"  -p  sampling period in microseconds, default %u\n"
+		"  -n  stop after this many samples, default never\n"
+		"  -t  run the ordering and overflow selftest\n",
+		prog, DEFAULT_PERIOD);
+}
+
+int main(int argc, char **argv)
+{
+	const char *dir = DEFAULT_DIR;
+	unsigned int period = DEFAULT_PERIOD;
+	struct consumer c = { 0 };
+	bool test = false;
+	int opt, ret = 0;
+
+	while ((opt = getopt(argc, argv, "d:p:n:th")) != -1) {
+		switch (opt) {
+		case 'd':
+			dir = optarg;
+			break;
+		case 'p':
+			period = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			c.limit = strtoull(optarg, NULL, 0);
+			break;
+		case 't':
+			test = true;
+			break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (!period || optind != argc) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	if (write_period(dir, period))
+		return 1;
+
+	if (map_ring(dir, &c)) {
+		write_period(dir, 0);
+		return 1;
+	}
+
+	if (test) {
+		c.quiet = true;
+		ret = selftest(dir, &c);
+	} else {
+		print_header(&c);
+		while (!c.limit || c.consumed < c.limit) {
+			if (!drain(&c))
+				usleep(period * (c.ring->nr_samples / 4));
+			if (c.errors)
+				break;
+		}
+		ret = c.errors ? 1 : 0;
+	}
+
+	write_period(dir, 0);
+	munmap(c.ring, c.size);
+
+	return ret;
+}
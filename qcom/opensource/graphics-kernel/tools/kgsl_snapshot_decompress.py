@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-2.0-only
+# Copyright (c) 2024, Qualcomm Innovation Center, Inc. All rights reserved.
+
+"""Expand the compressed sections of a KGSL GPU snapshot.
+
+Snapshots taken with /sys/class/kgsl/kgsl-3d0/snapshot/snapshot_compress
+set store the frozen GPU objects as compressed sections. This rewrites such
+a snapshot with every compressed section replaced by the section it holds,
+so that it can be loaded by the existing snapshot parsers.
+
+With -t it runs a selftest instead: it compresses sections the way the
+driver does, expands them again and checks that the result matches.
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+SNAPSHOT_HEADER = struct.Struct('<III')
+GPU_OBJECT_V2_HEADER = struct.Struct('<iQQQ')
+SECTION_HEADER = struct.Struct('<HHI')
+COMPRESSED_HEADER = struct.Struct('<II')
+
+SNAPSHOT_MAGIC = 0x504D0002
+SNAPSHOT_SECTION_MAGIC = 0xABCD
+KGSL_SNAPSHOT_SECTION_GPU_OBJECT_V2 = 0x0B02
+KGSL_SNAPSHOT_SECTION_COMPRESSED = 0x1B01
+KGSL_SNAPSHOT_SECTION_END = 0xFFFF
+KGSL_SNAPSHOT_COMPRESS_ZLIB = 0x1
+
+
+def decompress_section(data, offset, size):
+    algo, raw_size = COMPRESSED_HEADER.unpack_from(data,
+                                                   offset + SECTION_HEADER.size)
+    if algo != KGSL_SNAPSHOT_COMPRESS_ZLIB:
+        raise ValueError('unknown compression %#x at offset %#x' %
+                         (algo, offset))
+
+    start = offset + SECTION_HEADER.size + COMPRESSED_HEADER.size
+    raw = zlib.decompress(data[start:offset + size])
+    if len(raw) != raw_size:
+        raise ValueError('section at offset %#x is %d bytes, expected %d' %
+                         (offset, len(raw), raw_size))
+
+    magic, _, inner_size = SECTION_HEADER.unpack_from(raw)
+    if magic != SNAPSHOT_SECTION_MAGIC or inner_size != raw_size:
+        raise ValueError('bad compressed section at offset %#x' % offset)
+
+    return raw
+
+
+def decompress(data):
+    out = bytearray(data[:SNAPSHOT_HEADER.size])
+    offset = SNAPSHOT_HEADER.size
+
+    while offset + SECTION_HEADER.size <= len(data):
+        magic, sid, size = SECTION_HEADER.unpack_from(data, offset)
+        if magic != SNAPSHOT_SECTION_MAGIC or size < SECTION_HEADER.size:
+            raise ValueError('bad section header at offset %#x' % offset)
+
+        if sid == KGSL_SNAPSHOT_SECTION_COMPRESSED:
+            out += decompress_section(data, offset, size)
+        else:
+            out += data[offset:offset + size]
+
+        offset += size
+        if sid == KGSL_SNAPSHOT_SECTION_END:
+            break
+
+    return bytes(out)
+
+
+def gpu_object_section(gpuaddr, payload):
+    size = SECTION_HEADER.size + GPU_OBJECT_V2_HEADER.size + len(payload)
+    return (SECTION_HEADER.pack(SNAPSHOT_SECTION_MAGIC,
+                                KGSL_SNAPSHOT_SECTION_GPU_OBJECT_V2, size) +
+            GPU_OBJECT_V2_HEADER.pack(0, gpuaddr, 0, len(payload) >> 2) +
+            payload)
+
+
+def compressed_section(raw, chunk):
+    # Deflate the header and then the data in chunks like the driver does
+    strm = zlib.compressobj(1)
+    body = strm.compress(raw[:SECTION_HEADER.size + GPU_OBJECT_V2_HEADER.size])
+    for i in range(SECTION_HEADER.size + GPU_OBJECT_V2_HEADER.size, len(raw),
+                   chunk):
+        body += strm.compress(raw[i:i + chunk])
+    body += strm.flush()
+
+    size = SECTION_HEADER.size + COMPRESSED_HEADER.size + len(body)
+    return (SECTION_HEADER.pack(SNAPSHOT_SECTION_MAGIC,
+                                KGSL_SNAPSHOT_SECTION_COMPRESSED, size) +
+            COMPRESSED_HEADER.pack(KGSL_SNAPSHOT_COMPRESS_ZLIB, len(raw)) +
+            body)
+
+
+def selftest():
+    header = SNAPSHOT_HEADER.pack(SNAPSHOT_MAGIC, 0, 0)
+    end = SECTION_HEADER.pack(SNAPSHOT_SECTION_MAGIC,
+                              KGSL_SNAPSHOT_SECTION_END, SECTION_HEADER.size)
+
+    # An IB-like object that compresses well, one that doesn't and an
+    # empty one, the large one spans several deflate chunks
+    ib = struct.pack('<4I', 0x70268000, 0x40000000, 0x12345678, 0) * 8192
+    noise = bytes((i * 7919 + (i >> 5)) & 0xff for i in range(4096))
+    objects = [gpu_object_section(0x100000, ib),
+               gpu_object_section(0x200000, noise),
+               gpu_object_section(0x300000, b'')]
+
+    expected = header + b''.join(objects) + end
+    snapshot = (header + compressed_section(objects[0], 4096) + objects[1] +
+                compressed_section(objects[2], 4096) + end)
+
+    errors = 0
+    if decompress(snapshot) != expected:
+        print('round trip does not match', file=sys.stderr)
+        errors += 1
+
+    if len(snapshot) >= len(expected):
+        print('compressed snapshot is not smaller', file=sys.stderr)
+        errors += 1
+
+    # A section that expands to the wrong size must be rejected
+    bad = bytearray(snapshot)
+    COMPRESSED_HEADER.pack_into(bad, SNAPSHOT_HEADER.size +
+                                SECTION_HEADER.size,
+                                KGSL_SNAPSHOT_COMPRESS_ZLIB, len(ib))
+    try:
+        decompress(bytes(bad))
+        print('bad section size was not caught', file=sys.stderr)
+        errors += 1
+    except ValueError:
+        pass
+
+    print('%d bytes expanded to %d: %s' % (len(snapshot), len(expected),
+                                           'FAIL' if errors else 'PASS'))
+    return 1 if errors else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('input', nargs='?',
+                        help='snapshot read from snapshot/dump')
+    parser.add_argument('output', nargs='?', help='decompressed snapshot')
+    parser.add_argument('-t', '--selftest', action='store_true',
+                        help='run the compression round trip selftest')
+    args = parser.parse_args()
+
+    if args.selftest:
+        return selftest()
+
+    if not args.input or not args.output:
+        parser.error('input and output are required')
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    try:
+        out = decompress(data)
+    except (ValueError, struct.error, zlib.error) as e:
+        print('error: %s' % e, file=sys.stderr)
+        return 1
+
+    with open(args.output, 'wb') as f:
+        f.write(out)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
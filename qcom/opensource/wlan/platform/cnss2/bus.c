@@ -403,12 +403,20 @@ int cnss_bus_call_driver_remove(struct cnss_plat_data *plat_priv)
 
 int cnss_bus_dev_powerup(struct cnss_plat_data *plat_priv)
 {
+	int ret;
+
 	if (!plat_priv)
 		return -ENODEV;
 
 	switch (plat_priv->bus_type) {
 	case CNSS_BUS_PCI:
-		return cnss_pci_dev_powerup(plat_priv->bus_priv);
+		/* Read board independent files while the device powers up */
+		plat_priv->boot_start = ktime_get();
+		cnss_fw_prefetch_start(plat_priv, false);
+		ret = cnss_pci_dev_powerup(plat_priv->bus_priv);
+		cnss_boot_phase_done(plat_priv, CNSS_BOOT_PHASE_POWER_UP,
+				     plat_priv->boot_start, ret);
+		return ret;
 	default:
 		cnss_pr_err("Unsupported bus type: %d\n",
 			    plat_priv->bus_type);
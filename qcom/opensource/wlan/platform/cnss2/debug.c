@@ -869,6 +869,9 @@ static int cnss_show_quirks_state(struct seq_file *s,
 		case FORCE_ONE_MSI:
 			seq_puts(s, "FORCE_ONE_MSI");
 			continue;
+		case DISABLE_FW_FILE_CACHE:
+			seq_puts(s, "DISABLE_FW_FILE_CACHE");
+			continue;
 		default:
 			continue;
 		}
@@ -19,6 +19,7 @@
 #include <linux/timer.h>
 #include <linux/thermal.h>
 #include <linux/version.h>
+#include <linux/vmalloc.h>
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(5, 14, 0))
 #include <linux/panic_notifier.h>
 #endif
@@ -34,6 +35,9 @@
 #include "genl.h"
 #include "reg.h"
 
+#define CREATE_TRACE_POINTS
+#include "trace.h"
+
 #ifdef CONFIG_CNSS_HW_SECURE_DISABLE
 #ifdef CONFIG_CNSS_HW_SECURE_SMEM
 #include <linux/soc/qcom/smem.h>
@@ -1053,19 +1057,80 @@ static bool cnss_is_aux_support_enabled(struct cnss_plat_data *plat_priv)
 	return true;
 }
 
+static void cnss_fw_prefetch_work(struct work_struct *work)
+{
+	struct cnss_plat_data *plat_priv =
+		container_of(work, struct cnss_plat_data, fw_prefetch_work);
+
+	if (plat_priv->hds_enabled)
+		cnss_wlfw_bdf_prefetch(plat_priv, CNSS_BDF_HDS);
+
+	cnss_wlfw_bdf_prefetch(plat_priv, CNSS_BDF_REGDB);
+
+	/* Board files need the board info from target capability */
+	if (!READ_ONCE(plat_priv->fw_prefetch_board))
+		return;
+
+	cnss_wlfw_bdf_prefetch(plat_priv, plat_priv->ctrl_params.bdf_type);
+
+	if (plat_priv->device_id == QCN7605_DEVICE_ID)
+		return;
+
+	cnss_bus_load_m3(plat_priv);
+
+	if (cnss_is_aux_support_enabled(plat_priv))
+		cnss_bus_load_aux(plat_priv);
+}
+
+/**
+ * cnss_fw_prefetch_start() - Start reading firmware files in the background
+ * @plat_priv: Platform data structure
+ * @board: Also read board specific files and load M3/AUX images
+ *
+ * Board independent files are read while the device powers up. Board files
+ * and the M3/AUX images are read once target capability is known, while the
+ * board independent files are being downloaded. Every board stage must be
+ * followed by cnss_fw_prefetch_wait() before the event returns, since it
+ * fills in M3/AUX memory.
+ */
+void cnss_fw_prefetch_start(struct cnss_plat_data *plat_priv, bool board)
+{
+	if (test_bit(DISABLE_FW_FILE_CACHE, &plat_priv->ctrl_params.quirks))
+		return;
+
+	if (board)
+		WRITE_ONCE(plat_priv->fw_prefetch_board, true);
+
+	queue_work(system_unbound_wq, &plat_priv->fw_prefetch_work);
+}
+
+static void cnss_fw_prefetch_wait(struct cnss_plat_data *plat_priv)
+{
+	flush_work(&plat_priv->fw_prefetch_work);
+	WRITE_ONCE(plat_priv->fw_prefetch_board, false);
+}
+
 static int cnss_fw_mem_ready_hdlr(struct cnss_plat_data *plat_priv)
 {
+	ktime_t start, phase_start;
 	int ret = 0;
 
 	if (!plat_priv)
 		return -ENODEV;
 
 	set_bit(CNSS_FW_MEM_READY, &plat_priv->driver_state);
+	start = ktime_get();
 
 	ret = cnss_wlfw_tgt_cap_send_sync(plat_priv);
+	cnss_boot_phase_done(plat_priv, CNSS_BOOT_PHASE_TGT_CAP, start, ret);
 	if (ret)
 		goto out;
 
+	if (plat_priv->device_id == QCN7605_DEVICE_ID)
+		plat_priv->ctrl_params.bdf_type = CNSS_BDF_BIN;
+
+	cnss_fw_prefetch_start(plat_priv, true);
+
 	cnss_bus_load_tme_patch(plat_priv);
 
 	cnss_wlfw_tme_patch_dnld_send_sync(plat_priv,
@@ -1074,24 +1139,30 @@ static int cnss_fw_mem_ready_hdlr(struct cnss_plat_data *plat_priv)
 	if (plat_priv->hds_enabled)
 		cnss_wlfw_bdf_dnld_send_sync(plat_priv, CNSS_BDF_HDS);
 
-	cnss_wlfw_bdf_dnld_send_sync(plat_priv, CNSS_BDF_REGDB);
+	phase_start = ktime_get();
+	ret = cnss_wlfw_bdf_dnld_send_sync(plat_priv, CNSS_BDF_REGDB);
+	cnss_boot_phase_done(plat_priv, CNSS_BOOT_PHASE_REGDB_DNLD,
+			     phase_start, ret);
 
-	if (plat_priv->device_id == QCN7605_DEVICE_ID)
-		plat_priv->ctrl_params.bdf_type = CNSS_BDF_BIN;
+	cnss_fw_prefetch_wait(plat_priv);
 
+	phase_start = ktime_get();
 	ret = cnss_wlfw_bdf_dnld_send_sync(plat_priv,
 					   plat_priv->ctrl_params.bdf_type);
+	cnss_boot_phase_done(plat_priv, CNSS_BOOT_PHASE_BDF_DNLD,
+			     phase_start, ret);
 	if (ret)
 		goto out;
 
 	if (plat_priv->device_id == QCN7605_DEVICE_ID)
-		return 0;
-
-	ret = cnss_bus_load_m3(plat_priv);
-	if (ret)
 		goto out;
 
-	ret = cnss_wlfw_m3_dnld_send_sync(plat_priv);
+	phase_start = ktime_get();
+	ret = cnss_bus_load_m3(plat_priv);
+	if (!ret)
+		ret = cnss_wlfw_m3_dnld_send_sync(plat_priv);
+	cnss_boot_phase_done(plat_priv, CNSS_BOOT_PHASE_M3_DNLD,
+			     phase_start, ret);
 	if (ret)
 		goto out;
 
@@ -1107,8 +1178,9 @@ static int cnss_fw_mem_ready_hdlr(struct cnss_plat_data *plat_priv)
 
 	cnss_wlfw_qdss_dnld_send_sync(plat_priv);
 
-	return 0;
 out:
+	cnss_fw_prefetch_wait(plat_priv);
+	cnss_boot_phase_done(plat_priv, CNSS_BOOT_PHASE_FW_DNLD, start, ret);
 	return ret;
 }
 
@@ -1292,6 +1364,12 @@ static int cnss_fw_ready_hdlr(struct cnss_plat_data *plat_priv)
 	cnss_pr_dbg("Processing FW Init Done..\n");
 	del_timer(&plat_priv->fw_boot_timer);
 	set_bit(CNSS_FW_READY, &plat_priv->driver_state);
+
+	if (plat_priv->boot_start) {
+		cnss_boot_phase_done(plat_priv, CNSS_BOOT_PHASE_FW_READY,
+				     plat_priv->boot_start, 0);
+		plat_priv->boot_start = 0;
+	}
 	clear_bit(CNSS_DEV_ERR_NOTIFY, &plat_priv->driver_state);
 
 	cnss_wlfw_send_pcie_gen_speed_sync(plat_priv);
@@ -2879,6 +2957,7 @@ static void cnss_driver_event_work(struct work_struct *work)
 		container_of(work, struct cnss_plat_data, event_work);
 	struct cnss_driver_event *event;
 	unsigned long flags;
+	ktime_t start;
 	int ret = 0;
 
 	if (!plat_priv) {
@@ -2909,10 +2988,13 @@ static void cnss_driver_event_work(struct work_struct *work)
 			ret = cnss_wlfw_server_exit(plat_priv);
 			break;
 		case CNSS_DRIVER_EVENT_REQUEST_MEM:
+			start = ktime_get();
 			ret = cnss_bus_alloc_fw_mem(plat_priv);
-			if (ret)
-				break;
-			ret = cnss_wlfw_respond_mem_send_sync(plat_priv);
+			if (!ret)
+				ret = cnss_wlfw_respond_mem_send_sync(plat_priv);
+			cnss_boot_phase_done(plat_priv,
+					     CNSS_BOOT_PHASE_FW_MEM_ALLOC,
+					     start, ret);
 			break;
 		case CNSS_DRIVER_EVENT_FW_MEM_READY:
 			ret = cnss_fw_mem_ready_hdlr(plat_priv);
@@ -4112,6 +4194,215 @@ int cnss_request_firmware_direct(struct cnss_plat_data *plat_priv,
 					       &plat_priv->plat_dev->dev);
 }
 
+static const char *cnss_boot_phase_to_str(enum cnss_boot_phase phase)
+{
+	switch (phase) {
+	case CNSS_BOOT_PHASE_POWER_UP:
+		return "POWER_UP";
+	case CNSS_BOOT_PHASE_FW_MEM_ALLOC:
+		return "FW_MEM_ALLOC";
+	case CNSS_BOOT_PHASE_TGT_CAP:
+		return "TGT_CAP";
+	case CNSS_BOOT_PHASE_REGDB_DNLD:
+		return "REGDB_DNLD";
+	case CNSS_BOOT_PHASE_BDF_DNLD:
+		return "BDF_DNLD";
+	case CNSS_BOOT_PHASE_M3_DNLD:
+		return "M3_DNLD";
+	case CNSS_BOOT_PHASE_FW_DNLD:
+		return "FW_DNLD";
+	case CNSS_BOOT_PHASE_FW_READY:
+		return "FW_READY";
+	case CNSS_BOOT_PHASE_MAX:
+		return "MAX";
+	}
+
+	return "UNKNOWN";
+}
+
+/**
+ * cnss_boot_phase_done() - Report the duration of a boot phase
+ * @plat_priv: Platform data structure
+ * @phase: Boot phase which completed
+ * @start: ktime at which the phase started
+ * @ret: Result of the phase
+ *
+ * Emits the cnss2:cnss_boot_phase tracepoint, so cold boot and recovery
+ * times can be measured per phase. CNSS_BOOT_PHASE_FW_READY covers the
+ * whole boot, from power up to FW ready.
+ */
+void cnss_boot_phase_done(struct cnss_plat_data *plat_priv,
+			  enum cnss_boot_phase phase, ktime_t start, int ret)
+{
+	u64 duration_us = ktime_us_delta(ktime_get(), start);
+	bool recovery = test_bit(CNSS_DRIVER_RECOVERY,
+				 &plat_priv->driver_state);
+
+	trace_cnss_boot_phase(plat_priv->device_name,
+			      cnss_boot_phase_to_str(phase), recovery,
+			      duration_us, ret);
+	cnss_pr_dbg("Boot phase %s%s took %llu us, ret: %d\n",
+		    cnss_boot_phase_to_str(phase),
+		    recovery ? " (recovery)" : "", duration_us, ret);
+}
+
+static struct cnss_fw_file *cnss_find_fw_file(struct cnss_plat_data *plat_priv,
+					      const char *filename)
+{
+	struct cnss_fw_file *file;
+
+	list_for_each_entry(file, &plat_priv->fw_file_list, list) {
+		if (!strcmp(file->name, filename))
+			return file;
+	}
+
+	return NULL;
+}
+
+static void cnss_free_fw_file(struct cnss_fw_file *file)
+{
+	list_del(&file->list);
+	vfree(file->data);
+	kfree(file);
+}
+
+/**
+ * cnss_get_fw_file() - Get a firmware file, from memory if already read
+ * @plat_priv: Platform data structure
+ * @filename: Firmware file name including any prefix
+ * @direct: Read through cnss_request_firmware_direct()
+ * @data: Returns the file contents
+ * @size: Returns the file size
+ *
+ * Files stay in memory across SSR and idle restart once the firmware has
+ * accepted them, so recovery does not go back to the file system. The file
+ * system read is done without holding fw_file_lock, so prefetching one file
+ * does not hold up the download of another.
+ *
+ * The download path releases the file with cnss_put_fw_file(); @data is
+ * valid until then. With the DISABLE_FW_FILE_CACHE quirk set the file is
+ * always read again.
+ *
+ * Return: 0 on success, error code otherwise
+ */
+int cnss_get_fw_file(struct cnss_plat_data *plat_priv, const char *filename,
+		     bool direct, const u8 **data, size_t *size)
+{
+	bool no_cache = test_bit(DISABLE_FW_FILE_CACHE,
+				 &plat_priv->ctrl_params.quirks);
+	const struct firmware *fw_entry;
+	struct cnss_fw_file *file, *cached;
+	int ret;
+
+	mutex_lock(&plat_priv->fw_file_lock);
+	file = no_cache ? NULL : cnss_find_fw_file(plat_priv, filename);
+	if (file) {
+		*data = file->data;
+		*size = file->size;
+		mutex_unlock(&plat_priv->fw_file_lock);
+		trace_cnss_fw_file_cache(plat_priv->device_name, filename,
+					 file->size, true);
+		return 0;
+	}
+	mutex_unlock(&plat_priv->fw_file_lock);
+
+	if (direct)
+		ret = cnss_request_firmware_direct(plat_priv, &fw_entry,
+						   filename);
+	else
+		ret = firmware_request_nowarn(&fw_entry, filename,
+					      &plat_priv->plat_dev->dev);
+	if (ret)
+		return ret;
+
+	file = kzalloc(sizeof(*file), GFP_KERNEL);
+	if (!file) {
+		ret = -ENOMEM;
+		goto release_fw;
+	}
+
+	file->data = vmalloc(fw_entry->size);
+	if (!file->data) {
+		kfree(file);
+		ret = -ENOMEM;
+		goto release_fw;
+	}
+
+	memcpy(file->data, fw_entry->data, fw_entry->size);
+	file->size = fw_entry->size;
+	strscpy(file->name, filename, sizeof(file->name));
+
+	mutex_lock(&plat_priv->fw_file_lock);
+	cached = cnss_find_fw_file(plat_priv, filename);
+	if (cached && !no_cache) {
+		/* Lost a race with the prefetch work, use its copy */
+		vfree(file->data);
+		kfree(file);
+		file = cached;
+	} else {
+		if (cached)
+			cnss_free_fw_file(cached);
+		list_add_tail(&file->list, &plat_priv->fw_file_list);
+	}
+	*data = file->data;
+	*size = file->size;
+	mutex_unlock(&plat_priv->fw_file_lock);
+
+	trace_cnss_fw_file_cache(plat_priv->device_name, filename,
+				 fw_entry->size, false);
+
+release_fw:
+	release_firmware(fw_entry);
+	return ret;
+}
+
+/**
+ * cnss_put_fw_file() - Done with a file from cnss_get_fw_file()
+ * @plat_priv: Platform data structure
+ * @filename: Firmware file name including any prefix
+ * @verified: Firmware accepted the file
+ *
+ * Keeps the file in memory for the next boot if @verified, otherwise drops
+ * it so the next boot reads it again from the file system. Files are never
+ * kept with the DISABLE_FW_FILE_CACHE quirk set.
+ */
+void cnss_put_fw_file(struct cnss_plat_data *plat_priv, const char *filename,
+		      bool verified)
+{
+	struct cnss_fw_file *file;
+
+	mutex_lock(&plat_priv->fw_file_lock);
+	file = cnss_find_fw_file(plat_priv, filename);
+	if (file) {
+		if (verified &&
+		    !test_bit(DISABLE_FW_FILE_CACHE,
+			      &plat_priv->ctrl_params.quirks))
+			file->verified = true;
+		else
+			cnss_free_fw_file(file);
+	}
+	mutex_unlock(&plat_priv->fw_file_lock);
+}
+
+static void cnss_fw_file_cache_init(struct cnss_plat_data *plat_priv)
+{
+	INIT_LIST_HEAD(&plat_priv->fw_file_list);
+	mutex_init(&plat_priv->fw_file_lock);
+	INIT_WORK(&plat_priv->fw_prefetch_work, cnss_fw_prefetch_work);
+}
+
+static void cnss_fw_file_cache_deinit(struct cnss_plat_data *plat_priv)
+{
+	struct cnss_fw_file *file, *tmp;
+
+	cancel_work_sync(&plat_priv->fw_prefetch_work);
+
+	mutex_lock(&plat_priv->fw_file_lock);
+	list_for_each_entry_safe(file, tmp, &plat_priv->fw_file_list, list)
+		cnss_free_fw_file(file);
+	mutex_unlock(&plat_priv->fw_file_lock);
+}
+
 #if IS_ENABLED(CONFIG_INTERCONNECT)
 /**
  * cnss_register_bus_scale() - Setup interconnect voting data
@@ -5005,6 +5296,7 @@ static int cnss_misc_init(struct cnss_plat_data *plat_priv)
 			    ret);
 
 	INIT_WORK(&plat_priv->recovery_work, cnss_recovery_work_handler);
+	cnss_fw_file_cache_init(plat_priv);
 	init_completion(&plat_priv->power_up_complete);
 	init_completion(&plat_priv->cal_complete);
 	init_completion(&plat_priv->rddm_complete);
@@ -5071,6 +5363,7 @@ static void cnss_misc_deinit(struct cnss_plat_data *plat_priv)
 	wakeup_source_unregister(plat_priv->recovery_ws);
 	cnss_deinit_sol_gpio(plat_priv);
 	cnss_sram_dump_deinit(plat_priv);
+	cnss_fw_file_cache_deinit(plat_priv);
 	kfree(plat_priv->on_chip_pmic_board_ids);
 }
 
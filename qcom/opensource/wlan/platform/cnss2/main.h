@@ -343,6 +343,34 @@ enum cnss_driver_event_type {
 	CNSS_DRIVER_EVENT_MAX,
 };
 
+enum cnss_boot_phase {
+	CNSS_BOOT_PHASE_POWER_UP,
+	CNSS_BOOT_PHASE_FW_MEM_ALLOC,
+	CNSS_BOOT_PHASE_TGT_CAP,
+	CNSS_BOOT_PHASE_REGDB_DNLD,
+	CNSS_BOOT_PHASE_BDF_DNLD,
+	CNSS_BOOT_PHASE_M3_DNLD,
+	CNSS_BOOT_PHASE_FW_DNLD,
+	CNSS_BOOT_PHASE_FW_READY,
+	CNSS_BOOT_PHASE_MAX,
+};
+
+/**
+ * struct cnss_fw_file - Firmware file kept in memory across SSR
+ * @list: Entry in cnss_plat_data fw_file_list
+ * @name: Firmware file name including any prefix
+ * @size: Size of @data
+ * @verified: Firmware accepted the file at least once
+ * @data: File contents
+ */
+struct cnss_fw_file {
+	struct list_head list;
+	char name[MAX_FIRMWARE_NAME_LEN];
+	size_t size;
+	bool verified;
+	u8 *data;
+};
+
 enum cnss_driver_state {
 	CNSS_QMI_WLFW_CONNECTED = 0,
 	CNSS_FW_MEM_READY,
@@ -413,6 +441,7 @@ enum cnss_debug_quirks {
 	IGNORE_PCI_LINK_FAILURE,
 	DISABLE_TIME_SYNC,
 	FORCE_ONE_MSI,
+	DISABLE_FW_FILE_CACHE,
 	QUIRK_MAX_VALUE
 };
 
@@ -665,6 +694,11 @@ struct cnss_plat_data {
 	bool is_fw_managed_pwr;
 	struct device **pd_devs;
 	int pd_count;
+	struct list_head fw_file_list;
+	struct mutex fw_file_lock; /* mutex for fw_file_list access */
+	struct work_struct fw_prefetch_work;
+	bool fw_prefetch_board;
+	ktime_t boot_start;
 };
 
 #if IS_ENABLED(CONFIG_ARCH_QCOM)
@@ -762,6 +796,13 @@ int cnss_aop_ol_cpr_cfg_setup(struct cnss_plat_data *plat_priv,
 int cnss_request_firmware_direct(struct cnss_plat_data *plat_priv,
 				 const struct firmware **fw_entry,
 				 const char *filename);
+int cnss_get_fw_file(struct cnss_plat_data *plat_priv, const char *filename,
+		     bool direct, const u8 **data, size_t *size);
+void cnss_put_fw_file(struct cnss_plat_data *plat_priv, const char *filename,
+		      bool verified);
+void cnss_boot_phase_done(struct cnss_plat_data *plat_priv,
+			  enum cnss_boot_phase phase, ktime_t start, int ret);
+void cnss_fw_prefetch_start(struct cnss_plat_data *plat_priv, bool board);
 int cnss_set_feature_list(struct cnss_plat_data *plat_priv,
 			  enum cnss_feature_v01 feature);
 int cnss_clear_feature_list(struct cnss_plat_data *plat_priv,
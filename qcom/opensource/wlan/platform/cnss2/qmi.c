@@ -782,7 +782,8 @@ int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 	struct wlfw_bdf_download_resp_msg_v01 *resp;
 	struct qmi_txn txn;
 	char filename[MAX_FIRMWARE_NAME_LEN];
-	const struct firmware *fw_entry = NULL;
+	const u8 *data = NULL;
+	size_t size = 0;
 	const u8 *temp;
 	unsigned int remaining;
 	int ret = 0;
@@ -805,22 +806,17 @@ int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 	if (ret)
 		goto err_req_fw;
 
-	cnss_pr_dbg("Invoke firmware_request_nowarn for %s\n", filename);
-	if (bdf_type == CNSS_BDF_REGDB)
-		ret = cnss_request_firmware_direct(plat_priv, &fw_entry,
-						   filename);
-	else
-		ret = firmware_request_nowarn(&fw_entry, filename,
-					      &plat_priv->plat_dev->dev);
-
+	cnss_pr_dbg("Get firmware file %s\n", filename);
+	ret = cnss_get_fw_file(plat_priv, filename, bdf_type == CNSS_BDF_REGDB,
+			       &data, &size);
 	if (ret) {
 		cnss_pr_err("Failed to load %s: %s, ret: %d\n",
 			    cnss_bdf_type_to_str(bdf_type), filename, ret);
 		goto err_req_fw;
 	}
 
-	temp = fw_entry->data;
-	remaining = fw_entry->size;
+	temp = data;
+	remaining = size;
 
 	cnss_pr_dbg("Downloading %s: %s, size: %u\n",
 		    cnss_bdf_type_to_str(bdf_type), filename, remaining);
@@ -886,7 +882,7 @@ int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 		req->seg_id++;
 	}
 
-	release_firmware(fw_entry);
+	cnss_put_fw_file(plat_priv, filename, true);
 
 	if (resp->host_bdf_data_valid) {
 		/* QCA6490 enable S3E regulator for IPA configuration only */
@@ -904,7 +900,7 @@ int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 	return 0;
 
 err_send:
-	release_firmware(fw_entry);
+	cnss_put_fw_file(plat_priv, filename, false);
 err_req_fw:
 	if (!(bdf_type == CNSS_BDF_REGDB ||
 	      test_bit(CNSS_IN_REBOOT, &plat_priv->driver_state) ||
@@ -915,6 +911,32 @@ err_req_fw:
 	return ret;
 }
 
+/**
+ * cnss_wlfw_bdf_prefetch() - Read a BDF type file into the firmware file cache
+ * @plat_priv: Platform data structure
+ * @bdf_type: BDF type to read
+ *
+ * Lets the file system read overlap with device power up or other QMI
+ * downloads; cnss_wlfw_bdf_dnld_send_sync() then finds the file in memory.
+ *
+ * Return: 0 on success, error code otherwise
+ */
+int cnss_wlfw_bdf_prefetch(struct cnss_plat_data *plat_priv, u32 bdf_type)
+{
+	char filename[MAX_FIRMWARE_NAME_LEN];
+	const u8 *data;
+	size_t size;
+	int ret;
+
+	ret = cnss_get_bdf_file_name(plat_priv, bdf_type,
+				     filename, sizeof(filename));
+	if (ret)
+		return ret;
+
+	return cnss_get_fw_file(plat_priv, filename,
+				bdf_type == CNSS_BDF_REGDB, &data, &size);
+}
+
 int cnss_wlfw_tme_patch_dnld_send_sync(struct cnss_plat_data *plat_priv,
 				       enum wlfw_tme_lite_file_type_v01 file)
 {
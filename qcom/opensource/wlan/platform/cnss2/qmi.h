@@ -44,6 +44,7 @@ int cnss_wlfw_respond_mem_send_sync(struct cnss_plat_data *plat_priv);
 int cnss_wlfw_tgt_cap_send_sync(struct cnss_plat_data *plat_priv);
 int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 				 u32 bdf_type);
+int cnss_wlfw_bdf_prefetch(struct cnss_plat_data *plat_priv, u32 bdf_type);
 int cnss_wlfw_tme_patch_dnld_send_sync(struct cnss_plat_data *plat_priv,
 				       enum wlfw_tme_lite_file_type_v01 file);
 int cnss_wlfw_m3_dnld_send_sync(struct cnss_plat_data *plat_priv);
@@ -143,6 +144,12 @@ static inline int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 	return 0;
 }
 
+static inline int cnss_wlfw_bdf_prefetch(struct cnss_plat_data *plat_priv,
+					 u32 bdf_type)
+{
+	return 0;
+}
+
 static inline int cnss_wlfw_m3_dnld_send_sync(struct cnss_plat_data *plat_priv)
 {
 	return 0;
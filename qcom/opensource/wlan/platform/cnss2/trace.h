@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM cnss2
+
+#if !defined(_CNSS_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _CNSS_TRACE_H
+
+#include <linux/tracepoint.h>
+
+TRACE_EVENT(cnss_boot_phase,
+	    TP_PROTO(const char *dev, const char *phase, bool recovery,
+		     u64 duration_us, int ret),
+	    TP_ARGS(dev, phase, recovery, duration_us, ret),
+	    TP_STRUCT__entry(
+		__string(dev, dev)
+		__string(phase, phase)
+		__field(bool, recovery)
+		__field(u64, duration_us)
+		__field(int, ret)
+	    ),
+	    TP_fast_assign(
+		__assign_str(dev, dev);
+		__assign_str(phase, phase);
+		__entry->recovery = recovery;
+		__entry->duration_us = duration_us;
+		__entry->ret = ret;
+	    ),
+	    TP_printk("dev=%s phase=%s recovery=%d duration(us)=%llu ret=%d",
+		      __get_str(dev), __get_str(phase), __entry->recovery,
+		      __entry->duration_us, __entry->ret)
+);
+
+TRACE_EVENT(cnss_fw_file_cache,
+	    TP_PROTO(const char *dev, const char *filename, size_t size,
+		     bool hit),
+	    TP_ARGS(dev, filename, size, hit),
+	    TP_STRUCT__entry(
+		__string(dev, dev)
+		__string(filename, filename)
+		__field(size_t, size)
+		__field(bool, hit)
+	    ),
+	    TP_fast_assign(
+		__assign_str(dev, dev);
+		__assign_str(filename, filename);
+		__entry->size = size;
+		__entry->hit = hit;
+	    ),
+	    TP_printk("dev=%s file=%s size=%zu %s",
+		      __get_str(dev), __get_str(filename), __entry->size,
+		      __entry->hit ? "hit" : "miss")
+);
+#endif /* _CNSS_TRACE_H */
+
+/* Below should be outside the protection */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE trace
+#include <trace/define_trace.h>
@@ -10,7 +10,11 @@
 #include <linux/mm.h>
 #include <linux/err.h>
 #include <linux/of.h>
-#include <linux/version.h>
+#include <linux/hash.h>
+#include <linux/log2.h>
+#include <linux/percpu.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
 #include "cnss_common.h"
 #ifdef CONFIG_CNSS_OUT_OF_TREE
 #include "cnss_prealloc.h"
@@ -26,14 +30,50 @@ MODULE_DESCRIPTION("CNSS prealloc driver");
  * features: memorypool and kmem cache.
  */
 
+/* Per-CPU cache depth, and the largest pool which gets a per-CPU cache */
+#define CNSS_POOL_PCP_DEPTH 2
+#define CNSS_POOL_PCP_MAX_SIZE (32 * 1024)
+
+/* Minimum number of slots in the pointer tracking table */
+#define CNSS_PTR_TABLE_MIN_BITS 6
+
+/**
+ * struct cnss_pool_pcp - Per-CPU cache of free pool elements
+ * @count: Number of elements in @objs
+ * @objs: Free elements, only ever touched by the owning CPU with
+ *        interrupts disabled
+ */
+struct cnss_pool_pcp {
+	unsigned int count;
+	void *objs[CNSS_POOL_PCP_DEPTH];
+};
+
+/**
+ * struct cnss_pool_stats - Pool usage statistics
+ * @in_use: Elements currently handed out from the pool
+ * @high_water: Maximum value @in_use reached since the pool was created
+ * @allocs: Elements handed out from the pool
+ * @pcp_hits: Elements handed out from the per-CPU cache
+ * @fallbacks: Requests for this size class served by a larger pool
+ * @failures: Requests for this size class which could not be served
+ */
+struct cnss_pool_stats {
+	unsigned int in_use;
+	unsigned int high_water;
+	unsigned long allocs;
+	unsigned long pcp_hits;
+	unsigned long fallbacks;
+	unsigned long failures;
+};
+
 struct cnss_pool {
 	size_t size;
 	int min;
 	const char name[50];
 	mempool_t *mp;
 	struct kmem_cache *cache;
-	void **pool_ptrs;
-	int table_capacity;
+	struct cnss_pool_pcp __percpu *pcp;
+	struct cnss_pool_stats stats;
 };
 
 /**
@@ -50,12 +90,15 @@ struct cnss_pool {
  *              if not merged with another pool.
  *      mp    : A pointer to memory pool. Updated during init.
  *      cache : A pointer to cache. Updated during init.
- *      pool_ptrs: A table to keep track of memory allocated from the pool.
- *      table_capacity: Total capacity of the tracker table for the pool.
+ *      pcp   : Per-CPU cache of free elements. Updated during init for
+ *              pools up to CNSS_POOL_PCP_MAX_SIZE.
+ *      stats : Usage statistics, see <debugfs>/cnss_prealloc/stats.
  * 2. Always keep the table in increasing order
  * 3. Please keep the reserve pool as minimum as possible as it's always
  *    preallocated.
  * 4. Always profile with different use cases after updating this table.
+ *    The high water mark and fallback counters in the stats file show how
+ *    close each pool came to its reserve.
  * 5. A dynamic view of this pool can be viewed at /proc/slabinfo.
  * 6. Each pool has a sys node at /sys/kernel/slab/<name>
  *
@@ -90,6 +133,32 @@ struct cnss_pool *cnss_pools;
 unsigned int cnss_prealloc_pool_size = ARRAY_SIZE(cnss_pools_default);
 spinlock_t pool_table_lock;
 
+/*
+ * Size class -> first pool which may hold it. Class c covers sizes in
+ * (2^(c-1), 2^c], so with power of two pool sizes the first candidate is
+ * always the right one.
+ */
+static u8 cnss_pool_class[BITS_PER_LONG + 1];
+
+/**
+ * struct cnss_pool_ptr_entry - Pointer tracking table entry
+ * @mem: Element handed out by wcnss_prealloc_get(), NULL if the slot is free
+ * @pool: Index of the pool @mem belongs to
+ */
+struct cnss_pool_ptr_entry {
+	void *mem;
+	unsigned int pool;
+};
+
+/*
+ * Open addressed hash of every element handed out, protected by
+ * pool_table_lock. It resolves a pointer to its pool on free, and tells
+ * pool memory apart from any other pointer the host passes in.
+ */
+static struct cnss_pool_ptr_entry *cnss_ptr_table;
+static unsigned int cnss_ptr_table_bits;
+static unsigned int cnss_ptr_table_count;
+
 /**
  * cnss_pool_alloc_threshold() - Allocation threshold
  *
@@ -103,6 +172,225 @@ static inline size_t cnss_pool_alloc_threshold(void)
 	return cnss_pools[0].size;
 }
 
+/**
+ * cnss_pool_class_init() - Build the size class to pool index table
+ *
+ * Relies on cnss_pools[] being in increasing order of size.
+ */
+static void cnss_pool_class_init(void)
+{
+	unsigned int c, i = 0;
+
+	for (c = 0; c < ARRAY_SIZE(cnss_pool_class); c++) {
+		while (c && i < cnss_prealloc_pool_size &&
+		       cnss_pools[i].size <= (1UL << (c - 1)))
+			i++;
+		cnss_pool_class[c] = i;
+	}
+}
+
+/**
+ * cnss_pool_get_index() - Find the smallest pool able to hold @size
+ * @size: Size to allocate
+ *
+ * Return: pool index, or -ENOENT if @size is larger than every pool
+ */
+static int cnss_pool_get_index(size_t size)
+{
+	unsigned int i;
+
+	i = cnss_pool_class[order_base_2(size)];
+	while (i < cnss_prealloc_pool_size && cnss_pools[i].size < size)
+		i++;
+
+	return i < cnss_prealloc_pool_size ? i : -ENOENT;
+}
+
+static inline unsigned int cnss_ptr_table_slot(void *mem, unsigned int bits)
+{
+	return hash_ptr(mem, bits);
+}
+
+static int cnss_ptr_table_init(void)
+{
+	unsigned int reserve = 0;
+	int i;
+
+	for (i = 0; i < cnss_prealloc_pool_size; i++)
+		reserve += cnss_pools[i].min;
+
+	cnss_ptr_table_bits = max_t(unsigned int, CNSS_PTR_TABLE_MIN_BITS,
+				    order_base_2(reserve * 2));
+	cnss_ptr_table_count = 0;
+	cnss_ptr_table = kcalloc(1U << cnss_ptr_table_bits,
+				 sizeof(*cnss_ptr_table), GFP_KERNEL);
+	if (!cnss_ptr_table)
+		return -ENOMEM;
+
+	return 0;
+}
+
+static void cnss_ptr_table_deinit(void)
+{
+	kfree(cnss_ptr_table);
+	cnss_ptr_table = NULL;
+	cnss_ptr_table_count = 0;
+}
+
+/* Caller must hold pool_table_lock */
+static int cnss_ptr_table_grow(void)
+{
+	struct cnss_pool_ptr_entry *table;
+	unsigned int bits = cnss_ptr_table_bits + 1;
+	unsigned int mask = (1U << bits) - 1;
+	unsigned int i, slot;
+
+	table = kcalloc(1U << bits, sizeof(*table), GFP_ATOMIC);
+	if (!table)
+		return -ENOMEM;
+
+	for (i = 0; i < (1U << cnss_ptr_table_bits); i++) {
+		if (!cnss_ptr_table[i].mem)
+			continue;
+
+		slot = cnss_ptr_table_slot(cnss_ptr_table[i].mem, bits);
+		while (table[slot].mem)
+			slot = (slot + 1) & mask;
+		table[slot] = cnss_ptr_table[i];
+	}
+
+	kfree(cnss_ptr_table);
+	cnss_ptr_table = table;
+	cnss_ptr_table_bits = bits;
+
+	pr_debug("cnss_prealloc: pointer table grown to %u slots\n", mask + 1);
+
+	return 0;
+}
+
+/* Caller must hold pool_table_lock */
+static int cnss_ptr_table_insert(void *mem, unsigned int pool)
+{
+	unsigned int size = 1U << cnss_ptr_table_bits;
+	unsigned int slot;
+
+	/* Keep the load factor under 3/4, but only fail once really full */
+	if ((cnss_ptr_table_count + 1) * 4 > size * 3 &&
+	    cnss_ptr_table_grow() && cnss_ptr_table_count + 1 >= size) {
+		pr_debug("cnss_prealloc: pointer table is full at %u slots\n",
+			 size);
+		return -ENOMEM;
+	}
+
+	size = 1U << cnss_ptr_table_bits;
+	slot = cnss_ptr_table_slot(mem, cnss_ptr_table_bits);
+	while (cnss_ptr_table[slot].mem)
+		slot = (slot + 1) & (size - 1);
+
+	cnss_ptr_table[slot].mem = mem;
+	cnss_ptr_table[slot].pool = pool;
+	cnss_ptr_table_count++;
+
+	return 0;
+}
+
+/**
+ * cnss_ptr_table_remove() - Stop tracking an element
+ * @mem: Element handed out by wcnss_prealloc_get()
+ *
+ * Caller must hold pool_table_lock. Uses backward shift deletion so that
+ * lookups never need tombstones.
+ *
+ * Return: index of the pool @mem belongs to, or -ENOENT if not tracked
+ */
+static int cnss_ptr_table_remove(void *mem)
+{
+	unsigned int mask = (1U << cnss_ptr_table_bits) - 1;
+	unsigned int i, j, k;
+	int pool;
+
+	i = cnss_ptr_table_slot(mem, cnss_ptr_table_bits);
+	while (cnss_ptr_table[i].mem != mem) {
+		if (!cnss_ptr_table[i].mem)
+			return -ENOENT;
+		i = (i + 1) & mask;
+	}
+
+	pool = cnss_ptr_table[i].pool;
+
+	for (j = (i + 1) & mask; cnss_ptr_table[j].mem; j = (j + 1) & mask) {
+		k = cnss_ptr_table_slot(cnss_ptr_table[j].mem,
+					cnss_ptr_table_bits);
+		/* Entry at j may move to i unless its home is in (i, j] */
+		if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+			continue;
+		cnss_ptr_table[i] = cnss_ptr_table[j];
+		i = j;
+	}
+
+	cnss_ptr_table[i].mem = NULL;
+	cnss_ptr_table_count--;
+
+	return pool;
+}
+
+static void *cnss_pool_pcp_get(struct cnss_pool *pool)
+{
+	struct cnss_pool_pcp *pcp;
+	unsigned long irq_flags;
+	void *mem = NULL;
+
+	if (!pool->pcp)
+		return NULL;
+
+	local_irq_save(irq_flags);
+	pcp = this_cpu_ptr(pool->pcp);
+	if (pcp->count)
+		mem = pcp->objs[--pcp->count];
+	local_irq_restore(irq_flags);
+
+	return mem;
+}
+
+static bool cnss_pool_pcp_put(struct cnss_pool *pool, void *mem)
+{
+	struct cnss_pool_pcp *pcp;
+	unsigned long irq_flags;
+	bool cached = false;
+
+	/* Refill the emergency reserve before caching anything */
+	if (!pool->pcp || READ_ONCE(pool->mp->curr_nr) < pool->mp->min_nr)
+		return false;
+
+	local_irq_save(irq_flags);
+	pcp = this_cpu_ptr(pool->pcp);
+	if (pcp->count < CNSS_POOL_PCP_DEPTH) {
+		pcp->objs[pcp->count++] = mem;
+		cached = true;
+	}
+	local_irq_restore(irq_flags);
+
+	return cached;
+}
+
+static void cnss_pool_pcp_drain(struct cnss_pool *pool)
+{
+	struct cnss_pool_pcp *pcp;
+	int cpu;
+
+	if (!pool->pcp)
+		return;
+
+	for_each_possible_cpu(cpu) {
+		pcp = per_cpu_ptr(pool->pcp, cpu);
+		while (pcp->count)
+			mempool_free(pcp->objs[--pcp->count], pool->mp);
+	}
+
+	free_percpu(pool->pcp);
+	pool->pcp = NULL;
+}
+
 /**
  * cnss_pool_int() - Initialize memory pools.
  *
@@ -119,6 +407,8 @@ static int cnss_pool_init(void)
 	int i;
 
 	for (i = 0; i < cnss_prealloc_pool_size; i++) {
+		memset(&cnss_pools[i].stats, 0, sizeof(cnss_pools[i].stats));
+
 		/* Create the slab cache */
 		cnss_pools[i].cache =
 			kmem_cache_create_usercopy(cnss_pools[i].name,
@@ -144,21 +434,22 @@ static int cnss_pool_init(void)
 			continue;
 		}
 
-		cnss_pools[i].table_capacity = cnss_pools[i].min;
-		cnss_pools[i].pool_ptrs = kzalloc(cnss_pools[i].min * sizeof(void *),
-						  GFP_KERNEL);
+		/* Not fatal, the pool simply goes without a per-CPU cache */
+		if (cnss_pools[i].size <= CNSS_POOL_PCP_MAX_SIZE)
+			cnss_pools[i].pcp = alloc_percpu(struct cnss_pool_pcp);
 
-		if (!cnss_pools[i].pool_ptrs) {
-			pr_err("cnss_prealloc: failed to create mempool %s of min size %d * %zu\n",
-			       cnss_pools[i].name, cnss_pools[i].min,
-			       cnss_pools[i].size);
-			WARN_ON(1);
-		}
 		pr_info("cnss_prealloc: created mempool %s of min size %d * %zu\n",
 			cnss_pools[i].name, cnss_pools[i].min,
 			cnss_pools[i].size);
 	}
 
+	cnss_pool_class_init();
+
+	if (cnss_ptr_table_init()) {
+		pr_err("cnss_prealloc: failed to create pointer table\n");
+		WARN_ON(1);
+	}
+
 	spin_lock_init(&pool_table_lock);
 
 	return 0;
@@ -173,21 +464,26 @@ static int cnss_pool_init(void)
  */
 static void cnss_pool_deinit(void)
 {
+	struct cnss_pool_stats *stats;
 	int i;
 
 	if (!cnss_pools)
 		return;
 
 	for (i = 0; i < cnss_prealloc_pool_size; i++) {
-		pr_info("cnss_prealloc: destroy mempool %s\n",
-			cnss_pools[i].name);
+		stats = &cnss_pools[i].stats;
+		pr_info("cnss_prealloc: destroy mempool %s, high water %u/%d allocs %lu pcp hits %lu fallbacks %lu failures %lu\n",
+			cnss_pools[i].name, stats->high_water,
+			cnss_pools[i].min, stats->allocs, stats->pcp_hits,
+			stats->fallbacks, stats->failures);
+		cnss_pool_pcp_drain(&cnss_pools[i]);
 		mempool_destroy(cnss_pools[i].mp);
 		kmem_cache_destroy(cnss_pools[i].cache);
 		cnss_pools[i].mp = NULL;
 		cnss_pools[i].cache = NULL;
-		kfree(cnss_pools[i].pool_ptrs);
-		cnss_pools[i].pool_ptrs = NULL;
 	}
+
+	cnss_ptr_table_deinit();
 }
 
 static void cnss_assign_prealloc_pool(unsigned long device_id)
@@ -230,89 +526,35 @@ EXPORT_SYMBOL(cnss_deinitialize_prealloc_pool);
 
 void wcnss_check_pool_lists(void)
 {
-	void **pool;
-	int i;
-	size_t ptr_idx;
-	int count;
+	unsigned long irq_flags;
+	unsigned int slot;
 
 	pr_info("wcnss enter pool check\n");
 
-	for (i = 0; i < cnss_prealloc_pool_size; i++) {
-		pool = cnss_pools[i].pool_ptrs;
-		count = cnss_pools[i].table_capacity;
-		for (ptr_idx = 0; ptr_idx < count; ptr_idx++) {
-			if (pool[ptr_idx]) {
-				pr_err("%p not freed in %s pool at index %zu\n",
-					pool[ptr_idx], cnss_pools[i].name,
-					ptr_idx);
-				WARN_ON(1);
-			}
-		}
-	}
-}
-EXPORT_SYMBOL(wcnss_check_pool_lists);
-
-static int wcnss_find_pool_table_slot(int pool, void *mem)
-{
-	void **pool_table;
-	size_t ptr_idx;
-	int new_capacity;
-
-	pool_table = cnss_pools[pool].pool_ptrs;
-	for (ptr_idx = 0; ptr_idx < cnss_pools[pool].table_capacity; ptr_idx++) {
-		if (!pool_table[ptr_idx]) {
-			pool_table[ptr_idx] = mem;
-			return 0;
-		}
-	}
-
-	new_capacity = cnss_pools[pool].table_capacity + 1;
-
-
-	cnss_pools[pool].pool_ptrs = krealloc(cnss_pools[pool].pool_ptrs,
-					      new_capacity * sizeof(void *),
-					      GFP_ATOMIC);
-
-	if (!cnss_pools[pool].pool_ptrs) {
-		pr_debug("%s pool is full, failed to increase table size to %d\n",
-			 cnss_pools[pool].name, cnss_pools[pool].table_capacity);
-		return -EPERM;
-	}
-
-	cnss_pools[pool].pool_ptrs[ptr_idx] = mem;
-	cnss_pools[pool].table_capacity += 1;
-
-	pr_debug("%s pool is full, increasing table size to %d\n",
-		 cnss_pools[pool].name, cnss_pools[pool].table_capacity);
-
-	return 0;
-}
+	if (!cnss_pools || !cnss_ptr_table)
+		return;
 
-static int wcnss_free_pool_table_slot(struct cnss_pool mempool, void *mem)
-{
-	void **pool_table;
-	size_t ptr_idx;
-
-	pool_table = mempool.pool_ptrs;
-	for (ptr_idx = 0; ptr_idx < mempool.table_capacity; ptr_idx++) {
-		if (pool_table[ptr_idx] == mem) {
-			pool_table[ptr_idx] = NULL;
-			return ptr_idx;
+	spin_lock_irqsave(&pool_table_lock, irq_flags);
+	for (slot = 0; slot < (1U << cnss_ptr_table_bits); slot++) {
+		if (cnss_ptr_table[slot].mem) {
+			pr_err("%p not freed in %s pool at index %u\n",
+			       cnss_ptr_table[slot].mem,
+			       cnss_pools[cnss_ptr_table[slot].pool].name,
+			       slot);
+			WARN_ON(1);
 		}
 	}
-
-	pr_debug("wcnss prealloc put ptr %p not found in %s pool mem addr %p\n",
-		 mem, mempool.name, mempool.pool_ptrs);
-
-	return -EPERM;
+	spin_unlock_irqrestore(&pool_table_lock, irq_flags);
 }
+EXPORT_SYMBOL(wcnss_check_pool_lists);
 
 /**
  * wcnss_prealloc_get() - Get preallocated memory from a pool
  * @size: Size to allocate
  *
  * Memory pool is chosen based on the size. If memory is not available in a
- * given pool it goes to next higher sized pool until it succeeds.
+ * given pool it goes to next higher sized pool until it succeeds. Each pool
+ * is tried through its per-CPU cache first.
  *
  * Return: A void pointer to allocated memory
  */
@@ -322,10 +564,13 @@ void *wcnss_prealloc_get(size_t size)
 	void *mem = NULL;
 	gfp_t gfp_mask = __GFP_ZERO;
 	unsigned long irq_flags;
+	struct cnss_pool_stats *stats;
+	bool pcp_hit = false;
+	int class;
 	int i;
 	int ret = 0;
 
-	if (!cnss_pools)
+	if (!cnss_pools || !cnss_ptr_table)
 		return mem;
 
 	if (in_interrupt() || !preemptible() || rcu_preempt_depth())
@@ -333,34 +578,53 @@ void *wcnss_prealloc_get(size_t size)
 	else
 		gfp_mask |= GFP_KERNEL;
 
-	if (size >= cnss_pool_alloc_threshold()) {
-
-		for (i = 0; i < cnss_prealloc_pool_size; i++) {
-			if (cnss_pools[i].size >= size && cnss_pools[i].mp) {
-				if (!cnss_pools[i].pool_ptrs) {
-					pr_err("%s mempool table is null\n",
-					       cnss_pools[i].name);
-					mem = NULL;
-					break;
-				}
-				mem = mempool_alloc(cnss_pools[i].mp, gfp_mask);
-				if (mem) {
-					spin_lock_irqsave(&pool_table_lock,
-							  irq_flags);
-					ret = wcnss_find_pool_table_slot(i, mem);
-					spin_unlock_irqrestore(&pool_table_lock,
-							       irq_flags);
-					break;
-				}
-			}
+	if (size < cnss_pool_alloc_threshold())
+		return mem;
+
+	class = cnss_pool_get_index(size);
+	if (class < 0)
+		goto out;
+
+	for (i = class; i < cnss_prealloc_pool_size; i++) {
+		if (!cnss_pools[i].mp)
+			continue;
+
+		mem = cnss_pool_pcp_get(&cnss_pools[i]);
+		if (mem) {
+			memset(mem, 0, cnss_pools[i].size);
+			pcp_hit = true;
+			break;
 		}
+
+		mem = mempool_alloc(cnss_pools[i].mp, gfp_mask);
+		if (mem)
+			break;
+	}
+
+	spin_lock_irqsave(&pool_table_lock, irq_flags);
+	if (mem) {
+		ret = cnss_ptr_table_insert(mem, i);
+		if (!ret) {
+			stats = &cnss_pools[i].stats;
+			stats->allocs++;
+			stats->pcp_hits += pcp_hit;
+			if (++stats->in_use > stats->high_water)
+				stats->high_water = stats->in_use;
+			if (i != class)
+				cnss_pools[class].stats.fallbacks++;
+		}
+	} else {
+		cnss_pools[class].stats.failures++;
 	}
+	spin_unlock_irqrestore(&pool_table_lock, irq_flags);
+
 	if (ret < 0) {
 		mempool_free(mem, cnss_pools[i].mp);
 		mem = NULL;
 	}
 
-	if (!mem && size >= cnss_pool_alloc_threshold()) {
+out:
+	if (!mem) {
 		pr_err("cnss_prealloc: not available for size %zu, flag %x\n",
 		       size, gfp_mask);
 	}
@@ -369,116 +633,96 @@ void *wcnss_prealloc_get(size_t size)
 }
 EXPORT_SYMBOL(wcnss_prealloc_get);
 
-#if (LINUX_VERSION_CODE >= KERNEL_VERSION(5, 17, 0))
 /**
  * wcnss_prealloc_put() - Relase allocated memory
  * @mem: Allocated memory
  *
- * Free the memory got by wcnss_prealloc_get() to slab or pool reserve if memory
- * pool doesn't have enough elements.
+ * Free the memory got by wcnss_prealloc_get() to the per-CPU cache, the pool
+ * reserve if memory pool doesn't have enough elements, or slab.
  *
  * Return: 1 - success
  *         0 - fail
  */
 int wcnss_prealloc_put(void *mem)
 {
-	int i;
-	int ret;
 	unsigned long irq_flags;
+	int i;
 
-	if (!mem || !cnss_pools)
+	if (!mem || !cnss_pools || !cnss_ptr_table)
 		return 0;
 
-	for (i = 0; i < cnss_prealloc_pool_size; i++) {
-		if (cnss_pools[i].mp) {
-			if (!cnss_pools[i].pool_ptrs) {
-				pr_err("%s mempool table is null\n",
-				       cnss_pools[i].name);
-				break;
-			}
-			spin_lock_irqsave(&pool_table_lock, irq_flags);
-			ret = wcnss_free_pool_table_slot(cnss_pools[i],
-							 mem);
-			spin_unlock_irqrestore(&pool_table_lock,
-					       irq_flags);
-
-			if (ret >= 0) {
-				mempool_free(mem, cnss_pools[i].mp);
-				return 1;
-			}
-		}
-	}
+	spin_lock_irqsave(&pool_table_lock, irq_flags);
+	i = cnss_ptr_table_remove(mem);
+	if (i >= 0)
+		cnss_pools[i].stats.in_use--;
+	spin_unlock_irqrestore(&pool_table_lock, irq_flags);
 
-	return 0;
+	if (i < 0)
+		return 0;
+
+	if (!cnss_pool_pcp_put(&cnss_pools[i], mem))
+		mempool_free(mem, cnss_pools[i].mp);
+
+	return 1;
 }
 EXPORT_SYMBOL(wcnss_prealloc_put);
-#else
-static int cnss_pool_get_index(void *mem)
+
+#ifdef CONFIG_DEBUG_FS
+static struct dentry *cnss_prealloc_debugfs_root;
+
+static int cnss_prealloc_stats_show(struct seq_file *s, void *data)
 {
-	struct page *page;
-	struct kmem_cache *cache;
+	struct cnss_pool_stats *stats;
+	unsigned long irq_flags;
 	int i;
 
-	if (!virt_addr_valid(mem))
-		return -EINVAL;
-
-	/* mem -> page -> cache */
-	page = virt_to_head_page(mem);
-	if (!page)
-		return -ENOENT;
+	if (!cnss_pools || !cnss_ptr_table) {
+		seq_puts(s, "Pools not initialized\n");
+		return 0;
+	}
 
-	cache = page->slab_cache;
-	if (!cache)
-		return -ENOENT;
+	seq_printf(s, "%-16s %8s %6s %6s %10s %10s %10s %10s\n",
+		   "name", "size", "min", "in_use", "high_water", "allocs",
+		   "pcp_hits", "fallbacks");
 
-	/* Check if memory belongs to a pool */
+	spin_lock_irqsave(&pool_table_lock, irq_flags);
 	for (i = 0; i < cnss_prealloc_pool_size; i++) {
-		if (cnss_pools[i].cache == cache)
-			return i;
+		stats = &cnss_pools[i].stats;
+		seq_printf(s, "%-16s %8zu %6d %6u %10u %10lu %10lu %10lu\n",
+			   cnss_pools[i].name, cnss_pools[i].size,
+			   cnss_pools[i].min, stats->in_use, stats->high_water,
+			   stats->allocs, stats->pcp_hits, stats->fallbacks);
 	}
+	for (i = 0; i < cnss_prealloc_pool_size; i++)
+		if (cnss_pools[i].stats.failures)
+			seq_printf(s, "%s failures: %lu\n", cnss_pools[i].name,
+				   cnss_pools[i].stats.failures);
+	spin_unlock_irqrestore(&pool_table_lock, irq_flags);
 
-	return -ENOENT;
+	return 0;
 }
+DEFINE_SHOW_ATTRIBUTE(cnss_prealloc_stats);
 
-/**
- * wcnss_prealloc_put() - Relase allocated memory
- * @mem: Allocated memory
- *
- * Free the memory got by wcnss_prealloc_get() to slab or pool reserve if memory
- * pool doesn't have enough elements.
- *
- * Return: 1 - success
- *         0 - fail
- */
-int wcnss_prealloc_put(void *mem)
+static void cnss_prealloc_debugfs_create(void)
 {
-	int i;
-	int ret;
-	unsigned long irq_flags;
-
-	if (!mem || !cnss_pools)
-		return 0;
+	cnss_prealloc_debugfs_root = debugfs_create_dir("cnss_prealloc", NULL);
+	if (IS_ERR(cnss_prealloc_debugfs_root))
+		return;
 
-	i = cnss_pool_get_index(mem);
-	if (i >= 0 && i < cnss_prealloc_pool_size && cnss_pools[i].mp) {
-		if (!cnss_pools[i].pool_ptrs) {
-			pr_err("%s mempool table is null\n",
-			       cnss_pools[i].name);
-			return 0;
-		}
-		spin_lock_irqsave(&pool_table_lock, irq_flags);
-		ret = wcnss_free_pool_table_slot(cnss_pools[i], mem);
-		spin_unlock_irqrestore(&pool_table_lock, irq_flags);
-		if (ret >= 0) {
-			mempool_free(mem, cnss_pools[i].mp);
-			return 1;
-		}
-	}
+	debugfs_create_file("stats", 0400, cnss_prealloc_debugfs_root, NULL,
+			    &cnss_prealloc_stats_fops);
+}
 
-	return 0;
+static void cnss_prealloc_debugfs_destroy(void)
+{
+	debugfs_remove_recursive(cnss_prealloc_debugfs_root);
+	cnss_prealloc_debugfs_root = NULL;
 }
-EXPORT_SYMBOL(wcnss_prealloc_put);
-#endif /* (LINUX_VERSION_CODE >= KERNEL_VERSION(5, 17, 0)) */
+#else
+static void cnss_prealloc_debugfs_create(void) {}
+
+static void cnss_prealloc_debugfs_destroy(void) {}
+#endif
 
 /* Not implemented. Make use of Linux SLAB features. */
 void wcnss_prealloc_check_memory_leak(void) {}
@@ -517,12 +761,14 @@ static int __init cnss_prealloc_init(void)
 	if (!cnss_prealloc_is_valid_dt_node_found())
 		return -ENODEV;
 
+	cnss_prealloc_debugfs_create();
+
 	return 0;
 }
 
 static void __exit cnss_prealloc_exit(void)
 {
-	return;
+	cnss_prealloc_debugfs_destroy();
 }
 
 module_init(cnss_prealloc_init);
@@ -122,7 +122,7 @@ def _define_modules_for_target_variant(target, variant):
                 "cnss2/*.h",
                 "cnss_utils/*.h",
             ]),
-            includes = ["cnss", "cnss_utils"],
+            includes = ["cnss", "cnss2", "cnss_utils"],
             kconfig = "cnss2/Kconfig",
             defconfig = defconfig,
             conditional_srcs = {
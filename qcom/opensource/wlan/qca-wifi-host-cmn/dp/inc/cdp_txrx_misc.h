@@ -1074,4 +1074,47 @@ cdp_evaluate_update_tx_ilp_cfg(ol_txrx_soc_handle soc,
 						msdu_idx_map_arr);
 }
 #endif /* DP_TX_PACKET_INSPECT_FOR_ILP */
+
+#ifdef WLAN_DP_MLO_LINK_SCHED
+/**
+ * cdp_set_tx_link_metrics() - Enable or disable TX link metrics for a vdev
+ * @soc: DP SOC handle
+ * @vdev_id: vdev id
+ * @enable: true to reset and start collecting, false to stop
+ *
+ * Return: QDF_STATUS
+ */
+static inline QDF_STATUS
+cdp_set_tx_link_metrics(ol_txrx_soc_handle soc, uint8_t vdev_id, bool enable)
+{
+	if (!soc || !soc->ops || !soc->ops->misc_ops ||
+	    !soc->ops->misc_ops->set_tx_link_metrics) {
+		dp_cdp_debug("Invalid Instance:");
+		return QDF_STATUS_E_INVAL;
+	}
+
+	return soc->ops->misc_ops->set_tx_link_metrics(soc, vdev_id, enable);
+}
+
+/**
+ * cdp_get_tx_link_metrics() - Get the TX link metrics of a vdev
+ * @soc: DP SOC handle
+ * @vdev_id: vdev id
+ * @metrics: filled with the link metrics
+ *
+ * Return: QDF_STATUS
+ */
+static inline QDF_STATUS
+cdp_get_tx_link_metrics(ol_txrx_soc_handle soc, uint8_t vdev_id,
+			struct cdp_tx_link_metrics *metrics)
+{
+	if (!soc || !soc->ops || !soc->ops->misc_ops ||
+	    !soc->ops->misc_ops->get_tx_link_metrics) {
+		dp_cdp_debug("Invalid Instance:");
+		return QDF_STATUS_E_INVAL;
+	}
+
+	return soc->ops->misc_ops->get_tx_link_metrics(soc, vdev_id, metrics);
+}
+#endif /* WLAN_DP_MLO_LINK_SCHED */
 #endif /* _CDP_TXRX_MISC_H_ */
@@ -401,4 +401,141 @@ bool cdp_is_local_pkt_capture_running(ol_txrx_soc_handle soc, uint8_t pdev_id)
 }
 #endif /* WLAN_FEATURE_LOCAL_PKT_CAPTURE */
 
+#ifdef WLAN_DP_MON_CAPTURE_RING
+/**
+ * cdp_mon_capture_ring_attach() - start writing monitor MPDUs to a
+ *	capture ring instead of the monitor interface
+ * @soc: opaque soc handle
+ * @pdev_id: pdev id
+ * @cfg: ring memory and configuration
+ *
+ * Return: QDF_STATUS_SUCCESS if success
+ *         QDF_STATUS_E_FAILURE if error
+ */
+static inline
+QDF_STATUS cdp_mon_capture_ring_attach(ol_txrx_soc_handle soc,
+				       uint8_t pdev_id,
+				       struct cdp_mon_capture_ring_cfg *cfg)
+{
+	if (!soc || !soc->ops) {
+		dp_cdp_debug("Invalid Instance");
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	if (!soc->ops->mon_ops ||
+	    !soc->ops->mon_ops->mon_capture_ring_attach)
+		return QDF_STATUS_E_FAILURE;
+
+	return soc->ops->mon_ops->mon_capture_ring_attach(soc, pdev_id, cfg);
+}
+
+/**
+ * cdp_mon_capture_ring_detach() - stop writing to the capture ring
+ * @soc: opaque soc handle
+ * @pdev_id: pdev id
+ *
+ * The ring memory is no longer accessed once this returns.
+ *
+ * Return: QDF_STATUS_SUCCESS if success
+ *         QDF_STATUS_E_FAILURE if error
+ */
+static inline
+QDF_STATUS cdp_mon_capture_ring_detach(ol_txrx_soc_handle soc,
+				       uint8_t pdev_id)
+{
+	if (!soc || !soc->ops) {
+		dp_cdp_debug("Invalid Instance");
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	if (!soc->ops->mon_ops ||
+	    !soc->ops->mon_ops->mon_capture_ring_detach)
+		return QDF_STATUS_E_FAILURE;
+
+	return soc->ops->mon_ops->mon_capture_ring_detach(soc, pdev_id);
+}
+
+/**
+ * cdp_mon_capture_ring_flush() - retire the partially filled capture block
+ * @soc: opaque soc handle
+ * @pdev_id: pdev id
+ * @force: retire even if the block retire timeout has not expired
+ *
+ * Return: QDF_STATUS_SUCCESS if success
+ *         QDF_STATUS_E_FAILURE if error
+ */
+static inline
+QDF_STATUS cdp_mon_capture_ring_flush(ol_txrx_soc_handle soc,
+				      uint8_t pdev_id, bool force)
+{
+	if (!soc || !soc->ops) {
+		dp_cdp_debug("Invalid Instance");
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	if (!soc->ops->mon_ops ||
+	    !soc->ops->mon_ops->mon_capture_ring_flush)
+		return QDF_STATUS_E_FAILURE;
+
+	return soc->ops->mon_ops->mon_capture_ring_flush(soc, pdev_id, force);
+}
+
+/**
+ * cdp_mon_capture_ring_set_filter() - update the capture ring filter
+ * @soc: opaque soc handle
+ * @pdev_id: pdev id
+ * @frame_filter: CDP_MON_CAPTURE_FILTER_* frame types to capture
+ * @peer_mac: only capture frames to or from this peer, NULL for all
+ *
+ * Return: QDF_STATUS_SUCCESS if success
+ *         QDF_STATUS_E_FAILURE if error
+ */
+static inline
+QDF_STATUS cdp_mon_capture_ring_set_filter(ol_txrx_soc_handle soc,
+					   uint8_t pdev_id,
+					   uint32_t frame_filter,
+					   uint8_t *peer_mac)
+{
+	if (!soc || !soc->ops) {
+		dp_cdp_debug("Invalid Instance");
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	if (!soc->ops->mon_ops ||
+	    !soc->ops->mon_ops->mon_capture_ring_set_filter)
+		return QDF_STATUS_E_FAILURE;
+
+	return soc->ops->mon_ops->mon_capture_ring_set_filter(soc, pdev_id,
+							      frame_filter,
+							      peer_mac);
+}
+
+/**
+ * cdp_mon_capture_ring_get_stats() - get capture ring counters
+ * @soc: opaque soc handle
+ * @pdev_id: pdev id
+ * @stats: filled with the counters
+ *
+ * Return: QDF_STATUS_SUCCESS if success
+ *         QDF_STATUS_E_FAILURE if error
+ */
+static inline
+QDF_STATUS
+cdp_mon_capture_ring_get_stats(ol_txrx_soc_handle soc, uint8_t pdev_id,
+			       struct cdp_mon_capture_ring_stats *stats)
+{
+	if (!soc || !soc->ops) {
+		dp_cdp_debug("Invalid Instance");
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	if (!soc->ops->mon_ops ||
+	    !soc->ops->mon_ops->mon_capture_ring_get_stats)
+		return QDF_STATUS_E_FAILURE;
+
+	return soc->ops->mon_ops->mon_capture_ring_get_stats(soc, pdev_id,
+							     stats);
+}
+#endif /* WLAN_DP_MON_CAPTURE_RING */
+
 #endif
@@ -657,4 +657,129 @@ enum cdp_mon_reap_source {
 	CDP_MON_REAP_SOURCE_NUM,
 	CDP_MON_REAP_SOURCE_ANY,
 };
+
+#ifdef WLAN_DP_MON_CAPTURE_RING
+#define CDP_MON_CAPTURE_RING_VERSION 1
+/* packet headers within a capture block are aligned to this */
+#define CDP_MON_CAPTURE_ALIGN 8
+
+#define CDP_MON_CAPTURE_FILTER_MGMT BIT(0)
+#define CDP_MON_CAPTURE_FILTER_CTRL BIT(1)
+#define CDP_MON_CAPTURE_FILTER_DATA BIT(2)
+#define CDP_MON_CAPTURE_FILTER_ALL (CDP_MON_CAPTURE_FILTER_MGMT | \
+				    CDP_MON_CAPTURE_FILTER_CTRL | \
+				    CDP_MON_CAPTURE_FILTER_DATA)
+
+/**
+ * enum cdp_mon_capture_blk_status - ownership of a capture ring block
+ * @CDP_MON_CAPTURE_BLK_KERNEL: block may be filled by the driver
+ * @CDP_MON_CAPTURE_BLK_USER: block is retired and owned by the reader,
+ *	which hands it back by writing CDP_MON_CAPTURE_BLK_KERNEL
+ */
+enum cdp_mon_capture_blk_status {
+	CDP_MON_CAPTURE_BLK_KERNEL,
+	CDP_MON_CAPTURE_BLK_USER,
+};
+
+/**
+ * struct cdp_mon_capture_blk_desc - header at the start of every block
+ *	of the mmap'd monitor capture ring
+ * @version: CDP_MON_CAPTURE_RING_VERSION
+ * @block_status: enum cdp_mon_capture_blk_status
+ * @num_pkts: number of packets in the block
+ * @offset_to_first_pkt: offset of the first packet header from the
+ *	start of the block
+ * @blk_len: bytes used in the block, including this descriptor
+ * @reserved: reserved
+ * @seq_num: sequence number of the block, incremented on every retire
+ */
+struct cdp_mon_capture_blk_desc {
+	uint32_t version;
+	uint32_t block_status;
+	uint32_t num_pkts;
+	uint32_t offset_to_first_pkt;
+	uint32_t blk_len;
+	uint32_t reserved;
+	uint64_t seq_num;
+};
+
+/**
+ * struct cdp_mon_capture_pkt_hdr - header in front of every captured
+ *	packet in a capture ring block
+ * @next_offset: offset of the next packet header from this one,
+ *	0 for the last packet of the block
+ * @snaplen: bytes of radiotap and MPDU stored after this header
+ * @len: original length of radiotap and MPDU
+ * @mac_offset: offset of the radiotap header from this header
+ * @rtap_len: length of the radiotap header
+ * @ppdu_id: PPDU id the MPDU was received in
+ * @reserved: reserved
+ * @tsft: TSF timestamp of the PPDU
+ */
+struct cdp_mon_capture_pkt_hdr {
+	uint32_t next_offset;
+	uint32_t snaplen;
+	uint32_t len;
+	uint16_t mac_offset;
+	uint16_t rtap_len;
+	uint32_t ppdu_id;
+	uint32_t reserved;
+	uint64_t tsft;
+};
+
+/**
+ * typedef cdp_mon_capture_notify_cb() - called when capture ring blocks
+ *	are handed to the reader
+ * @ctx: context registered with the ring
+ *
+ * Called from the monitor rx path, must not sleep.
+ */
+typedef void (*cdp_mon_capture_notify_cb)(void *ctx);
+
+/**
+ * struct cdp_mon_capture_ring_cfg - monitor capture ring configuration
+ * @base: ring memory, num_blocks * block_size bytes, owned by the caller
+ * @block_size: size of one block, multiple of CDP_MON_CAPTURE_ALIGN
+ * @num_blocks: number of blocks
+ * @snaplen: max bytes of radiotap and MPDU stored per packet, 0 for all
+ * @retire_tmo_ms: retire a partially filled block after this long
+ * @frame_filter: CDP_MON_CAPTURE_FILTER_* frame types to capture
+ * @peer_filter: only capture frames with @peer_mac as addr1 or addr2
+ * @peer_mac: peer to capture when @peer_filter is set
+ * @notify: batch notification callback, called once per retire
+ * @lost: called if the ring is dropped by a pdev deinit, e.g. on SSR,
+ *	while still attached; the datapath no longer writes to it and the
+ *	caller has to detach and attach again
+ * @notify_ctx: context passed to @notify and @lost
+ */
+struct cdp_mon_capture_ring_cfg {
+	void *base;
+	uint32_t block_size;
+	uint32_t num_blocks;
+	uint32_t snaplen;
+	uint32_t retire_tmo_ms;
+	uint32_t frame_filter;
+	bool peer_filter;
+	uint8_t peer_mac[QDF_MAC_ADDR_SIZE];
+	cdp_mon_capture_notify_cb notify;
+	cdp_mon_capture_notify_cb lost;
+	void *notify_ctx;
+};
+
+/**
+ * struct cdp_mon_capture_ring_stats - monitor capture ring counters
+ * @captured: packets written to the ring
+ * @truncated: packets stored shorter than snaplen to fit a block
+ * @filtered: packets dropped by the frame type or peer filter
+ * @dropped: packets dropped because no block was free
+ * @blocks_retired: blocks handed to the reader
+ */
+struct cdp_mon_capture_ring_stats {
+	uint64_t captured;
+	uint64_t truncated;
+	uint64_t filtered;
+	uint64_t dropped;
+	uint64_t blocks_retired;
+};
+#endif /* WLAN_DP_MON_CAPTURE_RING */
 #endif
@@ -1044,6 +1044,11 @@ struct cdp_me_ops {
  * @start_local_pkt_capture: start local packet capture
  * @stop_local_pkt_capture: stop local packet capture
  * @is_local_pkt_capture_running: is local packet capture running
+ * @mon_capture_ring_attach: start writing monitor MPDUs to a capture ring
+ * @mon_capture_ring_detach: stop writing to the capture ring
+ * @mon_capture_ring_flush: retire the partially filled capture block
+ * @mon_capture_ring_set_filter: update the capture ring frame/peer filter
+ * @mon_capture_ring_get_stats: get capture ring counters
  */
 struct cdp_mon_ops {
 
@@ -1162,6 +1167,21 @@ struct cdp_mon_ops {
 	bool (*is_local_pkt_capture_running)(struct cdp_soc_t *soc,
 					     uint8_t pdev_id);
 #endif
+#ifdef WLAN_DP_MON_CAPTURE_RING
+	QDF_STATUS (*mon_capture_ring_attach)
+			(struct cdp_soc_t *soc, uint8_t pdev_id,
+			 struct cdp_mon_capture_ring_cfg *cfg);
+	QDF_STATUS (*mon_capture_ring_detach)(struct cdp_soc_t *soc,
+					      uint8_t pdev_id);
+	QDF_STATUS (*mon_capture_ring_flush)(struct cdp_soc_t *soc,
+					     uint8_t pdev_id, bool force);
+	QDF_STATUS (*mon_capture_ring_set_filter)
+			(struct cdp_soc_t *soc, uint8_t pdev_id,
+			 uint32_t frame_filter, uint8_t *peer_mac);
+	QDF_STATUS (*mon_capture_ring_get_stats)
+			(struct cdp_soc_t *soc, uint8_t pdev_id,
+			 struct cdp_mon_capture_ring_stats *stats);
+#endif
 };
 
 /**
@@ -1830,6 +1850,8 @@ void (*peer_send_wds_disconnect)(struct cdp_ctrl_objmgr_psoc *psoc,
  * @get_bus_vote_lvl_high: Get bus lvl to determine whether or not get
  *                         rx rate stats
  * @evaluate_update_tx_ilp_cfg: Evaluate and update DP TX ILP configuration
+ * @set_tx_link_metrics: Enable or disable TX link metrics for a vdev
+ * @get_tx_link_metrics: Get the TX link metrics of a vdev
  *
  * Function pointers for miscellaneous soc/pdev/vdev related operations.
  */
@@ -1937,6 +1959,13 @@ struct cdp_misc_ops {
 					   uint8_t num_msdu_idx_map,
 					   uint8_t *msdu_idx_map_arr);
 #endif
+#ifdef WLAN_DP_MLO_LINK_SCHED
+	QDF_STATUS (*set_tx_link_metrics)(struct cdp_soc_t *soc_hdl,
+					  uint8_t vdev_id, bool enable);
+	QDF_STATUS (*get_tx_link_metrics)(struct cdp_soc_t *soc_hdl,
+					  uint8_t vdev_id,
+					  struct cdp_tx_link_metrics *metrics);
+#endif
 };
 
 /**
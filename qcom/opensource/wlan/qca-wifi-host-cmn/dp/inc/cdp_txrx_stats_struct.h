@@ -3463,4 +3463,26 @@ struct cdp_pdev_tx_capture_stats {
 	uint32_t htt_frame_type[CDP_TX_CAP_HTT_MAX_FTYPE];
 	struct cdp_tid_q_len len_stats;
 };
+
+#ifdef WLAN_DP_MLO_LINK_SCHED
+/**
+ * struct cdp_tx_link_metrics - TX load of one MLO link vdev
+ * @enq: MSDUs enqueued to TCL since metrics were enabled
+ * @comp: MSDUs completed or flushed since metrics were enabled
+ * @pending: MSDUs enqueued and not yet completed
+ * @lat_ewma_us: EWMA of the enqueue to completion latency in us
+ * @svc_ewma_us: EWMA of the time between completions while the link
+ *		 had MSDUs pending, in us
+ *
+ * The expected delay of a new MSDU on the link is roughly
+ * @lat_ewma_us + @pending * @svc_ewma_us.
+ */
+struct cdp_tx_link_metrics {
+	uint32_t enq;
+	uint32_t comp;
+	uint32_t pending;
+	uint32_t lat_ewma_us;
+	uint32_t svc_ewma_us;
+};
+#endif
 #endif
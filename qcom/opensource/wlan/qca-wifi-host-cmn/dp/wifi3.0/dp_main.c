@@ -13343,6 +13343,10 @@ static struct cdp_misc_ops dp_ops_misc = {
 #ifdef DP_TX_PACKET_INSPECT_FOR_ILP
 	.evaluate_update_tx_ilp_cfg = dp_evaluate_update_tx_ilp_config,
 #endif
+#ifdef WLAN_DP_MLO_LINK_SCHED
+	.set_tx_link_metrics = dp_set_tx_link_metrics,
+	.get_tx_link_metrics = dp_get_tx_link_metrics,
+#endif
 };
 #endif
 
@@ -2690,6 +2690,29 @@ void dp_rx_nbuf_unmap_pool(struct dp_soc *soc,
 }
 #endif
 
+/**
+ * dp_rx_nbuf_unmap_batch() - unmap the nbufs of a batch of RX descriptors
+ * @soc: DP SoC handle
+ * @rx_desc: RX descriptors whose nbufs are unmapped
+ * @num: number of entries in @rx_desc
+ * @reo_ring_num: REO destination ring being reaped
+ *
+ * The cache invalidates are issued back to back. Like dp_rx_nbuf_unmap()
+ * they leave the barrier to the caller.
+ *
+ * Return: None
+ */
+static inline
+void dp_rx_nbuf_unmap_batch(struct dp_soc *soc,
+			    struct dp_rx_desc **rx_desc,
+			    uint8_t num, uint8_t reo_ring_num)
+{
+	uint8_t i;
+
+	for (i = 0; i < num; i++)
+		dp_rx_nbuf_unmap(soc, rx_desc[i], reo_ring_num);
+}
+
 static inline
 void dp_rx_per_core_stats_update(struct dp_soc *soc, uint8_t ring_id,
 				 uint32_t bufs_reaped)
@@ -2804,6 +2827,47 @@ void dp_rx_nbuf_unmap_pool(struct dp_soc *soc,
 				     rx_desc_pool->buf_size);
 }
 
+/**
+ * dp_rx_nbuf_unmap_batch() - unmap the nbufs of a batch of RX descriptors
+ * @soc: DP SoC handle
+ * @rx_desc: RX descriptors whose nbufs are unmapped
+ * @num: number of entries in @rx_desc
+ * @reo_ring_num: REO destination ring being reaped
+ *
+ * The IPA REO context lock is taken once for the whole batch instead of
+ * once per nbuf.
+ *
+ * Return: None
+ */
+static inline
+void dp_rx_nbuf_unmap_batch(struct dp_soc *soc,
+			    struct dp_rx_desc **rx_desc,
+			    uint8_t num, uint8_t reo_ring_num)
+{
+	struct rx_desc_pool *rx_desc_pool;
+	qdf_nbuf_t nbuf;
+	uint8_t i;
+
+	dp_ipa_reo_ctx_buf_mapping_lock(soc, reo_ring_num);
+
+	for (i = 0; i < num; i++) {
+		rx_desc_pool = &soc->rx_desc_buf[rx_desc[i]->pool_id];
+		nbuf = rx_desc[i]->nbuf;
+
+		dp_audio_smmu_unmap(soc->osdev, QDF_NBUF_CB_PADDR(nbuf),
+				    rx_desc_pool->buf_size);
+		dp_ipa_handle_rx_buf_smmu_mapping(soc, nbuf,
+						  rx_desc_pool->buf_size,
+						  false, __func__, __LINE__);
+		qdf_nbuf_unmap_nbytes_single(soc->osdev, nbuf,
+					     QDF_DMA_FROM_DEVICE,
+					     rx_desc_pool->buf_size);
+		rx_desc[i]->unmapped = 1;
+	}
+
+	dp_ipa_reo_ctx_buf_mapping_unlock(soc, reo_ring_num);
+}
+
 static inline
 void dp_rx_per_core_stats_update(struct dp_soc *soc, uint8_t ring_id,
 				 uint32_t bufs_reaped)
@@ -2829,6 +2893,100 @@ void dp_rx_nbuf_free(qdf_nbuf_t nbuf)
 }
 #endif
 
+#ifdef WLAN_DP_RX_REAP_BATCH
+/* Number of reaped RX descriptors unmapped and processed together */
+#define DP_RX_REAP_BATCH_SIZE 16
+#else
+#define DP_RX_REAP_BATCH_SIZE 1
+#endif
+
+/**
+ * struct dp_rx_reap_batch - reaped RX descriptors yet to be processed
+ * @rx_desc: RX descriptors whose nbufs are still mapped
+ * @num: number of valid entries in @rx_desc
+ *
+ * The reap loop stages the RX descriptors it pulls from the REO ring.
+ * Once the batch is full, and once the reap is done, the nbuf heads of
+ * the batch are prefetched, the nbufs are unmapped together and only
+ * then are they queued and their RX descriptors freed. No nbuf reaches
+ * DP_RX_PROCESS_NBUF(), which may hand it back to the RX buffer pool,
+ * while it is still mapped.
+ *
+ * Without WLAN_DP_RX_REAP_BATCH the batch holds a single descriptor and
+ * every nbuf is processed as soon as it is reaped.
+ */
+struct dp_rx_reap_batch {
+	struct dp_rx_desc *rx_desc[DP_RX_REAP_BATCH_SIZE];
+	uint8_t num;
+};
+
+#ifdef WLAN_DP_RX_REAP_BATCH
+/**
+ * dp_rx_reap_batch_prefetch() - prefetch the nbuf heads of a reap batch
+ * @batch: reap batch
+ *
+ * The unmap and the queueing of the staged nbufs both touch the nbuf
+ * head, so issue those cache misses back to back first. The nbuf data
+ * is not prefetched, it is only valid once the unmap is done.
+ *
+ * Return: None
+ */
+static inline void dp_rx_reap_batch_prefetch(struct dp_rx_reap_batch *batch)
+{
+	uint8_t i;
+
+	for (i = 0; i < batch->num; i++) {
+		qdf_prefetch((uint8_t *)batch->rx_desc[i]->nbuf);
+		qdf_prefetch((uint8_t *)batch->rx_desc[i]->nbuf + 64);
+	}
+}
+#else
+static inline void dp_rx_reap_batch_prefetch(struct dp_rx_reap_batch *batch)
+{
+}
+#endif /* WLAN_DP_RX_REAP_BATCH */
+
+static inline void dp_rx_reap_batch_init(struct dp_rx_reap_batch *batch)
+{
+	batch->num = 0;
+}
+
+/**
+ * dp_rx_reap_batch_add() - stage a reaped RX descriptor
+ * @batch: reap batch
+ * @rx_desc: reaped RX descriptor, its nbuf is still mapped
+ *
+ * Return: true if the batch is full and must be processed
+ */
+static inline bool dp_rx_reap_batch_add(struct dp_rx_reap_batch *batch,
+					struct dp_rx_desc *rx_desc)
+{
+	batch->rx_desc[batch->num++] = rx_desc;
+
+	return batch->num == DP_RX_REAP_BATCH_SIZE;
+}
+
+/**
+ * dp_rx_reap_batch_unmap() - prefetch and unmap the staged nbufs
+ * @soc: DP SoC handle
+ * @batch: reap batch
+ * @reo_ring_num: REO destination ring being reaped
+ *
+ * Must be called before the staged nbufs are queued. The caller then
+ * queues every staged nbuf, frees the staged RX descriptors and resets
+ * the batch.
+ *
+ * Return: None
+ */
+static inline void dp_rx_reap_batch_unmap(struct dp_soc *soc,
+					  struct dp_rx_reap_batch *batch,
+					  uint8_t reo_ring_num)
+{
+	dp_rx_reap_batch_prefetch(batch);
+	dp_rx_nbuf_unmap_batch(soc, batch->rx_desc, batch->num,
+			       reo_ring_num);
+}
+
 #ifdef DP_UMAC_HW_RESET_SUPPORT
 /**
  * dp_rx_desc_reuse() - Reuse the rx descriptors to fill the rx buf ring
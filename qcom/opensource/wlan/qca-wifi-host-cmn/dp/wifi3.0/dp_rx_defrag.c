@@ -197,6 +197,7 @@ void dp_rx_defrag_waitlist_flush(struct dp_soc *soc)
 
 		TAILQ_REMOVE(&soc->rx.defrag.waitlist, waitlist_elem,
 			     defrag_waitlist_elem);
+		waitlist_elem->on_waitlist = false;
 		DP_STATS_DEC(soc, rx.rx_frag_wait, 1);
 
 		/* Move to temp list and clean-up later */
@@ -257,6 +258,7 @@ void dp_rx_defrag_waitlist_add(struct dp_txrx_peer *txrx_peer,
 
 	TAILQ_INSERT_TAIL(&psoc->rx.defrag.waitlist, waitlist_elem,
 			  defrag_waitlist_elem);
+	waitlist_elem->on_waitlist = true;
 	DP_STATS_INC(psoc, rx.rx_frag_wait, 1);
 	qdf_spin_unlock_bh(&psoc->rx.defrag.defrag_lock);
 }
@@ -267,7 +269,6 @@ void dp_rx_defrag_waitlist_remove(struct dp_txrx_peer *txrx_peer,
 	struct dp_pdev *pdev = txrx_peer->vdev->pdev;
 	struct dp_soc *soc = pdev->soc;
 	struct dp_rx_tid_defrag *waitlist_elm;
-	struct dp_rx_tid_defrag *tmp;
 
 	dp_debug("Removing TID %u to waitlist for peer %pK peer_id = %d ",
 		 tid, txrx_peer, txrx_peer->peer_id);
@@ -277,35 +278,45 @@ void dp_rx_defrag_waitlist_remove(struct dp_txrx_peer *txrx_peer,
 		qdf_assert_always(0);
 	}
 
-	qdf_spin_lock_bh(&soc->rx.defrag.defrag_lock);
-	TAILQ_FOREACH_SAFE(waitlist_elm, &soc->rx.defrag.waitlist,
-			   defrag_waitlist_elem, tmp) {
-		struct dp_txrx_peer *peer_on_waitlist;
-
-		/* get address of current peer */
-		peer_on_waitlist = waitlist_elm->defrag_peer;
+	waitlist_elm = &txrx_peer->rx_tid[tid];
 
-		/* Ensure it is TID for same peer */
-		if (peer_on_waitlist == txrx_peer && waitlist_elm->tid == tid) {
-			TAILQ_REMOVE(&soc->rx.defrag.waitlist,
-				     waitlist_elm, defrag_waitlist_elem);
-			DP_STATS_DEC(soc, rx.rx_frag_wait, 1);
-		}
+	/* The TID is its own waitlist node, unlink it without a list walk */
+	qdf_spin_lock_bh(&soc->rx.defrag.defrag_lock);
+	if (waitlist_elm->on_waitlist) {
+		TAILQ_REMOVE(&soc->rx.defrag.waitlist,
+			     waitlist_elm, defrag_waitlist_elem);
+		waitlist_elm->on_waitlist = false;
+		DP_STATS_DEC(soc, rx.rx_frag_wait, 1);
 	}
 	qdf_spin_unlock_bh(&soc->rx.defrag.defrag_lock);
 }
 
+/**
+ * dp_rx_defrag_frag_hold() - Account a fragment held for reassembly
+ * @txrx_peer: Pointer to the peer data structure
+ * @rx_tid: Pointer to the defrag TID the fragment was linked to
+ * @fragno: Fragment number
+ *
+ * Return: None
+ */
+static inline void dp_rx_defrag_frag_hold(struct dp_txrx_peer *txrx_peer,
+					  struct dp_rx_tid_defrag *rx_tid,
+					  uint16_t fragno)
+{
+	rx_tid->frag_bitmap |= BIT(fragno);
+	qdf_atomic_inc(&txrx_peer->defrag_frag_cnt);
+}
+
 QDF_STATUS
 dp_rx_defrag_fraglist_insert(struct dp_txrx_peer *txrx_peer, unsigned int tid,
 			     qdf_nbuf_t *head_addr, qdf_nbuf_t *tail_addr,
 			     qdf_nbuf_t frag, uint8_t *all_frag_present)
 {
 	struct dp_soc *soc = txrx_peer->vdev->pdev->soc;
-	qdf_nbuf_t next;
 	qdf_nbuf_t prev = NULL;
 	qdf_nbuf_t cur;
-	uint16_t head_fragno, cur_fragno, next_fragno;
-	uint8_t last_morefrag = 1, count = 0;
+	uint16_t head_fragno, cur_fragno, last_fragno;
+	uint8_t last_morefrag = 1;
 	struct dp_rx_tid_defrag *rx_tid = &txrx_peer->rx_tid[tid];
 	uint8_t *rx_desc_info;
 
@@ -318,11 +329,28 @@ dp_rx_defrag_fraglist_insert(struct dp_txrx_peer *txrx_peer, unsigned int tid,
 	cur_fragno = dp_rx_frag_get_mpdu_frag_number(soc, rx_desc_info);
 
 	dp_debug("cur_fragno %d", cur_fragno);
+	if (cur_fragno >= DP_RX_DEFRAG_MAX_FRAGS ||
+	    (rx_tid->frag_bitmap & BIT(cur_fragno))) {
+		dp_rx_nbuf_free(frag);
+		goto insert_fail;
+	}
+
+	if (qdf_atomic_read(&txrx_peer->defrag_frag_cnt) >=
+	    DP_RX_DEFRAG_PEER_MAX_FRAGS) {
+		dp_info_rl("peer_id %d holds %d fragments, dropping",
+			   txrx_peer->peer_id,
+			   qdf_atomic_read(&txrx_peer->defrag_frag_cnt));
+		DP_STATS_INC(soc, rx.rx_frag_peer_limit, 1);
+		dp_rx_nbuf_free(frag);
+		goto insert_fail;
+	}
+
 	/* If this is the first fragment */
 	if (!(*head_addr)) {
 		*head_addr = *tail_addr = frag;
 		qdf_nbuf_set_next(*tail_addr, NULL);
 		rx_tid->curr_frag_num = cur_fragno;
+		dp_rx_defrag_frag_hold(txrx_peer, rx_tid, cur_fragno);
 
 		goto insert_done;
 	}
@@ -334,18 +362,14 @@ dp_rx_defrag_fraglist_insert(struct dp_txrx_peer *txrx_peer, unsigned int tid,
 		qdf_nbuf_set_next(*tail_addr, NULL);
 		rx_tid->curr_frag_num = cur_fragno;
 	} else {
-		/* Out of sequence fragment */
+		/* Out of sequence fragment, duplicates were dropped above */
 		cur = *head_addr;
 		rx_desc_info = qdf_nbuf_data(cur);
 		head_fragno = dp_rx_frag_get_mpdu_frag_number(soc,
 							      rx_desc_info);
 
-		if (cur_fragno == head_fragno) {
-			dp_rx_nbuf_free(frag);
-			goto insert_fail;
-		} else if (head_fragno > cur_fragno) {
+		if (head_fragno > cur_fragno) {
 			qdf_nbuf_set_next(frag, cur);
-			cur = frag;
 			*head_addr = frag; /* head pointer to be updated */
 		} else {
 			while ((cur_fragno > head_fragno) && cur) {
@@ -360,43 +384,24 @@ dp_rx_defrag_fraglist_insert(struct dp_txrx_peer *txrx_peer, unsigned int tid,
 				}
 			}
 
-			if (cur_fragno == head_fragno) {
-				dp_rx_nbuf_free(frag);
-				goto insert_fail;
-			}
-
 			qdf_nbuf_set_next(prev, frag);
 			qdf_nbuf_set_next(frag, cur);
 		}
 	}
-
-	next = qdf_nbuf_next(*head_addr);
+	dp_rx_defrag_frag_hold(txrx_peer, rx_tid, cur_fragno);
 
 	rx_desc_info = qdf_nbuf_data(*tail_addr);
 	last_morefrag = dp_rx_frag_get_more_frag_bit(soc, rx_desc_info);
 
-	/* TODO: optimize the loop */
+	/*
+	 * The tail holds the highest fragment number, the sequence is complete
+	 * once it is the last fragment and every lower number is held too.
+	 */
 	if (!last_morefrag) {
-		/* Check if all fragments are present */
-		do {
-			rx_desc_info = qdf_nbuf_data(next);
-			next_fragno =
-				dp_rx_frag_get_mpdu_frag_number(soc,
-								rx_desc_info);
-			count++;
-
-			if (next_fragno != count)
-				break;
-
-			next = qdf_nbuf_next(next);
-		} while (next);
-
-		if (!next) {
+		last_fragno = dp_rx_frag_get_mpdu_frag_number(soc,
+							      rx_desc_info);
+		if (rx_tid->frag_bitmap == (uint16_t)(BIT(last_fragno + 1) - 1))
 			*all_frag_present = 1;
-			return QDF_STATUS_SUCCESS;
-		} else {
-			/* revisit */
-		}
 	}
 
 insert_done:
@@ -1592,6 +1597,13 @@ void dp_rx_defrag_cleanup(struct dp_txrx_peer *txrx_peer, unsigned int tid)
 	/* Free up saved ring descriptors */
 	dp_rx_clear_saved_desc_info(txrx_peer, tid);
 
+	if (txrx_peer->rx_tid[tid].frag_bitmap) {
+		qdf_atomic_sub(qdf_get_hweight16(
+					txrx_peer->rx_tid[tid].frag_bitmap),
+			       &txrx_peer->defrag_frag_cnt);
+		txrx_peer->rx_tid[tid].frag_bitmap = 0;
+	}
+
 	txrx_peer->rx_tid[tid].defrag_timeout_ms = 0;
 	txrx_peer->rx_tid[tid].curr_frag_num = 0;
 	txrx_peer->rx_tid[tid].curr_seq_num = 0;
@@ -158,6 +158,14 @@ uint8_t dp_rx_get_pkt_dir(struct dp_soc *soc, uint8_t *rx_desc_info)
 	return mac_hdr->i_fc[1] & IEEE80211_FC1_DIR_MASK;
 }
 
+/* The fragment number is 4 bits wide, one bit per fragment in frag_bitmap */
+#define DP_RX_DEFRAG_MAX_FRAGS 16
+
+#ifndef DP_RX_DEFRAG_PEER_MAX_FRAGS
+/* Fragments one peer may hold for reassembly across all of its TIDs */
+#define DP_RX_DEFRAG_PEER_MAX_FRAGS 64
+#endif
+
 /**
  * dp_rx_defrag_fraglist_insert() - Create a per-sequence fragment list
  * @txrx_peer: Pointer to the peer data structure
@@ -167,7 +175,8 @@ uint8_t dp_rx_get_pkt_dir(struct dp_soc *soc, uint8_t *rx_desc_info)
  * @frag: Incoming fragment
  * @all_frag_present: Flag to indicate whether all fragments are received
  *
- * Build a per-tid, per-sequence fragment list.
+ * Build a per-tid, per-sequence fragment list. Duplicates and fragments
+ * past the per-peer DP_RX_DEFRAG_PEER_MAX_FRAGS budget are freed.
  *
  * Return: Success, if inserted
  */
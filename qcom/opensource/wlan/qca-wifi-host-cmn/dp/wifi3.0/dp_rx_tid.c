@@ -1192,6 +1192,7 @@ static void dp_peer_rx_tids_init(struct dp_peer *peer)
 	struct dp_rx_tid_defrag *rx_tid_defrag;
 
 	if (!IS_MLO_DP_LINK_PEER(peer)) {
+		qdf_atomic_init(&peer->txrx_peer->defrag_frag_cnt);
 		for (tid = 0; tid < DP_MAX_TIDS; tid++) {
 			rx_tid_defrag = &peer->txrx_peer->rx_tid[tid];
 
@@ -1199,6 +1200,8 @@ static void dp_peer_rx_tids_init(struct dp_peer *peer)
 			rx_tid_defrag->defrag_timeout_ms = 0;
 			rx_tid_defrag->defrag_waitlist_elem.tqe_next = NULL;
 			rx_tid_defrag->defrag_waitlist_elem.tqe_prev = NULL;
+			rx_tid_defrag->on_waitlist = false;
+			rx_tid_defrag->frag_bitmap = 0;
 			rx_tid_defrag->base.head = NULL;
 			rx_tid_defrag->base.tail = NULL;
 			rx_tid_defrag->tid = tid;
@@ -1226,6 +1229,7 @@ static void dp_peer_rx_tids_init(struct dp_peer *peer)
 	struct dp_rx_tid *rx_tid;
 	struct dp_rx_tid_defrag *rx_tid_defrag;
 
+	qdf_atomic_init(&peer->txrx_peer->defrag_frag_cnt);
 	for (tid = 0; tid < DP_MAX_TIDS; tid++) {
 		rx_tid = &peer->rx_tid[tid];
 
@@ -1241,6 +1245,8 @@ static void dp_peer_rx_tids_init(struct dp_peer *peer)
 		rx_tid_defrag->defrag_timeout_ms = 0;
 		rx_tid_defrag->defrag_waitlist_elem.tqe_next = NULL;
 		rx_tid_defrag->defrag_waitlist_elem.tqe_prev = NULL;
+		rx_tid_defrag->on_waitlist = false;
+		rx_tid_defrag->frag_bitmap = 0;
 		rx_tid_defrag->defrag_peer = peer->txrx_peer;
 	}
 }
@@ -379,6 +379,112 @@ dp_tx_release_ds_tx_desc(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
 }
 #endif
 
+#ifdef WLAN_DP_MLO_LINK_SCHED
+/* A new sample weighs 1/2^DP_TX_LINK_EWMA_SHIFT in the link EWMAs */
+#define DP_TX_LINK_EWMA_SHIFT 3
+/* Longer samples are stale descriptors */
+#define DP_TX_LINK_MAX_SAMPLE_US 1000000
+
+static inline uint32_t dp_tx_link_ewma(uint32_t avg, uint32_t sample)
+{
+	if (!avg)
+		return sample;
+
+	return ((avg << DP_TX_LINK_EWMA_SHIFT) - avg + sample) >>
+		DP_TX_LINK_EWMA_SHIFT;
+}
+
+void dp_tx_link_metrics_update(struct dp_soc *soc,
+			       struct dp_tx_desc_s *tx_desc, bool completed)
+{
+	struct dp_tx_link_metrics *metrics;
+	int32_t pending;
+	int64_t now_us;
+	int64_t sample;
+
+	metrics = &soc->tx_link_metrics[tx_desc->vdev_id];
+	pending = qdf_atomic_read(&metrics->enq) -
+		  qdf_atomic_inc_return(&metrics->comp);
+
+	if (!completed || (tx_desc->flags & DP_TX_DESC_FLAG_FLUSH) ||
+	    !metrics->enabled)
+		return;
+
+	now_us = qdf_ktime_to_us(qdf_ktime_get());
+	sample = now_us - qdf_ktime_to_us(tx_desc->link_enq_ts);
+	if (sample >= 0 && sample < DP_TX_LINK_MAX_SAMPLE_US)
+		metrics->lat_ewma_us = dp_tx_link_ewma(metrics->lat_ewma_us,
+						       sample);
+
+	/*
+	 * The gap to the previous completion is a service time sample only
+	 * if the link stayed backlogged in between.
+	 */
+	if (metrics->last_comp_us) {
+		sample = now_us - metrics->last_comp_us;
+		if (sample >= 0 && sample < DP_TX_LINK_MAX_SAMPLE_US)
+			metrics->svc_ewma_us =
+				dp_tx_link_ewma(metrics->svc_ewma_us, sample);
+	}
+
+	metrics->last_comp_us = pending > 0 ? now_us : 0;
+}
+
+QDF_STATUS dp_set_tx_link_metrics(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
+				  bool enable)
+{
+	struct dp_soc *soc = cdp_soc_t_to_dp_soc(soc_hdl);
+	struct dp_tx_link_metrics *metrics;
+
+	if (vdev_id >= MAX_VDEV_CNT)
+		return QDF_STATUS_E_INVAL;
+
+	metrics = &soc->tx_link_metrics[vdev_id];
+	if (!enable) {
+		metrics->enabled = false;
+		return QDF_STATUS_SUCCESS;
+	}
+
+	if (metrics->enabled)
+		return QDF_STATUS_SUCCESS;
+
+	qdf_atomic_set(&metrics->enq, 0);
+	qdf_atomic_set(&metrics->comp, 0);
+	metrics->lat_ewma_us = 0;
+	metrics->svc_ewma_us = 0;
+	metrics->last_comp_us = 0;
+	qdf_wmb();
+	metrics->enabled = true;
+
+	return QDF_STATUS_SUCCESS;
+}
+
+QDF_STATUS dp_get_tx_link_metrics(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
+				  struct cdp_tx_link_metrics *metrics)
+{
+	struct dp_soc *soc = cdp_soc_t_to_dp_soc(soc_hdl);
+	struct dp_tx_link_metrics *link;
+	int32_t pending;
+
+	if (vdev_id >= MAX_VDEV_CNT || !metrics)
+		return QDF_STATUS_E_INVAL;
+
+	link = &soc->tx_link_metrics[vdev_id];
+	metrics->enq = qdf_atomic_read(&link->enq);
+	metrics->comp = qdf_atomic_read(&link->comp);
+	/*
+	 * Descriptors enqueued before the last reset complete after it,
+	 * so comp may briefly run ahead of enq.
+	 */
+	pending = metrics->enq - metrics->comp;
+	metrics->pending = pending > 0 ? pending : 0;
+	metrics->lat_ewma_us = link->lat_ewma_us;
+	metrics->svc_ewma_us = link->svc_ewma_us;
+
+	return QDF_STATUS_SUCCESS;
+}
+#endif /* WLAN_DP_MLO_LINK_SCHED */
+
 void
 dp_tx_desc_release(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
 		   uint8_t desc_pool_id)
@@ -394,6 +500,7 @@ dp_tx_desc_release(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
 	soc = pdev->soc;
 
 	dp_tx_outstanding_dec(pdev);
+	dp_tx_link_metrics_comp(soc, tx_desc, false);
 
 	if (tx_desc->msdu_ext_desc) {
 		if (tx_desc->frm_type == dp_tx_frm_tso)
@@ -6494,6 +6601,8 @@ dp_tx_comp_process_desc_list(struct dp_soc *soc,
 			continue;
 		}
 
+		dp_tx_link_metrics_comp(soc, desc, true);
+
 		if (desc->flags & DP_TX_DESC_FLAG_PPEDS) {
 			qdf_nbuf_t nbuf;
 			dp_tx_update_ppeds_tx_comp_stats(soc, txrx_peer, &ts,
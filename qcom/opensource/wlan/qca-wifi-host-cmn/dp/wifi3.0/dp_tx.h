@@ -76,6 +76,7 @@ int dp_tx_proxy_arp(struct dp_vdev *vdev, qdf_nbuf_t nbuf);
 #define DP_TX_DESC_FLAG_PPEDS		0x20000
 #define DP_TX_DESC_FLAG_FAST		0x40000
 #define DP_TX_DESC_FLAG_SPECIAL         0x80000
+#define DP_TX_DESC_FLAG_LINK_METRICS	0x100000
 
 #define DP_TX_EXT_DESC_FLAG_METADATA_VALID 0x1
 
@@ -1720,6 +1721,98 @@ bool dp_tx_desc_set_ktimestamp(struct dp_vdev *vdev,
 }
 #endif
 
+#ifdef WLAN_DP_MLO_LINK_SCHED
+/**
+ * dp_tx_link_metrics_update() - account a TX link metrics descriptor
+ * @soc: DP soc handle
+ * @tx_desc: tx descriptor enqueued with DP_TX_DESC_FLAG_LINK_METRICS
+ * @completed: descriptor was completed by HW/FW, false for flush or free
+ *	       without completion
+ *
+ * Return: none
+ */
+void dp_tx_link_metrics_update(struct dp_soc *soc,
+			       struct dp_tx_desc_s *tx_desc, bool completed);
+
+/**
+ * dp_tx_link_metrics_enq() - account an MSDU enqueued to TCL
+ * @soc: DP soc handle
+ * @vdev: DP vdev handle
+ * @tx_desc: tx descriptor
+ *
+ * Return: none
+ */
+static inline void dp_tx_link_metrics_enq(struct dp_soc *soc,
+					  struct dp_vdev *vdev,
+					  struct dp_tx_desc_s *tx_desc)
+{
+	struct dp_tx_link_metrics *metrics;
+
+	metrics = &soc->tx_link_metrics[vdev->vdev_id];
+	if (qdf_likely(!metrics->enabled))
+		return;
+
+	tx_desc->link_enq_ts = qdf_ktime_get();
+	tx_desc->flags |= DP_TX_DESC_FLAG_LINK_METRICS;
+	qdf_atomic_inc(&metrics->enq);
+}
+
+/**
+ * dp_tx_link_metrics_comp() - account the completion of an MSDU
+ * @soc: DP soc handle
+ * @tx_desc: tx descriptor
+ * @completed: descriptor was completed by HW/FW
+ *
+ * Each enqueued descriptor is accounted once, the flag is cleared here.
+ *
+ * Return: none
+ */
+static inline void dp_tx_link_metrics_comp(struct dp_soc *soc,
+					   struct dp_tx_desc_s *tx_desc,
+					   bool completed)
+{
+	if (qdf_likely(!(tx_desc->flags & DP_TX_DESC_FLAG_LINK_METRICS)))
+		return;
+
+	tx_desc->flags &= ~DP_TX_DESC_FLAG_LINK_METRICS;
+	dp_tx_link_metrics_update(soc, tx_desc, completed);
+}
+
+/**
+ * dp_set_tx_link_metrics() - enable or disable TX link metrics of a vdev
+ * @soc_hdl: CDP soc handle
+ * @vdev_id: vdev id
+ * @enable: true to reset and start collecting, false to stop
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS dp_set_tx_link_metrics(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
+				  bool enable);
+
+/**
+ * dp_get_tx_link_metrics() - get the TX link metrics of a vdev
+ * @soc_hdl: CDP soc handle
+ * @vdev_id: vdev id
+ * @metrics: filled with the link metrics
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS dp_get_tx_link_metrics(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
+				  struct cdp_tx_link_metrics *metrics);
+#else
+static inline void dp_tx_link_metrics_enq(struct dp_soc *soc,
+					  struct dp_vdev *vdev,
+					  struct dp_tx_desc_s *tx_desc)
+{
+}
+
+static inline void dp_tx_link_metrics_comp(struct dp_soc *soc,
+					   struct dp_tx_desc_s *tx_desc,
+					   bool completed)
+{
+}
+#endif /* WLAN_DP_MLO_LINK_SCHED */
+
 #ifdef CONFIG_DP_PKT_ADD_TIMESTAMP
 /**
  * dp_pkt_add_timestamp() - add timestamp in data payload
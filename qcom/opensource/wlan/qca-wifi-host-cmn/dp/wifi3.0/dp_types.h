@@ -674,6 +674,8 @@ struct dp_tx_ext_desc_pool_s {
  * @timestamp:
  * @driver_egress_ts: driver egress timestamp
  * @driver_ingress_ts: driver ingress timestamp
+ * @link_enq_ts: TCL enqueue time for the TX link metrics, kept apart from
+ *		 @timestamp which the delay stats and tracking own
  * @comp:
  * @tcl_cmd_vaddr: VADDR of the TCL descriptor, valid for soft-umac arch
  * @tcl_cmd_paddr: PADDR of the TCL descriptor, valid for soft-umac arch
@@ -704,6 +706,9 @@ struct dp_tx_desc_s {
 #ifdef WLAN_FEATURE_TX_LATENCY_STATS
 	qdf_ktime_t driver_egress_ts;
 	qdf_ktime_t driver_ingress_ts;
+#endif
+#ifdef WLAN_DP_MLO_LINK_SCHED
+	qdf_ktime_t link_enq_ts;
 #endif
 	struct hal_tx_desc_comp_s comp;
 #ifdef WLAN_SOFTUMAC_SUPPORT
@@ -939,6 +944,10 @@ struct dp_rx_tid_defrag {
 	/* Sequence and fragments that are being processed currently */
 	uint32_t curr_seq_num;
 	uint32_t curr_frag_num;
+	/* Fragment numbers held for the current sequence */
+	uint16_t frag_bitmap;
+	/* Set while linked on the soc defrag waitlist */
+	bool on_waitlist;
 
 	/* TODO: Check the following while adding defragmentation support */
 	struct dp_rx_reorder_array_elem *array;
@@ -1280,6 +1289,8 @@ struct dp_soc_stats {
 		uint32_t rx_frag_err_len_error;
 		/* Fragments dropped due to no peer found */
 		uint32_t rx_frag_err_no_peer;
+		/* Fragments dropped as the peer holds too many fragments */
+		uint32_t rx_frag_peer_limit;
 		/* No of reinjected packets */
 		uint32_t reo_reinject;
 		/* Reap loop packet limit hit */
@@ -2692,6 +2703,30 @@ struct dp_rx_msdu_done_fail_desc_list {
 };
 #endif
 
+#ifdef WLAN_DP_MLO_LINK_SCHED
+/**
+ * struct dp_tx_link_metrics - TX load of a vdev for MLO link selection
+ * @enabled: metrics are being collected for the vdev
+ * @enq: MSDUs enqueued to TCL
+ * @comp: MSDUs completed or flushed
+ * @lat_ewma_us: EWMA of the enqueue to completion latency in us
+ * @svc_ewma_us: EWMA of the time between completions while busy, in us
+ * @last_comp_us: time of the last completion in us
+ *
+ * Indexed by vdev id in the soc so that completions can account without
+ * taking a vdev reference. The EWMAs are updated from several completion
+ * rings without a lock, a lost sample is harmless.
+ */
+struct dp_tx_link_metrics {
+	bool enabled;
+	qdf_atomic_t enq;
+	qdf_atomic_t comp;
+	uint32_t lat_ewma_us;
+	uint32_t svc_ewma_us;
+	uint64_t last_comp_us;
+};
+#endif
+
 /* SOC level structure for data path */
 struct dp_soc {
 	/**
@@ -3269,6 +3304,10 @@ struct dp_soc {
 #endif
 	/* monitor interface flags */
 	uint32_t mon_flags;
+#ifdef WLAN_DP_MLO_LINK_SCHED
+	/* per vdev TX load used for MLO link selection */
+	struct dp_tx_link_metrics tx_link_metrics[MAX_VDEV_CNT];
+#endif
 };
 
 #ifdef IPA_OFFLOAD
@@ -4990,6 +5029,7 @@ struct dp_local_link_id_peer_map {
  * @wds_ext:
  * @osif_rx:
  * @rx_tid:
+ * @defrag_frag_cnt: fragments held for reassembly across all TIDs
  * @sawf_stats:
  * @bw: bandwidth of peer connection
  * @mpdu_retry_threshold: MPDU retry threshold to increment tx bad count
@@ -5039,6 +5079,7 @@ struct dp_txrx_peer {
 	ol_txrx_rx_fp osif_rx;
 #endif
 	struct dp_rx_tid_defrag rx_tid[DP_MAX_TIDS];
+	qdf_atomic_t defrag_frag_cnt;
 #ifdef CONFIG_SAWF
 	struct dp_peer_sawf_stats *sawf_stats;
 #endif
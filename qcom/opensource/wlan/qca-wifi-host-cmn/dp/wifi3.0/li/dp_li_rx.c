@@ -189,6 +189,48 @@ dp_rx_intrabss_fwd_li(struct dp_soc *soc,
 }
 #endif
 
+/**
+ * dp_rx_reap_batch_process_li() - unmap and queue the staged RX descriptors
+ * @soc: DP SoC handle
+ * @batch: reap batch
+ * @reo_ring_num: REO destination ring being reaped
+ * @nbuf_head: head of the list of nbufs to deliver
+ * @nbuf_tail: tail of the list of nbufs to deliver
+ * @ebuf_head: head of the list of nbufs pending a buffer pool refill
+ * @ebuf_tail: tail of the list of nbufs pending a buffer pool refill
+ * @head: per pool head of the free RX descriptor lists
+ * @tail: per pool tail of the free RX descriptor lists
+ *
+ * Return: None
+ */
+static inline void
+dp_rx_reap_batch_process_li(struct dp_soc *soc,
+			    struct dp_rx_reap_batch *batch,
+			    uint8_t reo_ring_num,
+			    qdf_nbuf_t *nbuf_head, qdf_nbuf_t *nbuf_tail,
+			    qdf_nbuf_t *ebuf_head, qdf_nbuf_t *ebuf_tail,
+			    union dp_rx_desc_list_elem_t *head[MAX_PDEV_CNT],
+			    union dp_rx_desc_list_elem_t *tail[MAX_PDEV_CNT])
+{
+	struct dp_rx_desc *rx_desc;
+	uint8_t i;
+
+	dp_rx_reap_batch_unmap(soc, batch, reo_ring_num);
+
+	for (i = 0; i < batch->num; i++) {
+		rx_desc = batch->rx_desc[i];
+
+		DP_RX_PROCESS_NBUF(soc, *nbuf_head, *nbuf_tail, *ebuf_head,
+				   *ebuf_tail, rx_desc);
+
+		/* The free list entry overlays rx_desc->nbuf, add it last */
+		dp_rx_add_to_free_desc_list(&head[rx_desc->pool_id],
+					    &tail[rx_desc->pool_id], rx_desc);
+	}
+
+	batch->num = 0;
+}
+
 uint32_t dp_rx_process_li(struct dp_intr *int_ctx,
 			  hal_ring_handle_t hal_ring_hdl, uint8_t reo_ring_num,
 			  uint32_t quota)
@@ -203,6 +245,7 @@ uint32_t dp_rx_process_li(struct dp_intr *int_ctx,
 	union dp_rx_desc_list_elem_t *head[MAX_PDEV_CNT];
 	union dp_rx_desc_list_elem_t *tail[MAX_PDEV_CNT];
 	uint32_t num_pending = 0;
+	struct dp_rx_reap_batch reap_batch;
 	uint32_t rx_bufs_used = 0, rx_buf_cookie;
 	uint16_t msdu_len = 0;
 	uint16_t peer_id;
@@ -269,6 +312,7 @@ more_data:
 	txrx_peer = NULL;
 	vdev = NULL;
 	num_rx_bufs_reaped = 0;
+	dp_rx_reap_batch_init(&reap_batch);
 	ebuf_head = NULL;
 	ebuf_tail = NULL;
 	max_reap_limit = dp_rx_get_loop_pkt_limit(soc);
@@ -492,20 +536,20 @@ more_data:
 
 		QDF_NBUF_CB_RX_CTX_ID(rx_desc->nbuf) = reo_ring_num;
 
+		quota -= 1;
+		num_pending -= 1;
+		num_rx_bufs_reaped++;
+
 		/*
 		 * move unmap after scattered msdu waiting break logic
 		 * in case double skb unmap happened.
 		 */
-		dp_rx_nbuf_unmap(soc, rx_desc, reo_ring_num);
-		DP_RX_PROCESS_NBUF(soc, nbuf_head, nbuf_tail, ebuf_head,
-				   ebuf_tail, rx_desc);
-
-		quota -= 1;
-		num_pending -= 1;
-
-		dp_rx_add_to_free_desc_list(&head[rx_desc->pool_id],
-					    &tail[rx_desc->pool_id], rx_desc);
-		num_rx_bufs_reaped++;
+		if (dp_rx_reap_batch_add(&reap_batch, rx_desc))
+			dp_rx_reap_batch_process_li(soc, &reap_batch,
+						    reo_ring_num,
+						    &nbuf_head, &nbuf_tail,
+						    &ebuf_head, &ebuf_tail,
+						    head, tail);
 
 		dp_rx_prefetch_hw_sw_nbuf_desc(soc, hal_soc, num_pending,
 					       hal_ring_hdl,
@@ -523,6 +567,9 @@ more_data:
 	}
 done:
 	dp_rx_srng_access_end(int_ctx, soc, hal_ring_hdl);
+	dp_rx_reap_batch_process_li(soc, &reap_batch, reo_ring_num,
+				    &nbuf_head, &nbuf_tail,
+				    &ebuf_head, &ebuf_tail, head, tail);
 
 	dp_rx_per_core_stats_update(soc, reo_ring_num, num_rx_bufs_reaped);
 
@@ -1556,6 +1556,13 @@ struct cdp_mon_ops dp_ops_mon_1_0 = {
 	.stop_local_pkt_capture = dp_mon_stop_local_pkt_capture,
 	.is_local_pkt_capture_running = dp_mon_get_is_local_pkt_capture_running,
 #endif /* WLAN_FEATURE_LOCAL_PKT_CAPTURE */
+#ifdef WLAN_DP_MON_CAPTURE_RING
+	.mon_capture_ring_attach = dp_mon_capture_ring_attach,
+	.mon_capture_ring_detach = dp_mon_capture_ring_detach,
+	.mon_capture_ring_flush = dp_mon_capture_ring_flush,
+	.mon_capture_ring_set_filter = dp_mon_capture_ring_set_filter,
+	.mon_capture_ring_get_stats = dp_mon_capture_ring_get_stats,
+#endif
 };
 
 #ifdef QCA_MONITOR_OPS_PER_SOC_SUPPORT
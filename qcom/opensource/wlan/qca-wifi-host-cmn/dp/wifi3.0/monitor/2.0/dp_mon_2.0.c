@@ -1511,6 +1511,13 @@ struct cdp_mon_ops dp_ops_mon_2_0 = {
 	.stop_local_pkt_capture = NULL,
 	.is_local_pkt_capture_running = NULL,
 #endif /* WLAN_FEATURE_LOCAL_PKT_CAPTURE */
+#ifdef WLAN_DP_MON_CAPTURE_RING
+	.mon_capture_ring_attach = dp_mon_capture_ring_attach,
+	.mon_capture_ring_detach = dp_mon_capture_ring_detach,
+	.mon_capture_ring_flush = dp_mon_capture_ring_flush,
+	.mon_capture_ring_set_filter = dp_mon_capture_ring_set_filter,
+	.mon_capture_ring_get_stats = dp_mon_capture_ring_get_stats,
+#endif
 };
 
 #if defined(WLAN_PKT_CAPTURE_TX_2_0) || \
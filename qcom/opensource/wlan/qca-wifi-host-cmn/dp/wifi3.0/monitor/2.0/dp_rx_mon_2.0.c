@@ -1346,6 +1346,12 @@ dp_rx_mon_process_ppdu_info(struct dp_pdev *pdev,
 				dp_rx_mon_process_dest_pktlog(pdev->soc,
 							      pdev->pdev_id,
 							      mpdu);
+				if (dp_mon_capture_ring_consume(mon_pdev, mpdu,
+								&ppdu_info->rx_status)) {
+					dp_mon_free_parent_nbuf(mon_pdev, mpdu);
+					continue;
+				}
+
 				/* Deliver MPDU to osif layer */
 				status = dp_rx_mon_deliver_mpdu(mon_pdev,
 								mpdu,
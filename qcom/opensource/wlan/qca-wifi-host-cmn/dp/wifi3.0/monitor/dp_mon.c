@@ -6045,6 +6045,7 @@ QDF_STATUS dp_mon_pdev_init(struct dp_pdev *pdev)
 
 	qdf_spinlock_create(&mon_pdev->ppdu_stats_lock);
 	qdf_spinlock_create(&mon_pdev->neighbour_peer_mutex);
+	dp_mon_capture_ring_init(mon_pdev);
 	mon_pdev->monitor_configured = false;
 	mon_pdev->mon_chan_band = REG_BAND_UNKNOWN;
 
@@ -6119,6 +6120,7 @@ fail4:
 fail3:
 	dp_htt_ppdu_stats_detach(pdev);
 fail2:
+	dp_mon_capture_ring_deinit(mon_pdev);
 	qdf_spinlock_destroy(&mon_pdev->neighbour_peer_mutex);
 	qdf_spinlock_destroy(&mon_pdev->ppdu_stats_lock);
 	if (mon_ops->tx_mon_filter_dealloc)
@@ -6167,6 +6169,7 @@ QDF_STATUS dp_mon_pdev_deinit(struct dp_pdev *pdev)
 	dp_cal_client_detach(&mon_pdev->cal_client_ctx);
 	dp_htt_ppdu_stats_detach(pdev);
 	qdf_spinlock_destroy(&mon_pdev->ppdu_stats_lock);
+	dp_mon_capture_ring_deinit(mon_pdev);
 	dp_neighbour_peers_detach(pdev);
 	dp_pktlogmod_exit(pdev);
 	if (mon_ops->tx_mon_filter_dealloc)
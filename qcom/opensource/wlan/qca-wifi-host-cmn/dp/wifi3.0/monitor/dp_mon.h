@@ -33,6 +33,8 @@
 #include "dp_lite_mon.h"
 #endif
 
+#include "dp_mon_capture.h"
+
 #define DP_INTR_POLL_TIMER_MS	5
 #define DP_HIST_TRACK_SIZE 50
 
@@ -1262,6 +1264,10 @@ struct  dp_mon_pdev {
 	/* LPC lock */
 	qdf_spinlock_t lpc_lock;
 #endif
+#ifdef WLAN_DP_MON_CAPTURE_RING
+	/* mmap'd capture ring replacing delivery to the monitor vdev */
+	struct dp_mon_capture_ring capture_ring;
+#endif
 };
 
 struct  dp_mon_vdev {
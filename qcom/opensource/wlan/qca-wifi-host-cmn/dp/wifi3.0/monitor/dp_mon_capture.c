@@ -0,0 +1,488 @@
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <qdf_mem.h>
+#include <qdf_net_types.h>
+#include <qdf_time.h>
+#include <dp_types.h>
+#include <dp_internal.h>
+#include <dp_mon.h>
+#include "dp_mon_capture.h"
+
+#define DP_MON_CAPTURE_ROUNDUP(x) \
+	(((x) + CDP_MON_CAPTURE_ALIGN - 1) & ~(CDP_MON_CAPTURE_ALIGN - 1))
+#define DP_MON_CAPTURE_BLK_HDR_LEN \
+	DP_MON_CAPTURE_ROUNDUP(sizeof(struct cdp_mon_capture_blk_desc))
+#define DP_MON_CAPTURE_PKT_HDR_LEN \
+	DP_MON_CAPTURE_ROUNDUP(sizeof(struct cdp_mon_capture_pkt_hdr))
+/* smallest block that still holds one radiotap header and 802.11 header */
+#define DP_MON_CAPTURE_MIN_BLOCK_SIZE \
+	(DP_MON_CAPTURE_BLK_HDR_LEN + DP_MON_CAPTURE_PKT_HDR_LEN + 256)
+
+/* fc, duration, addr1 and addr2 are all the filter looks at */
+#define DP_MON_CAPTURE_FILTER_HDR_LEN 16
+#define DP_MON_CAPTURE_ADDR1_OFFSET 4
+#define DP_MON_CAPTURE_ADDR2_OFFSET 10
+
+static inline struct cdp_mon_capture_blk_desc *
+dp_mon_capture_blk(struct dp_mon_capture_ring *ring, uint32_t idx)
+{
+	return (struct cdp_mon_capture_blk_desc *)(ring->base +
+						   idx * ring->block_size);
+}
+
+static inline bool
+dp_mon_capture_blk_is_free(struct cdp_mon_capture_blk_desc *desc)
+{
+	uint32_t status;
+
+	/* written by the reader through the mapping */
+	status = *(volatile uint32_t *)&desc->block_status;
+	qdf_rmb();
+
+	return status == CDP_MON_CAPTURE_BLK_KERNEL;
+}
+
+static void dp_mon_capture_blk_open(struct dp_mon_capture_ring *ring)
+{
+	ring->blk_open = true;
+	ring->cur_offset = DP_MON_CAPTURE_BLK_HDR_LEN;
+	ring->last_pkt_offset = 0;
+	ring->num_pkts = 0;
+	ring->blk_open_ts = qdf_get_system_timestamp();
+}
+
+/**
+ * dp_mon_capture_blk_retire() - hand the current block to the reader
+ * @ring: capture ring
+ *
+ * Fills in the block descriptor, publishes it and notifies the reader.
+ * Called with the ring lock held.
+ *
+ * Return: none
+ */
+static void dp_mon_capture_blk_retire(struct dp_mon_capture_ring *ring)
+{
+	struct cdp_mon_capture_blk_desc *desc;
+
+	desc = dp_mon_capture_blk(ring, ring->cur_block);
+	desc->version = CDP_MON_CAPTURE_RING_VERSION;
+	desc->num_pkts = ring->num_pkts;
+	desc->offset_to_first_pkt = DP_MON_CAPTURE_BLK_HDR_LEN;
+	desc->blk_len = ring->cur_offset;
+	desc->seq_num = ring->seq_num++;
+	/* block contents must be visible before the reader owns it */
+	qdf_wmb();
+	desc->block_status = CDP_MON_CAPTURE_BLK_USER;
+
+	ring->blk_open = false;
+	ring->cur_block = (ring->cur_block + 1) % ring->num_blocks;
+	ring->stats.blocks_retired++;
+
+	if (ring->notify)
+		ring->notify(ring->notify_ctx);
+}
+
+static inline bool
+dp_mon_capture_blk_expired(struct dp_mon_capture_ring *ring)
+{
+	return ring->retire_tmo_ms &&
+	       qdf_get_system_timestamp() - ring->blk_open_ts >=
+	       ring->retire_tmo_ms;
+}
+
+/**
+ * dp_mon_capture_rtap_len() - get the radiotap header length of an MPDU
+ * @mpdu: MPDU with the radiotap header pushed in the linear part
+ *
+ * Return: radiotap length, 0 if the MPDU has no valid radiotap header
+ */
+static uint16_t dp_mon_capture_rtap_len(qdf_nbuf_t mpdu)
+{
+	uint8_t *data = qdf_nbuf_data(mpdu);
+	uint16_t rtap_len;
+
+	if (qdf_nbuf_headlen(mpdu) < 4)
+		return 0;
+
+	/* it_len is little endian at offset 2 */
+	rtap_len = data[2] | (data[3] << 8);
+	if (rtap_len > qdf_nbuf_len(mpdu))
+		return 0;
+
+	return rtap_len;
+}
+
+/**
+ * dp_mon_capture_frame_match() - apply the frame type and peer filter
+ * @ring: capture ring
+ * @mpdu: MPDU with the radiotap header pushed
+ * @rtap_len: radiotap header length
+ *
+ * Called with the ring lock held.
+ *
+ * Return: true if the MPDU should be captured
+ */
+static bool dp_mon_capture_frame_match(struct dp_mon_capture_ring *ring,
+				       qdf_nbuf_t mpdu, uint16_t rtap_len)
+{
+	uint8_t hdr[DP_MON_CAPTURE_FILTER_HDR_LEN] = {0};
+	uint32_t len = qdf_nbuf_len(mpdu);
+	uint32_t hdr_len;
+	uint32_t type_bit;
+
+	if (ring->frame_filter == CDP_MON_CAPTURE_FILTER_ALL &&
+	    !ring->peer_filter)
+		return true;
+
+	if (len <= rtap_len)
+		return false;
+
+	hdr_len = qdf_min(len - rtap_len,
+			  (uint32_t)DP_MON_CAPTURE_FILTER_HDR_LEN);
+	if (qdf_nbuf_copy_bits(mpdu, rtap_len, hdr_len, hdr))
+		return false;
+
+	switch (hdr[0] & QDF_IEEE80211_FC0_TYPE_MASK) {
+	case QDF_IEEE80211_FC0_TYPE_MGT:
+		type_bit = CDP_MON_CAPTURE_FILTER_MGMT;
+		break;
+	case QDF_IEEE80211_FC0_TYPE_CTL:
+		type_bit = CDP_MON_CAPTURE_FILTER_CTRL;
+		break;
+	case QDF_IEEE80211_FC0_TYPE_DATA:
+		type_bit = CDP_MON_CAPTURE_FILTER_DATA;
+		break;
+	default:
+		return false;
+	}
+
+	if (!(ring->frame_filter & type_bit))
+		return false;
+
+	if (!ring->peer_filter)
+		return true;
+
+	/* control frames such as ACK and CTS only carry addr1 */
+	if (hdr_len >= DP_MON_CAPTURE_ADDR1_OFFSET + QDF_MAC_ADDR_SIZE &&
+	    !qdf_mem_cmp(&hdr[DP_MON_CAPTURE_ADDR1_OFFSET], ring->peer_mac,
+			 QDF_MAC_ADDR_SIZE))
+		return true;
+
+	if (hdr_len >= DP_MON_CAPTURE_ADDR2_OFFSET + QDF_MAC_ADDR_SIZE &&
+	    !qdf_mem_cmp(&hdr[DP_MON_CAPTURE_ADDR2_OFFSET], ring->peer_mac,
+			 QDF_MAC_ADDR_SIZE))
+		return true;
+
+	return false;
+}
+
+/**
+ * dp_mon_capture_ring_write() - copy an MPDU into the current block
+ * @ring: capture ring
+ * @mpdu: MPDU with the radiotap header pushed
+ * @rtap_len: radiotap header length
+ * @rx_status: monitor rx status of the PPDU
+ *
+ * Called with the ring lock held.
+ *
+ * Return: none
+ */
+static void dp_mon_capture_ring_write(struct dp_mon_capture_ring *ring,
+				      qdf_nbuf_t mpdu, uint16_t rtap_len,
+				      struct mon_rx_status *rx_status)
+{
+	struct cdp_mon_capture_blk_desc *desc;
+	struct cdp_mon_capture_pkt_hdr *pkt, *prev;
+	uint32_t len = qdf_nbuf_len(mpdu);
+	uint32_t caplen = len;
+	uint32_t space;
+	uint8_t *blk;
+
+	if (ring->snaplen && caplen > ring->snaplen)
+		caplen = ring->snaplen;
+
+	if (ring->blk_open && ring->num_pkts &&
+	    ring->cur_offset + DP_MON_CAPTURE_PKT_HDR_LEN + caplen >
+	    ring->block_size)
+		dp_mon_capture_blk_retire(ring);
+
+	desc = dp_mon_capture_blk(ring, ring->cur_block);
+	if (!ring->blk_open) {
+		if (!dp_mon_capture_blk_is_free(desc)) {
+			ring->stats.dropped++;
+			return;
+		}
+		dp_mon_capture_blk_open(ring);
+	}
+
+	/* an empty block always has room for at least the 802.11 header */
+	space = ring->block_size - ring->cur_offset -
+		DP_MON_CAPTURE_PKT_HDR_LEN;
+	if (caplen > space) {
+		caplen = space;
+		ring->stats.truncated++;
+	}
+
+	blk = (uint8_t *)desc;
+	pkt = (struct cdp_mon_capture_pkt_hdr *)(blk + ring->cur_offset);
+	if (qdf_nbuf_copy_bits(mpdu, 0, caplen,
+			       (uint8_t *)pkt + DP_MON_CAPTURE_PKT_HDR_LEN)) {
+		ring->stats.dropped++;
+		return;
+	}
+
+	pkt->next_offset = 0;
+	pkt->snaplen = caplen;
+	pkt->len = len;
+	pkt->mac_offset = DP_MON_CAPTURE_PKT_HDR_LEN;
+	pkt->rtap_len = rtap_len;
+	pkt->ppdu_id = rx_status->ppdu_id;
+	pkt->reserved = 0;
+	pkt->tsft = rx_status->tsft;
+
+	if (ring->num_pkts) {
+		prev = (struct cdp_mon_capture_pkt_hdr *)(blk +
+							  ring->last_pkt_offset);
+		prev->next_offset = ring->cur_offset - ring->last_pkt_offset;
+	}
+
+	ring->last_pkt_offset = ring->cur_offset;
+	ring->cur_offset += DP_MON_CAPTURE_ROUNDUP(DP_MON_CAPTURE_PKT_HDR_LEN +
+						   caplen);
+	ring->num_pkts++;
+	ring->stats.captured++;
+
+	if (ring->cur_offset + DP_MON_CAPTURE_PKT_HDR_LEN >= ring->block_size ||
+	    dp_mon_capture_blk_expired(ring))
+		dp_mon_capture_blk_retire(ring);
+}
+
+bool dp_mon_capture_ring_consume(struct dp_mon_pdev *mon_pdev,
+				 qdf_nbuf_t mpdu,
+				 struct mon_rx_status *rx_status)
+{
+	struct dp_mon_capture_ring *ring = &mon_pdev->capture_ring;
+	uint16_t rtap_len;
+
+	if (qdf_likely(!ring->active))
+		return false;
+
+	rtap_len = dp_mon_capture_rtap_len(mpdu);
+
+	qdf_spin_lock_bh(&ring->lock);
+	if (!ring->active) {
+		qdf_spin_unlock_bh(&ring->lock);
+		return false;
+	}
+
+	if (dp_mon_capture_frame_match(ring, mpdu, rtap_len))
+		dp_mon_capture_ring_write(ring, mpdu, rtap_len, rx_status);
+	else
+		ring->stats.filtered++;
+	qdf_spin_unlock_bh(&ring->lock);
+
+	return true;
+}
+
+static struct dp_mon_capture_ring *
+dp_mon_capture_ring_get(struct cdp_soc_t *cdp_soc, uint8_t pdev_id)
+{
+	struct dp_pdev *pdev =
+		dp_get_pdev_from_soc_pdev_id_wifi3(cdp_soc_t_to_dp_soc(cdp_soc),
+						   pdev_id);
+
+	if (!pdev || !pdev->monitor_pdev) {
+		dp_mon_err("Invalid pdev_id %u", pdev_id);
+		return NULL;
+	}
+
+	return &pdev->monitor_pdev->capture_ring;
+}
+
+QDF_STATUS dp_mon_capture_ring_attach(struct cdp_soc_t *cdp_soc,
+				      uint8_t pdev_id,
+				      struct cdp_mon_capture_ring_cfg *cfg)
+{
+	struct dp_mon_capture_ring *ring;
+	uint32_t i;
+
+	ring = dp_mon_capture_ring_get(cdp_soc, pdev_id);
+	if (!ring)
+		return QDF_STATUS_E_INVAL;
+
+	if (!cfg || !cfg->base || !cfg->num_blocks ||
+	    cfg->block_size < DP_MON_CAPTURE_MIN_BLOCK_SIZE ||
+	    cfg->block_size & (CDP_MON_CAPTURE_ALIGN - 1)) {
+		dp_mon_err("Invalid capture ring config");
+		return QDF_STATUS_E_INVAL;
+	}
+
+	qdf_spin_lock_bh(&ring->lock);
+	if (ring->active) {
+		qdf_spin_unlock_bh(&ring->lock);
+		dp_mon_err("Capture ring already attached on pdev %u", pdev_id);
+		return QDF_STATUS_E_ALREADY;
+	}
+
+	ring->base = cfg->base;
+	ring->block_size = cfg->block_size;
+	ring->num_blocks = cfg->num_blocks;
+	ring->snaplen = cfg->snaplen;
+	ring->retire_tmo_ms = cfg->retire_tmo_ms;
+	ring->frame_filter = cfg->frame_filter ? cfg->frame_filter :
+						 CDP_MON_CAPTURE_FILTER_ALL;
+	ring->peer_filter = cfg->peer_filter;
+	qdf_mem_copy(ring->peer_mac, cfg->peer_mac, QDF_MAC_ADDR_SIZE);
+	ring->notify = cfg->notify;
+	ring->lost = cfg->lost;
+	ring->notify_ctx = cfg->notify_ctx;
+	ring->blk_open = false;
+	ring->cur_block = 0;
+	ring->seq_num = 0;
+	qdf_mem_zero(&ring->stats, sizeof(ring->stats));
+
+	for (i = 0; i < ring->num_blocks; i++)
+		dp_mon_capture_blk(ring, i)->block_status =
+						CDP_MON_CAPTURE_BLK_KERNEL;
+	qdf_wmb();
+	ring->active = true;
+	qdf_spin_unlock_bh(&ring->lock);
+
+	dp_mon_info("Capture ring attached pdev %u blocks %u x %u snaplen %u",
+		    pdev_id, cfg->num_blocks, cfg->block_size, cfg->snaplen);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+QDF_STATUS dp_mon_capture_ring_detach(struct cdp_soc_t *cdp_soc,
+				      uint8_t pdev_id)
+{
+	struct dp_mon_capture_ring *ring;
+
+	ring = dp_mon_capture_ring_get(cdp_soc, pdev_id);
+	if (!ring)
+		return QDF_STATUS_E_INVAL;
+
+	qdf_spin_lock_bh(&ring->lock);
+	ring->active = false;
+	ring->blk_open = false;
+	ring->base = NULL;
+	ring->notify = NULL;
+	ring->lost = NULL;
+	ring->notify_ctx = NULL;
+	qdf_spin_unlock_bh(&ring->lock);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+QDF_STATUS dp_mon_capture_ring_flush(struct cdp_soc_t *cdp_soc,
+				     uint8_t pdev_id, bool force)
+{
+	struct dp_mon_capture_ring *ring;
+
+	ring = dp_mon_capture_ring_get(cdp_soc, pdev_id);
+	if (!ring)
+		return QDF_STATUS_E_INVAL;
+
+	qdf_spin_lock_bh(&ring->lock);
+	if (ring->active && ring->blk_open && ring->num_pkts &&
+	    (force || dp_mon_capture_blk_expired(ring)))
+		dp_mon_capture_blk_retire(ring);
+	qdf_spin_unlock_bh(&ring->lock);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+QDF_STATUS dp_mon_capture_ring_set_filter(struct cdp_soc_t *cdp_soc,
+					  uint8_t pdev_id,
+					  uint32_t frame_filter,
+					  uint8_t *peer_mac)
+{
+	struct dp_mon_capture_ring *ring;
+
+	ring = dp_mon_capture_ring_get(cdp_soc, pdev_id);
+	if (!ring)
+		return QDF_STATUS_E_INVAL;
+
+	qdf_spin_lock_bh(&ring->lock);
+	ring->frame_filter = frame_filter ? frame_filter :
+					    CDP_MON_CAPTURE_FILTER_ALL;
+	ring->peer_filter = !!peer_mac;
+	if (peer_mac)
+		qdf_mem_copy(ring->peer_mac, peer_mac, QDF_MAC_ADDR_SIZE);
+	qdf_spin_unlock_bh(&ring->lock);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+QDF_STATUS
+dp_mon_capture_ring_get_stats(struct cdp_soc_t *cdp_soc, uint8_t pdev_id,
+			      struct cdp_mon_capture_ring_stats *stats)
+{
+	struct dp_mon_capture_ring *ring;
+
+	ring = dp_mon_capture_ring_get(cdp_soc, pdev_id);
+	if (!ring || !stats)
+		return QDF_STATUS_E_INVAL;
+
+	qdf_spin_lock_bh(&ring->lock);
+	qdf_mem_copy(stats, &ring->stats, sizeof(*stats));
+	qdf_spin_unlock_bh(&ring->lock);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+void dp_mon_capture_ring_init(struct dp_mon_pdev *mon_pdev)
+{
+	struct dp_mon_capture_ring *ring = &mon_pdev->capture_ring;
+
+	qdf_mem_zero(ring, sizeof(*ring));
+	qdf_spinlock_create(&ring->lock);
+}
+
+void dp_mon_capture_ring_deinit(struct dp_mon_pdev *mon_pdev)
+{
+	struct dp_mon_capture_ring *ring = &mon_pdev->capture_ring;
+	cdp_mon_capture_notify_cb lost = NULL;
+	void *ctx = NULL;
+
+	/*
+	 * The attacher still owns the ring memory, but the ring state is
+	 * zeroed when the pdev is initialized again, so tell it the ring is
+	 * gone instead of leaving it waiting for blocks that never come.
+	 */
+	qdf_spin_lock_bh(&ring->lock);
+	if (ring->active) {
+		dp_mon_info("Capture ring still attached at deinit");
+		lost = ring->lost;
+		ctx = ring->notify_ctx;
+	}
+	ring->active = false;
+	ring->blk_open = false;
+	ring->base = NULL;
+	ring->notify = NULL;
+	ring->lost = NULL;
+	ring->notify_ctx = NULL;
+	qdf_spin_unlock_bh(&ring->lock);
+
+	if (lost)
+		lost(ctx);
+
+	qdf_spinlock_destroy(&ring->lock);
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef _DP_MON_CAPTURE_H_
+#define _DP_MON_CAPTURE_H_
+
+#include <qdf_lock.h>
+#include <qdf_nbuf.h>
+#include <cdp_txrx_mon_struct.h>
+
+struct dp_mon_pdev;
+
+#ifdef WLAN_DP_MON_CAPTURE_RING
+/**
+ * struct dp_mon_capture_ring - monitor capture ring state
+ * @lock: serializes the writer, flush and configuration
+ * @active: ring is attached, MPDUs are written to it instead of the stack
+ * @base: ring memory, owned by the attacher
+ * @block_size: size of one block
+ * @num_blocks: number of blocks
+ * @snaplen: max bytes of radiotap and MPDU stored per packet, 0 for all
+ * @retire_tmo_ms: retire a partially filled block after this long
+ * @frame_filter: CDP_MON_CAPTURE_FILTER_* frame types to capture
+ * @peer_filter: only capture frames to or from @peer_mac
+ * @peer_mac: peer to capture when @peer_filter is set
+ * @notify: batch notification callback
+ * @lost: called if the ring is dropped at pdev deinit while attached
+ * @notify_ctx: context passed to @notify and @lost
+ * @blk_open: block @cur_block is being filled
+ * @cur_block: index of the block being filled
+ * @cur_offset: write offset in @cur_block
+ * @last_pkt_offset: offset of the last packet header in @cur_block
+ * @num_pkts: packets in @cur_block
+ * @blk_open_ts: system timestamp in ms when @cur_block was opened
+ * @seq_num: sequence number of the next retired block
+ * @stats: ring counters
+ *
+ * The driver never reads back anything but the block status from the
+ * shared memory, all write positions are kept here.
+ */
+struct dp_mon_capture_ring {
+	qdf_spinlock_t lock;
+	bool active;
+	uint8_t *base;
+	uint32_t block_size;
+	uint32_t num_blocks;
+	uint32_t snaplen;
+	uint32_t retire_tmo_ms;
+	uint32_t frame_filter;
+	bool peer_filter;
+	uint8_t peer_mac[QDF_MAC_ADDR_SIZE];
+	cdp_mon_capture_notify_cb notify;
+	cdp_mon_capture_notify_cb lost;
+	void *notify_ctx;
+	bool blk_open;
+	uint32_t cur_block;
+	uint32_t cur_offset;
+	uint32_t last_pkt_offset;
+	uint32_t num_pkts;
+	unsigned long blk_open_ts;
+	uint64_t seq_num;
+	struct cdp_mon_capture_ring_stats stats;
+};
+
+/**
+ * dp_mon_capture_ring_init() - init the monitor capture ring of a pdev
+ * @mon_pdev: monitor pdev
+ *
+ * Return: none
+ */
+void dp_mon_capture_ring_init(struct dp_mon_pdev *mon_pdev);
+
+/**
+ * dp_mon_capture_ring_deinit() - deinit the monitor capture ring of a pdev
+ * @mon_pdev: monitor pdev
+ *
+ * Return: none
+ */
+void dp_mon_capture_ring_deinit(struct dp_mon_pdev *mon_pdev);
+
+/**
+ * dp_mon_capture_ring_consume() - write a monitor MPDU to the capture ring
+ * @mon_pdev: monitor pdev
+ * @mpdu: MPDU with the radiotap header already pushed
+ * @rx_status: monitor rx status of the PPDU
+ *
+ * The MPDU is either copied into the ring, filtered or dropped, the
+ * caller still owns and frees @mpdu.
+ *
+ * Return: true if the ring is attached and consumed the MPDU, false if
+ *	   the MPDU should be delivered to the stack
+ */
+bool dp_mon_capture_ring_consume(struct dp_mon_pdev *mon_pdev,
+				 qdf_nbuf_t mpdu,
+				 struct mon_rx_status *rx_status);
+
+/**
+ * dp_mon_capture_ring_attach() - start writing monitor MPDUs to a ring
+ * @cdp_soc: cdp soc handle
+ * @pdev_id: pdev id
+ * @cfg: ring memory and configuration
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS dp_mon_capture_ring_attach(struct cdp_soc_t *cdp_soc,
+				      uint8_t pdev_id,
+				      struct cdp_mon_capture_ring_cfg *cfg);
+
+/**
+ * dp_mon_capture_ring_detach() - stop writing to the capture ring
+ * @cdp_soc: cdp soc handle
+ * @pdev_id: pdev id
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS dp_mon_capture_ring_detach(struct cdp_soc_t *cdp_soc,
+				      uint8_t pdev_id);
+
+/**
+ * dp_mon_capture_ring_flush() - retire the partially filled block
+ * @cdp_soc: cdp soc handle
+ * @pdev_id: pdev id
+ * @force: retire even if the retire timeout has not expired
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS dp_mon_capture_ring_flush(struct cdp_soc_t *cdp_soc,
+				     uint8_t pdev_id, bool force);
+
+/**
+ * dp_mon_capture_ring_set_filter() - update the frame type and peer filter
+ * @cdp_soc: cdp soc handle
+ * @pdev_id: pdev id
+ * @frame_filter: CDP_MON_CAPTURE_FILTER_* frame types to capture
+ * @peer_mac: only capture frames to or from this peer, NULL for all
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS dp_mon_capture_ring_set_filter(struct cdp_soc_t *cdp_soc,
+					  uint8_t pdev_id,
+					  uint32_t frame_filter,
+					  uint8_t *peer_mac);
+
+/**
+ * dp_mon_capture_ring_get_stats() - get the capture ring counters
+ * @cdp_soc: cdp soc handle
+ * @pdev_id: pdev id
+ * @stats: filled with the counters
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS
+dp_mon_capture_ring_get_stats(struct cdp_soc_t *cdp_soc, uint8_t pdev_id,
+			      struct cdp_mon_capture_ring_stats *stats);
+#else
+static inline void dp_mon_capture_ring_init(struct dp_mon_pdev *mon_pdev)
+{
+}
+
+static inline void dp_mon_capture_ring_deinit(struct dp_mon_pdev *mon_pdev)
+{
+}
+
+static inline bool
+dp_mon_capture_ring_consume(struct dp_mon_pdev *mon_pdev, qdf_nbuf_t mpdu,
+			    struct mon_rx_status *rx_status)
+{
+	return false;
+}
+#endif /* WLAN_DP_MON_CAPTURE_RING */
+#endif /* _DP_MON_CAPTURE_H_ */
@@ -2090,6 +2090,12 @@ QDF_STATUS dp_rx_mon_deliver(struct dp_soc *soc, uint32_t mac_id,
 		}
 
 		dp_rx_mon_update_pf_tag_to_buf_headroom(soc, mon_mpdu);
+		if (dp_mon_capture_ring_consume(mon_pdev, mon_mpdu,
+						&mon_pdev->ppdu_info.rx_status)) {
+			qdf_nbuf_free(mon_mpdu);
+			return QDF_STATUS_SUCCESS;
+		}
+
 		mon_vdev->osif_rx_mon(mon_pdev->mvdev->osif_vdev,
 				      mon_mpdu,
 				      &mon_pdev->ppdu_info.rx_status);
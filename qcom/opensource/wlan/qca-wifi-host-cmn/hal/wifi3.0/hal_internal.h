@@ -520,6 +520,10 @@ struct hal_reg_write_q_elem {
  * @coalesces: writes not enqueued since srng is already queued up
  * @direct: writes not enqueued and written to register directly
  * @dequeue_delay: dequeue operation be delayed
+ * @combined: dequeued writes dropped as a direct write already pushed the
+ *	      same value
+ * @fill_urgent: writes that kicked the worker as the ring fill level needed
+ *		 them at the target
  * @force_direct_write: writes forced and written to register directly
  */
 struct hal_reg_write_srng_stats {
@@ -528,6 +532,8 @@ struct hal_reg_write_srng_stats {
 	uint32_t coalesces;
 	uint32_t direct;
 	uint32_t dequeue_delay;
+	uint32_t combined;
+	uint32_t fill_urgent;
 #ifdef DELAYED_REG_FORCE_WRITE
 	uint32_t force_direct_write;
 #endif
@@ -560,6 +566,11 @@ enum hal_reg_sched_delay {
  * @max_q_depth: maximum queue for delayed register write queue
  * @sched_delay: = kernel work sched delay + bus wakeup delay, histogram
  * @dequeue_delay: dequeue operation be delayed
+ * @combined: dequeued writes dropped as a direct write already pushed the
+ *	      same value
+ * @fill_urgent: writes that kicked the worker as the ring fill level needed
+ *		 them at the target
+ * @ring_sched_delay: @sched_delay histogram per ring type
  */
 struct hal_reg_write_soc_stats {
 	qdf_atomic_t enqueues;
@@ -571,6 +582,9 @@ struct hal_reg_write_soc_stats {
 	uint32_t max_q_depth;
 	uint32_t sched_delay[REG_WRITE_SCHED_DELAY_HIST_MAX];
 	uint32_t dequeue_delay;
+	uint32_t combined;
+	qdf_atomic_t fill_urgent;
+	uint32_t ring_sched_delay[MAX_RING_TYPES][REG_WRITE_SCHED_DELAY_HIST_MAX];
 };
 #endif
 
@@ -867,6 +881,10 @@ struct hal_srng {
 #if defined(FEATURE_HAL_DELAYED_REG_WRITE)
 	/* flag to indicate whether srng is already queued for delayed write */
 	uint8_t reg_write_in_progress;
+	/* flag to indicate a direct write was done while queued */
+	uint8_t reg_write_direct_in_progress;
+	/* last HP/TP value written to the register by delayed write engine */
+	uint32_t last_reg_write_val;
 #ifdef DELAYED_REG_FORCE_WRITE
 	/* flag to force register direct write next */
 	bool force_reg_direct_write;
@@ -595,9 +595,11 @@ static inline
 char *hal_fill_reg_write_srng_stats(struct hal_srng *srng,
 				    char *buf, qdf_size_t size)
 {
-	qdf_scnprintf(buf, size, "enq %u deq %u coal %u direct %u",
+	qdf_scnprintf(buf, size,
+		      "enq %u deq %u coal %u direct %u comb %u urgent %u",
 		      srng->wstats.enqueues, srng->wstats.dequeues,
-		      srng->wstats.coalesces, srng->wstats.direct);
+		      srng->wstats.coalesces, srng->wstats.direct,
+		      srng->wstats.combined, srng->wstats.fill_urgent);
 	return buf;
 }
 
@@ -636,6 +638,7 @@ void hal_dump_reg_write_stats(hal_soc_handle_t hal_soc_hdl)
 {
 	uint32_t *hist;
 	struct hal_soc *hal = (struct hal_soc *)hal_soc_hdl;
+	int ring_type;
 
 	hist = hal->stats.wstats.sched_delay;
 	hal_debug("wstats: enq %u deq %u coal %u direct %u q_depth %u max_q %u sched-delay hist %u %u %u %u",
@@ -649,6 +652,27 @@ void hal_dump_reg_write_stats(hal_soc_handle_t hal_soc_hdl)
 		  hist[REG_WRITE_SCHED_DELAY_SUB_1000us],
 		  hist[REG_WRITE_SCHED_DELAY_SUB_5000us],
 		  hist[REG_WRITE_SCHED_DELAY_GT_5000us]);
+	hal_debug("wstats: saved %u (coal %u comb %u) fill urgent %u",
+		  qdf_atomic_read(&hal->stats.wstats.coalesces) +
+		  hal->stats.wstats.combined,
+		  qdf_atomic_read(&hal->stats.wstats.coalesces),
+		  hal->stats.wstats.combined,
+		  qdf_atomic_read(&hal->stats.wstats.fill_urgent));
+
+	for (ring_type = 0; ring_type < MAX_RING_TYPES; ring_type++) {
+		hist = hal->stats.wstats.ring_sched_delay[ring_type];
+		if (!(hist[REG_WRITE_SCHED_DELAY_SUB_100us] |
+		      hist[REG_WRITE_SCHED_DELAY_SUB_1000us] |
+		      hist[REG_WRITE_SCHED_DELAY_SUB_5000us] |
+		      hist[REG_WRITE_SCHED_DELAY_GT_5000us]))
+			continue;
+		hal_debug("ring type %d sched-delay hist %u %u %u %u",
+			  ring_type,
+			  hist[REG_WRITE_SCHED_DELAY_SUB_100us],
+			  hist[REG_WRITE_SCHED_DELAY_SUB_1000us],
+			  hist[REG_WRITE_SCHED_DELAY_SUB_5000us],
+			  hist[REG_WRITE_SCHED_DELAY_GT_5000us]);
+	}
 }
 #else
 void hal_dump_reg_write_srng_stats(hal_soc_handle_t hal_soc_hdl)
@@ -747,6 +771,57 @@ static inline void hal_srng_update_last_hptp(struct hal_srng *srng)
 }
 #endif /* QCA_WIFI_QCA6750 */
 
+/**
+ * hal_reg_write_record_direct() - note a direct write of the SRNG HP/TP
+ * @srng: srng pointer
+ * @value: value written to the register
+ *
+ * This function executes from within the SRNG LOCK
+ *
+ * Return: None
+ */
+static inline void hal_reg_write_record_direct(struct hal_srng *srng,
+					       uint32_t value)
+{
+	srng->last_reg_write_val = value;
+	if (srng->reg_write_in_progress)
+		srng->reg_write_direct_in_progress = true;
+}
+
+/**
+ * hal_reg_write_fill_urgent() - check if the ring fill level needs the write
+ *				 to reach the target soon
+ * @srng: srng pointer
+ * @value: HP/TP value to be written
+ *
+ * Writes may sit coalesced in the queue while the target has enough to
+ * work with. They are urgent once half of a source ring is filled without
+ * the target being told, or once a destination ring looks 3/4 full to the
+ * target although SW has already reaped part of it.
+ *
+ * This function executes from within the SRNG LOCK
+ *
+ * Return: true if the write should be done directly
+ */
+static inline bool hal_reg_write_fill_urgent(struct hal_srng *srng,
+					     uint32_t value)
+{
+	uint32_t ring_size = srng->ring_size;
+	uint32_t last = srng->last_reg_write_val;
+	uint32_t used;
+
+	if (value == last)
+		return false;
+
+	if (srng->ring_dir == HAL_SRNG_SRC_RING) {
+		used = (value + ring_size - last) % ring_size;
+		return used >= (ring_size >> 1);
+	}
+
+	used = (srng->u.dst_ring.cached_hp + ring_size - last) % ring_size;
+	return used >= ring_size - (ring_size >> 2);
+}
+
 /**
  * hal_process_reg_write_q_elem() - process a register write queue element
  * @hal: hal_soc pointer
@@ -759,6 +834,7 @@ hal_process_reg_write_q_elem(struct hal_soc *hal,
 			     struct hal_reg_write_q_elem *q_elem)
 {
 	struct hal_srng *srng = q_elem->srng;
+	uint32_t *reg_addr;
 	uint32_t write_val;
 
 	SRNG_LOCK(&srng->lock);
@@ -767,21 +843,29 @@ hal_process_reg_write_q_elem(struct hal_soc *hal,
 	srng->wstats.dequeues++;
 
 	if (srng->ring_dir == HAL_SRNG_SRC_RING) {
-		q_elem->dequeue_val = srng->u.src_ring.hp;
-		hal_write_address_32_mb(hal,
-					srng->u.src_ring.hp_addr,
-					srng->u.src_ring.hp, false);
+		reg_addr = srng->u.src_ring.hp_addr;
 		write_val = srng->u.src_ring.hp;
 	} else {
-		q_elem->dequeue_val = srng->u.dst_ring.tp;
-		hal_write_address_32_mb(hal,
-					srng->u.dst_ring.tp_addr,
-					srng->u.dst_ring.tp, false);
+		reg_addr = srng->u.dst_ring.tp_addr;
 		write_val = srng->u.dst_ring.tp;
 	}
+	q_elem->dequeue_val = write_val;
 
-	hal_srng_update_last_hptp(srng);
-	hal_srng_reg_his_add(srng, write_val);
+	/*
+	 * Only the latest HP/TP matters to the target, drop the write if a
+	 * direct write has already pushed it since this element was queued.
+	 */
+	if (srng->reg_write_direct_in_progress &&
+	    write_val == srng->last_reg_write_val) {
+		srng->wstats.combined++;
+		hal->stats.wstats.combined++;
+	} else {
+		hal_write_address_32_mb(hal, reg_addr, write_val, false);
+		srng->last_reg_write_val = write_val;
+		hal_srng_update_last_hptp(srng);
+		hal_srng_reg_his_add(srng, write_val);
+	}
+	srng->reg_write_direct_in_progress = false;
 
 	q_elem->valid = 0;
 	srng->last_dequeue_time = q_elem->dequeue_time;
@@ -793,25 +877,29 @@ hal_process_reg_write_q_elem(struct hal_soc *hal,
 /**
  * hal_reg_write_fill_sched_delay_hist() - fill reg write delay histogram in hal
  * @hal: hal_soc pointer
+ * @ring_type: type of the srng the write was queued for
  * @delay_us: delay in us
  *
  * Return: None
  */
 static inline void hal_reg_write_fill_sched_delay_hist(struct hal_soc *hal,
+						       uint8_t ring_type,
 						       uint64_t delay_us)
 {
-	uint32_t *hist;
-
-	hist = hal->stats.wstats.sched_delay;
+	enum hal_reg_sched_delay bin;
 
 	if (delay_us < 100)
-		hist[REG_WRITE_SCHED_DELAY_SUB_100us]++;
+		bin = REG_WRITE_SCHED_DELAY_SUB_100us;
 	else if (delay_us < 1000)
-		hist[REG_WRITE_SCHED_DELAY_SUB_1000us]++;
+		bin = REG_WRITE_SCHED_DELAY_SUB_1000us;
 	else if (delay_us < 5000)
-		hist[REG_WRITE_SCHED_DELAY_SUB_5000us]++;
+		bin = REG_WRITE_SCHED_DELAY_SUB_5000us;
 	else
-		hist[REG_WRITE_SCHED_DELAY_GT_5000us]++;
+		bin = REG_WRITE_SCHED_DELAY_GT_5000us;
+
+	hal->stats.wstats.sched_delay[bin]++;
+	if (ring_type < MAX_RING_TYPES)
+		hal->stats.wstats.ring_sched_delay[ring_type][bin]++;
 }
 
 #ifdef SHADOW_WRITE_DELAY
@@ -938,7 +1026,9 @@ static void hal_reg_write_work(void *arg)
 		addr = q_elem->addr;
 		delta_us = qdf_log_timestamp_to_usecs(q_elem->dequeue_time -
 						      q_elem->enqueue_time);
-		hal_reg_write_fill_sched_delay_hist(hal, delta_us);
+		hal_reg_write_fill_sched_delay_hist(hal,
+						    q_elem->srng->ring_type,
+						    delta_us);
 
 		hal->stats.wstats.dequeues++;
 		qdf_atomic_dec(&hal->stats.wstats.q_depth);
@@ -1067,6 +1157,21 @@ static void hal_reg_write_enqueue(struct hal_soc *hal_soc,
 		       &hal_soc->reg_write_work);
 }
 
+/**
+ * hal_reg_write_srng_init() - reset the delayed write state of a srng
+ * @srng: srng pointer
+ *
+ * The register HP/TP is reset along with the ring, so the value last
+ * written by a previous life of the ring must not be compared against.
+ *
+ * Return: None
+ */
+static inline void hal_reg_write_srng_init(struct hal_srng *srng)
+{
+	srng->last_reg_write_val = 0;
+	srng->reg_write_direct_in_progress = false;
+}
+
 /**
  * hal_delayed_reg_write_init() - Initialization function for delayed reg writes
  * @hal: hal_soc pointer
@@ -1114,6 +1219,10 @@ static void hal_delayed_reg_write_deinit(struct hal_soc *hal)
 }
 
 #else
+static inline void hal_reg_write_srng_init(struct hal_srng *srng)
+{
+}
+
 static inline QDF_STATUS hal_delayed_reg_write_init(struct hal_soc *hal)
 {
 	return QDF_STATUS_SUCCESS;
@@ -1176,6 +1285,7 @@ void hal_delayed_reg_write(struct hal_soc *hal_soc,
 		     PLD_MHI_STATE_L0 ==
 		     pld_get_mhi_state(hal_soc->qdf_dev->dev))) {
 			hal_write_address_32_mb(hal_soc, addr, value, false);
+			hal_reg_write_record_direct(srng, value);
 			hal_srng_update_last_hptp(srng);
 			hal_srng_reg_his_add(srng, value);
 			qdf_atomic_inc(&hal_soc->stats.wstats.direct);
@@ -1192,6 +1302,7 @@ void hal_delayed_reg_write(struct hal_soc *hal_soc,
 		    PLD_MHI_STATE_L0 ==
 		    pld_get_mhi_state(hal_soc->qdf_dev->dev)) {
 			hal_write_address_32_mb(hal_soc, addr, value, false);
+			hal_reg_write_record_direct(srng, value);
 			hal_srng_reg_his_add(srng, value);
 			qdf_atomic_inc(&hal_soc->stats.wstats.direct);
 			srng->wstats.direct++;
@@ -1208,18 +1319,36 @@ void hal_delayed_reg_write(struct hal_soc *hal_soc,
 			   void __iomem *addr,
 			   uint32_t value)
 {
-	if (hal_is_reg_write_tput_level_high(hal_soc) ||
-	    pld_is_device_awake(hal_soc->qdf_dev->dev) ||
-	    hal_srng_is_delay_reg_force_write(srng)) {
+	bool direct;
+
+	direct = hal_is_reg_write_tput_level_high(hal_soc) ||
+		 pld_is_device_awake(hal_soc->qdf_dev->dev) ||
+		 hal_srng_is_delay_reg_force_write(srng);
+
+	if (direct) {
 		hal_srng_delay_reg_record_direct_write(srng, true);
 		qdf_atomic_inc(&hal_soc->stats.wstats.direct);
 		srng->wstats.direct++;
 		hal_write_address_32_mb(hal_soc, addr, value, false);
+		hal_reg_write_record_direct(srng, value);
 		hal_srng_update_last_hptp(srng);
 		hal_srng_reg_his_add(srng, value);
 	} else {
 		hal_srng_delay_reg_record_direct_write(srng, false);
 		hal_reg_write_enqueue(hal_soc, srng, addr, value);
+
+		/*
+		 * The link may be in a low power state here, so even an
+		 * urgent write has to go through the worker which holds the
+		 * L1 vote around the access. Make sure it runs for a ring
+		 * whose write was only coalesced into an already queued one.
+		 */
+		if (hal_reg_write_fill_urgent(srng, value)) {
+			qdf_atomic_inc(&hal_soc->stats.wstats.fill_urgent);
+			srng->wstats.fill_urgent++;
+			qdf_queue_work(hal_soc->qdf_dev, hal_soc->reg_write_wq,
+				       &hal_soc->reg_write_work);
+		}
 	}
 
 	hal_record_suspend_write(srng->ring_id, value, srng->wstats.direct);
@@ -1746,6 +1875,7 @@ void *hal_srng_setup_idx(void *hal_soc, int ring_type, int ring_num, int mac_id,
 	}
 
 	hal_srng_reg_his_init(srng);
+	hal_reg_write_srng_init(srng);
 	dev_base_addr = hal->dev_base_addr;
 	srng->ring_id = ring_id;
 	srng->ring_type = ring_type;
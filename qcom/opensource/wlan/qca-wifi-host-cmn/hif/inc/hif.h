@@ -436,6 +436,7 @@ struct qca_napi_cpu {
  * @napi_mode: irq affinity & clock voting mode
  * @cpuhp_handler: CPU hotplug event registration handle
  * @flags:
+ * @load_sample_ts: time of the last exec context load sample, in ns
  */
 struct qca_napi_data {
 	struct               hif_softc *hif_softc;
@@ -454,6 +455,9 @@ struct qca_napi_data {
 	enum qca_napi_tput_state napi_mode;
 	struct qdf_cpuhp_handler *cpuhp_handler;
 	uint8_t              flags;
+#ifdef HIF_EXEC_LOAD_PLACEMENT
+	uint64_t             load_sample_ts;
+#endif
 };
 
 /**
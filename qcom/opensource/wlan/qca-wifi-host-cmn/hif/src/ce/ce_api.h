@@ -260,6 +260,45 @@ QDF_STATUS ce_recv_buf_enqueue(struct CE_handle *copyeng,
 			       void *per_transfer_recv_context,
 			       qdf_dma_addr_t buffer);
 
+/**
+ * ce_recv_buf_enqueue_batch() - Make several buffers available to receive
+ * @copyeng: which copy engine to use
+ * @per_transfer_recv_context: array of contexts passed back to recv_cb
+ * @buffers: array of buffer addresses in CE space
+ * @num: number of entries in @per_transfer_recv_context and @buffers
+ *
+ * Buffers are posted in order. On SRNG based targets the whole batch is
+ * posted under a single ring access window with a single head pointer
+ * update; other targets fall back to posting one buffer at a time.
+ *
+ * Return: number of buffers posted, starting from index 0
+ */
+uint32_t ce_recv_buf_enqueue_batch(struct CE_handle *copyeng,
+				   void **per_transfer_recv_context,
+				   qdf_dma_addr_t *buffers,
+				   uint32_t num);
+
+/* max completions reaped under a single ring access window */
+#define CE_RECV_BATCH_MAX 16
+
+/**
+ * struct ce_recv_completion - a reaped copy engine receive completion
+ * @per_CE_context: context registered with the copy engine
+ * @per_transfer_context: context supplied when the buffer was posted
+ * @buffer: address of the buffer in CE space
+ * @nbytes: number of bytes received
+ * @transfer_id: transfer id (meta data) from the status descriptor
+ * @flags: CE_RECV_FLAG_* flags
+ */
+struct ce_recv_completion {
+	void *per_CE_context;
+	void *per_transfer_context;
+	qdf_dma_addr_t buffer;
+	unsigned int nbytes;
+	unsigned int transfer_id;
+	unsigned int flags;
+};
+
 /*
  * Register a Receive Callback function.
  * This function is called as soon as data is received
@@ -650,6 +689,10 @@ struct ce_ops {
 	QDF_STATUS (*ce_recv_buf_enqueue)(struct CE_handle *copyeng,
 					  void *per_recv_context,
 					  qdf_dma_addr_t buffer);
+	uint32_t (*ce_recv_buf_enqueue_batch)(struct CE_handle *copyeng,
+					      void **per_recv_context,
+					      qdf_dma_addr_t *buffers,
+					      uint32_t num);
 	bool (*watermark_int)(struct CE_state *CE_state, unsigned int *flags);
 	QDF_STATUS (*ce_completed_recv_next_nolock)(
 			struct CE_state *CE_state,
@@ -659,6 +702,10 @@ struct ce_ops {
 			unsigned int *nbytesp,
 			unsigned int *transfer_idp,
 			unsigned int *flagsp);
+	uint32_t (*ce_completed_recv_batch_nolock)(
+			struct CE_state *CE_state,
+			struct ce_recv_completion *comp,
+			uint32_t max_comp);
 	QDF_STATUS (*ce_completed_send_next_nolock)(
 			struct CE_state *CE_state,
 			void **per_CE_contextp,
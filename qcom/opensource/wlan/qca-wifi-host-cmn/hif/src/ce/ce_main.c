@@ -3876,6 +3876,42 @@ static void hif_post_recv_buffers_failure(struct HIF_CE_pipe_info *pipe_info,
 
 }
 
+/**
+ * hif_post_recv_buffers_batch() - post a batch of mapped rx buffers to a pipe
+ * @pipe_info: pipe to post the buffers to
+ * @nbufs: array of mapped nbufs
+ * @paddrs: array of DMA addresses of @nbufs
+ * @num: number of entries in @nbufs and @paddrs
+ *
+ * Buffers that could not be posted are unmapped, freed and accounted back
+ * into recv_bufs_needed.
+ *
+ * Return: number of buffers posted
+ */
+static uint32_t hif_post_recv_buffers_batch(struct HIF_CE_pipe_info *pipe_info,
+					    void **nbufs,
+					    qdf_dma_addr_t *paddrs,
+					    uint32_t num)
+{
+	struct hif_softc *scn = HIF_GET_SOFTC(pipe_info->HIF_CE_state);
+	uint32_t posted, i;
+
+	posted = ce_recv_buf_enqueue_batch(pipe_info->ce_hdl, nbufs, paddrs,
+					   num);
+	for (i = posted; i < num; i++) {
+		hif_post_recv_buffers_failure(pipe_info, nbufs[i],
+				&pipe_info->nbuf_ce_enqueue_err_count,
+				 HIF_RX_NBUF_ENQUEUE_FAILURE,
+				"HIF_RX_NBUF_ENQUEUE_FAILURE");
+
+		qdf_nbuf_unmap_single(scn->qdf_dev, nbufs[i],
+				      QDF_DMA_FROM_DEVICE);
+		hif_ce_rx_nbuf_free(nbufs[i]);
+	}
+
+	return posted;
+}
+
 QDF_STATUS hif_post_recv_buffers_for_pipe(struct HIF_CE_pipe_info *pipe_info)
 {
 	struct CE_handle *ce_hdl;
@@ -3884,6 +3920,10 @@ QDF_STATUS hif_post_recv_buffers_for_pipe(struct HIF_CE_pipe_info *pipe_info)
 	QDF_STATUS status;
 	uint32_t bufs_posted = 0;
 	unsigned int ce_id;
+	void *nbufs[CE_RECV_BATCH_MAX];
+	qdf_dma_addr_t paddrs[CE_RECV_BATCH_MAX];
+	uint32_t num = 0;
+	uint32_t posted;
 
 	buf_sz = pipe_info->buf_sz;
 	if (buf_sz == 0) {
@@ -3916,7 +3956,8 @@ QDF_STATUS hif_post_recv_buffers_for_pipe(struct HIF_CE_pipe_info *pipe_info)
 					&pipe_info->nbuf_alloc_err_count,
 					 HIF_RX_NBUF_ALLOC_FAILURE,
 					"HIF_RX_NBUF_ALLOC_FAILURE");
-			return QDF_STATUS_E_NOMEM;
+			status = QDF_STATUS_E_NOMEM;
+			goto fail;
 		}
 
 		hif_record_ce_desc_event(scn, ce_id,
@@ -3936,7 +3977,7 @@ QDF_STATUS hif_post_recv_buffers_for_pipe(struct HIF_CE_pipe_info *pipe_info)
 					 HIF_RX_NBUF_MAP_FAILURE,
 					"HIF_RX_NBUF_MAP_FAILURE");
 			hif_ce_rx_nbuf_free(nbuf);
-			return status;
+			goto fail;
 		}
 
 		CE_data = qdf_nbuf_get_frag_paddr(nbuf, 0);
@@ -3945,22 +3986,32 @@ QDF_STATUS hif_post_recv_buffers_for_pipe(struct HIF_CE_pipe_info *pipe_info)
 					 0, 0);
 		qdf_mem_dma_sync_single_for_device(scn->qdf_dev, CE_data,
 					       buf_sz, DMA_FROM_DEVICE);
-		status = ce_recv_buf_enqueue(ce_hdl, (void *)nbuf, CE_data);
-		if (qdf_unlikely(status != QDF_STATUS_SUCCESS)) {
-			hif_post_recv_buffers_failure(pipe_info, nbuf,
-					&pipe_info->nbuf_ce_enqueue_err_count,
-					 HIF_RX_NBUF_ENQUEUE_FAILURE,
-					"HIF_RX_NBUF_ENQUEUE_FAILURE");
 
-			qdf_nbuf_unmap_single(scn->qdf_dev, nbuf,
-						QDF_DMA_FROM_DEVICE);
-			hif_ce_rx_nbuf_free(nbuf);
-			return status;
+		/* post in batches to update the ring head pointer once */
+		nbufs[num] = nbuf;
+		paddrs[num++] = CE_data;
+		if (num == CE_RECV_BATCH_MAX) {
+			posted = hif_post_recv_buffers_batch(pipe_info, nbufs,
+							     paddrs, num);
+			if (qdf_unlikely(posted < num))
+				return QDF_STATUS_E_FAILURE;
+			bufs_posted += posted;
+			num = 0;
 		}
 
 		qdf_spin_lock_bh(&pipe_info->recv_bufs_needed_lock);
-		bufs_posted++;
 	}
+	qdf_spin_unlock_bh(&pipe_info->recv_bufs_needed_lock);
+
+	if (num) {
+		posted = hif_post_recv_buffers_batch(pipe_info, nbufs,
+						     paddrs, num);
+		if (qdf_unlikely(posted < num))
+			return QDF_STATUS_E_FAILURE;
+		bufs_posted += posted;
+	}
+
+	qdf_spin_lock_bh(&pipe_info->recv_bufs_needed_lock);
 	pipe_info->nbuf_alloc_err_count =
 		(pipe_info->nbuf_alloc_err_count > bufs_posted) ?
 		pipe_info->nbuf_alloc_err_count - bufs_posted : 0;
@@ -3974,6 +4025,13 @@ QDF_STATUS hif_post_recv_buffers_for_pipe(struct HIF_CE_pipe_info *pipe_info)
 	qdf_spin_unlock_bh(&pipe_info->recv_bufs_needed_lock);
 
 	return QDF_STATUS_SUCCESS;
+
+fail:
+	/* buffers already prepared are still handed to the target */
+	if (num)
+		hif_post_recv_buffers_batch(pipe_info, nbufs, paddrs, num);
+
+	return status;
 }
 
 #ifdef FEATURE_DIRECT_LINK
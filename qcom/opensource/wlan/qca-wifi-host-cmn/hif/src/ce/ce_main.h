@@ -96,6 +96,24 @@ enum ce_buckets {
 	CE_BUCKET_BEYOND,
 	CE_BUCKET_MAX,
 };
+
+/**
+ * enum ce_batch_buckets - CE batch size buckets
+ * @CE_BATCH_1: batch of a single descriptor
+ * @CE_BATCH_2_4: batch of 2-4 descriptors
+ * @CE_BATCH_5_8: batch of 5-8 descriptors
+ * @CE_BATCH_9_16: batch of 9-16 descriptors
+ * @CE_BATCH_BEYOND: batch of more than 16 descriptors
+ * @CE_BATCH_MAX: enum max value
+ */
+enum ce_batch_buckets {
+	CE_BATCH_1,
+	CE_BATCH_2_4,
+	CE_BATCH_5_8,
+	CE_BATCH_9_16,
+	CE_BATCH_BEYOND,
+	CE_BATCH_MAX,
+};
 #endif
 
 enum ce_target_type {
@@ -176,6 +194,8 @@ extern struct hif_execution_ops napi_sched_ops;
  * @ce_tasklet_sched_bucket: Tasklet time in queue buckets
  * @ce_tasklet_exec_last_update: Latest timestamp when bucket is updated
  * @ce_tasklet_sched_last_update: Latest timestamp when bucket is updated
+ * @ce_recv_reap_batch: Number of receive completions reaped per ring access
+ * @ce_recv_post_batch: Number of receive buffers posted per ring access
  * @ce_ring_full_count:
  * @ce_manual_tasklet_schedule_count:
  * @ce_last_manual_tasklet_schedule_ts:
@@ -192,6 +212,8 @@ struct ce_stats {
 	uint64_t ce_tasklet_sched_bucket[CE_COUNT_MAX][CE_BUCKET_MAX];
 	uint64_t ce_tasklet_exec_last_update[CE_COUNT_MAX][CE_BUCKET_MAX];
 	uint64_t ce_tasklet_sched_last_update[CE_COUNT_MAX][CE_BUCKET_MAX];
+	uint64_t ce_recv_reap_batch[CE_COUNT_MAX][CE_BATCH_MAX];
+	uint64_t ce_recv_post_batch[CE_COUNT_MAX][CE_BATCH_MAX];
 #ifdef CE_TASKLET_SCHEDULE_ON_FULL
 	uint32_t ce_ring_full_count[CE_COUNT_MAX];
 	uint32_t ce_manual_tasklet_schedule_count[CE_COUNT_MAX];
@@ -237,6 +259,72 @@ struct HIF_CE_state {
 	int sz_tgt_svc_map;
 };
 
+#ifdef CE_TASKLET_DEBUG_ENABLE
+/**
+ * hif_ce_batch_hist_update() - account a batch in a batch size histogram
+ * @hist: per CE histogram to update
+ * @num: number of descriptors handled in the batch
+ *
+ * Return: None
+ */
+static inline void hif_ce_batch_hist_update(uint64_t *hist, uint32_t num)
+{
+	if (!num)
+		return;
+
+	if (num == 1)
+		hist[CE_BATCH_1]++;
+	else if (num <= 4)
+		hist[CE_BATCH_2_4]++;
+	else if (num <= 8)
+		hist[CE_BATCH_5_8]++;
+	else if (num <= 16)
+		hist[CE_BATCH_9_16]++;
+	else
+		hist[CE_BATCH_BEYOND]++;
+}
+
+/**
+ * hif_ce_record_reap_batch() - record the size of a receive reap batch
+ * @hif_state: HIF CE state
+ * @ce_id: copy engine id
+ * @num: number of completions reaped
+ *
+ * Return: None
+ */
+static inline void hif_ce_record_reap_batch(struct HIF_CE_state *hif_state,
+					    uint8_t ce_id, uint32_t num)
+{
+	hif_ce_batch_hist_update(hif_state->stats.ce_recv_reap_batch[ce_id],
+				 num);
+}
+
+/**
+ * hif_ce_record_post_batch() - record the size of a receive post batch
+ * @hif_state: HIF CE state
+ * @ce_id: copy engine id
+ * @num: number of buffers posted
+ *
+ * Return: None
+ */
+static inline void hif_ce_record_post_batch(struct HIF_CE_state *hif_state,
+					    uint8_t ce_id, uint32_t num)
+{
+	hif_ce_batch_hist_update(hif_state->stats.ce_recv_post_batch[ce_id],
+				 num);
+}
+#else
+static inline void hif_ce_record_reap_batch(struct HIF_CE_state *hif_state,
+					    uint8_t ce_id, uint32_t num)
+{
+}
+
+static inline void hif_ce_record_post_batch(struct HIF_CE_state *hif_state,
+					    uint8_t ce_id, uint32_t num)
+{
+}
+#endif /* CE_TASKLET_DEBUG_ENABLE */
+
 /*
  * HIA Map Definition
  */
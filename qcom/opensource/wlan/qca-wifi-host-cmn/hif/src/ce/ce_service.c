@@ -805,6 +805,35 @@ ce_recv_buf_enqueue(struct CE_handle *copyeng,
 }
 qdf_export_symbol(ce_recv_buf_enqueue);
 
+uint32_t
+ce_recv_buf_enqueue_batch(struct CE_handle *copyeng,
+			  void **per_recv_context,
+			  qdf_dma_addr_t *buffers, uint32_t num)
+{
+	struct CE_state *CE_state = (struct CE_state *)copyeng;
+	struct HIF_CE_state *hif_state = HIF_GET_CE_STATE(CE_state->scn);
+	struct ce_ops *ce_services = hif_state->ce_services;
+	uint32_t posted = 0;
+
+	if (ce_services->ce_recv_buf_enqueue_batch) {
+		posted = ce_services->ce_recv_buf_enqueue_batch(copyeng,
+							      per_recv_context,
+							      buffers, num);
+	} else {
+		while (posted < num &&
+		       ce_services->ce_recv_buf_enqueue(copyeng,
+						per_recv_context[posted],
+						buffers[posted]) ==
+		       QDF_STATUS_SUCCESS)
+			posted++;
+	}
+
+	hif_ce_record_post_batch(hif_state, CE_state->id, posted);
+
+	return posted;
+}
+qdf_export_symbol(ce_recv_buf_enqueue_batch);
+
 void
 ce_send_watermarks_set(struct CE_handle *copyeng,
 		       unsigned int low_alert_nentries,
@@ -1064,6 +1093,49 @@ static inline bool check_ce_id_and_epping_enabled(int CE_id, uint32_t mode)
 
 #endif /* ENABLE_CE4_COMP_DISABLE_HTT_HTC_MISC_LIST */
 
+/**
+ * ce_engine_service_recv_batch() - reap and deliver recv completions in batches
+ * @hif_state: HIF CE state
+ * @CE_state: copy engine to service, ce_index_lock held by the caller
+ *
+ * Completions are reaped CE_RECV_BATCH_MAX at a time under a single ring
+ * access window and then handed to the recv callback with the index lock
+ * dropped once per batch rather than once per descriptor.
+ *
+ * Return: true if servicing was force-broken and must be rescheduled
+ */
+static bool ce_engine_service_recv_batch(struct HIF_CE_state *hif_state,
+					 struct CE_state *CE_state)
+{
+	struct ce_recv_completion comp[CE_RECV_BATCH_MAX];
+	uint32_t num, i;
+
+	while ((num = hif_state->ce_services->ce_completed_recv_batch_nolock
+				(CE_state, comp, CE_RECV_BATCH_MAX))) {
+		hif_ce_record_reap_batch(hif_state, CE_state->id, num);
+
+		qdf_spin_unlock(&CE_state->ce_index_lock);
+		for (i = 0; i < num; i++)
+			CE_state->recv_cb((struct CE_handle *)CE_state,
+					  comp[i].per_CE_context,
+					  comp[i].per_transfer_context,
+					  comp[i].buffer, comp[i].nbytes,
+					  comp[i].transfer_id, comp[i].flags);
+		qdf_spin_lock(&CE_state->ce_index_lock);
+
+		/* reaped completions are always delivered before breaking */
+		if (qdf_unlikely(CE_state->force_break)) {
+			qdf_atomic_set(&CE_state->rx_pending, 1);
+			return true;
+		}
+
+		if (num < CE_RECV_BATCH_MAX)
+			break;
+	}
+
+	return false;
+}
+
 /*
  * ce_engine_service_reg:
  *
@@ -1090,7 +1162,11 @@ void ce_engine_service_reg(struct hif_softc *scn, int CE_id)
 	uint32_t mode = hif_get_conparam(scn);
 
 more_completions:
-	if (CE_state->recv_cb) {
+	if (CE_state->recv_cb &&
+	    hif_state->ce_services->ce_completed_recv_batch_nolock) {
+		if (ce_engine_service_recv_batch(hif_state, CE_state))
+			return;
+	} else if (CE_state->recv_cb) {
 
 		/* Pop completed recv buffers and call
 		 * the registered recv callback for each
@@ -393,6 +393,84 @@ ce_recv_buf_enqueue_srng(struct CE_handle *copyeng,
 	return status;
 }
 
+/**
+ * ce_recv_buf_enqueue_batch_srng() - enqueue several recv buffers into a CE
+ * @copyeng: copy engine handle
+ * @per_recv_context: array of virtual addresses of the nbufs
+ * @buffers: array of physical addresses of the nbufs
+ * @num: number of buffers to enqueue
+ *
+ * All buffers are written under one SRNG access window, so the head
+ * pointer is published to the target once for the whole batch.
+ *
+ * Return: number of buffers enqueued
+ */
+static uint32_t
+ce_recv_buf_enqueue_batch_srng(struct CE_handle *copyeng,
+			       void **per_recv_context,
+			       qdf_dma_addr_t *buffers, uint32_t num)
+{
+	struct CE_state *CE_state = (struct CE_state *)copyeng;
+	struct CE_ring_state *dest_ring = CE_state->dest_ring;
+	unsigned int nentries_mask = dest_ring->nentries_mask;
+	unsigned int write_index;
+	struct hif_softc *scn = CE_state->scn;
+	struct ce_srng_dest_desc *dest_desc;
+	uint32_t avail;
+	uint32_t posted = 0;
+
+	qdf_spin_lock_bh(&CE_state->ce_index_lock);
+	write_index = dest_ring->write_index;
+
+	if (Q_TARGET_ACCESS_BEGIN(scn) < 0) {
+		qdf_spin_unlock_bh(&CE_state->ce_index_lock);
+		return 0;
+	}
+
+	hal_srng_check_and_update_hptp(scn->hal_soc, dest_ring->srng_ctx,
+				       !CE_state->receive_count);
+
+	if (hal_srng_access_start(scn->hal_soc, dest_ring->srng_ctx)) {
+		Q_TARGET_ACCESS_END(scn);
+		qdf_spin_unlock_bh(&CE_state->ce_index_lock);
+		return 0;
+	}
+
+	avail = hal_srng_src_num_avail(scn->hal_soc, dest_ring->srng_ctx,
+				       false);
+	num = qdf_min(num, avail);
+
+	while (posted < num) {
+		uint64_t dma_addr = buffers[posted];
+
+		dest_desc = hal_srng_src_get_next(scn->hal_soc,
+						  dest_ring->srng_ctx);
+		if (!dest_desc)
+			break;
+
+		CE_ADDR_COPY(dest_desc, dma_addr);
+		dest_ring->per_transfer_context[write_index] =
+			per_recv_context[posted];
+		write_index = CE_RING_IDX_INCR(nentries_mask, write_index);
+
+		hif_record_ce_srng_desc_event(scn, CE_state->id,
+					      HIF_CE_DEST_RING_BUFFER_POST,
+					      (union ce_srng_desc *)dest_desc,
+					      per_recv_context[posted],
+					      write_index, 0,
+					      dest_ring->srng_ctx);
+		posted++;
+	}
+
+	dest_ring->write_index = write_index;
+	hal_srng_access_end(scn->hal_soc, dest_ring->srng_ctx);
+
+	Q_TARGET_ACCESS_END(scn);
+	qdf_spin_unlock_bh(&CE_state->ce_index_lock);
+
+	return posted;
+}
+
 /*
  * Guts of ce_recv_entries_done.
  * The caller takes responsibility for any necessary locking.
@@ -540,6 +618,97 @@ done:
 	return status;
 }
 
+/*
+ * Batched version of ce_completed_recv_next_nolock_srng(), reaps up to
+ * @max_comp completions under a single status ring access window.
+ * The caller takes responsibility for any necessary locking.
+ */
+static uint32_t
+ce_completed_recv_batch_nolock_srng(struct CE_state *CE_state,
+				    struct ce_recv_completion *comp,
+				    uint32_t max_comp)
+{
+	struct CE_ring_state *dest_ring = CE_state->dest_ring;
+	struct CE_ring_state *status_ring = CE_state->status_ring;
+	unsigned int nentries_mask = dest_ring->nentries_mask;
+	unsigned int sw_index = dest_ring->sw_index;
+	struct hif_softc *scn = CE_state->scn;
+	struct ce_srng_dest_status_desc *dest_status = NULL;
+	struct ce_srng_dest_status_desc dest_status_info;
+	struct ce_recv_completion *cur;
+	uint32_t num = 0;
+
+	/* HP/TP update if any should happen only once per interrupt,
+	 * therefore checking for CE receive_count.
+	 */
+	hal_srng_check_and_update_hptp(scn->hal_soc, status_ring->srng_ctx,
+				       !CE_state->receive_count);
+
+	if (hal_srng_access_start(scn->hal_soc, status_ring->srng_ctx))
+		return 0;
+
+	while (num < max_comp) {
+		dest_status = hal_srng_dst_peek(scn->hal_soc,
+						status_ring->srng_ctx);
+		if (!dest_status)
+			break;
+
+		/*
+		 * By copying the dest_desc_info element to local memory, we
+		 * could avoid extra memory read from non-cachable memory.
+		 */
+		dest_status_info = *dest_status;
+		if (!dest_status_info.nbytes) {
+			uint32_t hp, tp;
+
+			/* descriptor not yet done, see the single reap */
+			hal_get_sw_hptp(scn->hal_soc, status_ring->srng_ctx,
+					&tp, &hp);
+			hif_info_rl("No data to reap, hp %d tp %d", hp, tp);
+			break;
+		}
+
+		hal_srng_dst_get_next(scn->hal_soc, status_ring->srng_ctx);
+		dest_status->nbytes = 0;
+
+		cur = &comp[num++];
+		cur->nbytes = dest_status_info.nbytes;
+		cur->transfer_id = dest_status_info.meta_data;
+		cur->flags = (dest_status_info.byte_swap) ?
+				CE_RECV_FLAG_SWAPPED : 0;
+		cur->buffer = 0;
+		cur->per_CE_context = CE_state->recv_context;
+		cur->per_transfer_context =
+			dest_ring->per_transfer_context[sw_index];
+		dest_ring->per_transfer_context[sw_index] = 0;  /* sanity */
+
+		sw_index = CE_RING_IDX_INCR(nentries_mask, sw_index);
+
+		hif_record_ce_srng_desc_event(scn, CE_state->id,
+					      HIF_CE_DEST_RING_BUFFER_REAP,
+					      NULL,
+					      cur->per_transfer_context,
+					      sw_index, cur->nbytes,
+					      dest_ring->srng_ctx);
+	}
+
+	dest_ring->sw_index = sw_index;
+
+	if (num)
+		hal_srng_access_end(scn->hal_soc, status_ring->srng_ctx);
+	else
+		hal_srng_access_end_reap(scn->hal_soc, status_ring->srng_ctx);
+
+	hif_record_ce_srng_desc_event(scn, CE_state->id,
+				      HIF_CE_DEST_STATUS_RING_REAP,
+				      (union ce_srng_desc *)dest_status,
+				      NULL,
+				      -1, 0,
+				      status_ring->srng_ctx);
+
+	return num;
+}
+
 static QDF_STATUS
 ce_revoke_recv_next_srng(struct CE_handle *copyeng,
 		    void **per_CE_contextp,
@@ -1301,9 +1470,11 @@ static struct ce_ops ce_service_srng = {
 	.ce_srng_cleanup = ce_ring_cleanup_srng,
 	.ce_sendlist_send = ce_sendlist_send_srng,
 	.ce_completed_recv_next_nolock = ce_completed_recv_next_nolock_srng,
+	.ce_completed_recv_batch_nolock = ce_completed_recv_batch_nolock_srng,
 	.ce_revoke_recv_next = ce_revoke_recv_next_srng,
 	.ce_cancel_send_next = ce_cancel_send_next_srng,
 	.ce_recv_buf_enqueue = ce_recv_buf_enqueue_srng,
+	.ce_recv_buf_enqueue_batch = ce_recv_buf_enqueue_batch_srng,
 	.ce_per_engine_handler_adjust = ce_per_engine_handler_adjust_srng,
 	.ce_send_nolock = ce_send_nolock_srng,
 	.watermark_int = ce_check_int_watermark_srng,
@@ -188,6 +188,8 @@ hif_ce_latency_stats(struct hif_softc *hif_ctx)
 	uint64_t secs, usecs;
 	static const char * const buck_str[] = {"0 - 0.5", "0.5 - 1", "1  -  2",
 					       "2  -  5", "5  - 10", "  >  10"};
+	static const char * const batch_str[] = {"    1", "2 - 4", "5 - 8",
+						"9 -16", " > 16"};
 	struct HIF_CE_state *hif_ce_state = HIF_GET_CE_STATE(hif_ctx);
 	struct ce_stats *stats = &hif_ce_state->stats;
 
@@ -215,6 +217,13 @@ hif_ce_latency_stats(struct hif_softc *hif_ctx)
 				     secs, usecs);
 		}
 
+		hif_nofl_err("\n\t\tCE Ring %d Recv Batch Size Bucket", i);
+		for (j = 0; j < CE_BATCH_MAX; j++)
+			hif_nofl_err("\t Bucket %s :reaped %llu\t posted %llu",
+				     batch_str[j],
+				     stats->ce_recv_reap_batch[i][j],
+				     stats->ce_recv_post_batch[i][j]);
+
 		hif_nofl_err("\n\t\t CE RING %d Last %d time records",
 			     i, HIF_REQUESTED_EVENTS);
 		index = stats->record_index[i];
@@ -515,6 +515,50 @@ void hif_exec_fill_poll_time_histogram(struct hif_exec_context *hif_ext_group)
 }
 #endif /* WLAN_FEATURE_RX_SOFTIRQ_TIME_LIMIT */
 
+#ifdef HIF_EXEC_LOAD_PLACEMENT
+/**
+ * hif_exec_load_poll_start() - mark the start of a poll for load accounting
+ * @hif_ext_group: hif_ext_group of type NAPI
+ *
+ * Return: None
+ */
+static inline
+void hif_exec_load_poll_start(struct hif_exec_context *hif_ext_group)
+{
+	hif_ext_group->load_poll_start = qdf_time_sched_clock();
+}
+
+/**
+ * hif_exec_load_poll_end() - account the time and work of a poll
+ * @hif_ext_group: hif_ext_group of type NAPI
+ * @work_done: number of packets processed in the poll
+ *
+ * A group is polled on one CPU at a time, so the accumulators have a single
+ * writer; the placement engine only reads them.
+ *
+ * Return: None
+ */
+static inline
+void hif_exec_load_poll_end(struct hif_exec_context *hif_ext_group,
+			    int work_done)
+{
+	hif_ext_group->load_busy_ns += qdf_time_sched_clock() -
+				       hif_ext_group->load_poll_start;
+	hif_ext_group->load_pkts += work_done;
+}
+#else
+static inline
+void hif_exec_load_poll_start(struct hif_exec_context *hif_ext_group)
+{
+}
+
+static inline
+void hif_exec_load_poll_end(struct hif_exec_context *hif_ext_group,
+			    int work_done)
+{
+}
+#endif /* HIF_EXEC_LOAD_PLACEMENT */
+
 static void hif_exec_tasklet_schedule(struct hif_exec_context *ctx)
 {
 	struct hif_tasklet_exec_context *t_ctx = hif_exec_get_tasklet(ctx);
@@ -677,6 +721,7 @@ static int hif_exec_poll(struct napi_struct *napi, int budget)
 
 	hif_ext_group->force_break = false;
 	hif_exec_update_service_start_time(hif_ext_group);
+	hif_exec_load_poll_start(hif_ext_group);
 
 	if (budget)
 		normalized_budget = NAPI_BUDGET_TO_INTERNAL_BUDGET(budget, shift);
@@ -720,6 +765,7 @@ static int hif_exec_poll(struct napi_struct *napi, int budget)
 		work_done = INTERNAL_BUDGET_TO_NAPI_BUDGET(work_done, shift);
 
 	hif_exec_fill_poll_time_histogram(hif_ext_group);
+	hif_exec_load_poll_end(hif_ext_group, actual_dones);
 
 	return work_done;
 }
@@ -116,6 +116,19 @@ struct hif_exec_context {
 	qdf_atomic_t force_napi_complete;
 #endif
 	unsigned long long irq_disabled_start_time;
+#ifdef HIF_EXEC_LOAD_PLACEMENT
+	/* accumulated by the poll routine */
+	unsigned long long load_poll_start;
+	uint64_t load_busy_ns;
+	uint64_t load_pkts;
+	/* owned by the placement engine, under napi_data lock */
+	uint64_t load_last_busy_ns;
+	uint64_t load_last_pkts;
+	uint32_t load_util;
+	uint32_t load_pkt_rate;
+	int place_cand;
+	uint8_t place_cnt;
+#endif
 };
 
 /**
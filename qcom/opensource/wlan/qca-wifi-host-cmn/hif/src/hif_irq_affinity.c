@@ -38,6 +38,7 @@
 #include <hif_exec.h>
 #include <hif_main.h>
 #include "qdf_irq.h"
+#include <qdf_tracepoint.h>
 
 #if defined(FEATURE_NAPI_DEBUG) && defined(HIF_IRQ_AFFINITY)
 /*
@@ -53,6 +54,249 @@ static void hnc_dump_cpus(struct qca_napi_data *napid) { /* no-op */ };
 #endif /* FEATURE_NAPI_DEBUG */
 
 #ifdef HIF_IRQ_AFFINITY
+#ifdef HIF_EXEC_LOAD_PLACEMENT
+static int hncm_exec_migrate_to(struct qca_napi_data *napid, uint8_t ctx_id,
+				int didx);
+
+/* weight of a new sample in the load average, as a shift */
+#define HIF_EXEC_LOAD_EWMA_SHIFT 2
+/* share of a cpu, in per-mille, the exec contexts may use on their own */
+#define HIF_EXEC_LOAD_HEADROOM 750
+/* consecutive samples agreeing on a new cpu before a group is moved */
+#define HIF_EXEC_LOAD_HYST_SAMPLES 3
+/* capacity of the biggest cpu */
+#define HIF_EXEC_LOAD_CAP_SCALE 1024
+
+/**
+ * hnc_cpu_capacity() - relative compute capacity of a cpu
+ * @napid: pointer to NAPI block
+ * @cpu: index in the cpu topology table
+ * @max_freq: highest max_freq of all cpus in the topology table
+ *
+ * Return: capacity, HIF_EXEC_LOAD_CAP_SCALE for the biggest cpu
+ */
+static uint32_t hnc_cpu_capacity(struct qca_napi_data *napid, int cpu,
+				 unsigned int max_freq)
+{
+	if (!max_freq || !napid->napi_cpu[cpu].max_freq)
+		return HIF_EXEC_LOAD_CAP_SCALE;
+
+	return qdf_do_div((uint64_t)napid->napi_cpu[cpu].max_freq *
+			  HIF_EXEC_LOAD_CAP_SCALE, max_freq);
+}
+
+/**
+ * hif_exec_load_sample() - fold the load of each exec context since the last
+ *                          sample into its running average
+ * @napid: pointer to NAPI block
+ * @period_ns: time since the last sample
+ * @max_freq: highest max_freq of all cpus in the topology table
+ *
+ * The busy time is measured on the cpu the group currently runs on and is
+ * scaled by that cpu's capacity, so the average is comparable across
+ * clusters: HIF_EXEC_LOAD_CAP_SCALE means one fully busy biggest cpu.
+ *
+ * Return: None
+ */
+static void hif_exec_load_sample(struct qca_napi_data *napid,
+				 uint64_t period_ns, unsigned int max_freq)
+{
+	struct hif_exec_context *exec_ctx;
+	uint64_t busy, pkts;
+	uint32_t util, rate;
+	int i;
+
+	for (i = 0; i < HIF_MAX_GROUP; i++) {
+		if (!(napid->exec_map & (0x01 << i)))
+			continue;
+
+		exec_ctx = hif_exec_get_ctx(&napid->hif_softc->osc, i);
+		if (!exec_ctx)
+			continue;
+
+		busy = exec_ctx->load_busy_ns - exec_ctx->load_last_busy_ns;
+		pkts = exec_ctx->load_pkts - exec_ctx->load_last_pkts;
+		exec_ctx->load_last_busy_ns += busy;
+		exec_ctx->load_last_pkts += pkts;
+
+		if (busy > period_ns)
+			busy = period_ns;
+
+		util = qdf_do_div(busy * hnc_cpu_capacity(napid, exec_ctx->cpu,
+							  max_freq),
+				  period_ns);
+		rate = qdf_do_div(pkts * QDF_NSEC_PER_SEC, period_ns);
+
+		exec_ctx->load_util += ((int32_t)util -
+					(int32_t)exec_ctx->load_util) >>
+				       HIF_EXEC_LOAD_EWMA_SHIFT;
+		exec_ctx->load_pkt_rate += ((int32_t)rate -
+					    (int32_t)exec_ctx->load_pkt_rate) >>
+					   HIF_EXEC_LOAD_EWMA_SHIFT;
+	}
+}
+
+/**
+ * hif_exec_load_pick_cpu() - pick the cpu a group of given load fits best
+ * @napid: pointer to NAPI block
+ * @util: load of the group
+ * @cpu_load: load already placed on each cpu
+ * @max_freq: highest max_freq of all cpus in the topology table
+ *
+ * The smallest cpu which can take @util while staying within
+ * HIF_EXEC_LOAD_HEADROOM of its capacity wins, so light groups settle on
+ * the little cluster and heavy ones are pushed to bigger cores. If no cpu
+ * has room, the one with the most spare capacity is taken.
+ *
+ * Return: index in the cpu topology table, or -1 if no cpu is online
+ */
+static int hif_exec_load_pick_cpu(struct qca_napi_data *napid, uint32_t util,
+				  uint32_t *cpu_load, unsigned int max_freq)
+{
+	int fit = -1, spare = -1;
+	uint32_t fit_cap = 0, cap, limit;
+	int32_t spare_cap = INT_MIN, room;
+	int heads[] = { napid->lilcl_head, napid->bigcl_head };
+	int h, i;
+
+	for (h = 0; h < QDF_ARRAY_SIZE(heads); h++) {
+		for (i = heads[h]; i >= 0; i = napid->napi_cpu[i].cluster_nxt) {
+			if (napid->napi_cpu[i].state != QCA_NAPI_CPU_UP)
+				continue;
+
+			cap = hnc_cpu_capacity(napid, i, max_freq);
+			limit = cap * HIF_EXEC_LOAD_HEADROOM / 1000;
+			room = (int32_t)cap - (int32_t)cpu_load[i];
+
+			if (cpu_load[i] + util <= limit &&
+			    (fit < 0 || cap < fit_cap ||
+			     (cap == fit_cap && cpu_load[i] < cpu_load[fit]))) {
+				fit = i;
+				fit_cap = cap;
+			}
+
+			if (room > spare_cap) {
+				spare = i;
+				spare_cap = room;
+			}
+		}
+	}
+
+	return fit >= 0 ? fit : spare;
+}
+
+/**
+ * hif_exec_load_place() - place exec context groups on cpus by their load
+ * @napid: pointer to NAPI block
+ *
+ * Called periodically in high throughput mode with napid->lock held. The
+ * groups are placed heaviest first; each goes to the cpu picked by
+ * hif_exec_load_pick_cpu() given the groups placed before it. A group only
+ * moves once the same new cpu has been picked HIF_EXEC_LOAD_HYST_SAMPLES
+ * times in a row, and never between cpus of equal capacity while its
+ * current cpu still has room, so placement does not oscillate.
+ *
+ * Return: None
+ */
+static void hif_exec_load_place(struct qca_napi_data *napid)
+{
+	struct hif_exec_context *ctxs[HIF_MAX_GROUP];
+	struct hif_exec_context *exec_ctx;
+	uint32_t cpu_load[NR_CPUS] = { 0 };
+	unsigned int max_freq = 0;
+	uint64_t now = qdf_time_sched_clock();
+	uint64_t period_ns = now - napid->load_sample_ts;
+	uint32_t cur_cap, cur_limit;
+	int num = 0, i, j, dest, cur;
+
+	if (!napid->exec_map)
+		return;
+
+	for (i = 0; i < NR_CPUS; i++)
+		if (napid->napi_cpu[i].max_freq > max_freq)
+			max_freq = napid->napi_cpu[i].max_freq;
+
+	for (i = 0; i < HIF_MAX_GROUP; i++) {
+		if (!(napid->exec_map & (0x01 << i)))
+			continue;
+
+		exec_ctx = hif_exec_get_ctx(&napid->hif_softc->osc, i);
+		if (exec_ctx)
+			ctxs[num++] = exec_ctx;
+	}
+
+	/* the first sample only sets the reference point */
+	if (!napid->load_sample_ts || !period_ns) {
+		for (i = 0; i < num; i++) {
+			ctxs[i]->load_last_busy_ns = ctxs[i]->load_busy_ns;
+			ctxs[i]->load_last_pkts = ctxs[i]->load_pkts;
+		}
+		napid->load_sample_ts = now;
+		return;
+	}
+	napid->load_sample_ts = now;
+
+	hif_exec_load_sample(napid, period_ns, max_freq);
+
+	/* heaviest first; there are only a handful of groups */
+	for (i = 1; i < num; i++) {
+		exec_ctx = ctxs[i];
+		for (j = i; j > 0 && ctxs[j - 1]->load_util < exec_ctx->load_util;
+		     j--)
+			ctxs[j] = ctxs[j - 1];
+		ctxs[j] = exec_ctx;
+	}
+
+	for (i = 0; i < num; i++) {
+		exec_ctx = ctxs[i];
+		cur = exec_ctx->cpu;
+		dest = hif_exec_load_pick_cpu(napid, exec_ctx->load_util,
+					      cpu_load, max_freq);
+
+		if (dest >= 0 && dest != cur &&
+		    napid->napi_cpu[cur].state == QCA_NAPI_CPU_UP) {
+			cur_cap = hnc_cpu_capacity(napid, cur, max_freq);
+			cur_limit = cur_cap * HIF_EXEC_LOAD_HEADROOM / 1000;
+			if (cur_cap == hnc_cpu_capacity(napid, dest, max_freq) &&
+			    cpu_load[cur] + exec_ctx->load_util <= cur_limit)
+				dest = cur;
+		}
+
+		if (dest < 0 || dest == cur) {
+			exec_ctx->place_cnt = 0;
+			cpu_load[cur] += exec_ctx->load_util;
+			continue;
+		}
+
+		if (exec_ctx->place_cand != dest) {
+			exec_ctx->place_cand = dest;
+			exec_ctx->place_cnt = 0;
+		}
+
+		if (++exec_ctx->place_cnt < HIF_EXEC_LOAD_HYST_SAMPLES) {
+			cpu_load[cur] += exec_ctx->load_util;
+			continue;
+		}
+
+		qdf_trace_dp_exec_ctx_migrate(exec_ctx->grp_id, cur, dest,
+					      exec_ctx->load_util,
+					      exec_ctx->load_pkt_rate);
+		hif_debug("grp %d: cpu %d -> %d util %u pkt_rate %u",
+			  exec_ctx->grp_id, cur, dest, exec_ctx->load_util,
+			  exec_ctx->load_pkt_rate);
+
+		exec_ctx->place_cnt = 0;
+		if (hncm_exec_migrate_to(napid, exec_ctx->grp_id, dest))
+			dest = cur;
+		cpu_load[dest] += exec_ctx->load_util;
+	}
+}
+#else
+static inline void hif_exec_load_place(struct qca_napi_data *napid)
+{
+}
+#endif /* HIF_EXEC_LOAD_PLACEMENT */
+
 /**
  * hif_exec_event() - reacts to events that impact irq affinity
  * @hif_ctx: pointer to hif context
@@ -187,6 +431,10 @@ int hif_exec_event(struct hif_opaque_softc *hif_ctx, enum qca_napi_event event,
 			denylist_pending = DENYLIST_ON_PENDING;
 		break;
 	}
+	case NAPI_EVT_LOAD_SAMPLE:
+		if (napid->napi_mode == QCA_NAPI_TPUT_HI)
+			hif_exec_load_place(napid);
+		break;
 	case NAPI_EVT_USR_NORMAL: {
 		NAPI_DEBUG("%s: User forced DE-SERIALIZATION", __func__);
 		if (!napid->user_cpu_affin_mask)
@@ -627,6 +627,9 @@ int hif_napi_event(struct hif_opaque_softc *hif_ctx, enum qca_napi_event event,
 		napid->napi_mode = QCA_NAPI_TPUT_UNINITIALIZED;
 		break;
 	}
+	case NAPI_EVT_LOAD_SAMPLE:
+		/* load based placement is only done for exec contexts */
+		break;
 	default: {
 		hif_err("Unknown event: %d (data=0x%0lx)",
 			event, (unsigned long) data);
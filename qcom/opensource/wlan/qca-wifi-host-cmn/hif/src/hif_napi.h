@@ -69,6 +69,7 @@
  * EVT_TPUT_STATE : (high/low)       : tput trigger
  * EVT_USR_SERIAL : num-serial_calls : WMA/ROAMING-START/IND
  * EVT_USR_NORMAL : N/A              : WMA/ROAMING-END
+ * EVT_LOAD_SAMPLE: N/A              : periodic, while in high tput
  */
 enum qca_napi_event {
 	NAPI_EVT_INVALID,
@@ -78,7 +79,8 @@ enum qca_napi_event {
 	NAPI_EVT_CPU_STATE,
 	NAPI_EVT_TPUT_STATE,
 	NAPI_EVT_USR_SERIAL,
-	NAPI_EVT_USR_NORMAL
+	NAPI_EVT_USR_NORMAL,
+	NAPI_EVT_LOAD_SAMPLE
 };
 
 /*
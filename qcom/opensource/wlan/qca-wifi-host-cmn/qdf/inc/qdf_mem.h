@@ -118,6 +118,14 @@ void qdf_mem_exit(void);
  */
 bool qdf_mem_debug_config_get(void);
 
+/**
+ * qdf_mem_debug_sample_shift_get() - Get the memory debug sampling rate
+ *
+ * Return: value of mem_debug_sample_shift qdf module argument; only one in
+ *	every (1 << value) allocations is tracked, 0 tracks all of them
+ */
+uint8_t qdf_mem_debug_sample_shift_get(void);
+
 #ifdef QCA_WIFI_MODULE_PARAMS_FROM_INI
 /**
  * qdf_mem_debug_disabled_config_set() - Set mem_debug_disabled
@@ -359,6 +367,11 @@ static inline bool qdf_mem_debug_config_get(void)
 	return false;
 }
 
+static inline uint8_t qdf_mem_debug_sample_shift_get(void)
+{
+	return 0;
+}
+
 static inline
 QDF_STATUS qdf_mem_debug_disabled_config_set(const char *str_value)
 {
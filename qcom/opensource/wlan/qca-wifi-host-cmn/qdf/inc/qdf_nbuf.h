@@ -1492,6 +1492,38 @@ void qdf_nbuf_queue_head_enqueue_tail(qdf_nbuf_queue_head_t *nbuf_queue_head,
 	return __qdf_nbuf_queue_head_enqueue_tail(nbuf_queue_head, nbuf);
 }
 
+/**
+ * qdf_nbuf_queue_head_dequeue_no_lock() - dequeue nbuf from the head of queue
+ * @nbuf_queue_head: pointer to nbuf queue head
+ *
+ * This is a lockless version, driver must acquire locks if it
+ * needs to synchronize
+ *
+ * Return: pointer to network buffer dequeued
+ */
+static inline qdf_nbuf_t
+qdf_nbuf_queue_head_dequeue_no_lock(qdf_nbuf_queue_head_t *nbuf_queue_head)
+{
+	return __qdf_nbuf_queue_head_dequeue_no_lock(nbuf_queue_head);
+}
+
+/**
+ * qdf_nbuf_queue_head_enqueue_tail_no_lock() - enqueue nbuf into queue tail
+ * @nbuf_queue_head: pointer to nbuf queue head
+ * @nbuf: nbuf to be enqueued
+ *
+ * This is a lockless version, driver must acquire locks if it
+ * needs to synchronize
+ *
+ * Return: None
+ */
+static inline void
+qdf_nbuf_queue_head_enqueue_tail_no_lock(qdf_nbuf_queue_head_t *nbuf_queue_head,
+					 qdf_nbuf_t nbuf)
+{
+	__qdf_nbuf_queue_head_enqueue_tail_no_lock(nbuf_queue_head, nbuf);
+}
+
 /**
  * qdf_nbuf_queue_head_init() - initialize qdf_nbuf_queue_head_t
  * @nbuf_queue_head: pointer to nbuf queue head to be initialized
@@ -5315,6 +5347,20 @@ static inline void qdf_nbuf_set_hash(qdf_nbuf_t buf, uint32_t len)
 	__qdf_nbuf_set_hash(buf, len);
 }
 
+/**
+ * qdf_nbuf_get_flow_hash() - get the flow hash of the buf
+ * @buf: Network buf instance
+ *
+ * The hash is computed from the packet headers if the stack did not set
+ * one, so it is stable for all packets of a flow.
+ *
+ * Return: flow hash
+ */
+static inline uint32_t qdf_nbuf_get_flow_hash(qdf_nbuf_t buf)
+{
+	return __qdf_nbuf_get_flow_hash(buf);
+}
+
 /**
  * qdf_nbuf_set_sw_hash() - set the sw hash of the buf
  * @buf: Network buf instance
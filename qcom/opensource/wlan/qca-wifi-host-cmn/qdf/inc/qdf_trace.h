@@ -1721,6 +1721,22 @@ struct category_name_info {
 	unsigned char category_name_str[QDF_MAX_NAME_SIZE];
 };
 
+/**
+ * qdf_trace_msg_prefix() - Print the converged logging line prefix
+ * @buf: buffer to print the prefix into
+ * @size: size of @buf
+ * @pid: pid of the logging context, 0 for interrupt context
+ * @verbose: Verbose level of the message
+ * @category: Category identifier of the message
+ *
+ * Prints the "wlan: [pid:level:category] " prefix qdf_trace_msg_cmn() puts
+ * in front of every message, so that lines formatted later on look the same.
+ *
+ * Return: number of characters written, not including the trailing '\0'
+ */
+int qdf_trace_msg_prefix(char *buf, int size, int pid,
+			 QDF_TRACE_LEVEL verbose, QDF_MODULE_ID category);
+
 /**
  * qdf_trace_msg_cmn() - Converged logging API
  * @idx: Index of print control object assigned to the module
@@ -28,20 +28,27 @@
 
 #define QDF_TRACKER_FUNC_SIZE 48
 
+/* number of locks the hashtable buckets are spread over, a power of 2 */
+#define QDF_TRACKER_LOCK_SHARDS 8
+
 /**
  * struct qdf_tracker - a generic type for tracking resources
  * @leak_title: the string title to use when logging leaks
  * @track_title: the string title to use when logging double tracking issues
  * @untrack_title: the string title to use when logging double untracking issues
- * @lock: lock for simultaneous access to @ht
+ * @locks: locks for simultaneous access to @ht, bucket n of @ht is protected
+ *	by lock n % QDF_TRACKER_LOCK_SHARDS
  * @ht: the hashtable used for storing tracking information
+ * @sample_shift: track only 1 in (1 << @sample_shift) resources, picked by
+ *	pointer hash; 0 tracks every resource
  */
 struct qdf_tracker {
 	const char *leak_title;
 	const char *track_title;
 	const char *untrack_title;
-	struct qdf_spinlock lock;
+	struct qdf_spinlock locks[QDF_TRACKER_LOCK_SHARDS];
 	struct qdf_ptr_hash *ht;
+	uint8_t sample_shift;
 };
 
 /**
@@ -79,6 +86,20 @@ void qdf_tracker_init(struct qdf_tracker *tracker);
  */
 void qdf_tracker_deinit(struct qdf_tracker *tracker);
 
+/**
+ * qdf_tracker_set_sampling() - track only a sample of the resources
+ * @tracker: the qdf_tracker to configure
+ * @sample_shift: track 1 in (1 << @sample_shift) resources; 0 tracks all
+ *
+ * Sampling is decided by pointer hash, so untracking a resource makes the
+ * same decision as tracking it did. Must be set while @tracker is empty.
+ * Double untracking is only detected for sampled resources.
+ *
+ * Return: None
+ */
+void qdf_tracker_set_sampling(struct qdf_tracker *tracker,
+			      uint8_t sample_shift);
+
 /**
  * qdf_tracker_track() - track a resource with @tracker
  * @tracker: the qdf_tracker to track with
@@ -139,6 +160,12 @@ void qdf_tracker_deinit(struct qdf_tracker *tracker)
 {
 }
 
+static inline
+void qdf_tracker_set_sampling(struct qdf_tracker *tracker,
+			      uint8_t sample_shift)
+{
+}
+
 static inline qdf_must_check QDF_STATUS
 qdf_tracker_track(struct qdf_tracker *tracker, void *ptr,
 		  const char *func, uint32_t line)
@@ -2932,6 +2932,19 @@ void __qdf_nbuf_queue_head_enqueue_tail(struct sk_buff_head *skb_queue_head,
 	return skb_queue_tail(skb_queue_head, skb);
 }
 
+static inline struct sk_buff *
+__qdf_nbuf_queue_head_dequeue_no_lock(struct sk_buff_head *skb_queue_head)
+{
+	return __skb_dequeue(skb_queue_head);
+}
+
+static inline void
+__qdf_nbuf_queue_head_enqueue_tail_no_lock(struct sk_buff_head *skb_queue_head,
+					   struct sk_buff *skb)
+{
+	__skb_queue_tail(skb_queue_head, skb);
+}
+
 static inline
 void __qdf_nbuf_queue_head_init(struct sk_buff_head *skb_queue_head)
 {
@@ -3145,6 +3158,17 @@ static inline void __qdf_nbuf_set_hash(__qdf_nbuf_t buf, uint32_t len)
 	buf->hash = len;
 }
 
+/**
+ * __qdf_nbuf_get_flow_hash() - get the flow hash of the buf
+ * @buf: Network buf instance
+ *
+ * Return: flow hash
+ */
+static inline uint32_t __qdf_nbuf_get_flow_hash(__qdf_nbuf_t buf)
+{
+	return skb_get_hash(buf);
+}
+
 /**
  * __qdf_nbuf_set_sw_hash() - set the sw hash of the buf
  * @buf: Network buf instance
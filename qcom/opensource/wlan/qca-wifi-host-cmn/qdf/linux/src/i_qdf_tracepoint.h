@@ -326,4 +326,22 @@ __qdf_trace_dp_ce_tasklet_sched_latency(uint8_t ce_id, uint64_t sched_latency)
 {
 	trace_dp_ce_tasklet_sched_latency(ce_id, sched_latency);
 }
+
+/**
+ * __qdf_trace_dp_exec_ctx_migrate() - Trace exec context IRQ migration
+ * @grp_id: exec context group id
+ * @from_cpu: cpu the group was running on
+ * @to_cpu: cpu the group is moved to
+ * @util: measured group load
+ * @pkt_rate: measured group packet rate
+ *
+ * Return: None
+ */
+static inline void
+__qdf_trace_dp_exec_ctx_migrate(uint8_t grp_id, uint8_t from_cpu,
+				uint8_t to_cpu, uint32_t util,
+				uint32_t pkt_rate)
+{
+	trace_dp_exec_ctx_migrate(grp_id, from_cpu, to_cpu, util, pkt_rate);
+}
 #endif /* _I_QDF_TRACEPOINT_H */
@@ -34,6 +34,7 @@
 #include <linux/debugfs.h>
 #include <linux/seq_file.h>
 #include <linux/string.h>
+#include <linux/hash.h>
 #include <qdf_list.h>
 
 #ifdef CNSS_MEM_PRE_ALLOC
@@ -51,6 +52,13 @@ qdf_declare_param(mem_debug_disabled, bool);
 
 #ifdef MEMORY_DEBUG
 static bool is_initial_mem_debug_disabled;
+
+/*
+ * Track only one out of every (1 << mem_debug_sample_shift) allocations;
+ * 0 tracks every allocation.
+ */
+static uint mem_debug_sample_shift;
+qdf_declare_param(mem_debug_sample_shift, uint);
 #endif
 
 /* Preprocessor Definitions and Constants */
@@ -117,15 +125,28 @@ struct major_alloc_priv {
 	uint32_t threshold;
 };
 
-static qdf_list_t qdf_mem_domains[QDF_DEBUG_DOMAIN_COUNT];
-static qdf_spinlock_t qdf_mem_list_lock;
+/*
+ * The kmalloc debug lists are split into shards, each with its own lock, so
+ * that concurrent alloc/free from different contexts do not serialize on a
+ * single global lock. The shard is derived from the header address, so the
+ * free path finds it again without storing anything extra in the header.
+ */
+#define QDF_MEM_LIST_SHARD_BITS 3
+#define QDF_MEM_LIST_SHARDS (1 << QDF_MEM_LIST_SHARD_BITS)
+
+static qdf_list_t qdf_mem_domains[QDF_MEM_LIST_SHARDS][QDF_DEBUG_DOMAIN_COUNT];
+static qdf_spinlock_t qdf_mem_list_lock[QDF_MEM_LIST_SHARDS];
 
 static qdf_list_t qdf_mem_dma_domains[QDF_DEBUG_DOMAIN_COUNT];
 static qdf_spinlock_t qdf_mem_dma_list_lock;
 
-static inline qdf_list_t *qdf_mem_list_get(enum qdf_debug_domain domain)
+/* snapshot of mem_debug_sample_shift taken at qdf_mem_debug_init() */
+static uint8_t qdf_mem_sample_shift;
+
+static inline qdf_list_t *qdf_mem_list_get(uint32_t shard,
+					   enum qdf_debug_domain domain)
 {
-	return &qdf_mem_domains[domain];
+	return &qdf_mem_domains[shard][domain];
 }
 
 static inline qdf_list_t *qdf_mem_dma_list(enum qdf_debug_domain domain)
@@ -188,6 +209,33 @@ static inline void *qdf_mem_get_ptr(struct qdf_mem_header *header)
 	return (void *)(header + 1);
 }
 
+static inline uint32_t qdf_mem_list_shard(struct qdf_mem_header *header)
+{
+	return hash_long((unsigned long)header, QDF_MEM_LIST_SHARD_BITS);
+}
+
+/**
+ * qdf_mem_header_sampled() - check if an allocation is tracked in the lists
+ * @header: the memory header of the allocation
+ *
+ * The decision is a pure function of the header address, so alloc and free
+ * always agree without a per-allocation flag. Shard selection uses the top
+ * hash bits while sampling uses the low ones, keeping the two independent.
+ *
+ * Return: true if the allocation is (to be) tracked
+ */
+static inline bool qdf_mem_header_sampled(struct qdf_mem_header *header)
+{
+	uint32_t mask;
+
+	if (!qdf_mem_sample_shift)
+		return true;
+
+	mask = (1U << qdf_mem_sample_shift) - 1;
+
+	return !(hash_long((unsigned long)header, 32) & mask);
+}
+
 /* number of bytes needed for the qdf memory debug information */
 #define QDF_MEM_DEBUG_SIZE \
 	(sizeof(struct qdf_mem_header) + sizeof(WLAN_MEM_TRAILER))
@@ -399,17 +447,67 @@ static bool qdf_mem_meta_table_insert(struct __qdf_mem_info *table,
 	return i >= QDF_MEM_STAT_TABLE_SIZE - 1;
 }
 
+/**
+ * qdf_mem_list_print() - walk one debug list into the metadata table
+ * @list: the debug list to walk
+ * @lock: the lock protecting @list
+ * @table: the memory metadata table to accumulate into
+ * @print: the print adapter function
+ * @print_priv: the private data to be consumed by @print
+ * @threshold: the threshold value set by uset to list top allocations
+ * @mem_print: pointer to function which prints the memory allocation data
+ *
+ * Return: None
+ */
+static void qdf_mem_list_print(qdf_list_t *list,
+			       qdf_spinlock_t *lock,
+			       struct __qdf_mem_info *table,
+			       qdf_abstract_print print,
+			       void *print_priv,
+			       uint32_t threshold,
+			       void (*mem_print)(struct __qdf_mem_info *,
+						 qdf_abstract_print,
+						 void *, uint32_t))
+{
+	QDF_STATUS status;
+	qdf_list_node_t *node;
+
+	/* hold lock while inserting to avoid use-after free of the metadata */
+	qdf_spin_lock(lock);
+	status = qdf_list_peek_front(list, &node);
+	while (QDF_IS_STATUS_SUCCESS(status)) {
+		struct qdf_mem_header *meta = (struct qdf_mem_header *)node;
+		bool is_full = qdf_mem_meta_table_insert(table, meta);
+
+		qdf_spin_unlock(lock);
+
+		if (is_full) {
+			(*mem_print)(table, print, print_priv, threshold);
+			qdf_mem_zero(table, sizeof(*table) *
+				     QDF_MEM_STAT_TABLE_SIZE);
+		}
+
+		qdf_spin_lock(lock);
+		status = qdf_list_peek_next(list, node, &node);
+	}
+	qdf_spin_unlock(lock);
+}
+
 /**
  * qdf_mem_domain_print() - output agnostic memory domain print logic
+ * @type: the type of the debug list (kmalloc or dma) to print
  * @domain: the memory domain to print
  * @print: the print adapter function
  * @print_priv: the private data to be consumed by @print
  * @threshold: the threshold value set by uset to list top allocations
  * @mem_print: pointer to function which prints the memory allocation data
  *
+ * For kmalloc lists all shards are merged into a single table.
+ *
  * Return: None
  */
-static void qdf_mem_domain_print(qdf_list_t *domain,
+static void qdf_mem_domain_print(enum list_type type,
+				 enum qdf_debug_domain domain,
 				 qdf_abstract_print print,
 				 void *print_priv,
 				 uint32_t threshold,
@@ -417,33 +515,47 @@ static void qdf_mem_domain_print(qdf_list_t *domain,
 						   qdf_abstract_print,
 						   void *, uint32_t))
 {
-	QDF_STATUS status;
 	struct __qdf_mem_info table[QDF_MEM_STAT_TABLE_SIZE];
-	qdf_list_node_t *node;
+	uint32_t shard;
 
 	qdf_mem_zero(table, sizeof(table));
 	qdf_mem_debug_print_header(print, print_priv, threshold);
 
-	/* hold lock while inserting to avoid use-after free of the metadata */
-	qdf_spin_lock(&qdf_mem_list_lock);
-	status = qdf_list_peek_front(domain, &node);
-	while (QDF_IS_STATUS_SUCCESS(status)) {
-		struct qdf_mem_header *meta = (struct qdf_mem_header *)node;
-		bool is_full = qdf_mem_meta_table_insert(table, meta);
+	if (type == LIST_TYPE_DMA) {
+		qdf_mem_list_print(qdf_mem_dma_list(domain),
+				   &qdf_mem_dma_list_lock, table, print,
+				   print_priv, threshold, mem_print);
+	} else {
+		for (shard = 0; shard < QDF_MEM_LIST_SHARDS; shard++)
+			qdf_mem_list_print(qdf_mem_list_get(shard, domain),
+					   &qdf_mem_list_lock[shard], table,
+					   print, print_priv, threshold,
+					   mem_print);
+	}
 
-		qdf_spin_unlock(&qdf_mem_list_lock);
+	(*mem_print)(table, print, print_priv, threshold);
+}
 
-		if (is_full) {
-			(*mem_print)(table, print, print_priv, threshold);
-			qdf_mem_zero(table, sizeof(table));
-		}
+/**
+ * qdf_mem_domain_count() - number of tracked allocations in a memory domain
+ * @type: the type of the debug list (kmalloc or dma)
+ * @domain: the memory domain to count
+ *
+ * Return: number of allocations tracked across all shards
+ */
+static uint32_t qdf_mem_domain_count(enum list_type type,
+				     enum qdf_debug_domain domain)
+{
+	uint32_t count = 0;
+	uint32_t shard;
 
-		qdf_spin_lock(&qdf_mem_list_lock);
-		status = qdf_list_peek_next(domain, node, &node);
-	}
-	qdf_spin_unlock(&qdf_mem_list_lock);
+	if (type == LIST_TYPE_DMA)
+		return qdf_list_size(qdf_mem_dma_list(domain));
 
-	(*mem_print)(table, print, print_priv, threshold);
+	for (shard = 0; shard < QDF_MEM_LIST_SHARDS; shard++)
+		count += qdf_list_size(qdf_mem_list_get(shard, domain));
+
+	return count;
 }
 
 /**
@@ -641,7 +753,7 @@ static int qdf_mem_seq_show(struct seq_file *seq, void *v)
 
 	seq_printf(seq, "\n%s Memory Domain (Id %d)\n",
 		   qdf_debug_domain_name(domain_id), domain_id);
-	qdf_mem_domain_print(qdf_mem_list_get(domain_id),
+	qdf_mem_domain_print(LIST_TYPE_MEM, domain_id,
 			     seq_printf_printer,
 			     seq,
 			     0,
@@ -675,7 +787,6 @@ static int qdf_major_alloc_show(struct seq_file *seq, void *v)
 {
 	enum qdf_debug_domain domain_id = *(enum qdf_debug_domain *)v;
 	struct major_alloc_priv *priv;
-	qdf_list_t *list;
 
 	priv = (struct major_alloc_priv *)seq->private;
 	seq_printf(seq, "\n%s Memory Domain (Id %d)\n",
@@ -683,22 +794,16 @@ static int qdf_major_alloc_show(struct seq_file *seq, void *v)
 
 	switch (priv->type) {
 	case LIST_TYPE_MEM:
-		list = qdf_mem_list_get(domain_id);
-		break;
 	case LIST_TYPE_DMA:
-		list = qdf_mem_dma_list(domain_id);
-		break;
-	default:
-		list = NULL;
-		break;
-	}
-
-	if (list)
-		qdf_mem_domain_print(list,
+		qdf_mem_domain_print(priv->type, domain_id,
 				     seq_printf_printer,
 				     seq,
 				     priv->threshold,
 				     qdf_print_major_alloc);
+		break;
+	default:
+		break;
+	}
 
 	return 0;
 }
@@ -1405,6 +1510,11 @@ bool qdf_mem_debug_config_get(void)
 }
 #endif /* DISABLE_MEM_DBG_LOAD_CONFIG */
 
+uint8_t qdf_mem_debug_sample_shift_get(void)
+{
+	return qdf_min(mem_debug_sample_shift, 16U);
+}
+
 #ifdef QCA_WIFI_MODULE_PARAMS_FROM_INI
 QDF_STATUS qdf_mem_debug_disabled_config_set(const char *str_value)
 {
@@ -1422,17 +1532,21 @@ QDF_STATUS qdf_mem_debug_disabled_config_set(const char *str_value)
  */
 static void qdf_mem_debug_init(void)
 {
-	int i;
+	int i, shard;
 
 	is_initial_mem_debug_disabled = qdf_mem_debug_config_get();
 
 	if (is_initial_mem_debug_disabled)
 		return;
 
+	qdf_mem_sample_shift = qdf_mem_debug_sample_shift_get();
+
 	/* Initializing the list with maximum size of 60000 */
-	for (i = 0; i < QDF_DEBUG_DOMAIN_COUNT; ++i)
-		qdf_list_create(&qdf_mem_domains[i], 60000);
-	qdf_spinlock_create(&qdf_mem_list_lock);
+	for (shard = 0; shard < QDF_MEM_LIST_SHARDS; shard++) {
+		for (i = 0; i < QDF_DEBUG_DOMAIN_COUNT; ++i)
+			qdf_list_create(qdf_mem_list_get(shard, i), 60000);
+		qdf_spinlock_create(&qdf_mem_list_lock[shard]);
+	}
 
 	/* dma */
 	for (i = 0; i < QDF_DEBUG_DOMAIN_COUNT; ++i)
@@ -1442,26 +1556,29 @@ static void qdf_mem_debug_init(void)
 
 static uint32_t
 qdf_mem_domain_check_for_leaks(enum qdf_debug_domain domain,
-			       qdf_list_t *mem_list)
+			       enum list_type type)
 {
+	uint32_t count;
+
 	if (is_initial_mem_debug_disabled)
 		return 0;
 
-	if (qdf_list_empty(mem_list))
+	count = qdf_mem_domain_count(type, domain);
+	if (!count)
 		return 0;
 
 	qdf_err("Memory leaks detected in %s domain!",
 		qdf_debug_domain_name(domain));
-	qdf_mem_domain_print(mem_list,
+	qdf_mem_domain_print(type, domain,
 			     qdf_err_printer,
 			     NULL,
 			     0,
 			     qdf_mem_meta_table_print);
 
-	return mem_list->count;
+	return count;
 }
 
-static void qdf_mem_domain_set_check_for_leaks(qdf_list_t *domains)
+static void qdf_mem_domain_set_check_for_leaks(enum list_type type)
 {
 	uint32_t leak_count = 0;
 	int i;
@@ -1471,7 +1588,7 @@ static void qdf_mem_domain_set_check_for_leaks(qdf_list_t *domains)
 
 	/* detect and print leaks */
 	for (i = 0; i < QDF_DEBUG_DOMAIN_COUNT; ++i)
-		leak_count += qdf_mem_domain_check_for_leaks(i, domains + i);
+		leak_count += qdf_mem_domain_check_for_leaks(i, type);
 
 	if (leak_count)
 		QDF_MEMDEBUG_PANIC("%u fatal memory leaks detected!",
@@ -1485,31 +1602,58 @@ static void qdf_mem_domain_set_check_for_leaks(qdf_list_t *domains)
  */
 static void qdf_mem_debug_exit(void)
 {
-	int i;
+	int i, shard;
 
 	if (is_initial_mem_debug_disabled)
 		return;
 
 	/* mem */
-	qdf_mem_domain_set_check_for_leaks(qdf_mem_domains);
-	for (i = 0; i < QDF_DEBUG_DOMAIN_COUNT; ++i)
-		qdf_list_destroy(qdf_mem_list_get(i));
-
-	qdf_spinlock_destroy(&qdf_mem_list_lock);
+	qdf_mem_domain_set_check_for_leaks(LIST_TYPE_MEM);
+	for (shard = 0; shard < QDF_MEM_LIST_SHARDS; shard++) {
+		for (i = 0; i < QDF_DEBUG_DOMAIN_COUNT; ++i)
+			qdf_list_destroy(qdf_mem_list_get(shard, i));
+		qdf_spinlock_destroy(&qdf_mem_list_lock[shard]);
+	}
 
 	/* dma */
-	qdf_mem_domain_set_check_for_leaks(qdf_mem_dma_domains);
+	qdf_mem_domain_set_check_for_leaks(LIST_TYPE_DMA);
 	for (i = 0; i < QDF_DEBUG_DOMAIN_COUNT; ++i)
 		qdf_list_destroy(&qdf_mem_dma_domains[i]);
 	qdf_spinlock_destroy(&qdf_mem_dma_list_lock);
 }
 
+/**
+ * qdf_mem_list_insert() - link a new allocation into its debug list shard
+ * @header: the memory header of the allocation
+ * @domain: the memory domain to account the allocation to
+ *
+ * Allocations not selected by sampling are left unlinked.
+ *
+ * Return: QDF_STATUS
+ */
+static QDF_STATUS qdf_mem_list_insert(struct qdf_mem_header *header,
+				      enum qdf_debug_domain domain)
+{
+	uint32_t shard;
+	QDF_STATUS status;
+
+	if (!qdf_mem_header_sampled(header))
+		return QDF_STATUS_SUCCESS;
+
+	shard = qdf_mem_list_shard(header);
+	qdf_spin_lock_irqsave(&qdf_mem_list_lock[shard]);
+	status = qdf_list_insert_front(qdf_mem_list_get(shard, domain),
+				       &header->node);
+	qdf_spin_unlock_irqrestore(&qdf_mem_list_lock[shard]);
+
+	return status;
+}
+
 void *qdf_mem_malloc_debug(size_t size, const char *func, uint32_t line,
 			   void *caller, uint32_t flag)
 {
 	QDF_STATUS status;
 	enum qdf_debug_domain current_domain = qdf_debug_domain_get();
-	qdf_list_t *mem_list = qdf_mem_list_get(current_domain);
 	struct qdf_mem_header *header;
 	void *ptr;
 	unsigned long start, duration;
@@ -1546,9 +1690,7 @@ void *qdf_mem_malloc_debug(size_t size, const char *func, uint32_t line,
 	qdf_mem_trailer_init(header);
 	ptr = qdf_mem_get_ptr(header);
 
-	qdf_spin_lock_irqsave(&qdf_mem_list_lock);
-	status = qdf_list_insert_front(mem_list, &header->node);
-	qdf_spin_unlock_irqrestore(&qdf_mem_list_lock);
+	status = qdf_mem_list_insert(header, current_domain);
 	if (QDF_IS_STATUS_ERROR(status))
 		qdf_err("Failed to insert memory header; status %d", status);
 
@@ -1563,7 +1705,6 @@ void *qdf_mem_malloc_atomic_debug(size_t size, const char *func,
 {
 	QDF_STATUS status;
 	enum qdf_debug_domain current_domain = qdf_debug_domain_get();
-	qdf_list_t *mem_list = qdf_mem_list_get(current_domain);
 	struct qdf_mem_header *header;
 	void *ptr;
 	unsigned long start, duration;
@@ -1597,9 +1738,7 @@ void *qdf_mem_malloc_atomic_debug(size_t size, const char *func,
 	qdf_mem_trailer_init(header);
 	ptr = qdf_mem_get_ptr(header);
 
-	qdf_spin_lock_irqsave(&qdf_mem_list_lock);
-	status = qdf_list_insert_front(mem_list, &header->node);
-	qdf_spin_unlock_irqrestore(&qdf_mem_list_lock);
+	status = qdf_mem_list_insert(header, current_domain);
 	if (QDF_IS_STATUS_ERROR(status))
 		qdf_err("Failed to insert memory header; status %d", status);
 
@@ -1644,6 +1783,8 @@ void qdf_mem_free_debug(void *ptr, const char *func, uint32_t line)
 	enum qdf_debug_domain current_domain = qdf_debug_domain_get();
 	struct qdf_mem_header *header;
 	enum qdf_mem_validation_bitmap error_bitmap;
+	uint32_t shard;
+	bool sampled;
 
 	if (is_initial_mem_debug_disabled) {
 		__qdf_mem_free(ptr);
@@ -1663,17 +1804,26 @@ void qdf_mem_free_debug(void *ptr, const char *func, uint32_t line)
 
 	qdf_talloc_assert_no_children_fl(ptr, func, line);
 
-	qdf_spin_lock_irqsave(&qdf_mem_list_lock);
 	header = qdf_mem_get_header(ptr);
+	shard = qdf_mem_list_shard(header);
+	sampled = qdf_mem_header_sampled(header);
+
+	qdf_spin_lock_irqsave(&qdf_mem_list_lock[shard]);
 	error_bitmap = qdf_mem_header_validate(header, current_domain);
 	error_bitmap |= qdf_mem_trailer_validate(header);
 
+	/* untracked allocations were never linked into a debug list */
+	if (!sampled)
+		error_bitmap &= ~QDF_MEM_BAD_NODE;
+
 	if (!error_bitmap) {
 		header->freed = true;
-		qdf_list_remove_node(qdf_mem_list_get(header->domain),
-				     &header->node);
+		if (sampled)
+			qdf_list_remove_node(qdf_mem_list_get(shard,
+							      header->domain),
+					     &header->node);
 	}
-	qdf_spin_unlock_irqrestore(&qdf_mem_list_lock);
+	qdf_spin_unlock_irqrestore(&qdf_mem_list_lock[shard]);
 
 	qdf_mem_header_assert_valid(header, current_domain, error_bitmap,
 				    func, line);
@@ -1686,15 +1836,15 @@ qdf_export_symbol(qdf_mem_free_debug);
 void qdf_mem_check_for_leaks(void)
 {
 	enum qdf_debug_domain current_domain = qdf_debug_domain_get();
-	qdf_list_t *mem_list = qdf_mem_list_get(current_domain);
-	qdf_list_t *dma_list = qdf_mem_dma_list(current_domain);
 	uint32_t leaks_count = 0;
 
 	if (is_initial_mem_debug_disabled)
 		return;
 
-	leaks_count += qdf_mem_domain_check_for_leaks(current_domain, mem_list);
-	leaks_count += qdf_mem_domain_check_for_leaks(current_domain, dma_list);
+	leaks_count += qdf_mem_domain_check_for_leaks(current_domain,
+						      LIST_TYPE_MEM);
+	leaks_count += qdf_mem_domain_check_for_leaks(current_domain,
+						      LIST_TYPE_DMA);
 
 	if (leaks_count)
 		QDF_MEMDEBUG_PANIC("%u fatal memory leaks detected!",
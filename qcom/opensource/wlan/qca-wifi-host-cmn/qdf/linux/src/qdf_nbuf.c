@@ -1050,6 +1050,8 @@ qdf_tracker_declare(qdf_nbuf_map_tracker, qdf_nbuf_map_tracker_bits,
 static void qdf_nbuf_map_tracking_init(void)
 {
 	qdf_tracker_init(&qdf_nbuf_map_tracker);
+	qdf_tracker_set_sampling(&qdf_nbuf_map_tracker,
+				 qdf_mem_debug_sample_shift_get());
 }
 
 static void qdf_nbuf_map_tracking_deinit(void)
@@ -3507,6 +3507,65 @@ static const char *qdf_trace_wlan_modname(void)
 }
 #endif
 
+int qdf_trace_msg_prefix(char *buf, int size, int pid,
+			 QDF_TRACE_LEVEL verbose, QDF_MODULE_ID category)
+{
+	static const char * const VERBOSE_STR[] = {
+		[QDF_TRACE_LEVEL_NONE] = "",
+		[QDF_TRACE_LEVEL_FATAL] = "F",
+		[QDF_TRACE_LEVEL_ERROR] = "E",
+		[QDF_TRACE_LEVEL_WARN] = "W",
+		[QDF_TRACE_LEVEL_INFO] = "I",
+		[QDF_TRACE_LEVEL_INFO_HIGH] = "IH",
+		[QDF_TRACE_LEVEL_INFO_MED] = "IM",
+		[QDF_TRACE_LEVEL_INFO_LOW] = "IL",
+		[QDF_TRACE_LEVEL_DEBUG] = "D",
+		[QDF_TRACE_LEVEL_TRACE] = "T",
+		[QDF_TRACE_LEVEL_ALL] = "" };
+
+	return scnprintf(buf, size, "%s: [%d:%s:%s] ",
+			 qdf_trace_wlan_modname(), pid, VERBOSE_STR[verbose],
+			 g_qdf_category_name[category].category_name_str);
+}
+qdf_export_symbol(qdf_trace_msg_prefix);
+
+#if defined(WLAN_LOGGING_SOCK_SVC_ENABLE) && \
+	defined(WLAN_LOGGING_BINARY_RECORDS)
+/**
+ * qdf_trace_msg_record() - hand a log line to the binary record rings
+ * @verbose: trace level of the message
+ * @category: module id of the message
+ * @str_format: format string of the message
+ * @val: arguments of the message, left untouched for the caller
+ *
+ * Return: 0 if the line was recorded, error if the caller must format it
+ */
+static int qdf_trace_msg_record(QDF_TRACE_LEVEL verbose,
+				QDF_MODULE_ID category,
+				const char *str_format, va_list val)
+{
+	va_list args;
+	int ret;
+
+	/* kernel log dumps want the text right away */
+	if (qdf_unlikely(qdf_log_dump_at_kernel_enable))
+		return -EPERM;
+
+	va_copy(args, val);
+	ret = wlan_log_record_to_user(verbose, category, str_format, args);
+	va_end(args);
+
+	return ret;
+}
+#else
+static inline int qdf_trace_msg_record(QDF_TRACE_LEVEL verbose,
+				       QDF_MODULE_ID category,
+				       const char *str_format, va_list val)
+{
+	return -ENOTSUPP;
+}
+#endif
+
 void qdf_trace_msg_cmn(unsigned int idx,
 			QDF_MODULE_ID category,
 			QDF_TRACE_LEVEL verbose,
@@ -3549,25 +3608,14 @@ void qdf_trace_msg_cmn(unsigned int idx,
 	 */
 	if (print_ctrl_obj[idx].cat_info[category].category_verbose_mask &
 	    QDF_TRACE_LEVEL_TO_MODULE_BITMASK(verbose)) {
-		static const char * const VERBOSE_STR[] = {
-			[QDF_TRACE_LEVEL_NONE] = "",
-			[QDF_TRACE_LEVEL_FATAL] = "F",
-			[QDF_TRACE_LEVEL_ERROR] = "E",
-			[QDF_TRACE_LEVEL_WARN] = "W",
-			[QDF_TRACE_LEVEL_INFO] = "I",
-			[QDF_TRACE_LEVEL_INFO_HIGH] = "IH",
-			[QDF_TRACE_LEVEL_INFO_MED] = "IM",
-			[QDF_TRACE_LEVEL_INFO_LOW] = "IL",
-			[QDF_TRACE_LEVEL_DEBUG] = "D",
-			[QDF_TRACE_LEVEL_TRACE] = "T",
-			[QDF_TRACE_LEVEL_ALL] = "" };
+		/* defer formatting to the logging thread when possible */
+		if (!qdf_trace_msg_record(verbose, category, str_format, val))
+			return;
 
 		/* print the prefix string into the string buffer... */
-		n = scnprintf(str_buffer, QDF_TRACE_BUFFER_SIZE,
-			     "%s: [%d:%s:%s] ", qdf_trace_wlan_modname(),
-			     in_interrupt() ? 0 : current->pid,
-			     VERBOSE_STR[verbose],
-			     g_qdf_category_name[category].category_name_str);
+		n = qdf_trace_msg_prefix(str_buffer, QDF_TRACE_BUFFER_SIZE,
+					 in_interrupt() ? 0 : current->pid,
+					 verbose, category);
 
 		/* print the formatted log message after the prefix string */
 		vscnprintf(str_buffer + n, QDF_TRACE_BUFFER_SIZE - n,
@@ -242,6 +242,29 @@ TRACE_EVENT(dp_ce_tasklet_sched_latency,
 	    TP_printk("ce_id=%u latency(ns)=%llu", __entry->ce_id,
 		      __entry->sched_latency)
 );
+
+TRACE_EVENT(dp_exec_ctx_migrate,
+	    TP_PROTO(uint8_t grp_id, uint8_t from_cpu, uint8_t to_cpu,
+		     uint32_t util, uint32_t pkt_rate),
+	    TP_ARGS(grp_id, from_cpu, to_cpu, util, pkt_rate),
+	    TP_STRUCT__entry(
+		__field(uint8_t, grp_id)
+		__field(uint8_t, from_cpu)
+		__field(uint8_t, to_cpu)
+		__field(uint32_t, util)
+		__field(uint32_t, pkt_rate)
+	    ),
+	    TP_fast_assign(
+		__entry->grp_id = grp_id;
+		__entry->from_cpu = from_cpu;
+		__entry->to_cpu = to_cpu;
+		__entry->util = util;
+		__entry->pkt_rate = pkt_rate;
+	    ),
+	    TP_printk("grp_id=%u cpu %u->%u util=%u pkt_rate=%u",
+		      __entry->grp_id, __entry->from_cpu, __entry->to_cpu,
+		      __entry->util, __entry->pkt_rate)
+);
 #endif /* _QDF_TRACEPOINT_DEFS_H */
 
 /* Below should be outside the protection */
@@ -35,26 +35,72 @@ struct qdf_tracker_node {
 	uint32_t line;
 };
 
+#define qdf_tracker_for_each_lock(tracker, lock) \
+	for ((lock) = (tracker)->locks; \
+	     (lock) < (tracker)->locks + QDF_TRACKER_LOCK_SHARDS; \
+	     (lock)++)
+
+static inline struct qdf_spinlock *
+qdf_tracker_bucket_lock(struct qdf_tracker *tracker,
+			struct qdf_ptr_hash_bucket *bucket)
+{
+	return &tracker->locks[(bucket - tracker->ht->buckets) &
+			       (QDF_TRACKER_LOCK_SHARDS - 1)];
+}
+
+static inline struct qdf_spinlock *
+qdf_tracker_lock(struct qdf_tracker *tracker, void *ptr)
+{
+	return qdf_tracker_bucket_lock(tracker,
+				       __qdf_ptr_hash_get_bucket(tracker->ht,
+								 (uintptr_t)ptr));
+}
+
+/*
+ * Sample on the low bits of a 32 bit hash, the buckets use the high ones,
+ * so the sampled resources still spread over all buckets and locks.
+ */
+static inline bool qdf_tracker_sampled(struct qdf_tracker *tracker, void *ptr)
+{
+	if (!tracker->sample_shift)
+		return true;
+
+	return !(__qdf_ptr_hash_key((uintptr_t)ptr, 32) &
+		 ((1 << tracker->sample_shift) - 1));
+}
+
 void qdf_tracker_init(struct qdf_tracker *tracker)
 {
-	qdf_spinlock_create(&tracker->lock);
+	struct qdf_spinlock *lock;
+
+	qdf_tracker_for_each_lock(tracker, lock)
+		qdf_spinlock_create(lock);
 	qdf_ptr_hash_init(tracker->ht);
 }
 qdf_export_symbol(qdf_tracker_init);
 
 void qdf_tracker_deinit(struct qdf_tracker *tracker)
 {
+	struct qdf_spinlock *lock;
+
 	qdf_tracker_check_for_leaks(tracker);
 
-	qdf_spin_lock_bh(&tracker->lock);
 	QDF_BUG(qdf_ptr_hash_empty(tracker->ht));
-	qdf_spin_unlock_bh(&tracker->lock);
 
 	qdf_ptr_hash_deinit(tracker->ht);
-	qdf_spinlock_destroy(&tracker->lock);
+	qdf_tracker_for_each_lock(tracker, lock)
+		qdf_spinlock_destroy(lock);
 }
 qdf_export_symbol(qdf_tracker_deinit);
 
+void qdf_tracker_set_sampling(struct qdf_tracker *tracker,
+			      uint8_t sample_shift)
+{
+	QDF_BUG(qdf_ptr_hash_empty(tracker->ht));
+	tracker->sample_shift = sample_shift;
+}
+qdf_export_symbol(qdf_tracker_set_sampling);
+
 static inline void qdf_tracker_print_break(void)
 {
 	qdf_nofl_alert("-----------------------------------------------------");
@@ -65,24 +111,30 @@ static uint32_t qdf_tracker_leaks_print(struct qdf_tracker *tracker,
 {
 	struct qdf_ptr_hash_bucket *bucket;
 	struct qdf_tracker_node *node;
+	struct qdf_spinlock *lock;
 	bool print_header = true;
 	uint32_t count = 0;
 
-	qdf_ptr_hash_for_each(tracker->ht, bucket, node, entry) {
-		if (node->domain != domain)
-			continue;
-
-		if (print_header) {
-			print_header = false;
-			qdf_nofl_alert("%s detected in %s domain!",
-				       tracker->leak_title,
-				       qdf_debug_domain_name(domain));
-			qdf_tracker_print_break();
+	__qdf_ptr_hash_for_each_bucket(tracker->ht, bucket) {
+		lock = qdf_tracker_bucket_lock(tracker, bucket);
+		qdf_spin_lock_bh(lock);
+		__qdf_ptr_hash_for_each_in_bucket(bucket, node, entry) {
+			if (node->domain != domain)
+				continue;
+
+			if (print_header) {
+				print_header = false;
+				qdf_nofl_alert("%s detected in %s domain!",
+					       tracker->leak_title,
+					       qdf_debug_domain_name(domain));
+				qdf_tracker_print_break();
+			}
+
+			count++;
+			qdf_nofl_alert("0x%lx @ %s:%u", node->entry.key,
+				       node->func, node->line);
 		}
-
-		count++;
-		qdf_nofl_alert("0x%lx @ %s:%u", node->entry.key,
-			       node->func, node->line);
+		qdf_spin_unlock_bh(lock);
 	}
 
 	if (count)
@@ -96,36 +148,28 @@ void qdf_tracker_check_for_leaks(struct qdf_tracker *tracker)
 	enum qdf_debug_domain domain = qdf_debug_domain_get();
 	uint32_t leaks;
 
-	qdf_spin_lock_bh(&tracker->lock);
 	leaks = qdf_tracker_leaks_print(tracker, domain);
 	if (leaks)
 		QDF_DEBUG_PANIC("%u fatal %s detected in %s domain!",
 				leaks, tracker->leak_title,
 				qdf_debug_domain_name(domain));
-	qdf_spin_unlock_bh(&tracker->lock);
 }
 qdf_export_symbol(qdf_tracker_check_for_leaks);
 
 QDF_STATUS qdf_tracker_track(struct qdf_tracker *tracker, void *ptr,
 			     const char *func, uint32_t line)
 {
-	struct qdf_tracker_node *node;
+	struct qdf_tracker_node *node, *tracked;
+	struct qdf_spinlock *lock;
 
 	QDF_BUG(ptr);
 	if (!ptr)
 		return QDF_STATUS_E_INVAL;
 
-	qdf_spin_lock_bh(&tracker->lock);
-	node = qdf_ptr_hash_get(tracker->ht, ptr, node, entry);
-	if (node)
-		QDF_DEBUG_PANIC("Double %s (via %s:%u); last %s from %s:%u",
-				tracker->track_title, func, line,
-				tracker->track_title, node->func, node->line);
-	qdf_spin_unlock_bh(&tracker->lock);
-
-	if (node)
-		return QDF_STATUS_E_ALREADY;
+	if (!qdf_tracker_sampled(tracker, ptr))
+		return QDF_STATUS_SUCCESS;
 
+	/* allocate up front so the lookup and insert take the lock once */
 	node = qdf_mem_malloc(sizeof(*node));
 	if (!node)
 		return QDF_STATUS_E_NOMEM;
@@ -134,9 +178,22 @@ QDF_STATUS qdf_tracker_track(struct qdf_tracker *tracker, void *ptr,
 	qdf_str_lcopy(node->func, func, QDF_TRACKER_FUNC_SIZE);
 	node->line = line;
 
-	qdf_spin_lock_bh(&tracker->lock);
-	qdf_ptr_hash_add(tracker->ht, ptr, node, entry);
-	qdf_spin_unlock_bh(&tracker->lock);
+	lock = qdf_tracker_lock(tracker, ptr);
+	qdf_spin_lock_bh(lock);
+	tracked = qdf_ptr_hash_get(tracker->ht, ptr, tracked, entry);
+	if (tracked)
+		QDF_DEBUG_PANIC("Double %s (via %s:%u); last %s from %s:%u",
+				tracker->track_title, func, line,
+				tracker->track_title, tracked->func,
+				tracked->line);
+	else
+		qdf_ptr_hash_add(tracker->ht, ptr, node, entry);
+	qdf_spin_unlock_bh(lock);
+
+	if (tracked) {
+		qdf_mem_free(node);
+		return QDF_STATUS_E_ALREADY;
+	}
 
 	return QDF_STATUS_SUCCESS;
 }
@@ -147,12 +204,17 @@ void qdf_tracker_untrack(struct qdf_tracker *tracker, void *ptr,
 {
 	enum qdf_debug_domain domain = qdf_debug_domain_get();
 	struct qdf_tracker_node *node;
+	struct qdf_spinlock *lock;
 
 	QDF_BUG(ptr);
 	if (!ptr)
 		return;
 
-	qdf_spin_lock_bh(&tracker->lock);
+	if (!qdf_tracker_sampled(tracker, ptr))
+		return;
+
+	lock = qdf_tracker_lock(tracker, ptr);
+	qdf_spin_lock_bh(lock);
 	node = qdf_ptr_hash_remove(tracker->ht, ptr, node, entry);
 	if (!node)
 		QDF_DEBUG_PANIC("Double %s (via %s:%u)",
@@ -164,7 +226,7 @@ void qdf_tracker_untrack(struct qdf_tracker *tracker, void *ptr,
 				node->func, node->line,
 				qdf_debug_domain_name(domain),
 				func, line);
-	qdf_spin_unlock_bh(&tracker->lock);
+	qdf_spin_unlock_bh(lock);
 
 	if (node)
 		qdf_mem_free(node);
@@ -176,15 +238,17 @@ bool qdf_tracker_lookup(struct qdf_tracker *tracker, void *ptr,
 			uint32_t *out_line)
 {
 	struct qdf_tracker_node *node;
+	struct qdf_spinlock *lock;
 
-	qdf_spin_lock_bh(&tracker->lock);
+	lock = qdf_tracker_lock(tracker, ptr);
+	qdf_spin_lock_bh(lock);
 	node = qdf_ptr_hash_get(tracker->ht, ptr, node, entry);
 	if (node) {
 		qdf_str_lcopy((char *)out_func, node->func,
 			      QDF_TRACKER_FUNC_SIZE);
 		*out_line = node->line;
 	}
-	qdf_spin_unlock_bh(&tracker->lock);
+	qdf_spin_unlock_bh(lock);
 
 	return !!node;
 }
@@ -26,6 +26,10 @@
 #if defined(CONFIG_LEAK_DETECTION) && defined(WLAN_TRACKER_TEST)
 #define qdf_ut_tracker_bits 4 /* 16 buckets */
 #define qdf_ut_tracker_item_count 3
+#define qdf_ut_tracker_sample_shift 2 /* track 1 in 4 */
+#define qdf_ut_tracker_sample_count 256
+#define qdf_ut_tracker_sample_min (qdf_ut_tracker_sample_count / 8)
+#define qdf_ut_tracker_sample_max (qdf_ut_tracker_sample_count * 3 / 8)
 #define qdf_ut_tracker_declare(name) \
 	qdf_tracker_declare(name, qdf_ut_tracker_bits, "unit-test leak", \
 			    "unit-test alloc", "unit-test free")
@@ -86,12 +90,84 @@ static uint32_t qdf_tracker_test_add_remove(void)
 	return 0;
 }
 
+static uint32_t qdf_tracker_test_sampling(void)
+{
+	qdf_ut_tracker_declare(tracker);
+	bool items[qdf_ut_tracker_sample_count];
+	bool sampled[qdf_ut_tracker_sample_count];
+	char func[QDF_TRACKER_FUNC_SIZE];
+	uint32_t errors = 0;
+	uint32_t count = 0;
+	QDF_STATUS status;
+	uint32_t line;
+	int i;
+
+	qdf_tracker_init(&tracker);
+	qdf_tracker_set_sampling(&tracker, qdf_ut_tracker_sample_shift);
+
+	/* a sampling tracker should accept every item ... */
+	for (i = 0; i < qdf_ut_tracker_sample_count; i++) {
+		status = qdf_tracker_track(&tracker, items + i,
+					   __func__, __LINE__);
+		QDF_BUG(QDF_IS_STATUS_SUCCESS(status));
+	}
+
+	/* ... but only keep about 1 in (1 << sample_shift) of them */
+	for (i = 0; i < qdf_ut_tracker_sample_count; i++) {
+		sampled[i] = qdf_tracker_lookup(&tracker, items + i,
+						&func, &line);
+		if (sampled[i])
+			count++;
+	}
+
+	if (count < qdf_ut_tracker_sample_min ||
+	    count > qdf_ut_tracker_sample_max) {
+		qdf_nofl_alert("tracker sampled %u of %u items, expected %u-%u",
+			       count, qdf_ut_tracker_sample_count,
+			       qdf_ut_tracker_sample_min,
+			       qdf_ut_tracker_sample_max);
+		errors++;
+	}
+
+	/*
+	 * untracking a sampled out item should be silent, even twice, and
+	 * leave the sampled items tracked
+	 */
+	for (i = 0; i < qdf_ut_tracker_sample_count; i++) {
+		if (sampled[i])
+			continue;
+
+		qdf_tracker_untrack(&tracker, items + i, __func__, __LINE__);
+		qdf_tracker_untrack(&tracker, items + i, __func__, __LINE__);
+	}
+
+	for (i = 0; i < qdf_ut_tracker_sample_count; i++) {
+		if (qdf_tracker_lookup(&tracker, items + i, &func, &line) !=
+		    sampled[i])
+			errors++;
+	}
+
+	/* untracking the sampled items should leave no leaks behind */
+	for (i = 0; i < qdf_ut_tracker_sample_count; i++) {
+		if (sampled[i])
+			qdf_tracker_untrack(&tracker, items + i,
+					    __func__, __LINE__);
+	}
+
+	qdf_tracker_check_for_leaks(&tracker);
+
+	qdf_tracker_deinit(&tracker);
+
+	return errors;
+}
+
 uint32_t qdf_tracker_unit_test(void)
 {
 	uint32_t errors = 0;
 
 	errors += qdf_tracker_test_empty();
 	errors += qdf_tracker_test_add_remove();
+	errors += qdf_tracker_test_sampling();
 
 	return errors;
 }
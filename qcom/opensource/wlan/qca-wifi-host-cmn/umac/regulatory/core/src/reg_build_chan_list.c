@@ -3345,6 +3345,8 @@ void reg_modify_sp_channels(struct regulatory_channel *chan_list)
 void reg_compute_pdev_current_chan_list(struct wlan_regulatory_pdev_priv_obj
 					*pdev_priv_obj)
 {
+	reg_bonded_chan_cache_invalidate(pdev_priv_obj);
+
 	reg_modify_6g_afc_chan_list(pdev_priv_obj);
 
 	reg_copy_6g_cur_mas_chan_list_to_cmn(pdev_priv_obj);
@@ -3405,6 +3407,8 @@ void reg_compute_pdev_current_chan_list(struct wlan_regulatory_pdev_priv_obj
 	reg_modify_sec_chan_list_for_6g_edge_chan(pdev_priv_obj);
 
 	reg_disable_enable_opclass_channels(pdev_priv_obj);
+
+	reg_bonded_chan_cache_build(pdev_priv_obj);
 }
 
 void reg_reset_reg_rules(struct reg_rule_info *reg_rules)
@@ -3681,6 +3685,7 @@ void reg_propagate_mas_chan_list_to_pdev(struct wlan_objmgr_psoc *psoc,
 	else
 		phy_id = pdev_id;
 
+	reg_bonded_chan_cache_invalidate(pdev_priv_obj);
 	reg_set_pdev_fcc_rules(psoc_priv_obj, pdev_priv_obj);
 	reg_init_pdev_mas_chan_list(
 			pdev_priv_obj,
@@ -4941,6 +4946,7 @@ static void reg_reset_chan_list_and_power_event(
 	pdev_priv_obj->is_6g_afc_power_event_received = false;
 	reg_disable_afc_mas_chan_list_channels(pdev_priv_obj);
 	reg_disable_sp_channels_in_super_chan_list(pdev_priv_obj);
+	reg_bonded_chan_cache_build(pdev_priv_obj);
 }
 
 /**
@@ -5733,6 +5739,7 @@ reg_process_afc_power_event(struct afc_regulatory_info *afc_info)
 	reg_init_6ghz_master_chan(afc_mas_chan_list, soc_reg);
 	soc_reg->mas_chan_params[phy_id].is_6g_afc_power_event_received = true;
 
+	reg_bonded_chan_cache_invalidate(pdev_priv_obj);
 	reg_init_pdev_super_chan_list(pdev_priv_obj);
 	reg_init_6ghz_master_chan(pdev_priv_obj->afc_chan_list, soc_reg);
 	/* Free the old power_info event if it was allocated */
@@ -5759,6 +5766,7 @@ reg_process_afc_power_event(struct afc_regulatory_info *afc_info)
 
 	reg_modify_6g_afc_chan_list(pdev_priv_obj);
 	reg_compute_super_chan_list(pdev_priv_obj);
+	reg_bonded_chan_cache_build(pdev_priv_obj);
 	reg_client_afc_populate_channels(psoc, pdev);
 
 	if (tx_ops->trigger_acs_for_afc &&
@@ -85,6 +85,40 @@ void reg_save_reg_rules_to_pdev(
 void reg_compute_pdev_current_chan_list(
 		struct wlan_regulatory_pdev_priv_obj *pdev_priv_obj);
 
+#ifdef CONFIG_CHAN_FREQ_API
+/**
+ * reg_bonded_chan_cache_invalidate() - Mark the bonded channel state cache
+ * stale so that bonded channel lookups walk the sub-20MHz channels
+ * @pdev_priv_obj: Pointer to regdb pdev private object.
+ *
+ * Return: None
+ */
+void reg_bonded_chan_cache_invalidate(
+		struct wlan_regulatory_pdev_priv_obj *pdev_priv_obj);
+
+/**
+ * reg_bonded_chan_cache_build() - Precompute the state of every 40/80/160MHz
+ * bonded channel for every 6G power mode from the current channel lists
+ * @pdev_priv_obj: Pointer to regdb pdev private object.
+ *
+ * Must be called whenever the current or super channel list is rebuilt.
+ *
+ * Return: None
+ */
+void reg_bonded_chan_cache_build(
+		struct wlan_regulatory_pdev_priv_obj *pdev_priv_obj);
+#else
+static inline void reg_bonded_chan_cache_invalidate(
+		struct wlan_regulatory_pdev_priv_obj *pdev_priv_obj)
+{
+}
+
+static inline void reg_bonded_chan_cache_build(
+		struct wlan_regulatory_pdev_priv_obj *pdev_priv_obj)
+{
+}
+#endif
+
 /**
  * reg_propagate_mas_chan_list_to_pdev() - Propagate master channel list to pdev
  * @psoc: Pointer to psoc object.
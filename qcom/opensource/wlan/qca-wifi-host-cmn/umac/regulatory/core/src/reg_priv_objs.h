@@ -311,6 +311,26 @@ struct wlan_regulatory_psoc_priv_obj {
 	uint32_t country_max_allowed_bw;
 };
 
+#ifdef CONFIG_CHAN_FREQ_API
+/* 40, 80 and 160 MHz bonded channel entries covered by the cache */
+#define REG_BONDED_CHAN_CACHE_MAX_ENTRIES 80
+/* REG_BEST_PWR_MODE (-1) up to REG_CLI_SUB_VLP */
+#define REG_BONDED_CHAN_CACHE_NUM_PWR_MODES (REG_INVALID_PWR_MODE + 1)
+
+/**
+ * struct reg_bonded_chan_cache - Precomputed bonded channel states
+ * @seq: odd while @state matches the current channel lists, even while it is
+ * stale or being rebuilt
+ * @state: minimum sub-20MHz channel state of each bonded channel entry,
+ * indexed by [6G power mode + 1][bonded channel entry]
+ */
+struct reg_bonded_chan_cache {
+	uint32_t seq;
+	uint8_t state[REG_BONDED_CHAN_CACHE_NUM_PWR_MODES]
+		     [REG_BONDED_CHAN_CACHE_MAX_ENTRIES];
+};
+#endif
+
 /**
  * struct wlan_regulatory_pdev_priv_obj - wlan regulatory pdev private object
  * @cur_chan_list: current channel list, includes 6G channels
@@ -395,6 +415,8 @@ struct wlan_regulatory_psoc_priv_obj {
  * from firmware
  * @indoor_list: List of current indoor station interfaces
  * @keep_6ghz_sta_cli_connection: Keep current STA/P2P client connection
+ * @bonded_chan_cache: bonded channel states rebuilt with the current channel
+ * list
  */
 struct wlan_regulatory_pdev_priv_obj {
 	struct regulatory_channel cur_chan_list[NUM_CHANNELS];
@@ -479,6 +501,9 @@ struct wlan_regulatory_pdev_priv_obj {
 	struct indoor_concurrency_list indoor_list[MAX_INDOOR_LIST_SIZE];
 	bool keep_6ghz_sta_cli_connection;
 #endif
+#ifdef CONFIG_CHAN_FREQ_API
+	struct reg_bonded_chan_cache bonded_chan_cache;
+#endif
 };
 
 /**
@@ -4642,11 +4642,52 @@ decide_power_type:
 #endif
 #endif
 
+/* Bonded channel arrays whose states are kept in the bonded channel cache */
+static const
+struct bw_bonded_array_pair reg_bonded_chan_cache_map[] = {
+	{CH_WIDTH_40MHZ, bonded_chan_40mhz_list_freq,
+		QDF_ARRAY_SIZE(bonded_chan_40mhz_list_freq)},
+	{CH_WIDTH_80MHZ, bonded_chan_80mhz_list_freq,
+		QDF_ARRAY_SIZE(bonded_chan_80mhz_list_freq)},
+	{CH_WIDTH_160MHZ, bonded_chan_160mhz_list_freq,
+		QDF_ARRAY_SIZE(bonded_chan_160mhz_list_freq)},
+};
+
+QDF_COMPILE_TIME_ASSERT(reg_bonded_chan_cache_size_check,
+			QDF_ARRAY_SIZE(bonded_chan_40mhz_list_freq) +
+			QDF_ARRAY_SIZE(bonded_chan_80mhz_list_freq) +
+			QDF_ARRAY_SIZE(bonded_chan_160mhz_list_freq) <=
+			REG_BONDED_CHAN_CACHE_MAX_ENTRIES);
+
 /**
- * reg_get_5g_bonded_chan_array_for_pwrmode()- Return the channel state for a
- * 5G or 6G channel frequency based on the bonded channel.
+ * reg_get_bonded_chan_cache_idx() - Get the bonded channel cache slot of a
+ * bonded channel entry
+ * @bonded_chan_ptr: Pointer to an entry of one of the bonded channel arrays
+ *
+ * Return: cache slot, or -1 if the entry is not kept in the cache
+ */
+static int
+reg_get_bonded_chan_cache_idx(const struct bonded_channel_freq *bonded_chan_ptr)
+{
+	const struct bw_bonded_array_pair *pair;
+	int base = 0;
+	uint8_t i;
+
+	for (i = 0; i < QDF_ARRAY_SIZE(reg_bonded_chan_cache_map); i++) {
+		pair = &reg_bonded_chan_cache_map[i];
+		if (bonded_chan_ptr >= pair->bonded_chan_arr &&
+		    bonded_chan_ptr < pair->bonded_chan_arr + pair->array_size)
+			return base + (bonded_chan_ptr - pair->bonded_chan_arr);
+		base += pair->array_size;
+	}
+
+	return -1;
+}
+
+/**
+ * reg_compute_5g_bonded_chan_array_state() - Compute the channel state of a
+ * bonded channel from the states of its sub-20MHz channels
  * @pdev: Pointer to pdev.
- * @freq: Channel center frequency.
  * @bonded_chan_ptr: Pointer to bonded_channel_freq.
  * @in_6g_pwr_type: Input 6g power mode which decides the which power mode based
  * channel list will be chosen.
@@ -4655,24 +4696,18 @@ decide_power_type:
  * Return: Channel State
  */
 static enum channel_state
-reg_get_5g_bonded_chan_array_for_pwrmode(struct wlan_objmgr_pdev *pdev,
-					 uint16_t freq,
-					 const struct bonded_channel_freq *
-					 bonded_chan_ptr,
-					 enum supported_6g_pwr_types
-					 in_6g_pwr_type,
-					 uint16_t input_punc_bitmap)
+reg_compute_5g_bonded_chan_array_state(struct wlan_objmgr_pdev *pdev,
+				       const struct bonded_channel_freq *
+				       bonded_chan_ptr,
+				       enum supported_6g_pwr_types
+				       in_6g_pwr_type,
+				       uint16_t input_punc_bitmap)
 {
 	uint16_t chan_cfreq;
 	enum channel_state chan_state = CHANNEL_STATE_INVALID;
 	enum channel_state temp_chan_state;
 	uint8_t i = 0;
 
-	if (!bonded_chan_ptr) {
-		reg_debug("bonded chan ptr is NULL");
-		return chan_state;
-	}
-
 	chan_cfreq =  bonded_chan_ptr->start_freq;
 	while (chan_cfreq <= bonded_chan_ptr->end_freq) {
 		if (!reg_is_chan_bit_punctured(input_punc_bitmap, i)) {
@@ -4690,6 +4725,211 @@ reg_get_5g_bonded_chan_array_for_pwrmode(struct wlan_objmgr_pdev *pdev,
 	return chan_state;
 }
 
+void
+reg_bonded_chan_cache_invalidate(struct wlan_regulatory_pdev_priv_obj
+				 *pdev_priv_obj)
+{
+	struct reg_bonded_chan_cache *cache = &pdev_priv_obj->bonded_chan_cache;
+
+	if (cache->seq & 1)
+		cache->seq++;
+	qdf_wmb();
+}
+
+void
+reg_bonded_chan_cache_build(struct wlan_regulatory_pdev_priv_obj
+			    *pdev_priv_obj)
+{
+	struct reg_bonded_chan_cache *cache = &pdev_priv_obj->bonded_chan_cache;
+	struct wlan_objmgr_pdev *pdev = pdev_priv_obj->pdev_ptr;
+	const struct bw_bonded_array_pair *pair;
+	const struct bonded_channel_freq *bonded_chan_ptr;
+	int pwr_mode;
+	int idx = 0;
+	uint8_t i;
+	uint16_t j;
+
+	reg_bonded_chan_cache_invalidate(pdev_priv_obj);
+
+	/*
+	 * The states are read back through the pdev, so the pdev object must
+	 * already be attached, else every entry would be cached as invalid.
+	 */
+	if (!pdev || reg_get_pdev_obj(pdev) != pdev_priv_obj)
+		return;
+
+	for (i = 0; i < QDF_ARRAY_SIZE(reg_bonded_chan_cache_map); i++) {
+		pair = &reg_bonded_chan_cache_map[i];
+		for (j = 0; j < pair->array_size; j++, idx++) {
+			bonded_chan_ptr = &pair->bonded_chan_arr[j];
+
+			/* 2G/5G states do not depend on the 6G power mode */
+			if (!REG_IS_6GHZ_FREQ(bonded_chan_ptr->start_freq)) {
+				enum channel_state state;
+
+				state = reg_compute_5g_bonded_chan_array_state(
+						pdev, bonded_chan_ptr,
+						REG_CURRENT_PWR_MODE, 0);
+				for (pwr_mode = 0;
+				     pwr_mode < REG_BONDED_CHAN_CACHE_NUM_PWR_MODES;
+				     pwr_mode++)
+					cache->state[pwr_mode][idx] = state;
+				continue;
+			}
+
+			for (pwr_mode = REG_BEST_PWR_MODE;
+			     pwr_mode < REG_INVALID_PWR_MODE; pwr_mode++)
+				cache->state[pwr_mode + 1][idx] =
+				    reg_compute_5g_bonded_chan_array_state(
+						pdev, bonded_chan_ptr,
+						pwr_mode, 0);
+		}
+	}
+
+	qdf_wmb();
+	cache->seq++;
+}
+
+/**
+ * reg_bonded_chan_cache_lookup() - Look up the state of an unpunctured bonded
+ * channel in the bonded channel cache
+ * @pdev: Pointer to pdev.
+ * @bonded_chan_ptr: Pointer to bonded_channel_freq.
+ * @in_6g_pwr_type: 6G power mode of the lookup
+ * @state: Filled with the cached state on a hit
+ *
+ * Return: true if @state was filled, false if the caller has to walk the
+ * sub-20MHz channels
+ */
+static bool
+reg_bonded_chan_cache_lookup(struct wlan_objmgr_pdev *pdev,
+			     const struct bonded_channel_freq *bonded_chan_ptr,
+			     enum supported_6g_pwr_types in_6g_pwr_type,
+			     enum channel_state *state)
+{
+	struct wlan_regulatory_pdev_priv_obj *pdev_priv_obj;
+	struct reg_bonded_chan_cache *cache;
+	uint32_t seq;
+	int idx;
+
+	if (in_6g_pwr_type < REG_BEST_PWR_MODE ||
+	    in_6g_pwr_type >= REG_INVALID_PWR_MODE)
+		return false;
+
+	idx = reg_get_bonded_chan_cache_idx(bonded_chan_ptr);
+	if (idx < 0)
+		return false;
+
+	pdev_priv_obj = reg_get_pdev_obj(pdev);
+	if (!IS_VALID_PDEV_REG_OBJ(pdev_priv_obj))
+		return false;
+
+	cache = &pdev_priv_obj->bonded_chan_cache;
+	seq = cache->seq;
+	if (!(seq & 1))
+		return false;
+
+	qdf_rmb();
+	*state = cache->state[in_6g_pwr_type + 1][idx];
+	qdf_rmb();
+
+	/* a rebuild started meanwhile, the state may be torn */
+	return cache->seq == seq;
+}
+
+/**
+ * reg_get_5g_bonded_chan_array_for_pwrmode()- Return the channel state for a
+ * 5G or 6G channel frequency based on the bonded channel.
+ * @pdev: Pointer to pdev.
+ * @freq: Channel center frequency.
+ * @bonded_chan_ptr: Pointer to bonded_channel_freq.
+ * @in_6g_pwr_type: Input 6g power mode which decides the which power mode based
+ * channel list will be chosen.
+ * @input_punc_bitmap: Input puncture bitmap
+ *
+ * Unpunctured lookups are served from the bonded channel cache while it is
+ * valid.
+ *
+ * Return: Channel State
+ */
+static enum channel_state
+reg_get_5g_bonded_chan_array_for_pwrmode(struct wlan_objmgr_pdev *pdev,
+					 uint16_t freq,
+					 const struct bonded_channel_freq *
+					 bonded_chan_ptr,
+					 enum supported_6g_pwr_types
+					 in_6g_pwr_type,
+					 uint16_t input_punc_bitmap)
+{
+	enum channel_state chan_state;
+
+	if (!bonded_chan_ptr) {
+		reg_debug("bonded chan ptr is NULL");
+		return CHANNEL_STATE_INVALID;
+	}
+
+	if (!input_punc_bitmap &&
+	    reg_bonded_chan_cache_lookup(pdev, bonded_chan_ptr,
+					 in_6g_pwr_type, &chan_state))
+		return chan_state;
+
+	return reg_compute_5g_bonded_chan_array_state(pdev, bonded_chan_ptr,
+						      in_6g_pwr_type,
+						      input_punc_bitmap);
+}
+
+#ifdef WLAN_REG_BONDED_CHAN_CACHE_TEST
+uint32_t reg_bonded_chan_cache_unit_test(struct wlan_objmgr_pdev *pdev)
+{
+	struct wlan_regulatory_pdev_priv_obj *pdev_priv_obj;
+	const struct bw_bonded_array_pair *pair;
+	const struct bonded_channel_freq *bonded_chan_ptr;
+	enum channel_state cached, uncached;
+	uint32_t errors = 0;
+	int pwr_mode;
+	uint8_t i;
+	uint16_t j;
+
+	pdev_priv_obj = reg_get_pdev_obj(pdev);
+	if (!IS_VALID_PDEV_REG_OBJ(pdev_priv_obj)) {
+		reg_err("reg pdev priv obj is NULL");
+		return 1;
+	}
+
+	if (!(pdev_priv_obj->bonded_chan_cache.seq & 1)) {
+		reg_err("bonded chan cache is not built");
+		errors++;
+	}
+
+	for (i = 0; i < QDF_ARRAY_SIZE(reg_bonded_chan_cache_map); i++) {
+		pair = &reg_bonded_chan_cache_map[i];
+		for (j = 0; j < pair->array_size; j++) {
+			bonded_chan_ptr = &pair->bonded_chan_arr[j];
+			for (pwr_mode = REG_BEST_PWR_MODE;
+			     pwr_mode < REG_INVALID_PWR_MODE; pwr_mode++) {
+				cached = reg_get_5g_bonded_chan_array_for_pwrmode(
+						pdev, bonded_chan_ptr->start_freq,
+						bonded_chan_ptr, pwr_mode, 0);
+				uncached = reg_compute_5g_bonded_chan_array_state(
+						pdev, bonded_chan_ptr,
+						pwr_mode, 0);
+				if (cached == uncached)
+					continue;
+
+				reg_err("bonded chan %u-%u width %d pwr mode %d: cached state %d, expected %d",
+					bonded_chan_ptr->start_freq,
+					bonded_chan_ptr->end_freq,
+					pair->chwidth, pwr_mode,
+					cached, uncached);
+				errors++;
+			}
+		}
+	}
+
+	return errors;
+}
+#endif
+
 #ifdef WLAN_FEATURE_11BE
 
 QDF_STATUS reg_extract_puncture_by_bw(enum phy_ch_width ori_bw,
@@ -1524,6 +1524,23 @@ uint8_t reg_get_max_tx_power_for_pwr_mode(
 bool reg_is_passive_for_freq(struct wlan_objmgr_pdev *pdev, qdf_freq_t freq);
 #endif /* CONFIG_CHAN_FREQ_API */
 
+#if defined(CONFIG_CHAN_FREQ_API) && defined(WLAN_REG_BONDED_CHAN_CACHE_TEST)
+/**
+ * reg_bonded_chan_cache_unit_test() - Check that every cached bonded channel
+ * state matches the state computed from the sub-20MHz channels
+ * @pdev: Pointer to pdev
+ *
+ * Return: number of failed checks, 0 on success
+ */
+uint32_t reg_bonded_chan_cache_unit_test(struct wlan_objmgr_pdev *pdev);
+#else
+static inline
+uint32_t reg_bonded_chan_cache_unit_test(struct wlan_objmgr_pdev *pdev)
+{
+	return 0;
+}
+#endif
+
 /**
  * reg_get_max_tx_power() - Get maximum tx power from the current channel list
  * @pdev: Pointer to pdev
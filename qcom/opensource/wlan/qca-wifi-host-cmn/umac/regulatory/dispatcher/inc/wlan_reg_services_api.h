@@ -2979,4 +2979,13 @@ wlan_reg_get_endchan_cen_from_bandstart(qdf_freq_t band_start,
 QDF_STATUS
 wlan_reg_get_opclass_from_map(const struct reg_dmn_op_class_map_t **map,
 			      bool is_global_op_table_needed);
+
+/**
+ * wlan_reg_bonded_chan_cache_unit_test() - Compare the cached bonded channel
+ * states against the states computed from the sub-20MHz channels
+ * @pdev: Pointer to pdev
+ *
+ * Return: number of failed checks, 0 on success or when the test is not built
+ */
+uint32_t wlan_reg_bonded_chan_cache_unit_test(struct wlan_objmgr_pdev *pdev);
 #endif
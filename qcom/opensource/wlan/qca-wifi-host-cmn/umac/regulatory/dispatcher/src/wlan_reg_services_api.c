@@ -2014,3 +2014,8 @@ wlan_reg_get_opclass_from_map(const struct reg_dmn_op_class_map_t **map,
 {
 	return reg_get_opclass_from_map(map, is_global_op_table_needed);
 }
+
+uint32_t wlan_reg_bonded_chan_cache_unit_test(struct wlan_objmgr_pdev *pdev)
+{
+	return reg_bonded_chan_cache_unit_test(pdev);
+}
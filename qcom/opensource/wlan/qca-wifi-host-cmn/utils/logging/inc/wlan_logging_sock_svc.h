@@ -34,6 +34,27 @@ int wlan_logging_sock_init_svc(void);
 int wlan_logging_sock_deinit_svc(void);
 int wlan_log_to_user(QDF_TRACE_LEVEL log_level, char *to_be_sent, int length);
 
+#if defined(WLAN_LOGGING_SOCK_SVC_ENABLE) && \
+	defined(WLAN_LOGGING_BINARY_RECORDS)
+/**
+ * wlan_log_record_to_user() - Record a log line for deferred formatting
+ * @log_level: trace level of the message
+ * @category: module id of the message
+ * @fmt: printf format of the message, must be a string literal
+ * @args: arguments of the message, consumed by this call
+ *
+ * Packs @fmt and @args into a record on the current CPU's ring without
+ * taking the shared logging lock. The logging thread formats the record
+ * into the same text wlan_log_to_user() would have produced and sends it
+ * to the netlink consumers.
+ *
+ * Return: 0 if the line was recorded, error if the caller has to format
+ *	   it and use wlan_log_to_user() instead
+ */
+int wlan_log_record_to_user(QDF_TRACE_LEVEL log_level, QDF_MODULE_ID category,
+			    const char *fmt, va_list args);
+#endif
+
 /**
  * wlan_logging_set_flush_timer() - Sets the time period for log flush timer
  * @milliseconds: Time period in milliseconds
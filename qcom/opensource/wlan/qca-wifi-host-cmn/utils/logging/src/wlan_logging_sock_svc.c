@@ -125,7 +125,9 @@
 #define HOST_LOG_DRIVER_CONNECTIVITY_MSG 0x004
 #define HOST_LOG_CHIPSET_STATS           0x005
 #define FW_LOG_CHIPSET_STATS             0x006
-#define WLAN_LOGGING_BITS_MAX            7
+#define HOST_LOG_DRIVER_RECORDS          0x007
+#define HOST_LOG_DRIVER_FLUSH            0x008
+#define WLAN_LOGGING_BITS_MAX            9
 
 #define DIAG_TYPE_LOGS                 1
 #define PTT_MSG_DIAG_CMDS_TYPE    0x5050
@@ -413,43 +415,24 @@ log_to_console(QDF_TRACE_LEVEL level, const char *timestamp, const char *msg)
 }
 #endif
 
-int wlan_log_to_user(QDF_TRACE_LEVEL log_level, char *to_be_sent, int length)
+/* Need to call this with spin_lock acquired and pcur_node set */
+static bool wlan_logging_append(const char *tbuf, int tlen,
+				const char *to_be_sent, int length)
 {
 	char *ptr;
-	char tbuf[60];
-	int tlen;
 	int total_log_len;
 	unsigned int *pfilled_length;
-	bool wake_up_thread = false;
-	unsigned long flags;
-	uint64_t ts;
-
-	/* Add the current time stamp */
-	ts = qdf_get_log_timestamp();
-	tlen = wlan_add_user_log_time_stamp(tbuf, sizeof(tbuf), ts);
-
-	/* if logging isn't up yet, just dump to dmesg */
-	if (!gwlan_logging.is_active) {
-		log_to_console(log_level, tbuf, to_be_sent);
-		return 0;
-	}
+	bool queued = false;
 
 	/* 1+1 indicate '\n'+'\0' */
 	total_log_len = length + tlen + 1 + 1;
 
-	spin_lock_irqsave(&gwlan_logging.spin_lock, flags);
-	/* wlan logging svc resources are not yet initialized */
-	if (!gwlan_logging.pcur_node) {
-		spin_unlock_irqrestore(&gwlan_logging.spin_lock, flags);
-		return -EIO;
-	}
-
 	pfilled_length = &gwlan_logging.pcur_node->filled_length;
 
 	/* Check if we can accommodate more log into current node/buffer */
 	if ((MAX_LOGMSG_LENGTH - (*pfilled_length +
 			sizeof(tAniNlHdr))) < total_log_len) {
-		wake_up_thread = true;
+		queued = true;
 		wlan_queue_logmsg_for_app();
 		pfilled_length = &gwlan_logging.pcur_node->filled_length;
 	}
@@ -478,6 +461,51 @@ int wlan_log_to_user(QDF_TRACE_LEVEL log_level, char *to_be_sent, int length)
 	ptr[*pfilled_length] = '\n';
 	*pfilled_length += 1;
 
+	return queued;
+}
+
+#ifdef WLAN_LOGGING_BINARY_RECORDS
+static int wlan_log_record_text(QDF_TRACE_LEVEL log_level, const char *text,
+				int length);
+#else
+static inline int wlan_log_record_text(QDF_TRACE_LEVEL log_level,
+				       const char *text, int length)
+{
+	return -ENOTSUPP;
+}
+#endif
+
+int wlan_log_to_user(QDF_TRACE_LEVEL log_level, char *to_be_sent, int length)
+{
+	char tbuf[60];
+	int tlen;
+	bool wake_up_thread;
+	unsigned long flags;
+	uint64_t ts;
+
+	/* Add the current time stamp */
+	ts = qdf_get_log_timestamp();
+	tlen = wlan_add_user_log_time_stamp(tbuf, sizeof(tbuf), ts);
+
+	/* if logging isn't up yet, just dump to dmesg */
+	if (!gwlan_logging.is_active) {
+		log_to_console(log_level, tbuf, to_be_sent);
+		return 0;
+	}
+
+	/* keep the line in time order with the pending records */
+	if (!wlan_log_record_text(log_level, to_be_sent, length))
+		goto console;
+
+	spin_lock_irqsave(&gwlan_logging.spin_lock, flags);
+	/* wlan logging svc resources are not yet initialized */
+	if (!gwlan_logging.pcur_node) {
+		spin_unlock_irqrestore(&gwlan_logging.spin_lock, flags);
+		return -EIO;
+	}
+
+	wake_up_thread = wlan_logging_append(tbuf, tlen, to_be_sent, length);
+
 	spin_unlock_irqrestore(&gwlan_logging.spin_lock, flags);
 
 	/* Wakeup logger thread */
@@ -487,12 +515,386 @@ int wlan_log_to_user(QDF_TRACE_LEVEL log_level, char *to_be_sent, int length)
 		wake_up_interruptible(&gwlan_logging.wait_queue);
 	}
 
+console:
 	if (gwlan_logging.console_log_levels & BIT(log_level))
 		log_to_console(log_level, tbuf, to_be_sent);
 
 	return 0;
 }
 
+#ifdef WLAN_LOGGING_BINARY_RECORDS
+/* Records per CPU ring, must be a power of 2 */
+#define WLAN_LOG_RECORD_RING_SIZE 128
+/* Argument space of a record in 32 bit words, as packed by vbin_printf() */
+#define WLAN_LOG_RECORD_ARGS_WORDS 48
+/* Ring occupancy at which the producer wakes up the logging thread */
+#define WLAN_LOG_RECORD_WAKE_THRESH (WLAN_LOG_RECORD_RING_SIZE / 4)
+/* Process name width used by wlan_add_user_log_time_stamp(), plus '\0' */
+#define WLAN_LOG_RECORD_COMM_LEN 7
+
+/**
+ * struct wlan_log_record - log line captured for deferred formatting
+ * @fmt: printf format of the line, NULL if @args holds the line as text
+ * @ts: qdf_get_log_timestamp() at capture
+ * @tod_us: local time of the day at capture, in microseconds
+ * @pid: pid of the producer, 0 in interrupt context
+ * @cpu: CPU the producer ran on
+ * @level: trace level of the line
+ * @category: module id of the line
+ * @comm: process name of the producer, as current_process_name()
+ * @args: arguments of the line packed by vbin_printf(), or the text of
+ *	  the line
+ */
+struct wlan_log_record {
+	const char *fmt;
+	uint64_t ts;
+	uint64_t tod_us;
+	pid_t pid;
+	uint16_t cpu;
+	uint8_t level;
+	uint8_t category;
+	char comm[WLAN_LOG_RECORD_COMM_LEN];
+	uint32_t args[WLAN_LOG_RECORD_ARGS_WORDS];
+};
+
+/**
+ * struct wlan_log_record_ring - per CPU ring of log records
+ * @head: next slot to fill, only written by the owning CPU
+ * @tail: next slot to format, only written by the logging thread
+ * @records: record slots
+ */
+struct wlan_log_record_ring {
+	unsigned int head ____cacheline_aligned;
+	unsigned int tail ____cacheline_aligned;
+	struct wlan_log_record records[WLAN_LOG_RECORD_RING_SIZE];
+};
+
+static struct wlan_log_record_ring *gwlan_log_rings;
+
+/*
+ * Formatting buffer of the consumer. Only the logging thread drains the
+ * rings, besides the panic handler which runs once the other CPUs stopped.
+ */
+static char gwlan_log_record_buf[QDF_TRACE_BUFFER_SIZE];
+
+/**
+ * wlan_log_record_add() - add a record to the current CPU's ring
+ * @log_level: trace level of the line
+ * @category: module id of the line
+ * @fmt: printf format of the line, NULL for a line that is already text
+ * @args: arguments of the line, used with @fmt
+ * @text: line that is already formatted, used without @fmt
+ * @length: length of @text
+ *
+ * Return: 0 if the line was recorded, error otherwise
+ */
+static int wlan_log_record_add(QDF_TRACE_LEVEL log_level,
+			       QDF_MODULE_ID category, const char *fmt,
+			       va_list *args, const char *text, int length)
+{
+	struct wlan_log_record_ring *rings, *ring;
+	struct wlan_log_record *rec;
+	unsigned int head, used = 0;
+	unsigned long flags;
+	int ret = 0;
+
+	/*
+	 * With interrupts off the owning CPU is the only producer of its
+	 * ring, and deinit can not free the rings underneath us.
+	 */
+	local_irq_save(flags);
+	rings = READ_ONCE(gwlan_log_rings);
+	if (!rings) {
+		ret = -EIO;
+		goto out;
+	}
+
+	ring = &rings[smp_processor_id()];
+	head = ring->head;
+	used = head - smp_load_acquire(&ring->tail);
+	if (used >= WLAN_LOG_RECORD_RING_SIZE) {
+		ret = -ENOSPC;
+		goto out;
+	}
+
+	rec = &ring->records[head & (WLAN_LOG_RECORD_RING_SIZE - 1)];
+	if (fmt) {
+		if (vbin_printf(rec->args, WLAN_LOG_RECORD_ARGS_WORDS, fmt,
+				*args) > WLAN_LOG_RECORD_ARGS_WORDS) {
+			ret = -E2BIG;
+			goto out;
+		}
+	} else {
+		if ((size_t)length >= sizeof(rec->args)) {
+			ret = -E2BIG;
+			goto out;
+		}
+		memcpy(rec->args, text, length);
+		((char *)rec->args)[length] = '\0';
+	}
+
+	rec->fmt = fmt;
+	rec->ts = qdf_get_log_timestamp();
+	rec->tod_us = qdf_get_time_of_the_day_us();
+	rec->pid = in_interrupt() ? 0 : current->pid;
+	rec->cpu = smp_processor_id();
+	rec->level = log_level;
+	rec->category = category;
+	qdf_str_lcopy(rec->comm, current_process_name(), sizeof(rec->comm));
+
+	smp_store_release(&ring->head, head + 1);
+	used++;
+out:
+	local_irq_restore(flags);
+
+	/*
+	 * Kick the thread when the ring becomes non-empty so that a few
+	 * records do not sit in it, and again at the threshold in case the
+	 * thread is still draining. A full ring falls back to text, drain it
+	 * before that piles up.
+	 */
+	if ((ret == -ENOSPC || used == 1 ||
+	     used == WLAN_LOG_RECORD_WAKE_THRESH) &&
+	    !qdf_atomic_test_and_set_bit(HOST_LOG_DRIVER_RECORDS,
+					 gwlan_logging.event_flag))
+		wake_up_interruptible(&gwlan_logging.wait_queue);
+
+	return ret;
+}
+
+int wlan_log_record_to_user(QDF_TRACE_LEVEL log_level, QDF_MODULE_ID category,
+			    const char *fmt, va_list args)
+{
+	va_list copy;
+	int ret;
+
+	if (!gwlan_logging.is_active)
+		return -EIO;
+
+	/* console levels are printed right away from the text path */
+	if (gwlan_logging.console_log_levels & BIT(log_level))
+		return -EPERM;
+
+	va_copy(copy, args);
+	ret = wlan_log_record_add(log_level, category, fmt, &copy, NULL, 0);
+	va_end(copy);
+
+	return ret;
+}
+
+/**
+ * wlan_log_record_text() - record a line that is already formatted
+ * @log_level: trace level of the line
+ * @text: the line, including the qdf_trace_msg_prefix() prefix
+ * @length: length of @text
+ *
+ * Lines that could not be recorded in binary form, or that are printed to
+ * the console too, still go through the rings when they fit in a record.
+ * That way they are merged by time stamp with the records before them.
+ *
+ * Return: 0 if the line was recorded, error if it has to be appended to
+ *	   the log buffers right away
+ */
+static int wlan_log_record_text(QDF_TRACE_LEVEL log_level, const char *text,
+				int length)
+{
+	return wlan_log_record_add(log_level, QDF_MODULE_ID_QDF, NULL, NULL,
+				   text, length);
+}
+
+/**
+ * wlan_log_record_time_stamp() - wlan_add_user_log_time_stamp() of a record
+ * @tbuf: Pointer to time stamp buffer
+ * @tbuf_sz: Time buffer size
+ * @rec: record to print the context and time stamps of
+ *
+ * Return: number of characters written in target buffer not including
+ *	   trailing '\0'
+ */
+static int wlan_log_record_time_stamp(char *tbuf, size_t tbuf_sz,
+				      struct wlan_log_record *rec)
+{
+	uint64_t secs = rec->tod_us;
+	uint32_t usecs;
+
+	usecs = do_div(secs, 1000000);
+
+	return scnprintf(tbuf, tbuf_sz, "[%.6s][0x%llx][%02u:%02u:%02u.%06u]",
+			 rec->comm, (unsigned long long)rec->ts,
+			 (uint32_t)secs / 3600, ((uint32_t)secs / 60) % 60,
+			 (uint32_t)secs % 60, usecs);
+}
+
+/**
+ * wlan_log_record_send() - format a record into the netlink log buffers
+ * @rec: record to format
+ *
+ * Return: true if a log buffer got queued for the logging thread
+ */
+static bool wlan_log_record_send(struct wlan_log_record *rec)
+{
+	char *buf = gwlan_log_record_buf;
+	char tbuf[60];
+	int tlen, len;
+	unsigned long flags;
+	bool queued = false;
+
+	tlen = wlan_log_record_time_stamp(tbuf, sizeof(tbuf), rec);
+	if (rec->fmt) {
+		len = qdf_trace_msg_prefix(buf, QDF_TRACE_BUFFER_SIZE,
+					   rec->pid, rec->level,
+					   rec->category);
+		bstr_printf(buf + len, QDF_TRACE_BUFFER_SIZE - len, rec->fmt,
+			    rec->args);
+	} else {
+		qdf_str_lcopy(buf, (char *)rec->args, QDF_TRACE_BUFFER_SIZE);
+	}
+	len = strnlen(buf, QDF_TRACE_BUFFER_SIZE);
+
+	spin_lock_irqsave(&gwlan_logging.spin_lock, flags);
+	if (gwlan_logging.pcur_node)
+		queued = wlan_logging_append(tbuf, tlen, buf, len);
+	spin_unlock_irqrestore(&gwlan_logging.spin_lock, flags);
+
+	return queued;
+}
+
+/**
+ * wlan_log_records_drain() - format all pending records in time order
+ *
+ * Records are merged across the CPU rings by capture time stamp, so the
+ * text consumers see the same ordering as with the direct text path.
+ *
+ * Return: true if a log buffer got queued for the logging thread
+ */
+static bool wlan_log_records_drain(void)
+{
+	struct wlan_log_record_ring *rings, *ring, *oldest;
+	struct wlan_log_record *rec, *oldest_rec = NULL;
+	unsigned int budget;
+	bool queued = false;
+	int cpu;
+
+	rings = READ_ONCE(gwlan_log_rings);
+	if (!rings)
+		return false;
+
+	/* bound the drain while producers keep going */
+	for (budget = nr_cpu_ids * WLAN_LOG_RECORD_RING_SIZE; budget;
+	     budget--) {
+		oldest = NULL;
+		for_each_possible_cpu(cpu) {
+			ring = &rings[cpu];
+			if (ring->tail == smp_load_acquire(&ring->head))
+				continue;
+
+			rec = &ring->records[ring->tail &
+					     (WLAN_LOG_RECORD_RING_SIZE - 1)];
+			if (!oldest || rec->ts < oldest_rec->ts) {
+				oldest = ring;
+				oldest_rec = rec;
+			}
+		}
+
+		if (!oldest)
+			break;
+
+		queued |= wlan_log_record_send(oldest_rec);
+		smp_store_release(&oldest->tail, oldest->tail + 1);
+	}
+
+	return queued;
+}
+
+/**
+ * wlan_log_records_process() - logging thread handling of the record rings
+ *
+ * Return: None
+ */
+static void wlan_log_records_process(void)
+{
+	unsigned long flags;
+	bool queued = false;
+
+	if (qdf_atomic_test_and_clear_bit(HOST_LOG_DRIVER_RECORDS,
+					  gwlan_logging.event_flag))
+		queued = wlan_log_records_drain();
+
+	if (qdf_atomic_test_and_clear_bit(HOST_LOG_DRIVER_FLUSH,
+					  gwlan_logging.event_flag)) {
+		wlan_log_records_drain();
+		spin_lock_irqsave(&gwlan_logging.spin_lock, flags);
+		wlan_queue_logmsg_for_app();
+		spin_unlock_irqrestore(&gwlan_logging.spin_lock, flags);
+		queued = true;
+	}
+
+	if (queued)
+		qdf_atomic_set_bit(HOST_LOG_DRIVER_MSG,
+				   gwlan_logging.event_flag);
+}
+
+/**
+ * wlan_log_records_flush() - hand a host log flush to the logging thread
+ *
+ * Pending records have to be formatted before the current log buffer is
+ * queued, and only the logging thread may do that.
+ *
+ * Return: true if the flush was deferred to the logging thread
+ */
+static bool wlan_log_records_flush(void)
+{
+	if (!READ_ONCE(gwlan_log_rings))
+		return false;
+
+	qdf_atomic_set_bit(HOST_LOG_DRIVER_FLUSH, gwlan_logging.event_flag);
+	wake_up_interruptible(&gwlan_logging.wait_queue);
+
+	return true;
+}
+
+static void wlan_log_records_init(void)
+{
+	struct wlan_log_record_ring *rings;
+
+	rings = qdf_mem_valloc(nr_cpu_ids * sizeof(*rings));
+	if (!rings) {
+		qdf_err("Could not allocate log record rings, text only");
+		return;
+	}
+
+	WRITE_ONCE(gwlan_log_rings, rings);
+}
+
+static void wlan_log_records_deinit(void)
+{
+	struct wlan_log_record_ring *rings = gwlan_log_rings;
+
+	if (!rings)
+		return;
+
+	WRITE_ONCE(gwlan_log_rings, NULL);
+	/* producers run with interrupts off, wait for them to finish */
+	synchronize_rcu();
+	qdf_mem_vfree(rings);
+}
+#else
+static inline bool wlan_log_records_drain(void)
+{
+	return false;
+}
+
+static inline void wlan_log_records_process(void) {}
+
+static inline bool wlan_log_records_flush(void)
+{
+	return false;
+}
+
+static inline void wlan_log_records_init(void) {}
+static inline void wlan_log_records_deinit(void) {}
+#endif /* WLAN_LOGGING_BINARY_RECORDS */
+
 /**
  * nl_srv_bcast_host_logs() - Wrapper to send bcast msgs to host logs mcast grp
  * @skb: sk buffer pointer
@@ -904,6 +1306,10 @@ static int wlan_logging_thread(void *Arg)
 						gwlan_logging.event_flag) ||
 				 qdf_atomic_test_bit(HOST_LOG_FW_FLUSH_COMPLETE,
 						gwlan_logging.event_flag) ||
+				 qdf_atomic_test_bit(HOST_LOG_DRIVER_RECORDS,
+						gwlan_logging.event_flag) ||
+				 qdf_atomic_test_bit(HOST_LOG_DRIVER_FLUSH,
+						gwlan_logging.event_flag) ||
 				 qdf_atomic_test_bit(
 					HOST_LOG_DRIVER_CONNECTIVITY_MSG,
 					gwlan_logging.event_flag) ||
@@ -914,9 +1320,17 @@ static int wlan_logging_thread(void *Arg)
 			break;
 		}
 
-		if (gwlan_logging.exit)
+		if (gwlan_logging.exit) {
+			/*
+			 * Format what is left in the rings into the log
+			 * buffers before deinit frees the rings, the same
+			 * as the text lines that are still pending there.
+			 */
+			wlan_log_records_drain();
 			break;
+		}
 
+		wlan_log_records_process();
 
 		if (qdf_atomic_test_and_clear_bit(HOST_LOG_DRIVER_MSG,
 						  gwlan_logging.event_flag)) {
@@ -982,6 +1396,7 @@ static int wlan_logging_thread(void *Arg)
 			} else {
 				gwlan_logging.is_flush_complete = true;
 				/* Flush all current host logs*/
+				wlan_log_records_drain();
 				spin_lock_irqsave(&gwlan_logging.spin_lock,
 					flags);
 				wlan_queue_logmsg_for_app();
@@ -1115,6 +1530,9 @@ static int wlan_logging_panic_handler(struct notifier_block *this,
 	struct log_msg *plog_msg;
 	unsigned long flags;
 
+	/* the logging thread is stopped along with its CPU by now */
+	wlan_log_records_drain();
+
 	spin_lock_irqsave(&gwlan_logging.spin_lock, flags);
 	/* Iterate over nodes queued for app */
 	while (!list_empty(&gwlan_logging.filled_list)) {
@@ -1282,6 +1700,8 @@ int wlan_logging_sock_init_svc(void)
 			     gwlan_logging.event_flag);
 	qdf_atomic_clear_bit(HOST_LOG_CHIPSET_STATS, gwlan_logging.event_flag);
 	qdf_atomic_clear_bit(FW_LOG_CHIPSET_STATS, gwlan_logging.event_flag);
+	qdf_atomic_clear_bit(HOST_LOG_DRIVER_RECORDS, gwlan_logging.event_flag);
+	qdf_atomic_clear_bit(HOST_LOG_DRIVER_FLUSH, gwlan_logging.event_flag);
 
 	init_completion(&gwlan_logging.shutdown_comp);
 	gwlan_logging.thread = kthread_create(wlan_logging_thread, NULL,
@@ -1302,6 +1722,8 @@ int wlan_logging_sock_init_svc(void)
 		goto err3;
 	}
 
+	wlan_log_records_init();
+
 	return 0;
 
 err3:
@@ -1355,8 +1777,11 @@ int wlan_logging_sock_deinit_svc(void)
 		      gwlan_logging.event_flag);
 	qdf_atomic_clear_bit(HOST_LOG_CHIPSET_STATS, gwlan_logging.event_flag);
 	qdf_atomic_clear_bit(FW_LOG_CHIPSET_STATS, gwlan_logging.event_flag);
+	qdf_atomic_clear_bit(HOST_LOG_DRIVER_RECORDS, gwlan_logging.event_flag);
+	qdf_atomic_clear_bit(HOST_LOG_DRIVER_FLUSH, gwlan_logging.event_flag);
 	wake_up_interruptible(&gwlan_logging.wait_queue);
 	wait_for_completion(&gwlan_logging.shutdown_comp);
+	wlan_log_records_deinit();
 
 	spin_lock_irqsave(&gwlan_logging.pkt_stats_lock, irq_flag);
 	gwlan_logging.pkt_stats_pcur_node = NULL;
@@ -1443,6 +1868,9 @@ void wlan_flush_host_logs_for_fatal(void)
 
 	if (gwlan_logging.flush_timer_period == 0)
 		qdf_info("Flush all host logs Setting HOST_LOG_POST_MAS");
+	if (wlan_log_records_flush())
+		return;
+
 	spin_lock_irqsave(&gwlan_logging.spin_lock, flags);
 	wlan_queue_logmsg_for_app();
 	spin_unlock_irqrestore(&gwlan_logging.spin_lock, flags);
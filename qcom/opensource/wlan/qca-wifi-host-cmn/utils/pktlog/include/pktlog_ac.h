@@ -60,6 +60,20 @@ extern void pktlog_disable_adapter_logging(struct hif_opaque_softc *scn);
 extern int pktlog_alloc_buf(struct hif_opaque_softc *scn);
 extern void pktlog_release_buf(struct hif_opaque_softc *scn);
 
+#ifdef PKTLOG_MMAP_RING
+/**
+ * pktlog_ring_mapped() - check if userspace maps the pktlog buffer
+ *
+ * Return: true while a mapping of the ring proc entry is alive
+ */
+bool pktlog_ring_mapped(void);
+#else
+static inline bool pktlog_ring_mapped(void)
+{
+	return false;
+}
+#endif
+
 ssize_t pktlog_read_proc_entry(char *buf, size_t nbytes, loff_t *ppos,
 		struct ath_pktlog_info *pl_info, bool *read_complete);
 
@@ -116,9 +130,9 @@ struct pktlog_dev_t {
 };
 
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(6, 6, 0))
-#define PKTLOG_SYSCTL_SIZE	10
+#define PKTLOG_SYSCTL_SIZE	12
 #else
-#define PKTLOG_SYSCTL_SIZE      14
+#define PKTLOG_SYSCTL_SIZE      16
 #endif
 
 #define PKTLOG_MAX_SEND_QUEUE_DEPTH 64
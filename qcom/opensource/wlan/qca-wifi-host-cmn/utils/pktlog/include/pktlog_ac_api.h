@@ -120,6 +120,18 @@ struct ath_pktlog_info {
 	uint32_t trigger_interval;
 	uint32_t start_time_thruput;
 	uint32_t start_time_per;
+
+	/* Bitmap of log types dropped before they are copied, by log_type */
+	uint32_t type_filter;
+#ifdef PKTLOG_MMAP_RING
+	/* Append records without overwriting unread ones, for mmap readers */
+	int ring_mode;
+	/* Ring mode offsets into log_data, kept out of the mapped pages */
+	int32_t ring_wr_offset;
+	int32_t ring_rd_offset;
+	/* Records dropped in ring mode because the ring was full */
+	uint32_t ring_overruns;
+#endif
 };
 #endif /* _PKTLOG_INFO */
 #else                           /* REMOVE_PKT_LOG */
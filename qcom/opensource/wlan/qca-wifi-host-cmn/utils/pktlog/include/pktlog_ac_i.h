@@ -60,6 +60,98 @@ char *pktlog_getbuf(struct pktlog_dev_t *pl_dev,
 		    struct ath_pktlog_info *pl_info,
 		    size_t log_size, struct ath_pktlog_hdr *pl_hdr);
 
+/**
+ * pktlog_type_filtered() - check if a log type is filtered out at the source
+ * @pl_info: pktlog info
+ * @log_type: PKTLOG_TYPE_* of the record
+ *
+ * Return: true if records of @log_type must not be logged
+ */
+static inline bool pktlog_type_filtered(struct ath_pktlog_info *pl_info,
+					uint16_t log_type)
+{
+	return log_type < 32 && (pl_info->type_filter & BIT(log_type));
+}
+
+#ifdef PKTLOG_MMAP_RING
+/**
+ * pktlog_ring_enabled() - check if records go to the mmap ring
+ * @pl_info: pktlog info
+ *
+ * Return: true if ring mode is on
+ */
+static inline bool pktlog_ring_enabled(struct ath_pktlog_info *pl_info)
+{
+	return pl_info->ring_mode;
+}
+
+/**
+ * pktlog_ring_write() - append a record to the mmap ring
+ * @pl_info: pktlog info
+ * @pl_hdr: pktlog header of the record
+ * @data: record payload of pl_hdr->size bytes
+ *
+ * Copies the record straight into the mapped pages and publishes it with
+ * the ring wr_offset. Unread records are never overwritten; when the ring
+ * is full the record is dropped and counted in the ring overruns.
+ *
+ * Return: 0 on success, -ENOBUFS if the record was dropped
+ */
+int pktlog_ring_write(struct ath_pktlog_info *pl_info,
+		      struct ath_pktlog_hdr *pl_hdr, void *data);
+
+/**
+ * pktlog_ring_reset() - empty the ring
+ * @pl_info: pktlog info
+ *
+ * Must be called with the log lock held.
+ *
+ * Return: None
+ */
+static inline void pktlog_ring_reset(struct ath_pktlog_info *pl_info)
+{
+	pl_info->ring_wr_offset = 0;
+	pl_info->ring_rd_offset = 0;
+	pl_info->ring_overruns = 0;
+}
+
+/**
+ * pktlog_ring_get_hdr() - snapshot the ring state for the reader
+ * @pl_info: pktlog info
+ * @hdr: filled with the ring offsets, sizes and overruns; data_offset
+ *	 depends on the mapping and is left to the caller
+ *
+ * Return: 0 on success, -ENOMEM if there is no pktlog buffer
+ */
+int pktlog_ring_get_hdr(struct ath_pktlog_info *pl_info,
+			struct ath_pktlog_ring_hdr *hdr);
+
+/**
+ * pktlog_ring_consume() - free the records the reader is done with
+ * @pl_info: pktlog info
+ * @rd_offset: new read offset written by the reader
+ *
+ * Return: 0 on success, -EINVAL if @rd_offset is not in the unread part
+ *	   of the ring
+ */
+int pktlog_ring_consume(struct ath_pktlog_info *pl_info, int32_t rd_offset);
+#else
+static inline bool pktlog_ring_enabled(struct ath_pktlog_info *pl_info)
+{
+	return false;
+}
+
+static inline void pktlog_ring_reset(struct ath_pktlog_info *pl_info)
+{
+}
+
+static inline int pktlog_ring_write(struct ath_pktlog_info *pl_info,
+				    struct ath_pktlog_hdr *pl_hdr, void *data)
+{
+	return -ENOTSUPP;
+}
+#endif /* PKTLOG_MMAP_RING */
+
 #ifdef PKTLOG_HAS_SPECIFIC_DATA
 /**
  * pktlog_hdr_set_specific_data() - set type specific data
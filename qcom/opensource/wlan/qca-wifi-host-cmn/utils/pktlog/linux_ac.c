@@ -32,6 +32,7 @@
 #include <linux/module.h>
 #include <linux/vmalloc.h>
 #include <linux/proc_fs.h>
+#include <linux/uaccess.h>
 #include <pktlog_ac_i.h>
 #include <pktlog_ac_fmt.h>
 #include "i_host_diag_core_log.h"
@@ -46,6 +47,15 @@
 #define pde_data(inode) PDE_DATA(inode)
 #endif
 
+#if (LINUX_VERSION_CODE < KERNEL_VERSION(6, 3, 0))
+/*
+ * Commit bc292ab00f6c ("mm: introduce vma->vm_flags wrapper functions")
+ * Made vma->vm_flags read-only outside of the wrappers
+ */
+#define vm_flags_set(vma, flags) ((vma)->vm_flags |= (flags))
+#define vm_flags_clear(vma, flags) ((vma)->vm_flags &= ~(flags))
+#endif
+
 #define PKTLOG_DEVNAME_SIZE     32
 #define MAX_WLANDEV             1
 
@@ -55,8 +65,11 @@
 #define PKTLOG_PROC_DIR         "ath_pktlog"
 #endif
 
+#define PKTLOG_RING_PROC_NAME   WLANDEV_BASENAME "_ring"
+
 /* Permissions for creating proc entries */
 #define PKTLOG_PROC_PERM        0444
+#define PKTLOG_RING_PROC_PERM   0600
 #define PKTLOG_PROCSYS_DIR_PERM 0555
 #define PKTLOG_PROCSYS_PERM     0644
 
@@ -100,6 +113,233 @@ static struct file_operations pktlog_fops = {
 };
 #endif
 
+#ifdef PKTLOG_MMAP_RING
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(5, 6, 0))
+static qdf_atomic_t pktlog_ring_mappings;
+
+bool pktlog_ring_mapped(void)
+{
+	return qdf_atomic_read(&pktlog_ring_mappings);
+}
+
+static void pktlog_ring_vm_open(struct vm_area_struct *vma)
+{
+	qdf_atomic_inc(&pktlog_ring_mappings);
+}
+
+static void pktlog_ring_vm_close(struct vm_area_struct *vma)
+{
+	qdf_atomic_dec(&pktlog_ring_mappings);
+}
+
+static const struct vm_operations_struct pktlog_ring_vm_ops = {
+	.open = pktlog_ring_vm_open,
+	.close = pktlog_ring_vm_close,
+};
+
+/*
+ * The ring is read in place, opening it neither stops logging nor
+ * consumes the buffer like the pktlog proc entry does.
+ */
+static int pktlog_ring_open(struct inode *i, struct file *f)
+{
+	PKTLOG_MOD_INC_USE_COUNT;
+
+	return 0;
+}
+
+static int pktlog_ring_release(struct inode *i, struct file *f)
+{
+	PKTLOG_MOD_DEC_USE_COUNT;
+
+	return 0;
+}
+
+/* Start of the page holding log_data, the first page that is mapped */
+#define PKTLOG_RING_MAP_START \
+	(offsetof(struct ath_pktlog_buf, log_data) & PAGE_MASK)
+
+/**
+ * pktlog_ring_read() - read the ring header
+ * @file: ring proc entry file
+ * @buf: user buffer for the struct ath_pktlog_ring_hdr
+ * @count: size of @buf
+ * @ppos: file offset, the header is read from offset 0
+ *
+ * The ring offsets are kept by the driver, readers poll them here.
+ *
+ * Return: number of bytes read, error otherwise
+ */
+static ssize_t pktlog_ring_read(struct file *file, char __user *buf,
+				size_t count, loff_t *ppos)
+{
+	struct ath_pktlog_info *pl_info = pde_data(file_inode(file));
+	struct ath_pktlog_ring_hdr hdr;
+	int ret;
+
+	if (!pl_info)
+		return -ENODEV;
+
+	ret = pktlog_ring_get_hdr(pl_info, &hdr);
+	if (ret)
+		return ret;
+
+	hdr.data_offset = offsetof(struct ath_pktlog_buf, log_data) -
+			  PKTLOG_RING_MAP_START;
+
+	return simple_read_from_buffer(buf, count, ppos, &hdr, sizeof(hdr));
+}
+
+/**
+ * pktlog_ring_write_rd() - give records back to the ring
+ * @file: ring proc entry file
+ * @buf: user buffer holding the new int32_t read offset
+ * @count: size of @buf
+ * @ppos: file offset, the read offset is written at offset 0
+ *
+ * Return: number of bytes written, error otherwise
+ */
+static ssize_t pktlog_ring_write_rd(struct file *file, const char __user *buf,
+				    size_t count, loff_t *ppos)
+{
+	struct ath_pktlog_info *pl_info = pde_data(file_inode(file));
+	int32_t rd_offset;
+	int ret;
+
+	if (!pl_info)
+		return -ENODEV;
+
+	if (*ppos || count != sizeof(rd_offset))
+		return -EINVAL;
+
+	if (copy_from_user(&rd_offset, buf, sizeof(rd_offset)))
+		return -EFAULT;
+
+	ret = pktlog_ring_consume(pl_info, rd_offset);
+	if (ret)
+		return ret;
+
+	return count;
+}
+
+/**
+ * pktlog_ring_mmap() - map the pktlog log data into userspace
+ * @file: ring proc entry file
+ * @vma: userspace mapping, starting at the page holding log_data
+ *
+ * Only the pages of the log data are mapped, and only for reading; the
+ * ring offsets stay in the driver. log_data starts at the data_offset of
+ * the ring header in the mapping.
+ *
+ * All pages are inserted up front. They hold a reference of their own,
+ * so the mapping stays valid even if the driver releases the buffer.
+ * The mapping is accounted under the log lock, which is where the buffer
+ * size change checks pktlog_ring_mapped() before releasing the buffer.
+ *
+ * Return: 0 on success, error otherwise
+ */
+static int pktlog_ring_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct ath_pktlog_info *pl_info = pde_data(file_inode(file));
+	unsigned long size = vma->vm_end - vma->vm_start;
+	struct ath_pktlog_buf *buf;
+	unsigned long map_size = 0;
+	unsigned long offset;
+	char *start;
+	int ret = 0;
+
+	if (!pl_info)
+		return -ENODEV;
+
+	if (vma->vm_pgoff)
+		return -EINVAL;
+
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+
+	PKTLOG_LOCK(pl_info);
+	buf = pl_info->buf;
+	if (buf && pktlog_ring_enabled(pl_info)) {
+		map_size = PAGE_ALIGN(offsetof(struct ath_pktlog_buf,
+					       log_data) +
+				      pl_info->buf_size) -
+			   PKTLOG_RING_MAP_START;
+		pktlog_ring_vm_open(vma);
+	}
+	PKTLOG_UNLOCK(pl_info);
+
+	if (!buf)
+		return -ENOMEM;
+
+	/* outside ring mode the offsets in the buffer are the legacy ones */
+	if (!map_size)
+		return -EPERM;
+
+	if (size > map_size) {
+		ret = -EINVAL;
+		goto fail;
+	}
+
+	vm_flags_set(vma, VM_DONTEXPAND | VM_DONTDUMP);
+	vm_flags_clear(vma, VM_MAYWRITE);
+	start = (char *)buf + PKTLOG_RING_MAP_START;
+	for (offset = 0; offset < size; offset += PAGE_SIZE) {
+		ret = vm_insert_page(vma, vma->vm_start + offset,
+				     vmalloc_to_page(start + offset));
+		if (ret)
+			goto fail;
+	}
+
+	vma->vm_ops = &pktlog_ring_vm_ops;
+
+	return 0;
+
+fail:
+	pktlog_ring_vm_close(vma);
+
+	return ret;
+}
+
+static const struct proc_ops pktlog_ring_fops = {
+	.proc_open = pktlog_ring_open,
+	.proc_release = pktlog_ring_release,
+	.proc_read = pktlog_ring_read,
+	.proc_write = pktlog_ring_write_rd,
+	.proc_mmap = pktlog_ring_mmap,
+};
+
+static void pktlog_ring_proc_create(struct ath_pktlog_info *pl_info)
+{
+	if (!proc_create_data(PKTLOG_RING_PROC_NAME, PKTLOG_RING_PROC_PERM,
+			      g_pktlog_pde, &pktlog_ring_fops, pl_info))
+		qdf_info(PKTLOG_TAG "create_proc_entry failed for %s",
+			 PKTLOG_RING_PROC_NAME);
+}
+
+static void pktlog_ring_proc_remove(void)
+{
+	remove_proc_entry(PKTLOG_RING_PROC_NAME, g_pktlog_pde);
+}
+#else
+bool pktlog_ring_mapped(void)
+{
+	return false;
+}
+
+static inline void pktlog_ring_proc_create(struct ath_pktlog_info *pl_info)
+{
+}
+
+static inline void pktlog_ring_proc_remove(void) {}
+#endif
+#else
+static inline void pktlog_ring_proc_create(struct ath_pktlog_info *pl_info)
+{
+}
+
+static inline void pktlog_ring_proc_remove(void) {}
+#endif /* PKTLOG_MMAP_RING */
+
 void pktlog_disable_adapter_logging(struct hif_opaque_softc *scn)
 {
 	struct pktlog_dev_t *pl_dev = get_pktlog_handle();
@@ -394,7 +634,21 @@ static int pktlog_sysctl_register(struct hif_opaque_softc *scn)
 	pl_info_lnx->sysctls[8].data = &pl_info_lnx->info.trigger_interval;
 	pl_info_lnx->sysctls[8].maxlen =
 		sizeof(pl_info_lnx->info.trigger_interval);
-	/* [9] is NULL terminator */
+
+	pl_info_lnx->sysctls[9].procname = "type_filter";
+	pl_info_lnx->sysctls[9].mode = PKTLOG_PROCSYS_PERM;
+	pl_info_lnx->sysctls[9].proc_handler = proc_dointvec;
+	pl_info_lnx->sysctls[9].data = &pl_info_lnx->info.type_filter;
+	pl_info_lnx->sysctls[9].maxlen = sizeof(pl_info_lnx->info.type_filter);
+#ifdef PKTLOG_MMAP_RING
+
+	pl_info_lnx->sysctls[10].procname = "ring_mode";
+	pl_info_lnx->sysctls[10].mode = PKTLOG_PROCSYS_PERM;
+	pl_info_lnx->sysctls[10].proc_handler = proc_dointvec;
+	pl_info_lnx->sysctls[10].data = &pl_info_lnx->info.ring_mode;
+	pl_info_lnx->sysctls[10].maxlen = sizeof(pl_info_lnx->info.ring_mode);
+#endif
+	/* [11] is NULL terminator */
 
 	/* and register everything */
 	/* register_sysctl_table changed from 2.6.21 onwards */
@@ -495,7 +749,21 @@ static int pktlog_sysctl_register(struct hif_opaque_softc *scn)
 	pl_info_lnx->sysctls[12].data = &pl_info_lnx->info.trigger_interval;
 	pl_info_lnx->sysctls[12].maxlen =
 		sizeof(pl_info_lnx->info.trigger_interval);
-	/* [13] is NULL terminator */
+
+	pl_info_lnx->sysctls[13].procname = "type_filter";
+	pl_info_lnx->sysctls[13].mode = PKTLOG_PROCSYS_PERM;
+	pl_info_lnx->sysctls[13].proc_handler = proc_dointvec;
+	pl_info_lnx->sysctls[13].data = &pl_info_lnx->info.type_filter;
+	pl_info_lnx->sysctls[13].maxlen = sizeof(pl_info_lnx->info.type_filter);
+#ifdef PKTLOG_MMAP_RING
+
+	pl_info_lnx->sysctls[14].procname = "ring_mode";
+	pl_info_lnx->sysctls[14].mode = PKTLOG_PROCSYS_PERM;
+	pl_info_lnx->sysctls[14].proc_handler = proc_dointvec;
+	pl_info_lnx->sysctls[14].data = &pl_info_lnx->info.ring_mode;
+	pl_info_lnx->sysctls[14].maxlen = sizeof(pl_info_lnx->info.ring_mode);
+#endif
+	/* [15] is NULL terminator */
 
 	/* and register everything */
 	/* register_sysctl_table changed from 2.6.21 onwards */
@@ -569,6 +837,7 @@ static int pktlog_attach(struct hif_opaque_softc *scn)
 	}
 
 	pl_info_lnx->proc_entry = proc_entry;
+	pktlog_ring_proc_create(&pl_info_lnx->info);
 
 	if (pktlog_sysctl_register(scn)) {
 		qdf_nofl_info(PKTLOG_TAG "sysctl register failed for %s",
@@ -579,6 +848,7 @@ static int pktlog_attach(struct hif_opaque_softc *scn)
 	return 0;
 
 attach_fail2:
+	pktlog_ring_proc_remove();
 	remove_proc_entry(proc_name, g_pktlog_pde);
 
 attach_fail1:
@@ -626,6 +896,7 @@ static void pktlog_detach(struct hif_opaque_softc *scn)
 		return;
 	}
 	mutex_lock(&pl_info->pktlog_mutex);
+	pktlog_ring_proc_remove();
 	remove_proc_entry(WLANDEV_BASENAME, g_pktlog_pde);
 	pktlog_sysctl_unregister(pl_dev);
 
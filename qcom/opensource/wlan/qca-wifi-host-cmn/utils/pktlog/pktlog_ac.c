@@ -712,6 +712,7 @@ int __pktlog_enable(struct hif_opaque_softc *scn, int32_t log_state,
 		pl_info->buf->bytes_written = 0;
 		pl_info->buf->msg_index = 1;
 		pl_info->buf->offset = PKTLOG_READ_OFFSET;
+		pktlog_ring_reset(pl_info);
 		qdf_spin_unlock_bh(&pl_info->log_lock);
 
 		pl_info->start_time_thruput = os_get_timestamp();
@@ -847,6 +848,13 @@ static int __pktlog_setsize(struct hif_opaque_softc *scn, int32_t size)
 	}
 
 	qdf_spin_lock_bh(&pl_info->log_lock);
+	if (pktlog_ring_mapped()) {
+		pl_info->curr_pkt_state = PKTLOG_OPR_NOT_IN_PROGRESS;
+		qdf_spin_unlock_bh(&pl_info->log_lock);
+		qdf_print("Pktlog ring is mapped, cannot change buffer size");
+		return -EBUSY;
+	}
+
 	if (pl_info->buf) {
 		if (pl_dev->is_pktlog_cb_subscribed &&
 			wdi_pktlog_unsubscribe(pdev_id, pl_info->log_state)) {
@@ -196,4 +196,168 @@ char *pktlog_getbuf(struct pktlog_dev_t *pl_dev,
 
 	return plarg.buf;
 }
+
+#ifdef PKTLOG_MMAP_RING
+/**
+ * pktlog_ring_used() - bytes between the read and the write offset
+ * @rd_offset: ring read offset
+ * @wr_offset: ring write offset
+ * @buf_size: size of the log data area
+ *
+ * Return: number of bytes taken by unread records
+ */
+static inline int32_t pktlog_ring_used(int32_t rd_offset, int32_t wr_offset,
+				       int32_t buf_size)
+{
+	if (wr_offset >= rd_offset)
+		return wr_offset - rd_offset;
+
+	return buf_size - rd_offset + wr_offset;
+}
+
+/**
+ * pktlog_ring_reserve() - find room for a record in front of the reader
+ * @pl_info: pktlog info
+ * @log_size: payload size of the record
+ * @data_offset: out, offset of the record payload
+ *
+ * Places the record the way pktlog_getbuf_intsafe() does, so readers can
+ * step over it with PKTLOG_MOV_RD_IDX(): the header goes at wr_offset and
+ * the payload follows it, or starts over at the beginning of the ring when
+ * it does not fit at the end.
+ *
+ * The offsets live in @pl_info, not in the mapped buffer, but are still
+ * checked against the buffer size before anything is written.
+ *
+ * Return: wr_offset after the record, or -ENOBUFS if the ring is full
+ */
+static int32_t pktlog_ring_reserve(struct ath_pktlog_info *pl_info,
+				   size_t log_size, int32_t *data_offset)
+{
+	int32_t buf_size = pl_info->buf_size;
+	int32_t wr_offset = pl_info->ring_wr_offset;
+	int32_t rd_offset = pl_info->ring_rd_offset;
+	int32_t hdr_size = sizeof(struct ath_pktlog_hdr);
+	int32_t offset, used, avail;
+
+	if (wr_offset < 0 || wr_offset > buf_size - hdr_size ||
+	    rd_offset < 0 || rd_offset >= buf_size) {
+		pktlog_ring_reset(pl_info);
+		wr_offset = 0;
+		rd_offset = 0;
+	}
+
+	if (log_size > buf_size - hdr_size)
+		return -ENOBUFS;
+
+	avail = buf_size - pktlog_ring_used(rd_offset, wr_offset, buf_size);
+
+	offset = wr_offset + hdr_size;
+	if (buf_size - offset < log_size) {
+		used = buf_size - wr_offset + log_size;
+		offset = 0;
+	} else {
+		used = hdr_size + log_size;
+	}
+	*data_offset = offset;
+
+	offset += log_size;
+	if (buf_size - offset < hdr_size) {
+		used += buf_size - offset;
+		offset = 0;
+	}
+
+	/* the ring must not look empty once the record is in */
+	if (used >= avail)
+		return -ENOBUFS;
+
+	return offset;
+}
+
+int pktlog_ring_write(struct ath_pktlog_info *pl_info,
+		      struct ath_pktlog_hdr *pl_hdr, void *data)
+{
+	struct ath_pktlog_buf *log_buf;
+	int32_t wr_offset, data_offset;
+	int ret = 0;
+
+	PKTLOG_LOCK(pl_info);
+	log_buf = pl_info->buf;
+	if (!log_buf) {
+		ret = -EINVAL;
+		goto unlock;
+	}
+
+	wr_offset = pktlog_ring_reserve(pl_info, pl_hdr->size, &data_offset);
+	if (wr_offset < 0) {
+		pl_info->ring_overruns++;
+		ret = wr_offset;
+		goto unlock;
+	}
+
+	qdf_mem_copy(log_buf->log_data + pl_info->ring_wr_offset, pl_hdr,
+		     sizeof(*pl_hdr));
+	qdf_mem_copy(log_buf->log_data + data_offset, data, pl_hdr->size);
+
+	/* readers snapshot wr_offset under the log lock, after the copy */
+	pl_info->ring_wr_offset = wr_offset;
+
+unlock:
+	PKTLOG_UNLOCK(pl_info);
+
+	return ret;
+}
+
+int pktlog_ring_get_hdr(struct ath_pktlog_info *pl_info,
+			struct ath_pktlog_ring_hdr *hdr)
+{
+	int ret = 0;
+
+	qdf_mem_zero(hdr, sizeof(*hdr));
+	hdr->version = PKTLOG_RING_VERSION;
+	hdr->hdr_size = sizeof(*hdr);
+
+	PKTLOG_LOCK(pl_info);
+	if (!pl_info->buf) {
+		ret = -ENOMEM;
+		goto unlock;
+	}
+
+	hdr->data_size = pl_info->buf_size;
+	hdr->wr_offset = pl_info->ring_wr_offset;
+	hdr->rd_offset = pl_info->ring_rd_offset;
+	hdr->overruns = pl_info->ring_overruns;
+
+unlock:
+	PKTLOG_UNLOCK(pl_info);
+
+	return ret;
+}
+
+int pktlog_ring_consume(struct ath_pktlog_info *pl_info, int32_t rd_offset)
+{
+	int32_t buf_size, cur_rd, wr_offset;
+	int ret = 0;
+
+	PKTLOG_LOCK(pl_info);
+	buf_size = pl_info->buf_size;
+	cur_rd = pl_info->ring_rd_offset;
+	wr_offset = pl_info->ring_wr_offset;
+
+	/* the reader may only give back what was published to it */
+	if (!pl_info->buf || rd_offset < 0 || rd_offset >= buf_size ||
+	    pktlog_ring_used(cur_rd, rd_offset, buf_size) >
+	    pktlog_ring_used(cur_rd, wr_offset, buf_size)) {
+		ret = -EINVAL;
+		goto unlock;
+	}
+
+	pl_info->ring_rd_offset = rd_offset;
+
+unlock:
+	PKTLOG_UNLOCK(pl_info);
+
+	return ret;
+}
+#endif /* PKTLOG_MMAP_RING */
 #endif /*REMOVE_PKT_LOG */
@@ -68,6 +68,16 @@ process_offload_pktlog_wifi3(struct cdp_pdev *pdev, void *data)
 	 *  TX_CTL, TX_STATUS, TX_MSDU_ID, TX_FRM_HDR
 	 */
 	pl_info = pl_dev->pl_info;
+	if (pktlog_type_filtered(pl_info, pl_hdr.log_type))
+		return A_OK;
+
+	/* ring overruns are accounted in the ring itself */
+	if (pktlog_ring_enabled(pl_info)) {
+		pktlog_ring_write(pl_info, &pl_hdr,
+				  (void *)data + sizeof(struct ath_pktlog_hdr));
+		return A_OK;
+	}
+
 	log_size = pl_hdr.size;
 	txdesc_hdr_ctl =
 		(void *)pktlog_getbuf(pl_dev, pl_info, log_size, &pl_hdr);
@@ -101,12 +111,21 @@ int process_rx_desc_remote_wifi3(void *pdev, void *data)
 	}
 
 	pl_info = pl_dev->pl_info;
+	if (pktlog_type_filtered(pl_info, PKTLOG_TYPE_RX_STATBUF))
+		return 0;
+
 	qdf_mem_zero(&pl_hdr, sizeof(pl_hdr));
 	pl_hdr.flags = (1 << PKTLOG_FLG_FRM_TYPE_REMOTE_S);
 	pl_hdr.missed_cnt = 0;
 	pl_hdr.log_type = PKTLOG_TYPE_RX_STATBUF;
 	pl_hdr.size = qdf_nbuf_len(log_nbuf);
 	pl_hdr.timestamp = 0;
+
+	if (pktlog_ring_enabled(pl_info)) {
+		pktlog_ring_write(pl_info, &pl_hdr, qdf_nbuf_data(log_nbuf));
+		return 0;
+	}
+
 	log_size = pl_hdr.size;
 	rxstat_log.rx_desc = (void *)pktlog_getbuf(pl_dev, pl_info,
 						  log_size, &pl_hdr);
@@ -140,12 +159,21 @@ process_pktlog_lite_wifi3(void *context, void *log_data,
 	}
 
 	pl_info = pl_dev->pl_info;
+	if (pktlog_type_filtered(pl_info, log_type))
+		return 0;
+
 	qdf_mem_zero(&pl_hdr, sizeof(pl_hdr));
 	pl_hdr.flags = (1 << PKTLOG_FLG_FRM_TYPE_REMOTE_S);
 	pl_hdr.missed_cnt = 0;
 	pl_hdr.log_type = log_type;
 	pl_hdr.size = qdf_nbuf_len(log_nbuf);
 	pl_hdr.timestamp = 0;
+
+	if (pktlog_ring_enabled(pl_info)) {
+		pktlog_ring_write(pl_info, &pl_hdr, qdf_nbuf_data(log_nbuf));
+		return 0;
+	}
+
 	log_size = pl_hdr.size;
 	rxstat_log.rx_desc = (void *)pktlog_getbuf(pl_dev, pl_info,
 						   log_size, &pl_hdr);
@@ -1043,4 +1043,26 @@ static inline bool wlan_dp_link_check_cdp_vdev(struct wlan_dp_link *dp_link,
 
 	return false;
 }
+
+/**
+ * dp_get_tx_link() - get the link to transmit an MSDU on
+ * @dp_intf: DP interface
+ * @nbuf: MSDU to transmit
+ *
+ * Return: TX link, the default link unless the MLO TX link scheduler
+ *	   steers the flow of @nbuf to a partner link
+ */
+#ifdef WLAN_DP_MLO_LINK_SCHED
+static inline struct wlan_dp_link *
+dp_get_tx_link(struct wlan_dp_intf *dp_intf, qdf_nbuf_t nbuf)
+{
+	return dp_link_sched_select(dp_intf, nbuf);
+}
+#else
+static inline struct wlan_dp_link *
+dp_get_tx_link(struct wlan_dp_intf *dp_intf, qdf_nbuf_t nbuf)
+{
+	return dp_intf->def_link;
+}
+#endif
 #endif
@@ -35,6 +35,7 @@
 #include <cds_api.h>
 #include "pld_common.h"
 #include "wlan_dp_nud_tracking.h"
+#include "wlan_dp_link_sched.h"
 #include <i_qdf_net_stats.h>
 #include <qdf_types.h>
 #include "htc_api.h"
@@ -360,12 +361,15 @@ struct dp_fisa_reo_mismatch_stats {
  * @reo_mismatch: REO ID mismatch
  * @incorrect_rdi: Incorrect REO dest indication in TLV
  *		   (typically used for RDI = 0)
+ * @flows_aggr_steady: Num flows which reached steady state aggregation,
+ *		       see FISA_AGGR_STEADY_SEGS
  */
 struct dp_fisa_stats {
 	uint32_t invalid_flow_index;
 	uint32_t update_deferred;
 	struct dp_fisa_reo_mismatch_stats reo_mismatch;
 	uint32_t incorrect_rdi;
+	uint32_t flows_aggr_steady;
 };
 
 /**
@@ -438,6 +442,7 @@ struct fisa_pkt_hist {
  * @pkt_hist: FISA aggreagtion packets history
  * @same_mld_vdev_mismatch: Packets flushed after vdev_mismatch on same MLD
  * @add_timestamp: FISA entry created timestamp
+ * @aggr_steady: Flow aggregated FISA_AGGR_STEADY_SEGS consecutive MSDUs
  */
 struct dp_fisa_rx_sw_ft {
 	void *hw_fse;
@@ -488,6 +493,7 @@ struct dp_fisa_rx_sw_ft {
 #endif
 	uint64_t same_mld_vdev_mismatch;
 	uint64_t add_timestamp;
+	uint8_t aggr_steady;
 };
 
 #define DP_RX_GET_SW_FT_ENTRY_SIZE sizeof(struct dp_fisa_rx_sw_ft)
@@ -527,6 +533,8 @@ struct fse_cache_flush_history {
  * @fst_update_work: FST CMEM update work
  * @fst_update_wq: FST CMEM update workqueue
  * @fst_update_list: List to post event to CMEM update work
+ * @fst_update_pending: Bitmap of FT slots with an update queued to the
+ *			CMEM update work
  * @meta_counter:
  * @cmem_ba:
  * @dp_rx_sw_ft_lock: SW FST lock
@@ -563,6 +571,7 @@ struct dp_rx_fst {
 	qdf_work_t fst_update_work;
 	qdf_workqueue_t *fst_update_wq;
 	qdf_list_t fst_update_list;
+	unsigned long *fst_update_pending;
 	uint32_t meta_counter;
 	uint32_t cmem_ba;
 	qdf_spinlock_t dp_rx_sw_ft_lock[MAX_REO_DEST_RINGS];
@@ -628,6 +637,7 @@ struct dp_rx_fst {
  * @def_link: Pointer to default link (usually used for TX operation)
  * @dp_link_list_lock: Lock to protect dp_link_list operatiosn
  * @dp_link_list: List of dp_links for this DP interface
+ * @link_sched: MLO TX link scheduler
  */
 struct wlan_dp_intf {
 	struct wlan_dp_psoc_context *dp_ctx;
@@ -696,6 +706,9 @@ struct wlan_dp_intf {
 	struct wlan_dp_link *def_link;
 	qdf_spinlock_t dp_link_list_lock;
 	qdf_list_t dp_link_list;
+#ifdef WLAN_DP_MLO_LINK_SCHED
+	struct dp_link_sched link_sched;
+#endif
 };
 
 #define WLAN_DP_LINK_MAGIC 0x5F44505F4C494E4B	/* "_DP_LINK" in ASCII */
@@ -37,6 +37,25 @@
 /* Number of DP RX threads supported */
 #define DP_MAX_RX_THREADS WLAN_CFG_NUM_REO_DEST_RING
 
+#ifdef WLAN_DP_RX_THREAD_WORK_STEAL
+/*
+ * Work stealing moves RX traffic between threads in units of (REO ring,
+ * flow bucket), the bucket being taken from the toeplitz flow hash saved
+ * in the nbuf cb. A flow is always received on one REO ring with one hash,
+ * so keeping every nbuf_list of a unit in one thread queue keeps flows in
+ * order, while the flows of a ring can still be moved one bucket at a time.
+ */
+#define DP_RX_TM_STEAL_FLOW_BUCKETS 16
+#define DP_RX_TM_STEAL_KEYS \
+	(DP_RX_TM_MAX_REO_RINGS * DP_RX_TM_STEAL_FLOW_BUCKETS)
+/* No steal unit is being delivered by the thread */
+#define DP_RX_TM_STEAL_KEY_NONE DP_RX_TM_STEAL_KEYS
+/* Thread is in the middle of a steal, none of its units may be taken */
+#define DP_RX_TM_STEAL_KEY_ANY (DP_RX_TM_STEAL_KEYS + 1)
+/* Minimum victim backlog (nbuf_lists) for an idle thread to steal from it */
+#define DP_RX_TM_STEAL_MIN_QLEN 8
+#endif
+
 /*
  * struct dp_rx_tm_handle_cmn - Opaque handle for rx_threads to store
  * rx_tm_handle. This handle will be common for all the threads.
@@ -63,6 +82,10 @@ struct dp_rx_tm_handle_cmn;
  * @dropped_others: packets dropped due to other reasons
  * @dropped_enq_fail: packets dropped due to pending queue full
  * @rx_nbufq_loop_yield: rx loop yield counter
+ * @steal_attempts: number of times the thread tried to steal work
+ * @steal_success: number of steals that moved at least one nbuf_list
+ * @nbuf_stolen: packets stolen from other threads
+ * @nbuf_stolen_from: packets stolen from this thread by other threads
  */
 struct dp_rx_thread_stats {
 	unsigned int nbuf_queued[DP_RX_TM_MAX_REO_RINGS];
@@ -79,6 +102,10 @@ struct dp_rx_thread_stats {
 	unsigned int dropped_others;
 	unsigned int dropped_enq_fail;
 	unsigned int rx_nbufq_loop_yield;
+	unsigned int steal_attempts;
+	unsigned int steal_success;
+	unsigned int nbuf_stolen;
+	unsigned int nbuf_stolen_from;
 };
 
 /**
@@ -117,6 +144,16 @@ enum dp_rx_refill_thread_state {
  * @napi: napi to deliver packet to stack via GRO
  * @wait_q: wait queue to conditionally wait on events for DP Rx thread
  * @netdev: dummy netdev to initialize the napi structure with
+ * @steal_list: nbuf_lists stolen from another thread, delivered ahead of
+ *		@nbuf_queue. Only accessed by the thread itself.
+ * @steal_qlen: number of nbuf_lists in @steal_list
+ * @steal_flush_vdevs: vdevs whose nbuf_lists the thread has to drop from
+ *		       @steal_list before signaling @vdev_del_event
+ * @steal_inflight_key: steal unit of the nbuf_list being delivered
+ * @steal_flush_gen: number of GRO flushes done by the thread, starts at 1
+ * @steal_key_gen: @steal_flush_gen at the last delivery of each steal unit.
+ *		   A unit can only be stolen once the thread has flushed GRO
+ *		   after delivering it, so no segment of it is held in @napi.
  */
 struct dp_rx_thread {
 	uint8_t id;
@@ -135,6 +172,14 @@ struct dp_rx_thread {
 	qdf_napi_struct napi;
 	qdf_wait_queue_head_t wait_q;
 	qdf_dummy_netdev_t netdev;
+#ifdef WLAN_DP_RX_THREAD_WORK_STEAL
+	qdf_nbuf_t steal_list;
+	qdf_atomic_t steal_qlen;
+	qdf_bitmap(steal_flush_vdevs, WLAN_UMAC_PSOC_MAX_VDEVS);
+	qdf_atomic_t steal_inflight_key;
+	qdf_atomic_t steal_flush_gen;
+	uint32_t steal_key_gen[DP_RX_TM_STEAL_KEYS];
+#endif
 };
 
 /**
@@ -185,6 +230,8 @@ enum dp_rx_thread_state {
  * @state: state of the rx_threads. All of them should be in the same state.
  * @rx_thread: array of pointers of type struct dp_rx_thread
  * @allow_dropping: flag to indicate frame dropping is enabled
+ * @steal_owner: id of the thread currently owning each steal unit. Only
+ *		 updated with the nbuf_queue lock of the current owner held.
  */
 struct dp_rx_tm_handle {
 	uint8_t num_dp_rx_threads;
@@ -192,6 +239,9 @@ struct dp_rx_tm_handle {
 	enum dp_rx_thread_state state;
 	struct dp_rx_thread **rx_thread;
 	qdf_atomic_t allow_dropping;
+#ifdef WLAN_DP_RX_THREAD_WORK_STEAL
+	uint8_t steal_owner[DP_RX_TM_STEAL_KEYS];
+#endif
 };
 
 /**
@@ -1640,6 +1640,9 @@ static void dp_pld_request_bus_bandwidth(struct wlan_dp_psoc_context *dp_ctx,
 							 true, 0, 0);
 	}
 
+	/* NAPI load placement needs a sample on every period, not on votes */
+	dp_ops->dp_napi_load_sample(ctx);
+
 	qdf_dp_trace_apply_tput_policy(dptrace_high_tput_req);
 
 	rx_level_change = dp_bus_bandwidth_work_tune_rx(dp_ctx,
@@ -896,9 +896,7 @@ static void dp_fisa_rx_fst_update(struct dp_rx_fst *fisa_hdl,
 
 		if (qdf_log_timestamp_to_usecs(sw_timestamp - sw_ft_entry->add_timestamp) >
 			FISA_FT_ENTRY_AGING_US) {
-			qdf_spin_unlock_bh(&fisa_hdl->dp_rx_fst_lock);
 			dp_fisa_rx_delete_flow(fisa_hdl, elem, lru_ft_entry_idx);
-			qdf_spin_lock_bh(&fisa_hdl->dp_rx_fst_lock);
 			is_fst_updated = true;
 		} else
 			dp_fisa_debug("skip update due to aging not complete");
@@ -930,6 +928,7 @@ void dp_fisa_rx_fst_update_work(void *arg)
 	struct dp_fisa_rx_fst_update_elem *elem;
 	struct dp_rx_fst *fisa_hdl = arg;
 	qdf_list_node_t *node;
+	qdf_list_t update_list;
 	hal_soc_handle_t hal_soc_hdl = fisa_hdl->dp_ctx->hal_soc;
 	struct dp_vdev *vdev;
 
@@ -945,8 +944,17 @@ void dp_fisa_rx_fst_update_work(void *arg)
 		return;
 	}
 
+	/*
+	 * Detach the whole batch of pending updates in one go, so that the
+	 * RX contexts queueing new flows never wait behind the FSE/CMEM
+	 * programming done below.
+	 */
+	qdf_list_create(&update_list, 0);
 	qdf_spin_lock_bh(&fisa_hdl->dp_rx_fst_lock);
-	while (qdf_list_peek_front(&fisa_hdl->fst_update_list, &node) ==
+	qdf_list_join(&update_list, &fisa_hdl->fst_update_list);
+	qdf_spin_unlock_bh(&fisa_hdl->dp_rx_fst_lock);
+
+	while (qdf_list_remove_front(&update_list, &node) ==
 	       QDF_STATUS_SUCCESS) {
 		elem = (struct dp_fisa_rx_fst_update_elem *)node;
 		vdev = dp_vdev_get_ref_by_id(fisa_hdl->soc_hdl,
@@ -964,10 +972,11 @@ void dp_fisa_rx_fst_update_work(void *arg)
 			dp_vdev_unref_delete(fisa_hdl->soc_hdl, vdev,
 					     DP_MOD_ID_RX);
 		}
-		qdf_list_remove_front(&fisa_hdl->fst_update_list, &node);
+		qdf_atomic_clear_bit(elem->flow_idx & fisa_hdl->hash_mask,
+				     fisa_hdl->fst_update_pending);
 		qdf_mem_free(elem);
 	}
-	qdf_spin_unlock_bh(&fisa_hdl->dp_rx_fst_lock);
+	qdf_list_destroy(&update_list);
 
 	if (hif_force_wake_release(((struct hal_soc *)hal_soc_hdl)->hif_handle)) {
 		dp_err("Wake up release failed");
@@ -976,38 +985,6 @@ void dp_fisa_rx_fst_update_work(void *arg)
 	}
 }
 
-/**
- * dp_fisa_rx_is_fst_work_queued() - Check if work is already queued for
- * the flow
- * @fisa_hdl: handle to FISA context
- * @flow_idx: Flow index
- *
- * Return: True/False
- */
-static inline bool
-dp_fisa_rx_is_fst_work_queued(struct dp_rx_fst *fisa_hdl, uint32_t flow_idx)
-{
-	struct dp_fisa_rx_fst_update_elem *elem;
-	qdf_list_node_t *cur_node, *next_node;
-	QDF_STATUS status;
-
-	status = qdf_list_peek_front(&fisa_hdl->fst_update_list, &cur_node);
-	if (status == QDF_STATUS_E_EMPTY)
-		return false;
-
-	do {
-		elem = (struct dp_fisa_rx_fst_update_elem *)cur_node;
-		if (elem->flow_idx == flow_idx)
-			return true;
-
-		status = qdf_list_peek_next(&fisa_hdl->fst_update_list,
-					    cur_node, &next_node);
-		cur_node = next_node;
-	} while (status == QDF_STATUS_SUCCESS);
-
-	return false;
-}
-
 /**
  * dp_fisa_rx_queue_fst_update_work() - Queue FST update work
  * @fisa_hdl: Handle to FISA context
@@ -1028,7 +1005,6 @@ dp_fisa_rx_queue_fst_update_work(struct dp_rx_fst *fisa_hdl, uint32_t flow_idx,
 	struct dp_fisa_rx_sw_ft *sw_ft_entry;
 	uint32_t hashed_flow_idx;
 	uint32_t reo_dest_indication;
-	bool found;
 	struct hal_proto_params proto_params;
 
 	if (hal_rx_get_proto_params(fisa_hdl->dp_ctx->hal_soc, rx_tlv_hdr,
@@ -1041,15 +1017,17 @@ dp_fisa_rx_queue_fst_update_work(struct dp_rx_fst *fisa_hdl, uint32_t flow_idx,
 		return NULL;
 	}
 
-	hal_rx_msdu_get_reo_destination_indication(hal_soc_hdl, rx_tlv_hdr,
-						   &reo_dest_indication);
-	qdf_spin_lock_bh(&fisa_hdl->dp_rx_fst_lock);
-	found = dp_fisa_rx_is_fst_work_queued(fisa_hdl, flow_idx);
-	qdf_spin_unlock_bh(&fisa_hdl->dp_rx_fst_lock);
-	if (found)
+	hashed_flow_idx = flow_idx & fisa_hdl->hash_mask;
+
+	/*
+	 * Insertion for this FT slot is already on its way to the update
+	 * work, no need to look at the tuple again.
+	 */
+	if (qdf_atomic_test_bit(hashed_flow_idx, fisa_hdl->fst_update_pending))
 		return NULL;
 
-	hashed_flow_idx = flow_idx & fisa_hdl->hash_mask;
+	hal_rx_msdu_get_reo_destination_indication(hal_soc_hdl, rx_tlv_hdr,
+						   &reo_dest_indication);
 	sw_ft_entry = &(((struct dp_fisa_rx_sw_ft *)
 				fisa_hdl->base)[hashed_flow_idx]);
 
@@ -1062,9 +1040,16 @@ dp_fisa_rx_queue_fst_update_work(struct dp_rx_fst *fisa_hdl, uint32_t flow_idx,
 			&sw_ft_entry->rx_flow_tuple_info, &flow_tuple_info))
 		return sw_ft_entry;
 
+	/* Only the RX context winning this bit queues the FST update */
+	if (qdf_atomic_test_and_set_bit(hashed_flow_idx,
+					fisa_hdl->fst_update_pending))
+		return NULL;
+
 	elem = qdf_mem_malloc(sizeof(*elem));
 	if (!elem) {
 		dp_fisa_debug("failed to allocate memory for FST update");
+		qdf_atomic_clear_bit(hashed_flow_idx,
+				     fisa_hdl->fst_update_pending);
 		return NULL;
 	}
 
@@ -1985,6 +1970,12 @@ static int dp_add_nbuf_to_fisa_flow(struct dp_rx_fst *fisa_hdl,
 		 * length
 		 */
 		fisa_flow->cur_aggr++;
+		if (qdf_unlikely(!fisa_flow->aggr_steady &&
+				 fisa_flow->head_skb &&
+				 fisa_flow->cur_aggr >= FISA_AGGR_STEADY_SEGS)) {
+			fisa_flow->aggr_steady = 1;
+			DP_STATS_INC(fisa_hdl, flows_aggr_steady, 1);
+		}
 	}
 
 	dp_fisa_debug("nbuf %pK cumulat_ip_length %d flow %pK fl aggr cont %d",
@@ -69,6 +69,13 @@
 
 #define FISA_FT_ENTRY_AGING_US	1000000
 
+/*
+ * Consecutive MSDUs a flow must aggregate, on top of the head MSDU,
+ * before it is counted as having reached steady state aggregation.
+ * A flow aggregating only a segment or two is not yet steady.
+ */
+#define FISA_AGGR_STEADY_SEGS 4
+
 struct dp_fisa_rx_fst_update_elem {
 	/* Do not add new entries here */
 	qdf_list_node_t node;
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: wlan_dp_link_sched.c
+ *
+ * MLO TX link scheduler, see wlan_dp_link_sched.h
+ */
+
+#include <qdf_time.h>
+#include <cdp_txrx_misc.h>
+#include "wlan_dp_main.h"
+#include "wlan_dp_link_sched.h"
+
+/* A flow idle for this long starts a new burst */
+#define DP_LINK_SCHED_BURST_GAP_US 2000
+/* Expected delay gain needed to move a burst to another link */
+#define DP_LINK_SCHED_SWITCH_MARGIN_US 200
+
+/**
+ * dp_link_sched_delay() - expected TX delay of a new MSDU on a link
+ * @metrics: TX link metrics of the link
+ *
+ * The completion latency is the delay seen on an idle link, every
+ * pending MSDU adds one service time on top of it.
+ *
+ * Return: expected delay in us
+ */
+static uint64_t dp_link_sched_delay(struct cdp_tx_link_metrics *metrics)
+{
+	return metrics->lat_ewma_us +
+	       (uint64_t)metrics->pending * metrics->svc_ewma_us;
+}
+
+/**
+ * dp_link_sched_pick() - pick the link for a new burst of a flow
+ * @dp_intf: DP interface
+ * @flow: flow entry
+ * @now_us: current time
+ *
+ * The flow only leaves its link once the MSDUs it sent there are expected
+ * to have completed, so MSDUs of a flow are never in flight on two links.
+ *
+ * Return: link for the burst
+ */
+static struct wlan_dp_link *
+dp_link_sched_pick(struct wlan_dp_intf *dp_intf,
+		   struct dp_link_sched_flow *flow, uint64_t now_us)
+{
+	struct wlan_dp_psoc_context *dp_ctx = dp_intf->dp_ctx;
+	struct cdp_tx_link_metrics metrics;
+	struct wlan_dp_link *dp_link, *dp_link_next;
+	struct wlan_dp_link *cur_link = flow->dp_link;
+	struct wlan_dp_link *best_link = NULL;
+	uint64_t best_delay = U64_MAX;
+	uint64_t cur_delay = U64_MAX;
+	uint64_t delay;
+	QDF_STATUS status;
+
+	qdf_spin_lock_bh(&dp_intf->dp_link_list_lock);
+	status = dp_get_front_link_no_lock(dp_intf, &dp_link);
+	while (QDF_IS_STATUS_SUCCESS(status)) {
+		if (dp_link->conn_info.is_authenticated &&
+		    QDF_IS_STATUS_SUCCESS(cdp_get_tx_link_metrics(dp_ctx->cdp_soc,
+								  dp_link->link_id,
+								  &metrics))) {
+			delay = dp_link_sched_delay(&metrics);
+			if (dp_link == cur_link)
+				cur_delay = delay;
+			if (delay < best_delay) {
+				best_delay = delay;
+				best_link = dp_link;
+			}
+		}
+		status = dp_get_next_link_no_lock(dp_intf, dp_link,
+						  &dp_link_next);
+		dp_link = dp_link_next;
+	}
+
+	if (cur_delay != U64_MAX && best_link != cur_link &&
+	    (now_us - flow->last_tx_us < 2 * cur_delay ||
+	     best_delay + DP_LINK_SCHED_SWITCH_MARGIN_US >= cur_delay))
+		best_link = cur_link;
+
+	if (best_link && cur_link && best_link != cur_link)
+		dp_intf->link_sched.num_switch++;
+
+	/*
+	 * Installed under the list lock so that a link removed meanwhile is
+	 * either not picked or purged by dp_link_sched_link_del(). The
+	 * default link is not installed, it may already be out of the list
+	 * while dp_vdev_obj_destroy_notification() looks for a new one.
+	 */
+	flow->dp_link = best_link;
+	flow->last_tx_us = now_us;
+	qdf_spin_unlock_bh(&dp_intf->dp_link_list_lock);
+
+	return best_link ? best_link : dp_intf->def_link;
+}
+
+/**
+ * dp_link_sched_link_live() - check a link cached in the flow table
+ * @dp_link: link read from the flow table without the list lock
+ *
+ * The link was read with num_active_task held, so it is not freed before
+ * the caller is done with it. A link being deleted is either purged from
+ * the flow table or caught here.
+ *
+ * Return: true if @dp_link can still be transmitted on
+ */
+static inline bool dp_link_sched_link_live(struct wlan_dp_link *dp_link)
+{
+	return dp_link->magic == WLAN_DP_LINK_MAGIC && !dp_link->destroyed &&
+	       dp_link->vdev;
+}
+
+struct wlan_dp_link *dp_link_sched_select(struct wlan_dp_intf *dp_intf,
+					  qdf_nbuf_t nbuf)
+{
+	struct dp_link_sched_flow *flow;
+	struct wlan_dp_link *dp_link;
+	uint64_t now_us;
+
+	if (dp_intf->num_links < 2 || dp_intf->device_mode != QDF_STA_MODE)
+		return dp_intf->def_link;
+
+	flow = &dp_intf->link_sched.flows[qdf_nbuf_get_flow_hash(nbuf) &
+					  (DP_LINK_SCHED_FLOW_TBL_SIZE - 1)];
+	now_us = qdf_ktime_to_us(qdf_ktime_get());
+	dp_link = flow->dp_link;
+	if (qdf_likely(dp_link &&
+		       now_us - flow->last_tx_us < DP_LINK_SCHED_BURST_GAP_US &&
+		       dp_link_sched_link_live(dp_link))) {
+		flow->last_tx_us = now_us;
+		return dp_link;
+	}
+
+	return dp_link_sched_pick(dp_intf, flow, now_us);
+}
+
+void dp_link_sched_link_add(struct wlan_dp_intf *dp_intf,
+			    struct wlan_dp_link *dp_link)
+{
+	/* Only MLO STA links are scheduled, keep the TX path clean otherwise */
+	if (wlan_vdev_mlme_get_opmode(dp_link->vdev) != QDF_STA_MODE ||
+	    !wlan_vdev_mlme_is_mlo_vdev(dp_link->vdev))
+		return;
+
+	cdp_set_tx_link_metrics(dp_intf->dp_ctx->cdp_soc, dp_link->link_id,
+				true);
+}
+
+void dp_link_sched_link_del(struct wlan_dp_intf *dp_intf,
+			    struct wlan_dp_link *dp_link)
+{
+	struct dp_link_sched *sched = &dp_intf->link_sched;
+	int i;
+
+	qdf_spin_lock_bh(&dp_intf->dp_link_list_lock);
+	for (i = 0; i < DP_LINK_SCHED_FLOW_TBL_SIZE; i++) {
+		if (sched->flows[i].dp_link == dp_link)
+			sched->flows[i].dp_link = NULL;
+	}
+	qdf_spin_unlock_bh(&dp_intf->dp_link_list_lock);
+
+	cdp_set_tx_link_metrics(dp_intf->dp_ctx->cdp_soc, dp_link->link_id,
+				false);
+
+	dp_info("link %d removed from TX link scheduler, %u link switches",
+		dp_link->link_id, sched->num_switch);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: MLO TX link scheduler
+ *
+ * Picks the link of an MLO STA interface for each TX burst of a flow.
+ * A flow stays on its link while it keeps sending, a burst that starts
+ * after the flow was idle and its previous MSDUs have likely completed
+ * goes to the link with the lowest expected delay, computed from the
+ * per link completion latency and pending counts kept by the datapath.
+ */
+
+#ifndef _WLAN_DP_LINK_SCHED_H_
+#define _WLAN_DP_LINK_SCHED_H_
+
+#include <qdf_nbuf.h>
+
+struct wlan_dp_intf;
+struct wlan_dp_link;
+
+#ifdef WLAN_DP_MLO_LINK_SCHED
+#define DP_LINK_SCHED_FLOW_TBL_SIZE 256
+
+/**
+ * struct dp_link_sched_flow - link of a TX flow
+ * @dp_link: link the flow is sent on, NULL if not yet assigned
+ * @last_tx_us: time of the last MSDU of the flow
+ *
+ * Flows hashing to the same entry share the link, which keeps their
+ * ordering too.
+ */
+struct dp_link_sched_flow {
+	struct wlan_dp_link *dp_link;
+	uint64_t last_tx_us;
+};
+
+/**
+ * struct dp_link_sched - MLO TX link scheduler of a DP interface
+ * @flows: flow table indexed by flow hash
+ * @num_switch: number of bursts moved to another link
+ */
+struct dp_link_sched {
+	struct dp_link_sched_flow flows[DP_LINK_SCHED_FLOW_TBL_SIZE];
+	uint32_t num_switch;
+};
+
+/**
+ * dp_link_sched_select() - select the TX link for an MSDU
+ * @dp_intf: DP interface
+ * @nbuf: MSDU to transmit
+ *
+ * Called with dp_intf->num_active_task held, which keeps the returned link
+ * from being freed while the MSDU is sent on it.
+ *
+ * Return: link to transmit @nbuf on
+ */
+struct wlan_dp_link *dp_link_sched_select(struct wlan_dp_intf *dp_intf,
+					  qdf_nbuf_t nbuf);
+
+/**
+ * dp_link_sched_link_add() - start collecting TX metrics for a link
+ * @dp_intf: DP interface
+ * @dp_link: link added to @dp_intf
+ *
+ * Only links of an MLO STA collect metrics, other links always send on
+ * the default link.
+ *
+ * Return: None
+ */
+void dp_link_sched_link_add(struct wlan_dp_intf *dp_intf,
+			    struct wlan_dp_link *dp_link);
+
+/**
+ * dp_link_sched_link_del() - drop a link from the scheduler
+ * @dp_intf: DP interface
+ * @dp_link: link already removed from the link list of @dp_intf
+ *
+ * Flows on @dp_link pick a new link on their next MSDU.
+ *
+ * Return: None
+ */
+void dp_link_sched_link_del(struct wlan_dp_intf *dp_intf,
+			    struct wlan_dp_link *dp_link);
+#else
+static inline void dp_link_sched_link_add(struct wlan_dp_intf *dp_intf,
+					  struct wlan_dp_link *dp_link)
+{
+}
+
+static inline void dp_link_sched_link_del(struct wlan_dp_intf *dp_intf,
+					  struct wlan_dp_link *dp_link)
+{
+}
+#endif /* WLAN_DP_MLO_LINK_SCHED */
+#endif /* _WLAN_DP_LINK_SCHED_H_ */
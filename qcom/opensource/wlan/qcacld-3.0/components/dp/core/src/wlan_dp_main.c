@@ -1230,6 +1230,8 @@ dp_vdev_obj_create_notification(struct wlan_objmgr_vdev *vdev, void *arg)
 		return status;
 	}
 
+	dp_link_sched_link_add(dp_intf, dp_link);
+
 	if (dp_intf->num_links == 1) {
 		/*
 		 * Interface level operations to be done only
@@ -1317,6 +1319,7 @@ dp_vdev_obj_destroy_notification(struct wlan_objmgr_vdev *vdev, void *arg)
 	qdf_list_remove_node(&dp_intf->dp_link_list, &dp_link->node);
 	dp_intf->num_links--;
 	qdf_spin_unlock_bh(&dp_intf->dp_link_list_lock);
+	dp_link_sched_link_del(dp_intf, dp_link);
 
 	if (dp_intf->num_links == 0) {
 		/*
@@ -85,6 +85,8 @@ static void dp_print_fisa_stats(struct wlan_dp_psoc_context *dp_ctx)
 		return;
 
 	dp_info("invalid flow index: %u", fst->stats.invalid_flow_index);
+	dp_info("flows reached steady aggregation: %u of %u added",
+		fst->stats.flows_aggr_steady, fst->add_flow_count);
 	dp_info("workqueue update deferred: %u", fst->stats.update_deferred);
 	dp_info("reo_mismatch: cce_match: %u",
 		fst->stats.reo_mismatch.allow_cce_match);
@@ -146,7 +148,7 @@ static QDF_STATUS dp_rx_dump_fisa_stats(struct wlan_dp_psoc_context *dp_ctx)
 				 tuple_str,
 				 sizeof(tuple_str));
 
-		dp_info("Flow[%d][%s][%s] ring %d msdu-aggr %d flushes %d bytes-agg %llu avg-bytes-aggr %llu same_mld_vdev_mismatch %llu",
+		dp_info("Flow[%d][%s][%s] ring %d msdu-aggr %d flushes %d bytes-agg %llu avg-bytes-aggr %llu same_mld_vdev_mismatch %llu steady %d",
 			sw_ft_entry->flow_id,
 			sw_ft_entry->is_flow_udp ? "udp" : "tcp",
 			tuple_str,
@@ -156,7 +158,8 @@ static QDF_STATUS dp_rx_dump_fisa_stats(struct wlan_dp_psoc_context *dp_ctx)
 			sw_ft_entry->bytes_aggregated,
 			qdf_do_div(sw_ft_entry->bytes_aggregated,
 				   sw_ft_entry->flush_count),
-			sw_ft_entry->same_mld_vdev_mismatch);
+			sw_ft_entry->same_mld_vdev_mismatch,
+			sw_ft_entry->aggr_steady);
 	}
 	return QDF_STATUS_SUCCESS;
 }
@@ -293,6 +296,8 @@ static void dp_rx_fst_cmem_deinit(struct dp_rx_fst *fst)
 	qdf_spin_unlock_bh(&fst->dp_rx_fst_lock);
 
 	qdf_list_destroy(&fst->fst_update_list);
+	qdf_mem_free(fst->fst_update_pending);
+	fst->fst_update_pending = NULL;
 	qdf_event_destroy(&fst->cmem_resp_event);
 
 	for (i = 0; i < MAX_REO_DEST_RINGS; i++)
@@ -309,10 +314,18 @@ static QDF_STATUS dp_rx_fst_cmem_init(struct dp_rx_fst *fst)
 {
 	int i;
 
+	fst->fst_update_pending =
+		qdf_mem_malloc(BITS_TO_LONGS(fst->max_entries) *
+			       sizeof(unsigned long));
+	if (!fst->fst_update_pending)
+		return QDF_STATUS_E_NOMEM;
+
 	fst->fst_update_wq =
 		qdf_alloc_high_prior_ordered_workqueue("dp_rx_fst_update_wq");
 	if (!fst->fst_update_wq) {
 		dp_err("failed to allocate fst update wq");
+		qdf_mem_free(fst->fst_update_pending);
+		fst->fst_update_pending = NULL;
 		return QDF_STATUS_E_FAILURE;
 	}
 
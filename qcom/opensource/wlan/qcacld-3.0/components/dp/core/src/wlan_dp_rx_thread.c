@@ -157,6 +157,14 @@ static void dp_rx_tm_thread_dump_stats(struct dp_rx_thread *rx_thread)
 				     "reo[%u]:%u ", reo_ring_num, temp);
 	}
 
+	if (rx_thread->stats.steal_attempts || rx_thread->stats.nbuf_stolen_from)
+		dp_info("thread:%u - steal attempts:%u success:%u stolen:%u stolen_from:%u",
+			rx_thread->id,
+			rx_thread->stats.steal_attempts,
+			rx_thread->stats.steal_success,
+			rx_thread->stats.nbuf_stolen,
+			rx_thread->stats.nbuf_stolen_from);
+
 	if (!total_queued)
 		return;
 
@@ -267,6 +275,519 @@ QDF_STATUS dp_check_and_update_pending(struct dp_rx_tm_handle_cmn
 }
 #endif
 
+#ifdef WLAN_DP_RX_THREAD_WORK_STEAL
+static void dp_rx_thread_adjust_nbuf_list(qdf_nbuf_t head);
+
+/**
+ * dp_rx_tm_steal_key() - get the steal unit of a nbuf
+ * @nbuf: nbuf, or head of a queued nbuf_list
+ *
+ * All nbufs of a queued nbuf_list are in the same unit, see
+ * dp_rx_tm_thread_enqueue_list(). The flow hash is only filled in when GRO
+ * is enabled, without it every flow of a REO ring is in the same unit.
+ *
+ * Return: steal unit made of the REO ring and flow bucket of the nbuf
+ */
+static inline uint8_t dp_rx_tm_steal_key(qdf_nbuf_t nbuf)
+{
+	return QDF_NBUF_CB_RX_CTX_ID(nbuf) * DP_RX_TM_STEAL_FLOW_BUCKETS +
+	       QDF_NBUF_CB_RX_FLOW_ID(nbuf) % DP_RX_TM_STEAL_FLOW_BUCKETS;
+}
+
+/**
+ * dp_rx_tm_steal_init() - hand every steal unit to its REO ring's thread
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread
+ *	       infrastructure
+ *
+ * Return: None
+ */
+static void dp_rx_tm_steal_init(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+	uint8_t key;
+
+	for (key = 0; key < DP_RX_TM_STEAL_KEYS; key++)
+		rx_tm_hdl->steal_owner[key] =
+			(key / DP_RX_TM_STEAL_FLOW_BUCKETS) %
+			rx_tm_hdl->num_dp_rx_threads;
+}
+
+/**
+ * dp_rx_tm_thread_steal_init() - initialize work stealing state of a thread
+ * @rx_thread: rx_thread to be initialized
+ *
+ * Return: None
+ */
+static void dp_rx_tm_thread_steal_init(struct dp_rx_thread *rx_thread)
+{
+	rx_thread->steal_list = NULL;
+	qdf_atomic_init(&rx_thread->steal_qlen);
+	qdf_mem_zero(rx_thread->steal_flush_vdevs,
+		     sizeof(rx_thread->steal_flush_vdevs));
+	qdf_atomic_init(&rx_thread->steal_inflight_key);
+	qdf_atomic_set(&rx_thread->steal_inflight_key,
+		       DP_RX_TM_STEAL_KEY_NONE);
+	/* start ahead of steal_key_gen so never delivered units are free */
+	qdf_atomic_init(&rx_thread->steal_flush_gen);
+	qdf_atomic_set(&rx_thread->steal_flush_gen, 1);
+	qdf_mem_zero(rx_thread->steal_key_gen,
+		     sizeof(rx_thread->steal_key_gen));
+}
+
+/**
+ * dp_rx_tm_thread_steal_deinit() - free nbuf_lists stolen but not delivered
+ * @rx_thread: rx_thread to be de-initialized
+ *
+ * Return: None
+ */
+static void dp_rx_tm_thread_steal_deinit(struct dp_rx_thread *rx_thread)
+{
+	qdf_nbuf_t nbuf_list;
+
+	while (rx_thread->steal_list) {
+		nbuf_list = rx_thread->steal_list;
+		rx_thread->steal_list = qdf_nbuf_next(nbuf_list);
+		qdf_nbuf_set_next(nbuf_list, NULL);
+		dp_rx_thread_adjust_nbuf_list(nbuf_list);
+		qdf_nbuf_list_free(nbuf_list);
+	}
+	qdf_atomic_set(&rx_thread->steal_qlen, 0);
+}
+
+/**
+ * dp_rx_tm_thread_steal_flush_vdev() - ask a thread to drop the stolen
+ *					nbuf_lists of a vdev
+ * @rx_thread: rx_thread to be flushed
+ * @vdev_id: vdev id for which packets are to be flushed
+ *
+ * @steal_list is private to the thread, so it is filtered by the thread
+ * itself when it handles RX_VDEV_DEL_EVENT.
+ *
+ * Return: None
+ */
+static void dp_rx_tm_thread_steal_flush_vdev(struct dp_rx_thread *rx_thread,
+					     uint8_t vdev_id)
+{
+	if (vdev_id < WLAN_UMAC_PSOC_MAX_VDEVS)
+		qdf_atomic_set_bit(vdev_id, rx_thread->steal_flush_vdevs);
+}
+
+/**
+ * dp_rx_tm_thread_steal_flush() - drop stolen nbuf_lists of flushed vdevs
+ * @rx_thread: rx_thread handling RX_VDEV_DEL_EVENT
+ *
+ * Return: None
+ */
+static void dp_rx_tm_thread_steal_flush(struct dp_rx_thread *rx_thread)
+{
+	qdf_bitmap(vdevs, WLAN_UMAC_PSOC_MAX_VDEVS);
+	qdf_nbuf_t nbuf_list, next, tail = NULL;
+	uint8_t vdev_id;
+	int i;
+
+	qdf_mem_zero(vdevs, sizeof(vdevs));
+	for (i = 0; i < WLAN_UMAC_PSOC_MAX_VDEVS; i++) {
+		if (qdf_atomic_test_and_clear_bit(i,
+						  rx_thread->steal_flush_vdevs))
+			qdf_set_bit(i, vdevs);
+	}
+
+	nbuf_list = rx_thread->steal_list;
+	rx_thread->steal_list = NULL;
+	while (nbuf_list) {
+		next = qdf_nbuf_next(nbuf_list);
+		vdev_id = QDF_NBUF_CB_RX_VDEV_ID(nbuf_list);
+		if (vdev_id < WLAN_UMAC_PSOC_MAX_VDEVS &&
+		    qdf_test_bit(vdev_id, vdevs)) {
+			qdf_nbuf_set_next(nbuf_list, NULL);
+			dp_rx_thread_adjust_nbuf_list(nbuf_list);
+			rx_thread->stats.rx_flushed +=
+				QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list);
+			qdf_nbuf_list_free(nbuf_list);
+			qdf_atomic_dec(&rx_thread->steal_qlen);
+		} else {
+			if (tail)
+				qdf_nbuf_set_next(tail, nbuf_list);
+			else
+				rx_thread->steal_list = nbuf_list;
+			tail = nbuf_list;
+		}
+		nbuf_list = next;
+	}
+
+	if (tail)
+		qdf_nbuf_set_next(tail, NULL);
+}
+
+/**
+ * dp_rx_tm_thread_steal_qlen() - number of nbuf_lists stolen by a thread
+ * @rx_thread: rx_thread to be checked
+ *
+ * Return: number of nbuf_lists in @rx_thread->steal_list
+ */
+static inline int dp_rx_tm_thread_steal_qlen(struct dp_rx_thread *rx_thread)
+{
+	return qdf_atomic_read(&rx_thread->steal_qlen);
+}
+
+/**
+ * dp_rx_tm_thread_enqueue_tail() - enqueue nbuf_list into the thread owning
+ *				    its steal unit
+ * @rx_thread: rx_thread selected for the REO ring of the nbuf_list
+ * @nbuf_list: nbuf_list head to be queued
+ *
+ * The owner is re-checked with its nbuf_queue lock held, so a steal of
+ * the unit can not slip in between the lookup and the enqueue. An owner
+ * other than @rx_thread is woken up here, the caller wakes up @rx_thread.
+ *
+ * Return: None
+ */
+static void dp_rx_tm_thread_enqueue_tail(struct dp_rx_thread *rx_thread,
+					 qdf_nbuf_t nbuf_list)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	uint8_t key = dp_rx_tm_steal_key(nbuf_list);
+	struct dp_rx_thread *owner;
+
+	while (true) {
+		owner = rx_tm_hdl->rx_thread[rx_tm_hdl->steal_owner[key]];
+		qdf_nbuf_queue_head_lock(&owner->nbuf_queue);
+		if (rx_tm_hdl->steal_owner[key] == owner->id)
+			break;
+		qdf_nbuf_queue_head_unlock(&owner->nbuf_queue);
+	}
+	qdf_nbuf_queue_head_enqueue_tail_no_lock(&owner->nbuf_queue, nbuf_list);
+	qdf_nbuf_queue_head_unlock(&owner->nbuf_queue);
+
+	if (owner != rx_thread) {
+		qdf_set_bit(RX_POST_EVENT, &owner->event_flag);
+		qdf_wake_up_interruptible(&owner->wait_q);
+	}
+}
+
+/**
+ * dp_rx_tm_thread_enqueue_list() - enqueue nbuf_lists of each steal unit
+ * @rx_thread: rx_thread selected for the REO ring of the nbuf_list
+ * @nbuf_list: nbuf_list linked through ->next, of one REO ring and vdev
+ * @num_elements: number of nbufs in @nbuf_list
+ *
+ * The nbufs of a delivery list may belong to several flows. Split them
+ * into one nbuf_list per steal unit, keeping their order within the unit,
+ * so that every queued nbuf_list can be stolen on its own.
+ *
+ * Return: None
+ */
+static void dp_rx_tm_thread_enqueue_list(struct dp_rx_thread *rx_thread,
+					 qdf_nbuf_t nbuf_list,
+					 uint32_t num_elements)
+{
+	qdf_nbuf_t head[DP_RX_TM_STEAL_FLOW_BUCKETS] = {NULL};
+	qdf_nbuf_t tail[DP_RX_TM_STEAL_FLOW_BUCKETS];
+	qdf_nbuf_t nbuf, next;
+	uint8_t bucket;
+
+	for (nbuf = nbuf_list; nbuf; nbuf = next) {
+		next = qdf_nbuf_next(nbuf);
+		bucket = dp_rx_tm_steal_key(nbuf) % DP_RX_TM_STEAL_FLOW_BUCKETS;
+		if (head[bucket]) {
+			qdf_nbuf_set_next(tail[bucket], nbuf);
+			QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(head[bucket])++;
+		} else {
+			head[bucket] = nbuf;
+			QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf) = 1;
+		}
+		tail[bucket] = nbuf;
+	}
+
+	for (bucket = 0; bucket < DP_RX_TM_STEAL_FLOW_BUCKETS; bucket++) {
+		if (!head[bucket])
+			continue;
+
+		qdf_nbuf_set_next(tail[bucket], NULL);
+		next = qdf_nbuf_next(head[bucket]);
+		if (next)
+			/* move ->next pointer to ext list */
+			qdf_nbuf_append_ext_list(head[bucket], next, 0);
+		qdf_nbuf_set_next(head[bucket], NULL);
+
+		dp_rx_tm_thread_enqueue_tail(rx_thread, head[bucket]);
+	}
+}
+
+/**
+ * dp_rx_tm_thread_dequeue_head() - dequeue the next nbuf_list to deliver
+ * @rx_thread: rx_thread from which the nbuf needs to be dequeued
+ *
+ * Stolen nbuf_lists are older than anything of the same unit left in
+ * nbuf_queue and are handed out first. For nbuf_queue, the unit being
+ * delivered is published under the queue lock for the stealing threads.
+ *
+ * Return: nbuf_list head or NULL
+ */
+static qdf_nbuf_t dp_rx_tm_thread_dequeue_head(struct dp_rx_thread *rx_thread)
+{
+	qdf_nbuf_t head;
+	uint8_t key = DP_RX_TM_STEAL_KEY_NONE;
+
+	head = rx_thread->steal_list;
+	if (head) {
+		rx_thread->steal_list = qdf_nbuf_next(head);
+		qdf_nbuf_set_next(head, NULL);
+		qdf_atomic_dec(&rx_thread->steal_qlen);
+		return head;
+	}
+
+	qdf_nbuf_queue_head_lock(&rx_thread->nbuf_queue);
+	head = qdf_nbuf_queue_head_dequeue_no_lock(&rx_thread->nbuf_queue);
+	if (head) {
+		key = dp_rx_tm_steal_key(head);
+		rx_thread->steal_key_gen[key] =
+			qdf_atomic_read(&rx_thread->steal_flush_gen);
+	}
+	qdf_atomic_set(&rx_thread->steal_inflight_key, key);
+	qdf_nbuf_queue_head_unlock(&rx_thread->nbuf_queue);
+
+	return head;
+}
+
+/**
+ * dp_rx_tm_steal_key_allowed() - check if a steal unit may leave a thread
+ * @victim: rx_thread owning the unit, with its nbuf_queue lock held
+ * @key: steal unit
+ *
+ * A unit can not move while the victim is delivering it, nor while
+ * segments of it may still be held in the victim's GRO.
+ *
+ * Return: true if the unit can be stolen
+ */
+static bool dp_rx_tm_steal_key_allowed(struct dp_rx_thread *victim,
+				       uint8_t key)
+{
+	int inflight_key = qdf_atomic_read(&victim->steal_inflight_key);
+
+	if (inflight_key == key || inflight_key == DP_RX_TM_STEAL_KEY_ANY)
+		return false;
+
+	return victim->steal_key_gen[key] !=
+		qdf_atomic_read(&victim->steal_flush_gen);
+}
+
+/**
+ * dp_rx_thread_steal() - steal a batch of work from the busiest RX thread
+ * @rx_thread: idle rx_thread looking for work
+ *
+ * Takes every queued nbuf_list of one steal unit from the thread with the
+ * longest nbuf_queue, keeping their order, and redirects later nbuf_lists
+ * of the unit to @rx_thread. The largest unit is picked, even a single
+ * elephant flow, unless it is the whole victim backlog: moving it would
+ * only move the backlog and leave the victim idle instead.
+ *
+ * Return: true if nbuf_lists were stolen into @rx_thread->steal_list
+ */
+static bool dp_rx_thread_steal(struct dp_rx_thread *rx_thread)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	struct dp_rx_thread *victim = NULL, *thread;
+	uint16_t key_cnt[DP_RX_TM_STEAL_KEYS] = {0};
+	uint8_t key, steal_key = DP_RX_TM_STEAL_KEY_NONE;
+	uint32_t qlen, max_qlen = DP_RX_TM_STEAL_MIN_QLEN - 1;
+	uint32_t num_stolen = 0, num_lists = 0;
+	qdf_nbuf_t nbuf_list, tmp_nbuf_list, tail = NULL;
+	int i;
+
+	if (rx_thread->steal_list ||
+	    qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue))
+		return false;
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		thread = rx_tm_hdl->rx_thread[i];
+		if (!thread || thread == rx_thread)
+			continue;
+		qlen = qdf_nbuf_queue_head_qlen(&thread->nbuf_queue);
+		if (qlen > max_qlen) {
+			max_qlen = qlen;
+			victim = thread;
+		}
+	}
+
+	if (!victim)
+		return false;
+
+	rx_thread->stats.steal_attempts++;
+	qdf_atomic_set(&rx_thread->steal_inflight_key, DP_RX_TM_STEAL_KEY_ANY);
+
+	qdf_nbuf_queue_head_lock(&victim->nbuf_queue);
+	qlen = qdf_nbuf_queue_head_qlen(&victim->nbuf_queue);
+	QDF_NBUF_QUEUE_WALK_SAFE(&victim->nbuf_queue, nbuf_list,
+				 tmp_nbuf_list)
+		key_cnt[dp_rx_tm_steal_key(nbuf_list)]++;
+
+	for (key = 0; key < DP_RX_TM_STEAL_KEYS; key++) {
+		if (!key_cnt[key] || key_cnt[key] == qlen)
+			continue;
+		if (steal_key != DP_RX_TM_STEAL_KEY_NONE &&
+		    key_cnt[key] <= key_cnt[steal_key])
+			continue;
+		if (dp_rx_tm_steal_key_allowed(victim, key))
+			steal_key = key;
+	}
+
+	if (steal_key == DP_RX_TM_STEAL_KEY_NONE) {
+		qdf_nbuf_queue_head_unlock(&victim->nbuf_queue);
+		qdf_atomic_set(&rx_thread->steal_inflight_key,
+			       DP_RX_TM_STEAL_KEY_NONE);
+		return false;
+	}
+
+	QDF_NBUF_QUEUE_WALK_SAFE(&victim->nbuf_queue, nbuf_list,
+				 tmp_nbuf_list) {
+		if (dp_rx_tm_steal_key(nbuf_list) != steal_key)
+			continue;
+		qdf_nbuf_unlink_no_lock(nbuf_list, &victim->nbuf_queue);
+		if (tail)
+			qdf_nbuf_set_next(tail, nbuf_list);
+		else
+			rx_thread->steal_list = nbuf_list;
+		tail = nbuf_list;
+		num_stolen += QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list);
+		num_lists++;
+	}
+	qdf_atomic_set(&rx_thread->steal_qlen, num_lists);
+	rx_tm_hdl->steal_owner[steal_key] = rx_thread->id;
+	victim->stats.nbuf_stolen_from += num_stolen;
+	qdf_nbuf_queue_head_unlock(&victim->nbuf_queue);
+
+	/* hold the unit here until it is delivered and GRO flushed */
+	rx_thread->steal_key_gen[steal_key] =
+		qdf_atomic_read(&rx_thread->steal_flush_gen);
+	qdf_atomic_set(&rx_thread->steal_inflight_key, steal_key);
+
+	rx_thread->stats.steal_success++;
+	rx_thread->stats.nbuf_stolen += num_stolen;
+	dp_debug("thread %u stole unit %u (%u pkts) from thread %u",
+		 rx_thread->id, steal_key, num_stolen, victim->id);
+
+	return true;
+}
+
+/**
+ * dp_rx_tm_steal_kick() - wake idle threads to steal from a busy thread
+ * @rx_thread: rx_thread that just had a nbuf_list queued
+ * @qlen: nbuf_queue length of @rx_thread
+ *
+ * Return: None
+ */
+static void dp_rx_tm_steal_kick(struct dp_rx_thread *rx_thread,
+				uint32_t qlen)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	struct dp_rx_thread *thread;
+	int i;
+
+	if (qlen < DP_RX_TM_STEAL_MIN_QLEN || qlen % DP_RX_TM_STEAL_MIN_QLEN)
+		return;
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		thread = rx_tm_hdl->rx_thread[i];
+		if (!thread || thread == rx_thread ||
+		    qdf_nbuf_queue_head_qlen(&thread->nbuf_queue))
+			continue;
+		qdf_set_bit(RX_POST_EVENT, &thread->event_flag);
+		qdf_wake_up_interruptible(&thread->wait_q);
+	}
+}
+
+/**
+ * dp_rx_thread_steal_gro_flushed() - note a GRO flush of the thread
+ * @rx_thread: rx_thread whose GRO was flushed
+ *
+ * Return: None
+ */
+static inline void dp_rx_thread_steal_gro_flushed(struct dp_rx_thread *rx_thread)
+{
+	qdf_atomic_inc(&rx_thread->steal_flush_gen);
+}
+#else
+static inline void dp_rx_tm_steal_init(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+}
+
+static inline void dp_rx_tm_thread_steal_init(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline void
+dp_rx_tm_thread_steal_deinit(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline void
+dp_rx_tm_thread_steal_flush_vdev(struct dp_rx_thread *rx_thread,
+				 uint8_t vdev_id)
+{
+}
+
+static inline void dp_rx_tm_thread_steal_flush(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline int dp_rx_tm_thread_steal_qlen(struct dp_rx_thread *rx_thread)
+{
+	return 0;
+}
+
+static inline void
+dp_rx_tm_thread_enqueue_tail(struct dp_rx_thread *rx_thread,
+			     qdf_nbuf_t nbuf_list)
+{
+	qdf_nbuf_queue_head_enqueue_tail(&rx_thread->nbuf_queue, nbuf_list);
+}
+
+static inline void
+dp_rx_tm_thread_enqueue_list(struct dp_rx_thread *rx_thread,
+			     qdf_nbuf_t nbuf_list, uint32_t num_elements)
+{
+	qdf_nbuf_t next_ptr_list;
+
+	QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list) = num_elements;
+
+	next_ptr_list = nbuf_list->next;
+
+	if (next_ptr_list) {
+		/* move ->next pointer to ext list */
+		qdf_nbuf_append_ext_list(nbuf_list, next_ptr_list, 0);
+		dp_debug("appended next_ptr_list %pK to nbuf %pK ext list %pK",
+			 qdf_nbuf_next(nbuf_list), nbuf_list,
+			 qdf_nbuf_get_ext_list(nbuf_list));
+	}
+	qdf_nbuf_set_next(nbuf_list, NULL);
+
+	dp_rx_tm_thread_enqueue_tail(rx_thread, nbuf_list);
+}
+
+static inline qdf_nbuf_t
+dp_rx_tm_thread_dequeue_head(struct dp_rx_thread *rx_thread)
+{
+	return qdf_nbuf_queue_head_dequeue(&rx_thread->nbuf_queue);
+}
+
+static inline bool dp_rx_thread_steal(struct dp_rx_thread *rx_thread)
+{
+	return false;
+}
+
+static inline void dp_rx_tm_steal_kick(struct dp_rx_thread *rx_thread,
+				       uint32_t qlen)
+{
+}
+
+static inline void dp_rx_thread_steal_gro_flushed(struct dp_rx_thread *rx_thread)
+{
+}
+#endif /* WLAN_DP_RX_THREAD_WORK_STEAL */
+
 /**
  * dp_rx_tm_thread_enqueue() - enqueue nbuf list into rx_thread
  * @rx_thread: rx_thread in which the nbuf needs to be queued
@@ -301,8 +822,6 @@ static QDF_STATUS dp_rx_tm_thread_enqueue(struct dp_rx_thread *rx_thread,
 		return QDF_STATUS_E_FAILURE;
 	}
 
-	wait_q_ptr = &rx_thread->wait_q;
-
 	if (reo_ring_num >= DP_RX_TM_MAX_REO_RINGS) {
 		dp_alert("incorrect ring %u", reo_ring_num);
 		QDF_BUG(0);
@@ -333,30 +852,17 @@ static QDF_STATUS dp_rx_tm_thread_enqueue(struct dp_rx_thread *rx_thread,
 		qdf_nbuf_set_next(head_ptr, NULL);
 		/* count aggregated RX frame into enqueued stats */
 		nbuf_queued += qdf_nbuf_get_gso_segs(head_ptr);
-		qdf_nbuf_queue_head_enqueue_tail(&rx_thread->nbuf_queue,
-						 head_ptr);
+		dp_rx_tm_thread_enqueue_tail(rx_thread, head_ptr);
 		head_ptr = next_ptr_list;
 	}
 
 	if (!head_ptr)
 		goto enq_done;
 
-	QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(head_ptr) = num_elements_in_nbuf;
-
-	next_ptr_list = head_ptr->next;
-
-	if (next_ptr_list) {
-		/* move ->next pointer to ext list */
-		qdf_nbuf_append_ext_list(head_ptr, next_ptr_list, 0);
-		dp_debug("appended next_ptr_list %pK to nbuf %pK ext list %pK",
-			 qdf_nbuf_next(nbuf_list), nbuf_list,
-			 qdf_nbuf_get_ext_list(nbuf_list));
-	}
-	qdf_nbuf_set_next(head_ptr, NULL);
-
-	qdf_nbuf_queue_head_enqueue_tail(&rx_thread->nbuf_queue, head_ptr);
+	dp_rx_tm_thread_enqueue_list(rx_thread, head_ptr, num_elements_in_nbuf);
 
 enq_done:
+	wait_q_ptr = &rx_thread->wait_q;
 	temp_qlen = qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue);
 
 	rx_thread->stats.nbuf_queued[reo_ring_num] += nbuf_queued;
@@ -374,6 +880,8 @@ enq_done:
 	qdf_set_bit(RX_POST_EVENT, &rx_thread->event_flag);
 	qdf_wake_up_interruptible(wait_q_ptr);
 
+	dp_rx_tm_steal_kick(rx_thread, temp_qlen);
+
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -434,7 +942,7 @@ static qdf_nbuf_t dp_rx_tm_thread_dequeue(struct dp_rx_thread *rx_thread)
 {
 	qdf_nbuf_t head;
 
-	head = qdf_nbuf_queue_head_dequeue(&rx_thread->nbuf_queue);
+	head = dp_rx_tm_thread_dequeue_head(rx_thread);
 	dp_rx_thread_adjust_nbuf_list(head);
 
 	dp_debug("Dequeued %pK nbuf_list", head);
@@ -556,6 +1064,7 @@ static void dp_rx_thread_gro_flush(struct dp_rx_thread *rx_thread,
 						   gro_flush_code);
 	qdf_local_bh_enable();
 	rx_thread->stats.gro_flushes++;
+	dp_rx_thread_steal_gro_flushed(rx_thread);
 }
 
 /**
@@ -608,6 +1117,10 @@ static int dp_rx_thread_sub_loop(struct dp_rx_thread *rx_thread, bool *shutdown)
 
 		dp_rx_thread_process_nbufq(rx_thread);
 
+		/* stolen work goes through this thread's GRO flush below */
+		if (dp_rx_thread_steal(rx_thread))
+			dp_rx_thread_process_nbufq(rx_thread);
+
 		gro_flush_code = dp_rx_should_flush(rx_thread);
 		/* Only flush when gro_flush_code is either
 		 * DP_RX_GRO_NORMAL_FLUSH or DP_RX_GRO_LOW_TPUT_FLUSH
@@ -620,6 +1133,7 @@ static int dp_rx_thread_sub_loop(struct dp_rx_thread *rx_thread, bool *shutdown)
 		if (qdf_atomic_test_and_clear_bit(RX_VDEV_DEL_EVENT,
 						  &rx_thread->event_flag)) {
 			rx_thread->stats.gro_flushes_by_vdev_del++;
+			dp_rx_tm_thread_steal_flush(rx_thread);
 			qdf_event_set(&rx_thread->vdev_del_event);
 			if (qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue))
 				continue;
@@ -848,6 +1362,7 @@ static QDF_STATUS dp_rx_tm_thread_init(struct dp_rx_thread *rx_thread,
 	qdf_event_create(&rx_thread->vdev_del_event);
 	qdf_atomic_init(&rx_thread->gro_flush_ind);
 	qdf_init_waitqueue_head(&rx_thread->wait_q);
+	dp_rx_tm_thread_steal_init(rx_thread);
 	qdf_scnprintf(thread_name, sizeof(thread_name), "dp_rx_thread_%u", id);
 	dp_info("%s %u", thread_name, id);
 
@@ -886,6 +1401,7 @@ static QDF_STATUS dp_rx_tm_thread_deinit(struct dp_rx_thread *rx_thread)
 	qdf_event_destroy(&rx_thread->resume_event);
 	qdf_event_destroy(&rx_thread->shutdown_event);
 	qdf_event_destroy(&rx_thread->vdev_del_event);
+	dp_rx_tm_thread_steal_deinit(rx_thread);
 
 	if (cdp_cfg_get(dp_rx_tm_get_soc_handle(rx_thread->rtm_handle_cmn),
 			cfg_dp_gro_enable))
@@ -964,6 +1480,7 @@ QDF_STATUS dp_rx_tm_init(struct dp_rx_tm_handle *rx_tm_hdl,
 
 	rx_tm_hdl->num_dp_rx_threads = num_dp_rx_threads;
 	rx_tm_hdl->state = DP_RX_THREADS_INVALID;
+	dp_rx_tm_steal_init(rx_tm_hdl);
 
 	dp_info("initializing %u threads", num_dp_rx_threads);
 
@@ -1125,6 +1642,8 @@ dp_rx_tm_flush_nbuf_list(struct dp_rx_tm_handle *rx_tm_hdl, uint8_t vdev_id)
 		if (!rx_thread)
 			continue;
 
+		dp_rx_tm_thread_steal_flush_vdev(rx_thread, vdev_id);
+
 		qdf_nbuf_queue_head_lock(&rx_thread->nbuf_queue);
 		lock_time = qdf_get_log_timestamp();
 		QDF_NBUF_QUEUE_WALK_SAFE(&rx_thread->nbuf_queue, nbuf_list,
@@ -1154,11 +1673,21 @@ dp_rx_tm_flush_nbuf_list(struct dp_rx_tm_handle *rx_tm_hdl, uint8_t vdev_id)
 			rx_thread->id,
 			qdf_log_timestamp_to_usecs(unlock_time - lock_time),
 			qdf_log_timestamp_to_usecs(flush_time - unlock_time));
+	}
+
+	/*
+	 * Only signal the threads once every queue is flushed, so no thread
+	 * can steal nbuf_lists of the vdev after it dropped its stolen ones.
+	 */
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		rx_thread = rx_tm_hdl->rx_thread[i];
+		if (!rx_thread)
+			continue;
 
 		qdf_event_reset(&rx_thread->vdev_del_event);
 		qdf_set_bit(RX_VDEV_DEL_EVENT, &rx_thread->event_flag);
 		qdf_wake_up_interruptible(&rx_thread->wait_q);
-		}
+	}
 }
 
 /**
@@ -1421,6 +1950,55 @@ QDF_STATUS dp_rx_tm_enqueue_pkt(struct dp_rx_tm_handle *rx_tm_hdl,
 	return QDF_STATUS_SUCCESS;
 }
 
+#ifdef WLAN_DP_RX_THREAD_WORK_STEAL
+QDF_STATUS
+dp_rx_tm_gro_flush_ind(struct dp_rx_tm_handle *rx_tm_hdl, int rx_ctx_id,
+		       enum dp_rx_gro_flush_code flush_code)
+{
+	uint32_t thread_map;
+	uint8_t key;
+	int i;
+
+	thread_map = BIT(dp_rx_tm_select_thread(rx_tm_hdl, rx_ctx_id));
+
+	/* the ring's traffic may have been stolen by other threads */
+	if (rx_ctx_id >= 0 && rx_ctx_id < DP_RX_TM_MAX_REO_RINGS) {
+		key = rx_ctx_id * DP_RX_TM_STEAL_FLOW_BUCKETS;
+		for (i = 0; i < DP_RX_TM_STEAL_FLOW_BUCKETS; i++)
+			thread_map |= BIT(rx_tm_hdl->steal_owner[key + i]);
+	}
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		if (thread_map & BIT(i))
+			dp_rx_tm_thread_gro_flush_ind(rx_tm_hdl->rx_thread[i],
+						      flush_code);
+	}
+
+	return QDF_STATUS_SUCCESS;
+}
+
+qdf_napi_struct *dp_rx_tm_get_napi_context(struct dp_rx_tm_handle *rx_tm_hdl,
+					   uint8_t rx_ctx_id)
+{
+	uint8_t selected_thread_id;
+	qdf_thread_t *task = qdf_get_current_task();
+	int i;
+
+	/*
+	 * A stolen nbuf_list is delivered by a thread other than the one
+	 * of its RX context, use the napi of the delivering thread.
+	 */
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		if (rx_tm_hdl->rx_thread[i] &&
+		    rx_tm_hdl->rx_thread[i]->task == task)
+			return &rx_tm_hdl->rx_thread[i]->napi;
+	}
+
+	selected_thread_id = dp_rx_tm_select_thread(rx_tm_hdl, rx_ctx_id);
+
+	return &rx_tm_hdl->rx_thread[selected_thread_id]->napi;
+}
+#else
 QDF_STATUS
 dp_rx_tm_gro_flush_ind(struct dp_rx_tm_handle *rx_tm_hdl, int rx_ctx_id,
 		       enum dp_rx_gro_flush_code flush_code)
@@ -1443,6 +2021,7 @@ qdf_napi_struct *dp_rx_tm_get_napi_context(struct dp_rx_tm_handle *rx_tm_hdl,
 
 	return &rx_tm_hdl->rx_thread[selected_thread_id]->napi;
 }
+#endif /* WLAN_DP_RX_THREAD_WORK_STEAL */
 
 QDF_STATUS dp_rx_tm_set_cpu_mask(struct dp_rx_tm_handle *rx_tm_hdl,
 				 qdf_cpu_mask *new_mask)
@@ -1622,6 +2201,7 @@ int dp_rx_tm_get_pending(ol_txrx_soc_handle soc)
 		if (!rx_thread)
 			continue;
 		num_pending += qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue);
+		num_pending += dp_rx_tm_thread_steal_qlen(rx_thread);
 	}
 
 	if (num_pending)
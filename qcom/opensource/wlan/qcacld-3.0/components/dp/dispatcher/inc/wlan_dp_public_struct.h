@@ -625,6 +625,7 @@ union wlan_tp_data {
  * @dp_is_roaming_in_progress:Callback to check if roaming is in progress
  * @dp_is_ap_active:Callback to check if AP is active
  * @dp_napi_apply_throughput_policy:Callback to apply NAPI throughput policy
+ * @dp_napi_load_sample: Callback to end a NAPI load sample period
  * @wlan_dp_display_tx_multiq_stats: Callback to display Tx Mulit queue stats
  * @wlan_dp_display_netif_queue_history: Callback to display Netif queue
  * history
@@ -706,6 +707,7 @@ struct wlan_dp_psoc_callbacks {
 	int (*dp_napi_apply_throughput_policy)(hdd_cb_handle context,
 					       uint64_t tx_packets,
 					       uint64_t rx_packets);
+	int (*dp_napi_load_sample)(hdd_cb_handle context);
 	void (*wlan_dp_display_tx_multiq_stats)(hdd_cb_handle context,
 						qdf_netdev_t netdev);
 	void (*wlan_dp_display_netif_queue_history)(hdd_cb_handle context,
@@ -1439,9 +1439,12 @@ QDF_STATUS ucfg_dp_start_xmit(qdf_nbuf_t nbuf, struct wlan_objmgr_vdev *vdev)
 	 * Since one link is already present in the dp_intf and validated above,
 	 * the def_link is not expected to be NULL. Hence there is no need
 	 * to validate tx_dp_link again.
+	 *
+	 * The link is selected with num_active_task held, the vdev destroy
+	 * waits for it before freeing a link that may still be selected.
 	 */
-	tx_dp_link = dp_intf->def_link;
 	qdf_atomic_inc(&dp_intf->num_active_task);
+	tx_dp_link = dp_get_tx_link(dp_intf, nbuf);
 	status = dp_start_xmit(tx_dp_link, nbuf);
 	qdf_atomic_dec(&dp_intf->num_active_task);
 
@@ -2267,6 +2270,7 @@ void ucfg_dp_register_hdd_callbacks(struct wlan_objmgr_psoc *psoc,
 		cb_obj->dp_disable_rx_ol_for_low_tput;
 	dp_ctx->dp_ops.dp_napi_apply_throughput_policy =
 		cb_obj->dp_napi_apply_throughput_policy;
+	dp_ctx->dp_ops.dp_napi_load_sample = cb_obj->dp_napi_load_sample;
 	dp_ctx->dp_ops.dp_is_link_adapter = cb_obj->dp_is_link_adapter;
 	dp_ctx->dp_ops.dp_get_pause_map = cb_obj->dp_get_pause_map;
 	dp_ctx->dp_ops.dp_nud_failure_work = cb_obj->dp_nud_failure_work;
@@ -97,6 +97,10 @@
 #define WLAN_PTR_HASH_TEST (1)
 #endif
 
+#ifdef CONFIG_QDF_TEST
+#define WLAN_REG_BONDED_CHAN_CACHE_TEST (1)
+#endif
+
 #ifdef CONFIG_QDF_TEST
 #define WLAN_SLIST_TEST (1)
 #endif
@@ -342,6 +346,11 @@
 #define WLAN_LOGGING_BUFFERS_DYNAMICALLY (1)
 #endif
 
+#if defined(CONFIG_WLAN_LOGGING_BINARY_RECORDS) && \
+	defined(CONFIG_BINARY_PRINTF)
+#define WLAN_LOGGING_BINARY_RECORDS (1)
+#endif
+
 #ifdef CONFIG_WLAN_FEATURE_FILS
 #define WLAN_FEATURE_FILS_SK (1)
 #endif
@@ -457,6 +466,14 @@
 #define FEATURE_WLAN_DP_RX_THREADS (1)
 #endif
 
+#ifdef CONFIG_WLAN_DP_RX_REAP_BATCH
+#define WLAN_DP_RX_REAP_BATCH (1)
+#endif
+
+#ifdef CONFIG_WLAN_DP_RX_THREAD_WORK_STEAL
+#define WLAN_DP_RX_THREAD_WORK_STEAL (1)
+#endif
+
 #ifdef CONFIG_WLAN_FEATURE_RX_SOFTIRQ_TIME_LIMIT
 #define WLAN_FEATURE_RX_SOFTIRQ_TIME_LIMIT (1)
 #endif
@@ -1116,6 +1133,10 @@
 #define PKTLOG_HAS_SPECIFIC_DATA (1)
 #endif
 
+#ifdef CONFIG_PKTLOG_MMAP_RING
+#define PKTLOG_MMAP_RING (1)
+#endif
+
 #ifdef CONFIG_LITTLE_ENDIAN
 #define ANI_LITTLE_BYTE_ENDIAN (1)
 #define ANI_LITTLE_BIT_ENDIAN (1)
@@ -2644,6 +2665,10 @@
 #define HIF_CPU_PERF_AFFINE_MASK (1)
 #endif
 
+#ifdef CONFIG_HIF_EXEC_LOAD_PLACEMENT
+#define HIF_EXEC_LOAD_PLACEMENT (1)
+#endif
+
 #ifdef CONFIG_CE_CMN_REG_CFG_QMI
 #define CE_CMN_REG_CFG_QMI (1)
 #endif
@@ -2846,6 +2871,14 @@
 #define WLAN_FEATURE_LOCAL_PKT_CAPTURE (1)
 #endif
 
+#ifdef CONFIG_WLAN_DP_MON_CAPTURE_RING
+#define WLAN_DP_MON_CAPTURE_RING (1)
+#endif
+
+#ifdef CONFIG_WLAN_DP_MLO_LINK_SCHED
+#define WLAN_DP_MLO_LINK_SCHED (1)
+#endif
+
 #ifdef CONFIG_WIFI_MONITOR_SUPPORT_Y_WLAN_TX_MON_2_0
 #define WLAN_PKT_CAPTURE_TX_2_0 (1)
 #define WLAN_TX_PKT_CAPTURE_ENH_BE (1)
@@ -54,6 +54,7 @@ struct qca_napi_data *hdd_napi_get_all(void);
 int hdd_napi_apply_throughput_policy(struct hdd_context *hddctx,
 				     uint64_t              tx_packets,
 				     uint64_t              rx_packets);
+int hdd_napi_load_sample(void);
 int hdd_napi_serialize(int is_on);
 #else
 static inline int hdd_napi_apply_throughput_policy(struct hdd_context *hddctx,
@@ -62,6 +63,10 @@ static inline int hdd_napi_apply_throughput_policy(struct hdd_context *hddctx,
 {
 	return 0;
 }
+static inline int hdd_napi_load_sample(void)
+{
+	return 0;
+}
 static inline int hdd_napi_serialize(int is_on)
 {
 	return -EINVAL;
@@ -93,6 +98,11 @@ static inline int hdd_napi_apply_throughput_policy(void *hdd_ctx,
 	return 0;
 }
 
+static inline int hdd_napi_load_sample(void)
+{
+	return 0;
+}
+
 static inline int hdd_napi_serialize(int is_on)
 {
 	return -EINVAL;
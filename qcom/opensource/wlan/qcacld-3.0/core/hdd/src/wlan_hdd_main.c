@@ -246,6 +246,7 @@
 #include "wlan_ll_sap_ucfg_api.h"
 
 #include "os_if_dp_local_pkt_capture.h"
+#include "os_if_dp_mon_capture.h"
 #include <wlan_mlo_mgr_link_switch.h>
 #include "cdp_txrx_mon.h"
 #include "os_if_ll_sap.h"
@@ -11474,6 +11475,7 @@ void hdd_wlan_exit(struct hdd_context *hdd_ctx)
 	hdd_enter();
 
 	ucfg_dp_wait_complete_tasks();
+	os_if_dp_mon_capture_deinit();
 	wlan_hdd_destroy_mib_stats_lock();
 	hdd_debugfs_ini_config_deinit(hdd_ctx);
 	hdd_debugfs_mws_coex_info_deinit(hdd_ctx);
@@ -12327,6 +12329,26 @@ int wlan_hdd_napi_apply_throughput_policy(hdd_cb_handle context,
 	return rc;
 }
 
+/**
+ * wlan_hdd_napi_load_sample() - End a NAPI load sample period
+ * @context: HDD context
+ *
+ * Return: 0 on success else error code
+ */
+static inline int wlan_hdd_napi_load_sample(hdd_cb_handle context)
+{
+	struct hdd_context *hdd_ctx = hdd_cb_handle_to_context(context);
+
+	if (!hdd_ctx) {
+		hdd_err("hdd_ctx is null");
+		return 0;
+	}
+	if (hdd_ctx->config->napi_cpu_affinity_mask)
+		return hdd_napi_load_sample();
+
+	return 0;
+}
+
 /**
  * hdd_is_link_adapter() - Check if adapter is link adapter
  * @context: HDD context
@@ -12587,6 +12609,7 @@ static void hdd_dp_register_callbacks(struct hdd_context *hdd_ctx)
 	cb_obj.dp_is_ap_active = hdd_is_ap_active;
 	cb_obj.dp_napi_apply_throughput_policy =
 		wlan_hdd_napi_apply_throughput_policy;
+	cb_obj.dp_napi_load_sample = wlan_hdd_napi_load_sample;
 	cb_obj.dp_is_link_adapter = hdd_is_link_adapter;
 	cb_obj.dp_nud_failure_work = hdd_nud_failure_work;
 	cb_obj.dp_get_pause_map = hdd_get_pause_map;
@@ -17651,6 +17674,7 @@ int hdd_wlan_startup(struct hdd_context *hdd_ctx)
 	hdd_debugfs_ini_config_init(hdd_ctx);
 	wlan_hdd_debugfs_unit_test_host_create(hdd_ctx);
 	wlan_hdd_create_mib_stats_lock();
+	os_if_dp_mon_capture_init();
 	wlan_cfg80211_init_interop_issues_ap(hdd_ctx->pdev);
 
 	hdd_exit();
@@ -402,6 +402,29 @@ int hdd_napi_apply_throughput_policy(struct hdd_context *hddctx,
 	return rc;
 }
 
+/**
+ * hdd_napi_load_sample() - end a load sample period of the NAPI instances
+ *
+ * Called on every bus bandwidth period, whether or not the bus vote
+ * changed. While NAPI is in high throughput mode, this lets HIF re-balance
+ * the IRQs on their load measured over the period.
+ *
+ * Return: 0 : no action taken, or action return code
+ *         !0: error, or action error code
+ */
+int hdd_napi_load_sample(void)
+{
+	struct qca_napi_data *napid = hdd_napi_get_all();
+
+	if (!napid || !hdd_napi_enabled(HDD_NAPI_ANY))
+		return 0;
+
+	if (napid->napi_mode != QCA_NAPI_TPUT_HI)
+		return 0;
+
+	return hdd_napi_event(NAPI_EVT_LOAD_SAMPLE, NULL);
+}
+
 /**
  * hdd_napi_serialize() - serialize all NAPI activities
  * @is_on: 1="serialize" or 0="de-serialize"
@@ -35,6 +35,7 @@
 #include "qdf_types_test.h"
 #include "wlan_dsc_test.h"
 #include "wlan_hdd_unit_test.h"
+#include "wlan_reg_services_api.h"
 
 typedef uint32_t (*hdd_ut_callback)(void);
 
@@ -43,6 +44,18 @@ struct hdd_ut_entry {
 	const char *name;
 };
 
+static uint32_t hdd_reg_bonded_chan_cache_unit_test(void)
+{
+	struct hdd_context *hdd_ctx = cds_get_context(QDF_MODULE_ID_HDD);
+
+	if (!hdd_ctx || !hdd_ctx->pdev) {
+		hdd_err("pdev is not available");
+		return 1;
+	}
+
+	return wlan_reg_bonded_chan_cache_unit_test(hdd_ctx->pdev);
+}
+
 struct hdd_ut_entry hdd_ut_entries[] = {
 	{ .name = "dsc", .callback = dsc_unit_test },
 	{ .name = "qdf_delayed_work", .callback = qdf_delayed_work_unit_test },
@@ -54,6 +67,8 @@ struct hdd_ut_entry hdd_ut_entries[] = {
 	{ .name = "qdf_talloc", .callback = qdf_talloc_unit_test },
 	{ .name = "qdf_tracker", .callback = qdf_tracker_unit_test },
 	{ .name = "qdf_types", .callback = qdf_types_unit_test },
+	{ .name = "reg_bonded_chan_cache",
+	  .callback = hdd_reg_bonded_chan_cache_unit_test },
 };
 
 #define hdd_for_each_ut_entry(cursor) \
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: os_if_dp_mon_capture.h
+ *
+ * Monitor capture ring proc entry. A sniffer opens the entry, sizes the
+ * ring with OS_IF_MON_CAPTURE_IOC_SETUP, mmaps it and polls for retired
+ * blocks. The block and packet layout is struct cdp_mon_capture_blk_desc
+ * and struct cdp_mon_capture_pkt_hdr. Monitor MPDUs are written to the
+ * ring instead of the monitor interface while the entry is open.
+ *
+ * If the datapath goes away under the ring, e.g. on SSR, poll returns
+ * EPOLLERR and the ioctls and mmap fail with -ENODEV. The sniffer then
+ * unmaps the old ring and sets up and maps a new one.
+ */
+
+#ifndef _OS_IF_DP_MON_CAPTURE_H_
+#define _OS_IF_DP_MON_CAPTURE_H_
+
+#include "qdf_types.h"
+
+#define OS_IF_MON_CAPTURE_PROC_NAME "wlan_mon_capture"
+
+#define OS_IF_MON_CAPTURE_IOC_MAGIC 0xB7
+
+/**
+ * struct os_if_mon_capture_setup - OS_IF_MON_CAPTURE_IOC_SETUP argument
+ * @block_size: block size, multiple of the page size
+ * @num_blocks: number of blocks
+ * @snaplen: max bytes of radiotap and MPDU stored per packet, 0 for all
+ * @retire_tmo_ms: retire a partially filled block after this long,
+ *	0 to only retire full blocks
+ * @frame_filter: CDP_MON_CAPTURE_FILTER_* frame types, 0 for all
+ * @peer_filter: only capture frames with @peer_mac as addr1 or addr2
+ * @peer_mac: peer to capture when @peer_filter is set
+ * @reserved: reserved, must be 0
+ */
+struct os_if_mon_capture_setup {
+	uint32_t block_size;
+	uint32_t num_blocks;
+	uint32_t snaplen;
+	uint32_t retire_tmo_ms;
+	uint32_t frame_filter;
+	uint32_t peer_filter;
+	uint8_t peer_mac[QDF_MAC_ADDR_SIZE];
+	uint8_t reserved[2];
+};
+
+/**
+ * struct os_if_mon_capture_filter - OS_IF_MON_CAPTURE_IOC_SET_FILTER
+ *	argument
+ * @frame_filter: CDP_MON_CAPTURE_FILTER_* frame types, 0 for all
+ * @peer_filter: only capture frames with @peer_mac as addr1 or addr2
+ * @peer_mac: peer to capture when @peer_filter is set
+ * @reserved: reserved, must be 0
+ */
+struct os_if_mon_capture_filter {
+	uint32_t frame_filter;
+	uint32_t peer_filter;
+	uint8_t peer_mac[QDF_MAC_ADDR_SIZE];
+	uint8_t reserved[2];
+};
+
+#define OS_IF_MON_CAPTURE_IOC_SETUP \
+	_IOW(OS_IF_MON_CAPTURE_IOC_MAGIC, 1, struct os_if_mon_capture_setup)
+#define OS_IF_MON_CAPTURE_IOC_SET_FILTER \
+	_IOW(OS_IF_MON_CAPTURE_IOC_MAGIC, 2, struct os_if_mon_capture_filter)
+#define OS_IF_MON_CAPTURE_IOC_FLUSH \
+	_IO(OS_IF_MON_CAPTURE_IOC_MAGIC, 3)
+#define OS_IF_MON_CAPTURE_IOC_GET_STATS \
+	_IOR(OS_IF_MON_CAPTURE_IOC_MAGIC, 4, struct cdp_mon_capture_ring_stats)
+
+#ifdef WLAN_DP_MON_CAPTURE_RING
+/**
+ * os_if_dp_mon_capture_init() - create the monitor capture proc entry
+ *
+ * Return: none
+ */
+void os_if_dp_mon_capture_init(void);
+
+/**
+ * os_if_dp_mon_capture_deinit() - remove the monitor capture proc entry
+ *
+ * An open ring is detached from the datapath and freed.
+ *
+ * Return: none
+ */
+void os_if_dp_mon_capture_deinit(void);
+#else
+static inline void os_if_dp_mon_capture_init(void)
+{
+}
+
+static inline void os_if_dp_mon_capture_deinit(void)
+{
+}
+#endif /* WLAN_DP_MON_CAPTURE_RING */
+#endif /* _OS_IF_DP_MON_CAPTURE_H_ */
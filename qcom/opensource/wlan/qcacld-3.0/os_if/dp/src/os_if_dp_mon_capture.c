@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <linux/fs.h>
+#include <linux/mm.h>
+#include <linux/poll.h>
+#include <linux/proc_fs.h>
+#include <linux/uaccess.h>
+#include <linux/vmalloc.h>
+#include <linux/version.h>
+#include "qdf_types.h"
+#include "qdf_timer.h"
+#include "wlan_cfg80211.h"
+#include "cds_api.h"
+#include "cdp_txrx_mon.h"
+#include <ol_defines.h>
+#include "os_if_dp_mon_capture.h"
+
+#define OS_IF_MON_CAPTURE_PROC_PERM 0600
+#define OS_IF_MON_CAPTURE_MAX_BLOCKS 1024
+#define OS_IF_MON_CAPTURE_MAX_RING_SIZE (64 << 20)
+
+/**
+ * struct os_if_mon_capture - monitor capture proc entry state
+ * @pde: proc entry
+ * @lock: serializes setup, the ioctls, mmap, poll and release
+ * @in_use: the entry is open, only one reader is supported
+ * @attached: the ring is attached to the datapath
+ * @lost: the datapath dropped the ring at pdev deinit, e.g. on SSR; the
+ *	reader gets an error until it sets the ring up again
+ * @ring: ring memory, allocated with vmalloc_user() so it can be mapped
+ * @ring_size: size of @ring
+ * @block_size: block size
+ * @num_blocks: number of blocks
+ * @retire_tmo_ms: block retire timeout
+ * @retire_timer: retires partially filled blocks while traffic is idle
+ * @wq: readers waiting for a retired block
+ */
+struct os_if_mon_capture {
+	struct proc_dir_entry *pde;
+	struct mutex lock;
+	atomic_t in_use;
+	bool attached;
+	bool lost;
+	void *ring;
+	size_t ring_size;
+	uint32_t block_size;
+	uint32_t num_blocks;
+	uint32_t retire_tmo_ms;
+	qdf_timer_t retire_timer;
+	wait_queue_head_t wq;
+};
+
+static struct os_if_mon_capture os_if_mon_capture;
+
+/* called by the datapath with the ring lock held, must not sleep */
+static void os_if_mon_capture_notify(void *ctx)
+{
+	struct os_if_mon_capture *cap = ctx;
+
+	wake_up_interruptible(&cap->wq);
+}
+
+/* called by the datapath at pdev deinit, must not take @cap->lock */
+static void os_if_mon_capture_lost(void *ctx)
+{
+	struct os_if_mon_capture *cap = ctx;
+
+	osif_info("Capture ring dropped by the datapath");
+	WRITE_ONCE(cap->lost, true);
+	wake_up_interruptible(&cap->wq);
+}
+
+static void os_if_mon_capture_retire_timer(void *ctx)
+{
+	struct os_if_mon_capture *cap = ctx;
+	void *soc = cds_get_context(QDF_MODULE_ID_SOC);
+
+	if (!soc || READ_ONCE(cap->lost))
+		return;
+
+	cdp_mon_capture_ring_flush(soc, OL_TXRX_PDEV_ID, false);
+	qdf_timer_mod(&cap->retire_timer, cap->retire_tmo_ms);
+}
+
+/**
+ * os_if_mon_capture_detach() - detach the ring from the datapath and free it
+ * @cap: capture state
+ *
+ * Called with @cap->lock held. The datapath no longer touches the ring
+ * once the detach returns. Pages still mapped by the reader hold their own
+ * reference, so freeing the ring here is safe.
+ *
+ * Return: none
+ */
+static void os_if_mon_capture_detach(struct os_if_mon_capture *cap)
+{
+	void *soc = cds_get_context(QDF_MODULE_ID_SOC);
+
+	if (!cap->attached)
+		return;
+
+	if (cap->retire_tmo_ms)
+		qdf_timer_sync_cancel(&cap->retire_timer);
+
+	if (soc)
+		cdp_mon_capture_ring_detach(soc, OL_TXRX_PDEV_ID);
+
+	vfree(cap->ring);
+	cap->ring = NULL;
+	cap->ring_size = 0;
+	cap->attached = false;
+	WRITE_ONCE(cap->lost, false);
+}
+
+static int os_if_mon_capture_setup(struct os_if_mon_capture *cap,
+				   struct os_if_mon_capture_setup *setup)
+{
+	struct cdp_mon_capture_ring_cfg cfg = {0};
+	void *soc = cds_get_context(QDF_MODULE_ID_SOC);
+	QDF_STATUS status;
+	size_t size;
+
+	if (!soc)
+		return -EAGAIN;
+
+	if (!setup->block_size || !PAGE_ALIGNED(setup->block_size) ||
+	    !setup->num_blocks ||
+	    setup->num_blocks > OS_IF_MON_CAPTURE_MAX_BLOCKS)
+		return -EINVAL;
+
+	size = (size_t)setup->block_size * setup->num_blocks;
+	if (size > OS_IF_MON_CAPTURE_MAX_RING_SIZE)
+		return -EINVAL;
+
+	/* a ring lost to a pdev deinit is replaced, the reader maps it again */
+	if (cap->attached && READ_ONCE(cap->lost))
+		os_if_mon_capture_detach(cap);
+
+	if (cap->attached)
+		return -EBUSY;
+
+	/* zeroed, so every block starts as CDP_MON_CAPTURE_BLK_KERNEL */
+	cap->ring = vmalloc_user(size);
+	if (!cap->ring)
+		return -ENOMEM;
+
+	cfg.base = cap->ring;
+	cfg.block_size = setup->block_size;
+	cfg.num_blocks = setup->num_blocks;
+	cfg.snaplen = setup->snaplen;
+	cfg.retire_tmo_ms = setup->retire_tmo_ms;
+	cfg.frame_filter = setup->frame_filter;
+	cfg.peer_filter = !!setup->peer_filter;
+	qdf_mem_copy(cfg.peer_mac, setup->peer_mac, QDF_MAC_ADDR_SIZE);
+	cfg.notify = os_if_mon_capture_notify;
+	cfg.lost = os_if_mon_capture_lost;
+	cfg.notify_ctx = cap;
+
+	status = cdp_mon_capture_ring_attach(soc, OL_TXRX_PDEV_ID, &cfg);
+	if (QDF_IS_STATUS_ERROR(status)) {
+		osif_err("Capture ring attach failed: %d", status);
+		vfree(cap->ring);
+		cap->ring = NULL;
+		return qdf_status_to_os_return(status);
+	}
+
+	cap->ring_size = size;
+	cap->block_size = setup->block_size;
+	cap->num_blocks = setup->num_blocks;
+	cap->retire_tmo_ms = setup->retire_tmo_ms;
+	cap->attached = true;
+
+	if (cap->retire_tmo_ms)
+		qdf_timer_mod(&cap->retire_timer, cap->retire_tmo_ms);
+
+	return 0;
+}
+
+/* called with @cap->lock held */
+static bool os_if_mon_capture_valid(struct os_if_mon_capture *cap)
+{
+	return cap->attached && !READ_ONCE(cap->lost);
+}
+
+static long os_if_mon_capture_ioctl(struct file *file, unsigned int cmd,
+				    unsigned long arg)
+{
+	struct os_if_mon_capture *cap = &os_if_mon_capture;
+	void __user *uarg = (void __user *)arg;
+	struct os_if_mon_capture_setup setup;
+	struct os_if_mon_capture_filter filter;
+	struct cdp_mon_capture_ring_stats stats;
+	void *soc = cds_get_context(QDF_MODULE_ID_SOC);
+	QDF_STATUS status;
+	int ret;
+
+	if (!soc)
+		return -EAGAIN;
+
+	switch (cmd) {
+	case OS_IF_MON_CAPTURE_IOC_SETUP:
+		if (copy_from_user(&setup, uarg, sizeof(setup)))
+			return -EFAULT;
+
+		mutex_lock(&cap->lock);
+		ret = os_if_mon_capture_setup(cap, &setup);
+		mutex_unlock(&cap->lock);
+		return ret;
+	case OS_IF_MON_CAPTURE_IOC_SET_FILTER:
+		if (copy_from_user(&filter, uarg, sizeof(filter)))
+			return -EFAULT;
+
+		mutex_lock(&cap->lock);
+		if (os_if_mon_capture_valid(cap)) {
+			status = cdp_mon_capture_ring_set_filter(
+					soc, OL_TXRX_PDEV_ID,
+					filter.frame_filter,
+					filter.peer_filter ? filter.peer_mac :
+							     NULL);
+			ret = qdf_status_to_os_return(status);
+		} else {
+			ret = -ENODEV;
+		}
+		mutex_unlock(&cap->lock);
+		return ret;
+	case OS_IF_MON_CAPTURE_IOC_FLUSH:
+		mutex_lock(&cap->lock);
+		if (os_if_mon_capture_valid(cap)) {
+			status = cdp_mon_capture_ring_flush(soc,
+							    OL_TXRX_PDEV_ID,
+							    true);
+			ret = qdf_status_to_os_return(status);
+		} else {
+			ret = -ENODEV;
+		}
+		mutex_unlock(&cap->lock);
+		return ret;
+	case OS_IF_MON_CAPTURE_IOC_GET_STATS:
+		mutex_lock(&cap->lock);
+		if (os_if_mon_capture_valid(cap)) {
+			status = cdp_mon_capture_ring_get_stats(soc,
+								OL_TXRX_PDEV_ID,
+								&stats);
+			ret = qdf_status_to_os_return(status);
+		} else {
+			ret = -ENODEV;
+		}
+		mutex_unlock(&cap->lock);
+		if (ret)
+			return ret;
+
+		if (copy_to_user(uarg, &stats, sizeof(stats)))
+			return -EFAULT;
+		return 0;
+	default:
+		return -ENOTTY;
+	}
+}
+
+static int os_if_mon_capture_mmap(struct file *file,
+				  struct vm_area_struct *vma)
+{
+	struct os_if_mon_capture *cap = &os_if_mon_capture;
+	unsigned long size = vma->vm_end - vma->vm_start;
+	int ret;
+
+	if (vma->vm_pgoff)
+		return -EINVAL;
+
+	mutex_lock(&cap->lock);
+	if (!os_if_mon_capture_valid(cap))
+		ret = -ENODEV;
+	else if (size > PAGE_ALIGN(cap->ring_size))
+		ret = -EINVAL;
+	else
+		ret = remap_vmalloc_range(vma, cap->ring, 0);
+	mutex_unlock(&cap->lock);
+
+	return ret;
+}
+
+static __poll_t os_if_mon_capture_poll(struct file *file,
+				       struct poll_table_struct *wait)
+{
+	struct os_if_mon_capture *cap = &os_if_mon_capture;
+	struct cdp_mon_capture_blk_desc *desc;
+	__poll_t mask = 0;
+	uint32_t i;
+
+	poll_wait(file, &cap->wq, wait);
+
+	/* a SETUP from another thread may replace a lost ring under us */
+	mutex_lock(&cap->lock);
+	if (!os_if_mon_capture_valid(cap)) {
+		mutex_unlock(&cap->lock);
+		return EPOLLERR;
+	}
+
+	for (i = 0; i < cap->num_blocks; i++) {
+		desc = (struct cdp_mon_capture_blk_desc *)
+			((uint8_t *)cap->ring + i * cap->block_size);
+		if (READ_ONCE(desc->block_status) ==
+		    CDP_MON_CAPTURE_BLK_USER) {
+			mask |= EPOLLIN | EPOLLRDNORM;
+			break;
+		}
+	}
+	mutex_unlock(&cap->lock);
+
+	return mask;
+}
+
+static int os_if_mon_capture_open(struct inode *inode, struct file *file)
+{
+	struct os_if_mon_capture *cap = &os_if_mon_capture;
+
+	if (atomic_cmpxchg(&cap->in_use, 0, 1))
+		return -EBUSY;
+
+	return nonseekable_open(inode, file);
+}
+
+static int os_if_mon_capture_release(struct inode *inode, struct file *file)
+{
+	struct os_if_mon_capture *cap = &os_if_mon_capture;
+
+	mutex_lock(&cap->lock);
+	os_if_mon_capture_detach(cap);
+	mutex_unlock(&cap->lock);
+	atomic_set(&cap->in_use, 0);
+
+	return 0;
+}
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 6, 0)
+static const struct proc_ops os_if_mon_capture_fops = {
+	.proc_open = os_if_mon_capture_open,
+	.proc_release = os_if_mon_capture_release,
+	.proc_ioctl = os_if_mon_capture_ioctl,
+	.proc_mmap = os_if_mon_capture_mmap,
+	.proc_poll = os_if_mon_capture_poll,
+};
+#else
+static const struct file_operations os_if_mon_capture_fops = {
+	.owner = THIS_MODULE,
+	.open = os_if_mon_capture_open,
+	.release = os_if_mon_capture_release,
+	.unlocked_ioctl = os_if_mon_capture_ioctl,
+	.mmap = os_if_mon_capture_mmap,
+	.poll = os_if_mon_capture_poll,
+};
+#endif
+
+void os_if_dp_mon_capture_init(void)
+{
+	struct os_if_mon_capture *cap = &os_if_mon_capture;
+
+	mutex_init(&cap->lock);
+	init_waitqueue_head(&cap->wq);
+	atomic_set(&cap->in_use, 0);
+	qdf_timer_init(NULL, &cap->retire_timer,
+		       os_if_mon_capture_retire_timer, cap,
+		       QDF_TIMER_TYPE_SW);
+
+	cap->pde = proc_create_data(OS_IF_MON_CAPTURE_PROC_NAME,
+				    OS_IF_MON_CAPTURE_PROC_PERM, NULL,
+				    &os_if_mon_capture_fops, cap);
+	if (!cap->pde)
+		osif_err("Failed to create /proc/%s",
+			 OS_IF_MON_CAPTURE_PROC_NAME);
+}
+
+void os_if_dp_mon_capture_deinit(void)
+{
+	struct os_if_mon_capture *cap = &os_if_mon_capture;
+
+	/* releases a still open reader, which detaches the ring */
+	if (cap->pde)
+		proc_remove(cap->pde);
+	cap->pde = NULL;
+
+	mutex_lock(&cap->lock);
+	os_if_mon_capture_detach(cap);
+	mutex_unlock(&cap->lock);
+	qdf_timer_free(&cap->retire_timer);
+}
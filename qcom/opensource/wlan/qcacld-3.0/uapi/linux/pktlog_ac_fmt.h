@@ -285,6 +285,32 @@ struct ath_pktlog_buf {
 	char log_data[];
 };
 
+#define PKTLOG_RING_VERSION 1
+
+/*
+ * In ring mode the log data is mapped read-only by userspace through the
+ * PKTLOG_PROC_DIR/<device>_ring proc entry. Reading that entry at offset 0
+ * returns this header, and writing a int32_t at offset 0 sets rd_offset.
+ *
+ * The driver appends records at wr_offset and never overwrites unread
+ * records: a record that does not fit before rd_offset is dropped and
+ * counted in overruns. Records are placed the way PKTLOG_MOV_RD_IDX()
+ * expects, with log_data starting at data_offset in the mapping. The
+ * reader steps over the records it consumed and writes the new
+ * rd_offset, which has to lie between the old rd_offset and wr_offset.
+ * rd_offset == wr_offset means the ring is empty.
+ */
+struct ath_pktlog_ring_hdr {
+	uint32_t version;       /* Set to PKTLOG_RING_VERSION */
+	uint32_t hdr_size;      /* Size of this header */
+	uint32_t data_offset;   /* Offset of log_data in the mapping */
+	uint32_t data_size;     /* Size of log_data in bytes */
+	int32_t wr_offset;
+	int32_t rd_offset;
+	uint32_t overruns;
+	uint32_t reserved;
+};
+
 #define PKTLOG_MOV_RD_IDX(_rd_offset, _log_buf, _log_size)  \
 	do { \
 		if ((_rd_offset + sizeof(struct ath_pktlog_hdr) + \